@@ -0,0 +1,48 @@
+#include "alerthighlighter.h"
+
+#include <QColor>
+#include <QVector>
+
+AlertHighlighter::AlertHighlighter(QTextDocument *document)
+    : QSyntaxHighlighter(document)
+{
+    m_format.setBackground(QColor(255, 214, 102));
+    m_format.setForeground(QColor(128, 0, 0));
+}
+
+void AlertHighlighter::setMatcher(const AlertMatcher &matcher)
+{
+    m_matcher = matcher;
+    rehighlight();
+}
+
+void AlertHighlighter::highlightBlock(const QString &text)
+{
+    if (m_matcher.isEmpty() || text.isEmpty()) return;
+    const QByteArray bytes = text.toUtf8();
+    // 非纯 ASCII 时建立字节偏移到字符下标的映射（代理对占 4 字节、2 个 QChar）
+    QVector<int> charAt;
+    if (bytes.size() != text.size()) {
+        charAt.resize(bytes.size());
+        int b = 0;
+        for (int i = 0; i < text.size(); ++i) {
+            const ushort u = text.at(i).unicode();
+            int len = u < 0x80 ? 1 : (u < 0x800 ? 2 : 3);
+            if (text.at(i).isHighSurrogate() && i + 1 < text.size() && text.at(i + 1).isLowSurrogate()) len = 4;
+            for (int k = 0; k < len && b < bytes.size(); ++k) charAt[b++] = i;
+            if (len == 4) ++i;
+        }
+    }
+    int state = 0;
+    m_matcher.scan(bytes.constData(), bytes.size(), &state, [&](int pattern, int end) {
+        const int begin = end - m_matcher.pattern(pattern).size();
+        const int from = charAt.isEmpty() ? begin : charAt[begin];
+        int to = end;
+        if (!charAt.isEmpty()) {
+            // 命中可能止于多字节字符中间，按该字符整体着色
+            const int last = charAt[end - 1];
+            to = last + (text.at(last).isHighSurrogate() ? 2 : 1);
+        }
+        setFormat(from, to - from, m_format);
+    });
+}
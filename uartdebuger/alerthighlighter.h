@@ -0,0 +1,28 @@
+#ifndef ALERTHIGHLIGHTER_H
+#define ALERTHIGHLIGHTER_H
+
+#include "alertmatcher.h"
+
+#include <QSyntaxHighlighter>
+#include <QTextCharFormat>
+
+class QTextDocument;
+
+// 接收区告警高亮：每个文本块按 UTF-8 字节跑一遍告警匹配器，命中处加底色。
+// 只作用于显示文本（HEX 显示模式下按十六进制文本匹配），计数以 AlertMonitor 的原始字节为准
+class AlertHighlighter : public QSyntaxHighlighter
+{
+public:
+    explicit AlertHighlighter(QTextDocument *document);
+
+    void setMatcher(const AlertMatcher &matcher);
+
+protected:
+    void highlightBlock(const QString &text) override;
+
+private:
+    AlertMatcher m_matcher;
+    QTextCharFormat m_format;
+};
+
+#endif // ALERTHIGHLIGHTER_H
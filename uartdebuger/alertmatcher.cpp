@@ -0,0 +1,144 @@
+#include "alertmatcher.h"
+
+namespace {
+int hexValue(QChar c)
+{
+    const ushort u = c.unicode();
+    if (u >= '0' && u <= '9') return u - '0';
+    if (u >= 'a' && u <= 'f') return u - 'a' + 10;
+    if (u >= 'A' && u <= 'F') return u - 'A' + 10;
+    return -1;
+}
+
+uchar foldByte(uchar c)
+{
+    return (c >= 'A' && c <= 'Z') ? uchar(c + ('a' - 'A')) : c;
+}
+}
+
+bool AlertMatcher::parsePattern(const QString &line, QByteArray *out, QString *error)
+{
+    QByteArray bytes;
+    QString plain;
+    for (int i = 0; i < line.size(); ++i) {
+        const QChar c = line.at(i);
+        if (c != QLatin1Char('\\')) {
+            plain += c;
+            continue;
+        }
+        bytes += plain.toUtf8();
+        plain.clear();
+        if (i + 1 >= line.size()) {
+            if (error) *error = QStringLiteral("行尾多余的反斜杠");
+            return false;
+        }
+        const QChar e = line.at(++i);
+        if (e == QLatin1Char('r')) bytes += '\r';
+        else if (e == QLatin1Char('n')) bytes += '\n';
+        else if (e == QLatin1Char('t')) bytes += '\t';
+        else if (e == QLatin1Char('\\')) bytes += '\\';
+        else if (e == QLatin1Char('x')) {
+            const int hi = i + 1 < line.size() ? hexValue(line.at(i + 1)) : -1;
+            const int lo = i + 2 < line.size() ? hexValue(line.at(i + 2)) : -1;
+            if (hi < 0 || lo < 0) {
+                if (error) *error = QStringLiteral("\\x 后需要两位十六进制数");
+                return false;
+            }
+            bytes += char((hi << 4) | lo);
+            i += 2;
+        } else {
+            if (error) *error = QStringLiteral("不支持的转义 \\%1").arg(e);
+            return false;
+        }
+    }
+    bytes += plain.toUtf8();
+    if (bytes.isEmpty()) {
+        if (error) *error = QStringLiteral("模式为空");
+        return false;
+    }
+    *out = bytes;
+    return true;
+}
+
+bool AlertMatcher::compile(const QVector<QByteArray> &patterns, bool ignoreCase, QString *error)
+{
+    *this = AlertMatcher();
+    if (patterns.isEmpty()) return true;
+
+    // 先建字典树：goto 为 0 表示没有该边（根以外的状态号都大于 0）
+    QVector<quint16> next(256, 0);
+    QVector<QVector<qint32>> own(1);
+    int states = 1;
+    int maxLength = 0;
+    for (int p = 0; p < patterns.size(); ++p) {
+        const QByteArray &pat = patterns[p];
+        if (pat.isEmpty()) {
+            if (error) *error = QStringLiteral("第 %1 个模式为空").arg(p + 1);
+            return false;
+        }
+        int s = 0;
+        for (int i = 0; i < pat.size(); ++i) {
+            const uchar c = ignoreCase ? foldByte(uchar(pat[i])) : uchar(pat[i]);
+            quint16 &edge = next[(s << 8) | c];
+            if (edge == 0) {
+                if (states >= kMaxStates) {
+                    if (error) *error = QStringLiteral("模式总长度过大（状态数超过 %1）").arg(kMaxStates);
+                    return false;
+                }
+                edge = quint16(states++);
+                next.resize(states * 256);
+                own.resize(states);
+            }
+            s = next[(s << 8) | c];
+        }
+        own[s].append(p);
+        maxLength = qMax(maxLength, pat.size());
+    }
+
+    // 按层遍历求失配链，同时把缺失的边补成失配状态的转移，得到完整 DFA
+    QVector<qint32> fail(states, 0);
+    QVector<qint32> report(states, -1);
+    QVector<qint32> outputLink(states, -1);
+    QVector<int> queue;
+    queue.reserve(states);
+    for (int c = 0; c < 256; ++c) {
+        const int t = next[c];
+        if (t != 0) queue.append(t);
+    }
+    for (int head = 0; head < queue.size(); ++head) {
+        const int s = queue[head];
+        const int f = fail[s];
+        // 失配链上最近的有输出状态；f 先于 s 出队，其 report 已确定
+        outputLink[s] = report[f];
+        report[s] = own[s].isEmpty() ? report[f] : s;
+        for (int c = 0; c < 256; ++c) {
+            quint16 &edge = next[(s << 8) | c];
+            if (edge != 0) {
+                fail[edge] = next[(f << 8) | c];
+                queue.append(edge);
+            } else {
+                edge = next[(f << 8) | c];
+            }
+        }
+    }
+    // 根的输出链不会被用到：模式非空，根永远没有输出
+    if (ignoreCase) {
+        for (int s = 0; s < states; ++s) {
+            for (int c = 'A'; c <= 'Z'; ++c) next[(s << 8) | c] = next[(s << 8) | (c + ('a' - 'A'))];
+        }
+    }
+
+    m_outputBegin.resize(states + 1);
+    for (int s = 0; s < states; ++s) {
+        m_outputBegin[s] = m_outputIds.size();
+        m_outputIds += own[s];
+    }
+    m_outputBegin[states] = m_outputIds.size();
+    m_patterns = patterns;
+    m_stateCount = states;
+    m_maxLength = maxLength;
+    m_next = next;
+    m_report = report;
+    m_outputLink = outputLink;
+    return true;
+}
@@ -0,0 +1,58 @@
+#ifndef ALERTMATCHER_H
+#define ALERTMATCHER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+// 多模式匹配：Aho-Corasick 自动机展开成完整的 256 列转移表（失配链在编译期折叠），
+// 扫描每字节只查一次表，与模式数量无关；状态号由调用方保存，可跨数据块延续，命中可以跨块。
+// 忽略大小写时把大写列复制为小写列，扫描时不再额外折叠
+class AlertMatcher
+{
+public:
+    // 转移表用 16 位状态号，总状态数上限（约 8 MB 转移表）
+    static const int kMaxStates = 16384;
+
+    bool compile(const QVector<QByteArray> &patterns, bool ignoreCase, QString *error);
+    bool isEmpty() const { return m_patterns.isEmpty(); }
+    int patternCount() const { return m_patterns.size(); }
+    const QByteArray &pattern(int index) const { return m_patterns[index]; }
+    int stateCount() const { return m_stateCount; }
+    int maxPatternLength() const { return m_maxLength; }
+
+    // 流式扫描：*state 为上次结束时的状态（初始 0）；每个命中调用 onHit(模式序号, 命中末字节之后在 data 中的下标)
+    template <typename F>
+    void scan(const char *data, int size, int *state, F onHit) const
+    {
+        if (m_stateCount == 0) return;
+        const quint16 *next = m_next.constData();
+        const qint32 *report = m_report.constData();
+        int s = *state;
+        for (int i = 0; i < size; ++i) {
+            s = next[(s << 8) | static_cast<uchar>(data[i])];
+            if (report[s] < 0) continue;
+            // 沿输出链列出以此处结尾的全部模式（含作为后缀的短模式）
+            for (int o = report[s]; o >= 0; o = m_outputLink[o]) {
+                for (int k = m_outputBegin[o]; k < m_outputBegin[o + 1]; ++k) onHit(m_outputIds[k], i + 1);
+            }
+        }
+        *state = s;
+    }
+
+    // 解析一行模式文本：支持 \r \n \t \\ 与 \xNN 转义，其余字符按 UTF-8 编码
+    static bool parsePattern(const QString &line, QByteArray *out, QString *error);
+
+private:
+    QVector<QByteArray> m_patterns;
+    int m_stateCount = 0;
+    int m_maxLength = 0;
+    QVector<quint16> m_next;             // stateCount × 256
+    QVector<qint32> m_report;            // 自身或失配链上第一个有输出的状态，没有为 -1
+    QVector<qint32> m_outputLink;        // 失配链上下一个有输出的状态
+    QVector<qint32> m_outputBegin;       // 各状态自身输出在 m_outputIds 中的区间，size = stateCount + 1
+    QVector<qint32> m_outputIds;
+};
+
+#endif // ALERTMATCHER_H
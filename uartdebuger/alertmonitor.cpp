@@ -0,0 +1,246 @@
+#include "alertmonitor.h"
+
+#include "nativeport.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+
+namespace {
+const int kContextBytes = 48;
+const int kPopTimeoutMs = 200;
+const qint64 kSnapshotIntervalMs = 1000;    // 两次快照的最小间隔，避免命中密集时写满磁盘
+const qint64 kActionIntervalMs = 200;       // 停止动作的最小投递间隔
+}
+
+AlertMonitor::AlertMonitor()
+    : m_ring(1 << 21)
+{
+}
+
+AlertMonitor::~AlertMonitor()
+{
+    stop();
+}
+
+QString AlertMonitor::defaultDirectory()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).filePath("alerts");
+}
+
+bool AlertMonitor::setPatterns(const QStringList &lines, const Options &options, QString *error)
+{
+    QVector<QByteArray> patterns;
+    QStringList kept;
+    for (int i = 0; i < lines.size(); ++i) {
+        if (lines[i].isEmpty()) continue;
+        QByteArray bytes;
+        QString lineError;
+        if (!AlertMatcher::parsePattern(lines[i], &bytes, &lineError)) {
+            *error = QStringLiteral("第 %1 行：%2").arg(i + 1).arg(lineError);
+            return false;
+        }
+        patterns.append(bytes);
+        kept.append(lines[i]);
+    }
+    AlertMatcher matcher;
+    if (!matcher.compile(patterns, options.ignoreCase, error)) return false;
+
+    stop();
+    m_matcher = matcher;
+    m_lines = kept;
+    m_options = options;
+    m_options.snapshotBefore = qMax(options.snapshotBefore, kContextBytes);
+    m_history.clear();
+    m_ring.clear();
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stats = Stats();
+        m_stats.counts.resize(m_matcher.patternCount());
+    }
+    if (m_matcher.isEmpty()) return true;
+    m_stop = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stats.running = true;
+    }
+    m_accepting = true;
+    QThread::start();
+    return true;
+}
+
+void AlertMonitor::setActionHandler(QObject *context, const ActionHandler &handler)
+{
+    m_actionContext = context;
+    m_actionHandler = handler;
+}
+
+void AlertMonitor::resetStats()
+{
+    QMutexLocker locker(&m_mutex);
+    const bool running = m_stats.running;
+    m_stats = Stats();
+    m_stats.running = running;
+    m_stats.counts.resize(m_matcher.patternCount());
+}
+
+AlertMonitor::Stats AlertMonitor::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    Stats s = m_stats;
+    s.dropped = m_ring.dropped();
+    return s;
+}
+
+void AlertMonitor::feed(const QByteArray &data, qint64 timestampNs)
+{
+    if (m_accepting.load()) m_ring.push(data, timestampNs);
+}
+
+void AlertMonitor::stop()
+{
+    m_stop = true;
+    m_ring.wake();
+    wait();
+    m_accepting = false;
+    QMutexLocker locker(&m_mutex);
+    m_stats.running = false;
+}
+
+void AlertMonitor::appendHistory(const char *data, int size)
+{
+    // 只保留最近 snapshotBefore 字节；超出两倍时才整体前移，摊还开销
+    const int keep = m_options.snapshotBefore;
+    if (size >= keep) {
+        m_history = QByteArray(data + size - keep, keep);
+        return;
+    }
+    m_history.append(data, size);
+    if (m_history.size() > 2 * keep) m_history.remove(0, m_history.size() - keep);
+}
+
+void AlertMonitor::finishSnapshot(Snapshot *snapshot)
+{
+    const QString directory = defaultDirectory();
+    const QString fileName = QDir(directory).filePath(QStringLiteral("alert_%1_p%2.bin")
+            .arg(QDateTime::fromMSecsSinceEpoch(snapshot->wallMs).toString(QStringLiteral("yyyyMMdd_hhmmss_zzz")))
+            .arg(snapshot->pattern + 1));
+    QString error;
+    QFile file(fileName);
+    if (!QDir().mkpath(directory) || !file.open(QIODevice::WriteOnly)) {
+        error = QStringLiteral("无法写入快照 %1").arg(fileName);
+    } else if (file.write(snapshot->data) != snapshot->data.size()) {
+        error = QStringLiteral("快照写入不完整 %1").arg(fileName);
+    }
+    file.close();
+    snapshot->data.clear();
+    snapshot->pattern = -1;
+
+    QMutexLocker locker(&m_mutex);
+    if (error.isEmpty()) {
+        ++m_stats.snapshots;
+        m_stats.lastSnapshot = fileName;
+    } else {
+        m_stats.error = error;
+    }
+}
+
+void AlertMonitor::run()
+{
+    // 运行期间 m_matcher / m_options 不会被修改（setPatterns 先停线程）
+    const AlertMatcher &matcher = m_matcher;
+    const Options options = m_options;
+    int state = 0;
+    qint64 offset = 0;
+    Snapshot snapshot;
+    qint64 lastSnapshotMs = 0;
+    qint64 lastActionMs = 0;
+    QVector<int> hitPatterns;
+    QVector<int> hitEnds;
+    IngestRing::Chunk chunk;
+
+    while (!m_stop.load()) {
+        if (!m_ring.pop(&chunk, kPopTimeoutMs)) {
+            // 数据停了：未收满的快照先落盘，避免一直悬着
+            if (snapshot.pattern >= 0) finishSnapshot(&snapshot);
+            continue;
+        }
+        const char *data = chunk.data.constData();
+        const int size = chunk.data.size();
+        const qint64 wallMs = QDateTime::currentMSecsSinceEpoch()
+                - (NativePort::nowNanos() - chunk.timestampNs) / 1000000;
+
+        if (snapshot.pattern >= 0) {
+            const int take = qMin(size, snapshot.remaining);
+            snapshot.data.append(data, take);
+            snapshot.remaining -= take;
+            if (snapshot.remaining == 0) finishSnapshot(&snapshot);
+        }
+
+        hitPatterns.clear();
+        hitEnds.clear();
+        const qint64 scanStart = NativePort::nowNanos();
+        matcher.scan(data, size, &state, [&](int pattern, int end) {
+            hitPatterns.append(pattern);
+            hitEnds.append(end);
+        });
+        const qint64 scanNs = NativePort::nowNanos() - scanStart;
+
+        if (!hitPatterns.isEmpty()) {
+            // 只为最后 kRecentHits 个命中拼上下文，计数仍是全部
+            const int first = qMax(0, hitPatterns.size() - kRecentHits);
+            QVector<Hit> fresh;
+            fresh.reserve(hitPatterns.size() - first);
+            for (int k = first; k < hitPatterns.size(); ++k) {
+                Hit hit;
+                hit.wallMs = wallMs;
+                hit.offset = offset + hitEnds[k];
+                hit.pattern = hitPatterns[k];
+                const int end = hitEnds[k];
+                const int fromChunk = qMin(end, kContextBytes);
+                const int fromHistory = qMin(kContextBytes - fromChunk, m_history.size());
+                hit.context = m_history.right(fromHistory);
+                hit.context.append(data + end - fromChunk, fromChunk);
+                fresh.append(hit);
+            }
+
+            if (options.snapshot && snapshot.pattern < 0 && wallMs - lastSnapshotMs >= kSnapshotIntervalMs) {
+                const int end = hitEnds[0];
+                const int fromChunk = qMin(end, options.snapshotBefore);
+                const int fromHistory = qMin(options.snapshotBefore - fromChunk, m_history.size());
+                snapshot.data = m_history.right(fromHistory);
+                snapshot.data.append(data + end - fromChunk, fromChunk);
+                snapshot.pattern = hitPatterns[0];
+                snapshot.wallMs = wallMs;
+                const int take = qMin(size - end, options.snapshotAfter);
+                snapshot.data.append(data + end, take);
+                snapshot.remaining = options.snapshotAfter - take;
+                lastSnapshotMs = wallMs;
+                if (snapshot.remaining == 0) finishSnapshot(&snapshot);
+            }
+
+            if (options.stopAutoSend && m_actionHandler && m_actionContext
+                    && wallMs - lastActionMs >= kActionIntervalMs) {
+                const ActionHandler handler = m_actionHandler;
+                const int pattern = hitPatterns[0];
+                QMetaObject::invokeMethod(m_actionContext, [handler, pattern]() { handler(pattern); },
+                                          Qt::QueuedConnection);
+                lastActionMs = wallMs;
+            }
+
+            QMutexLocker locker(&m_mutex);
+            m_stats.hits += hitPatterns.size();
+            for (int pattern : hitPatterns) ++m_stats.counts[pattern];
+            m_stats.recent += fresh;
+            if (m_stats.recent.size() > kRecentHits) m_stats.recent.remove(0, m_stats.recent.size() - kRecentHits);
+        }
+
+        appendHistory(data, size);
+        offset += size;
+        QMutexLocker locker(&m_mutex);
+        m_stats.bytes += size;
+        m_stats.scanSeconds += scanNs / 1e9;
+    }
+    if (snapshot.pattern >= 0) finishSnapshot(&snapshot);
+}
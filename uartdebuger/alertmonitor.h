@@ -0,0 +1,101 @@
+#ifndef ALERTMONITOR_H
+#define ALERTMONITOR_H
+
+#include "alertmatcher.h"
+#include "ingestring.h"
+
+#include <QByteArray>
+#include <QMutex>
+#include <QObject>
+#include <QStringList>
+#include <QThread>
+#include <QVector>
+#include <atomic>
+#include <functional>
+
+// 接收流告警：在工作线程中对 readAll() 得到的原始字节做多模式匹配，与显示模式、暂停无关。
+// 命中计数、保留最近命中的上下文；可选把命中前后的原始字节存成快照文件，
+// 或通过回调（在 GUI 线程执行）停止自动发送
+class AlertMonitor : public QThread
+{
+public:
+    struct Options {
+        bool ignoreCase = false;
+        bool snapshot = false;           // 命中时保存原始字节快照
+        bool stopAutoSend = false;       // 命中时停止自动发送与精确定时发送
+        int snapshotBefore = 16384;      // 快照包含命中末字节之前的字节数
+        int snapshotAfter = 4096;        // 之后继续收集的字节数
+    };
+
+    struct Hit {
+        qint64 wallMs = 0;               // 命中所在块的读取时刻（墙钟）
+        qint64 offset = 0;               // 命中末字节之后在接收流中的字节偏移
+        int pattern = -1;
+        QByteArray context;              // 命中末尾之前的一段原始字节
+    };
+
+    struct Stats {
+        bool running = false;
+        qint64 bytes = 0;
+        qint64 hits = 0;
+        qint64 dropped = 0;              // 环形缓冲溢出丢弃的块
+        double scanSeconds = 0;          // 匹配累计耗时，用于估算吞吐
+        QVector<qint64> counts;          // 按模式序号
+        QVector<Hit> recent;             // 最近的命中，旧的在前
+        int snapshots = 0;
+        QString lastSnapshot;
+        QString error;
+    };
+
+    // 命中且开启停止自动发送时调用，参数为模式序号
+    using ActionHandler = std::function<void(int pattern)>;
+
+    static const int kRecentHits = 200;
+
+    AlertMonitor();
+    ~AlertMonitor();
+
+    // 解析并编译模式表（每行一个，空行忽略），成功后重启工作线程并清空统计；在 GUI 线程调用
+    bool setPatterns(const QStringList &lines, const Options &options, QString *error);
+    QStringList patternLines() const { return m_lines; }
+    Options options() const { return m_options; }
+    // 当前编译好的匹配器副本，供显示区高亮使用
+    const AlertMatcher &matcher() const { return m_matcher; }
+    // 在 setPatterns() 之前设置；回调以 QueuedConnection 投递到 context 所在线程
+    void setActionHandler(QObject *context, const ActionHandler &handler);
+    void resetStats();
+    Stats stats() const;
+    // 在 readAll() 处调用；未运行时丢弃
+    void feed(const QByteArray &data, qint64 timestampNs);
+    void stop();
+
+    static QString defaultDirectory();
+
+protected:
+    void run() override;
+
+private:
+    struct Snapshot {
+        QByteArray data;
+        int pattern = -1;
+        qint64 wallMs = 0;
+        int remaining = 0;               // 尚需收集的命中后字节
+    };
+
+    void appendHistory(const char *data, int size);
+    void finishSnapshot(Snapshot *snapshot);
+
+    AlertMatcher m_matcher;
+    QStringList m_lines;
+    Options m_options;
+    QObject *m_actionContext = nullptr;
+    ActionHandler m_actionHandler;
+    IngestRing m_ring;
+    std::atomic<bool> m_accepting{false};
+    std::atomic<bool> m_stop{false};
+    QByteArray m_history;                // 最近 snapshotBefore 字节，仅工作线程访问
+    mutable QMutex m_mutex;
+    Stats m_stats;
+};
+
+#endif // ALERTMONITOR_H
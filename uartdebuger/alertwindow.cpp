@@ -0,0 +1,178 @@
+#include "alertwindow.h"
+
+#include "alertmonitor.h"
+
+#include <QCheckBox>
+#include <QDateTime>
+#include <QFontDatabase>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPlainTextEdit>
+#include <QPushButton>
+#include <QSplitter>
+#include <QVBoxLayout>
+#include <algorithm>
+
+namespace {
+const int kRefreshIntervalMs = 500;
+const int kListedHits = 50;
+
+// 上下文中的不可打印字节按 \xNN 显示
+QString describeBytes(const QByteArray &bytes)
+{
+    QString text;
+    for (char ch : bytes) {
+        const uchar c = static_cast<uchar>(ch);
+        if (c >= 0x20 && c < 0x7f && c != '\\') text += QChar(c);
+        else if (c == '\r') text += QStringLiteral("\\r");
+        else if (c == '\n') text += QStringLiteral("\\n");
+        else text += QStringLiteral("\\x%1").arg(int(c), 2, 16, QLatin1Char('0'));
+    }
+    return text;
+}
+}
+
+AlertWindow::AlertWindow(AlertMonitor *monitor, QWidget *parent)
+    : QWidget(parent, Qt::Window)
+    , m_monitor(monitor)
+{
+    setWindowTitle(QStringLiteral("告警匹配"));
+    resize(640, 560);
+
+    const QFont fixed = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+    m_patternEdit = new QPlainTextEdit(this);
+    m_patternEdit->setFont(fixed);
+    m_patternEdit->setPlaceholderText(QStringLiteral("每行一个模式，按原始字节匹配，可跨数据块。\n"
+                                                     "支持 \\r \\n \\t \\\\ 与 \\xNN 转义，例如：\n"
+                                                     "ERROR\nHardFault\n\\x55\\xAA\\x01"));
+    m_ignoreCaseCheck = new QCheckBox(QStringLiteral("忽略大小写（ASCII）"), this);
+    m_snapshotCheck = new QCheckBox(QStringLiteral("命中时保存原始字节快照"), this);
+    m_snapshotCheck->setToolTip(QStringLiteral("保存命中前 16 KB 与之后 4 KB，每秒最多一个，目录：%1")
+                                .arg(AlertMonitor::defaultDirectory()));
+    m_stopAutoSendCheck = new QCheckBox(QStringLiteral("命中时停止自动发送"), this);
+    m_stopAutoSendCheck->setToolTip(QStringLiteral("同时停止自动发送定时器与精确定时发送"));
+    m_applyButton = new QPushButton(QStringLiteral("应用"), this);
+    m_resetButton = new QPushButton(QStringLiteral("计数清零"), this);
+    m_statusLabel = new QLabel(this);
+    m_statusLabel->setWordWrap(true);
+    m_report = new QPlainTextEdit(this);
+    m_report->setReadOnly(true);
+    m_report->setFont(fixed);
+    m_report->setLineWrapMode(QPlainTextEdit::NoWrap);
+
+    QWidget *top = new QWidget(this);
+    QHBoxLayout *options = new QHBoxLayout;
+    options->addWidget(m_ignoreCaseCheck);
+    options->addWidget(m_snapshotCheck);
+    options->addWidget(m_stopAutoSendCheck);
+    options->addStretch(1);
+    QHBoxLayout *buttons = new QHBoxLayout;
+    buttons->addWidget(m_statusLabel, 1);
+    buttons->addWidget(m_resetButton);
+    buttons->addWidget(m_applyButton);
+    QVBoxLayout *topLayout = new QVBoxLayout(top);
+    topLayout->setContentsMargins(0, 0, 0, 0);
+    topLayout->addWidget(m_patternEdit, 1);
+    topLayout->addLayout(options);
+    topLayout->addLayout(buttons);
+    QSplitter *splitter = new QSplitter(Qt::Vertical, this);
+    splitter->addWidget(top);
+    splitter->addWidget(m_report);
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addWidget(splitter);
+
+    connect(m_applyButton, &QPushButton::clicked, this, &AlertWindow::apply);
+    connect(m_resetButton, &QPushButton::clicked, this, [this]() {
+        m_monitor->resetStats();
+        refresh();
+    });
+    m_refreshTimer.setInterval(kRefreshIntervalMs);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &AlertWindow::refresh);
+    loadFromMonitor();
+}
+
+void AlertWindow::setAppliedHandler(const std::function<void()> &handler)
+{
+    m_appliedHandler = handler;
+}
+
+void AlertWindow::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    refresh();
+    m_refreshTimer.start();
+}
+
+void AlertWindow::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    m_refreshTimer.stop();
+}
+
+void AlertWindow::loadFromMonitor()
+{
+    const AlertMonitor::Options opt = m_monitor->options();
+    m_patternEdit->setPlainText(m_monitor->patternLines().join('\n'));
+    m_ignoreCaseCheck->setChecked(opt.ignoreCase);
+    m_snapshotCheck->setChecked(opt.snapshot);
+    m_stopAutoSendCheck->setChecked(opt.stopAutoSend);
+}
+
+void AlertWindow::apply()
+{
+    AlertMonitor::Options opt = m_monitor->options();
+    opt.ignoreCase = m_ignoreCaseCheck->isChecked();
+    opt.snapshot = m_snapshotCheck->isChecked();
+    opt.stopAutoSend = m_stopAutoSendCheck->isChecked();
+    QString error;
+    if (!m_monitor->setPatterns(m_patternEdit->toPlainText().split('\n'), opt, &error)) {
+        m_statusLabel->setText(error);
+        return;
+    }
+    const AlertMatcher &matcher = m_monitor->matcher();
+    m_statusLabel->setText(matcher.isEmpty()
+                           ? QStringLiteral("未设置模式，告警已关闭")
+                           : QStringLiteral("已应用 %1 个模式，自动机 %2 个状态")
+                             .arg(matcher.patternCount()).arg(matcher.stateCount()));
+    if (m_appliedHandler) m_appliedHandler();
+    refresh();
+}
+
+void AlertWindow::refresh()
+{
+    const AlertMonitor::Stats s = m_monitor->stats();
+    const QStringList lines = m_monitor->patternLines();
+    QString text;
+    text += s.running ? QStringLiteral("监视中\n") : QStringLiteral("未启用\n");
+    if (!s.error.isEmpty()) text += s.error + '\n';
+    text += QStringLiteral("已扫描 %1 字节，命中 %2 次").arg(s.bytes).arg(s.hits);
+    if (s.scanSeconds > 0) {
+        text += QStringLiteral("，匹配吞吐 %1 MB/s").arg(s.bytes / s.scanSeconds / 1e6, 0, 'f', 1);
+    }
+    text += '\n';
+    if (s.dropped > 0) text += QStringLiteral("缓冲溢出丢弃 %1 块\n").arg(s.dropped);
+    if (s.snapshots > 0) text += QStringLiteral("快照 %1 个，最近：%2\n").arg(s.snapshots).arg(s.lastSnapshot);
+
+    // 按命中次数从多到少列出命中过的模式
+    QVector<int> order;
+    for (int i = 0; i < s.counts.size(); ++i) {
+        if (s.counts[i] > 0) order.append(i);
+    }
+    std::sort(order.begin(), order.end(), [&s](int a, int b) { return s.counts[a] > s.counts[b]; });
+    if (!order.isEmpty()) text += QStringLiteral("\n命中次数：\n");
+    for (int i : order) {
+        text += QStringLiteral("  %1  %2\n").arg(s.counts[i], 10).arg(i < lines.size() ? lines[i] : QString());
+    }
+
+    if (!s.recent.isEmpty()) text += QStringLiteral("\n最近命中（新的在前）：\n");
+    const int last = s.recent.size() - 1;
+    for (int k = last; k >= 0 && k > last - kListedHits; --k) {
+        const AlertMonitor::Hit &hit = s.recent[k];
+        text += QStringLiteral("%1  @%2  %3  …%4\n")
+                .arg(QDateTime::fromMSecsSinceEpoch(hit.wallMs).toString(QStringLiteral("hh:mm:ss.zzz")))
+                .arg(hit.offset)
+                .arg(hit.pattern < lines.size() ? lines[hit.pattern] : QString())
+                .arg(describeBytes(hit.context));
+    }
+    m_report->setPlainText(text);
+}
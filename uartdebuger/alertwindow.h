@@ -0,0 +1,45 @@
+#ifndef ALERTWINDOW_H
+#define ALERTWINDOW_H
+
+#include <QTimer>
+#include <QWidget>
+#include <functional>
+
+class AlertMonitor;
+class QCheckBox;
+class QLabel;
+class QPlainTextEdit;
+class QPushButton;
+
+// 告警匹配窗口：编辑模式表（每行一个）与命中动作，查看各模式命中次数和最近命中的上下文
+class AlertWindow : public QWidget
+{
+public:
+    explicit AlertWindow(AlertMonitor *monitor, QWidget *parent = nullptr);
+
+    // 模式表成功应用后调用，用于刷新接收区高亮
+    void setAppliedHandler(const std::function<void()> &handler);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    void loadFromMonitor();
+    void apply();
+    void refresh();
+
+    AlertMonitor *m_monitor = nullptr;
+    std::function<void()> m_appliedHandler;
+    QTimer m_refreshTimer;
+    QPlainTextEdit *m_patternEdit = nullptr;
+    QCheckBox *m_ignoreCaseCheck = nullptr;
+    QCheckBox *m_snapshotCheck = nullptr;
+    QCheckBox *m_stopAutoSendCheck = nullptr;
+    QPushButton *m_applyButton = nullptr;
+    QPushButton *m_resetButton = nullptr;
+    QLabel *m_statusLabel = nullptr;
+    QPlainTextEdit *m_report = nullptr;
+};
+
+#endif // ALERTWINDOW_H
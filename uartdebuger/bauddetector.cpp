@@ -0,0 +1,306 @@
+#include "bauddetector.h"
+
+#include "nativeport.h"
+
+namespace {
+const int kWindowBytes = 128;
+const int kMinBytes = 12;
+const int kWindowMs = 40;
+const int kMaxWindowMs = 150;
+const int kFormatWindowMs = 80;
+const int kSettleMs = 2;                 // 切换参数时线上正在传输的字节会错位，丢弃
+const int kActivityTimeoutMs = 3000;
+const int kPollMs = 50;
+const double kLockScore = 0.97;          // 无线路错误且达到此分数时不再尝试其余波特率
+const double kMinScore = 0.6;
+const double kFormatMargin = 0.2;
+const double kErrorRateForParity = 0.15;
+const double kMinHighBit = 0.2;
+
+bool isTextByte(uchar c)
+{
+    return (c >= 0x20 && c < 0x7F) || c == '\r' || c == '\n' || c == '\t';
+}
+
+int parityOf7(uchar c)
+{
+    int ones = 0;
+    for (int bit = 0; bit < 7; ++bit) ones += (c >> bit) & 1;
+    return ones & 1;
+}
+
+// 合法 UTF-8 多字节序列的长度，不是则返回 0；结尾处被截断的序列按合法计
+int utf8SequenceLength(const uchar *p, int remaining)
+{
+    int length = 0;
+    if (p[0] >= 0xC2 && p[0] <= 0xDF) length = 2;
+    else if (p[0] >= 0xE0 && p[0] <= 0xEF) length = 3;
+    else if (p[0] >= 0xF0 && p[0] <= 0xF4) length = 4;
+    else return 0;
+    const int available = qMin(length, remaining);
+    for (int i = 1; i < available; ++i) {
+        if ((p[i] & 0xC0) != 0x80) return 0;
+    }
+    return available;
+}
+}
+
+BaudDetector::BaudDetector()
+{
+}
+
+BaudDetector::~BaudDetector()
+{
+    stop();
+}
+
+void BaudDetector::start(const QString &portName, const QList<qint32> &bauds, QObject *context, const ResultHandler &handler)
+{
+    stop();
+    m_portName = portName;
+    m_bauds = bauds;
+    m_context = context;
+    m_handler = handler;
+    m_stop = false;
+    QThread::start();
+}
+
+void BaudDetector::stop()
+{
+    m_stop = true;
+    wait();
+}
+
+BaudDetector::ByteScore BaudDetector::scoreBytes(const QByteArray &data)
+{
+    ByteScore score;
+    const int size = data.size();
+    if (size == 0) return score;
+    const uchar *p = reinterpret_cast<const uchar *>(data.constData());
+
+    int text = 0;
+    int even = 0;
+    int odd = 0;
+    int high = 0;
+    bool seen[256] = {};
+    int distinct = 0;
+    int i = 0;
+    while (i < size) {
+        if (isTextByte(p[i])) {
+            ++text;
+            ++i;
+        } else if (const int length = utf8SequenceLength(p + i, size - i)) {
+            text += length;
+            i += length;
+        } else {
+            ++i;
+        }
+    }
+    for (i = 0; i < size; ++i) {
+        if (!seen[p[i]]) {
+            seen[p[i]] = true;
+            ++distinct;
+        }
+        if (p[i] & 0x80) ++high;
+        // 第 8 位是校验位：偶校验时 8 位中 1 的个数为偶数
+        if (!isTextByte(p[i] & 0x7F)) continue;
+        const int parityBit = p[i] >> 7;
+        if (parityBit == parityOf7(p[i])) ++even;
+        else ++odd;
+    }
+    score.text = double(text) / size;
+    score.text7Even = double(even) / size;
+    score.text7Odd = double(odd) / size;
+    score.highBit = double(high) / size;
+    score.diversity = qMin(1.0, distinct / 8.0);
+
+    for (int bigEndian = 0; bigEndian < 2; ++bigEndian) {
+        for (int offset = 0; offset < 2; ++offset) {
+            const int words = (size - offset) / 2;
+            if (words < 2) continue;
+            int valid = 0;
+            for (int w = 0; w < words; ++w) {
+                const uchar a = p[offset + 2 * w];
+                const uchar b = p[offset + 2 * w + 1];
+                const int value = bigEndian ? (a << 8) | b : (b << 8) | a;
+                // 全 0 多为错误波特率下的 break 与停止位错位，不计为有效码值
+                if (value >= 1 && value <= 0x0FFF) ++valid;
+            }
+            score.binary12 = qMax(score.binary12, double(valid) / words);
+        }
+    }
+    return score;
+}
+
+QString BaudDetector::formatName(const Format &format)
+{
+    QChar parity = 'N';
+    switch (format.parity) {
+    case QSerialPort::EvenParity: parity = 'E'; break;
+    case QSerialPort::OddParity: parity = 'O'; break;
+    case QSerialPort::MarkParity: parity = 'M'; break;
+    case QSerialPort::SpaceParity: parity = 'S'; break;
+    default: break;
+    }
+    const QString stop = format.stopBits == QSerialPort::TwoStop ? QStringLiteral("2")
+            : format.stopBits == QSerialPort::OneAndHalfStop ? QStringLiteral("1.5") : QStringLiteral("1");
+    return QStringLiteral("%1%2%3").arg(int(format.dataBits)).arg(parity).arg(stop);
+}
+
+void BaudDetector::run()
+{
+    QSerialPort port;
+    port.setPortName(m_portName);
+    Result result;
+    if (!port.open(QIODevice::ReadOnly)) {
+        result.error = QStringLiteral("无法打开 %1：%2").arg(m_portName, port.errorString());
+    } else {
+        qint64 counter = 0;
+        m_errorCounting = NativePort::lineErrorCount(port.handle(), &counter);
+        result = detect(port);
+        result.errorCounting = m_errorCounting;
+        port.close();
+    }
+    if (m_stop.load() || !m_handler || !m_context) return;
+    const ResultHandler handler = m_handler;
+    QMetaObject::invokeMethod(m_context, [handler, result]() { handler(result); }, Qt::QueuedConnection);
+}
+
+bool BaudDetector::configure(QSerialPort &port, qint32 baudRate, const Format &format)
+{
+    if (!port.setBaudRate(baudRate) || !port.setDataBits(format.dataBits) || !port.setParity(format.parity)
+            || !port.setStopBits(format.stopBits) || !port.setFlowControl(QSerialPort::NoFlowControl)) {
+        return false;
+    }
+    port.clear(QSerialPort::Input);
+    port.waitForReadyRead(kSettleMs);
+    port.readAll();
+    return true;
+}
+
+BaudDetector::Window BaudDetector::sample(QSerialPort &port, int maxMs)
+{
+    Window window;
+    qint64 before = 0;
+    qint64 counter = 0;
+    if (m_errorCounting) {
+        NativePort::lineErrorCount(port.handle(), &before);
+        counter = before;
+    }
+    qint64 erroredPolls = 0;
+    QByteArray data;
+    const qint64 startNs = NativePort::nowNanos();
+    while (!m_stop.load()) {
+        const int elapsedMs = static_cast<int>((NativePort::nowNanos() - startNs) / 1000000);
+        if (data.size() >= kWindowBytes || elapsedMs >= maxMs) break;
+        if (elapsedMs >= kWindowMs && data.size() >= kMinBytes) break;
+        port.waitForReadyRead(qBound(1, maxMs - elapsedMs, kPollMs));
+        data += port.readAll();
+        if (m_errorCounting) {
+            const qint64 last = counter;
+            NativePort::lineErrorCount(port.handle(), &counter);
+            ++window.polls;
+            if (counter != last) ++erroredPolls;
+        }
+    }
+    window.bytes = data.size();
+    window.errors = counter - before;
+    if (NativePort::lineErrorCountIsExact()) {
+        // 出错的字节多被驱动丢弃，不在 bytes 中
+        window.errorRate = window.bytes + window.errors > 0 ? double(window.errors) / (window.bytes + window.errors) : 0.0;
+    } else {
+        window.errorRate = window.polls > 0 ? double(erroredPolls) / window.polls : 0.0;
+    }
+    window.bytesScore = scoreBytes(data);
+    if (window.bytes >= kMinBytes) {
+        // 8 位带校验的数据按 8N1 接收时约一半字节帧错误，但字节本身正确，错误率只作次要扣分
+        window.score = window.bytesScore.best() * (1.0 - 0.5 * qMin(1.0, window.errorRate));
+    }
+    return window;
+}
+
+BaudDetector::Result BaudDetector::detect(QSerialPort &port)
+{
+    Result result;
+    if (m_bauds.isEmpty()) {
+        result.error = QStringLiteral("没有候选波特率");
+        return result;
+    }
+    const Format format8N1;
+
+    // 先等线路上有数据；波特率不对也会收到（错位的）字节
+    if (!configure(port, m_bauds.first(), format8N1)) {
+        result.error = QStringLiteral("设置串口参数失败：%1").arg(port.errorString());
+        return result;
+    }
+    const qint64 waitStartNs = NativePort::nowNanos();
+    while (!m_stop.load() && port.bytesAvailable() == 0) {
+        if (NativePort::nowNanos() - waitStartNs >= kActivityTimeoutMs * 1000000LL) {
+            result.error = QStringLiteral("%1 s 内未收到数据，请确认设备正在发送").arg(kActivityTimeoutMs / 1000);
+            return result;
+        }
+        port.waitForReadyRead(kPollMs);
+    }
+    const qint64 startNs = NativePort::nowNanos();
+
+    Window best;
+    qint32 bestBaud = 0;
+    for (qint32 baud : m_bauds) {
+        if (m_stop.load()) return result;
+        if (!configure(port, baud, format8N1)) continue;
+        const Window window = sample(port, kMaxWindowMs);
+        ++result.windows;
+        if (window.score > best.score) {
+            best = window;
+            bestBaud = baud;
+        }
+        if (window.score >= kLockScore && window.errors == 0) break;
+    }
+    if (bestBaud == 0 || best.score < kMinScore) {
+        result.error = QStringLiteral("各波特率得分均低于 %1（最高 %2），数据可能不是文本或 12 位二进制")
+                .arg(kMinScore).arg(best.score, 0, 'f', 2);
+        result.elapsedMs = (NativePort::nowNanos() - startNs) / 1000000;
+        return result;
+    }
+
+    Format format = format8N1;
+    const ByteScore &s = best.bytesScore;
+    const double score7 = qMax(s.text7Even, s.text7Odd);
+    // 帧错误多而字节统计正常，先试 8 位带校验；不成立再看是否为 7 位数据
+    if (m_errorCounting && best.errorRate > kErrorRateForParity) {
+        // 8 位带校验时按 8N1 接收，校验位为 0 会被当作停止位出错，字节本身正确
+        const QSerialPort::Parity parities[] = {QSerialPort::EvenParity, QSerialPort::OddParity};
+        for (QSerialPort::Parity parity : parities) {
+            if (m_stop.load()) return result;
+            Format candidate = format8N1;
+            candidate.parity = parity;
+            if (!configure(port, bestBaud, candidate)) continue;
+            const Window window = sample(port, kFormatWindowMs);
+            ++result.windows;
+            if (window.bytes >= kMinBytes && window.errorRate < best.errorRate) {
+                best = window;
+                format = candidate;
+            }
+        }
+    }
+    if (format.parity == QSerialPort::NoParity && score7 >= kMinScore && score7 > qMax(s.text, s.binary12) + kFormatMargin
+               && s.highBit >= kMinHighBit && s.highBit <= 1.0 - kMinHighBit) {
+        // 7 位数据：第 8 位恒满足某一种校验，且 0、1 都常见
+        format.dataBits = QSerialPort::Data7;
+        format.parity = s.text7Even >= s.text7Odd ? QSerialPort::EvenParity : QSerialPort::OddParity;
+        if (configure(port, bestBaud, format)) {
+            const Window window = sample(port, kFormatWindowMs);
+            ++result.windows;
+            if (window.score > 0) best = window;
+        }
+    }
+
+    result.ok = true;
+    result.baudRate = bestBaud;
+    result.format = format;
+    result.score = best.score;
+    result.content = best.bytesScore.binary12 > qMax(best.bytesScore.text, qMax(best.bytesScore.text7Even, best.bytesScore.text7Odd))
+            ? QStringLiteral("12 位二进制") : QStringLiteral("文本");
+    result.elapsedMs = (NativePort::nowNanos() - startNs) / 1000000;
+    return result;
+}
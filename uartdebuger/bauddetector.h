@@ -0,0 +1,89 @@
+#ifndef BAUDDETECTOR_H
+#define BAUDDETECTOR_H
+
+#include <QByteArray>
+#include <QList>
+#include <QSerialPort>
+#include <QString>
+#include <QThread>
+#include <atomic>
+#include <functional>
+
+// 波特率与帧格式自动识别：工作线程自行打开串口（只读），按候选波特率逐个采一个短窗口，
+// 以字节统计（可打印/UTF-8 比例，或 12 位二进制码值的有效比例）与线路错误计数打分。
+// 先以 8N1 扫描波特率，再在最佳波特率上判断格式：7 位数据按第 8 位是否恒为奇/偶校验位从 8N1 样本直接判定，
+// 8 位带校验则在出现帧错误时再试 8E1/8O1，取错误最少者。8N2 与 8N1 接收上无法区分，按 8N1 报告。
+// 设备需要在识别期间持续发送；有数据后通常在 0.5 s 内得到结果
+class BaudDetector : public QThread
+{
+public:
+    struct Format {
+        QSerialPort::DataBits dataBits = QSerialPort::Data8;
+        QSerialPort::Parity parity = QSerialPort::NoParity;
+        QSerialPort::StopBits stopBits = QSerialPort::OneStop;
+    };
+
+    // 一段字节的统计得分，均为 0~1
+    struct ByteScore {
+        double text = 0;                 // 可打印 ASCII、\r\n\t 与合法 UTF-8 多字节序列所占比例
+        double text7Even = 0;            // 按 7 位数据 + 偶校验解释时的文本比例（校验位不符计为无效）
+        double text7Odd = 0;
+        double highBit = 0;              // 最高位为 1 的字节比例；7 位数据的校验位约一半为 1
+        double binary12 = 0;             // 按 16 位字（两种字节序、两种对齐取最好）落在 1~0x0FFF 的比例
+        // 不同字节值个数 / 8，封顶 1；波特率过高时慢速数据被采成同一个值反复出现
+        double diversity = 0;
+        double best() const { return diversity * qMax(qMax(text, binary12), qMax(text7Even, text7Odd)); }
+    };
+
+    struct Result {
+        bool ok = false;
+        qint32 baudRate = 0;
+        Format format;
+        QString content;                 // 判定依据：文本/12 位二进制
+        double score = 0;
+        bool errorCounting = false;      // 是否取得了线路错误计数
+        int windows = 0;                 // 采样窗口数
+        qint64 elapsedMs = 0;            // 自收到首个字节起的耗时
+        QString error;
+    };
+
+    using ResultHandler = std::function<void(const Result &result)>;
+
+    BaudDetector();
+    ~BaudDetector();
+
+    // bauds 按尝试顺序给出；结果以 QueuedConnection 投递到 context 所在线程
+    void start(const QString &portName, const QList<qint32> &bauds, QObject *context, const ResultHandler &handler);
+    void stop();
+
+    static ByteScore scoreBytes(const QByteArray &data);
+    static QString formatName(const Format &format);
+
+protected:
+    void run() override;
+
+private:
+    struct Window {
+        int bytes = 0;
+        qint64 errors = 0;
+        int polls = 0;                   // 读取并查询错误计数的次数
+        double errorRate = 0;            // 逐个计数时为错误/(字节+错误)，否则为出错查询的比例
+        ByteScore bytesScore;
+        double score = 0;                // 计入错误率后的得分
+    };
+
+    Result detect(QSerialPort &port);
+    bool configure(QSerialPort &port, qint32 baudRate, const Format &format);
+    // 采一个窗口：清空输入后收集至多 kWindowBytes 字节，或至少 kMinBytes 字节且超过 kWindowMs；
+    // 每次读取后都查询线路错误，Windows 下一次查询最多只能反映“出过错”
+    Window sample(QSerialPort &port, int maxMs);
+
+    QString m_portName;
+    QList<qint32> m_bauds;
+    QObject *m_context = nullptr;
+    ResultHandler m_handler;
+    bool m_errorCounting = false;        // 仅工作线程访问
+    std::atomic<bool> m_stop{false};
+};
+
+#endif // BAUDDETECTOR_H
@@ -0,0 +1,119 @@
+#include "framechecksum.h"
+
+namespace {
+struct Crc16Tables {
+    quint16 ccitt[256];
+    quint16 modbus[256];
+
+    Crc16Tables()
+    {
+        for (int i = 0; i < 256; ++i) {
+            quint16 c = static_cast<quint16>(i << 8);
+            for (int k = 0; k < 8; ++k) c = (c & 0x8000) ? static_cast<quint16>((c << 1) ^ 0x1021) : static_cast<quint16>(c << 1);
+            ccitt[i] = c;
+            quint16 r = static_cast<quint16>(i);
+            for (int k = 0; k < 8; ++k) r = (r & 1) ? static_cast<quint16>((r >> 1) ^ 0xA001) : static_cast<quint16>(r >> 1);
+            modbus[i] = r;
+        }
+    }
+};
+
+// slice-by-8：t[0] 为普通字节表，t[k][i] 为字节 i 之后再经过 k 个零字节的余数
+struct Crc32Tables {
+    quint32 t[8][256];
+
+    Crc32Tables()
+    {
+        for (int i = 0; i < 256; ++i) {
+            quint32 c = static_cast<quint32>(i);
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? (c >> 1) ^ 0xEDB88320u : (c >> 1);
+            t[0][i] = c;
+        }
+        for (int i = 0; i < 256; ++i) {
+            for (int k = 1; k < 8; ++k) t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xFF];
+        }
+    }
+};
+
+const Crc16Tables &crc16Tables()
+{
+    static const Crc16Tables tables;
+    return tables;
+}
+
+const Crc32Tables &crc32Tables()
+{
+    static const Crc32Tables tables;
+    return tables;
+}
+
+inline quint32 loadLe32(const uchar *p)
+{
+    return quint32(p[0]) | (quint32(p[1]) << 8) | (quint32(p[2]) << 16) | (quint32(p[3]) << 24);
+}
+}
+
+int FrameChecksum::size(Type type)
+{
+    switch (type) {
+    case Crc16Ccitt:
+    case Crc16Modbus: return 2;
+    case Crc32: return 4;
+    default: return 0;
+    }
+}
+
+QString FrameChecksum::name(Type type)
+{
+    switch (type) {
+    case None: return QStringLiteral("无");
+    case Crc16Ccitt: return QStringLiteral("CRC-16/CCITT-FALSE");
+    case Crc16Modbus: return QStringLiteral("CRC-16/MODBUS");
+    case Crc32: return QStringLiteral("CRC-32");
+    default: return QString();
+    }
+}
+
+quint32 FrameChecksum::compute(Type type, const char *data, int size)
+{
+    switch (type) {
+    case Crc16Ccitt: return crc16Ccitt(data, size);
+    case Crc16Modbus: return crc16Modbus(data, size);
+    case Crc32: return crc32(data, size);
+    default: return 0;
+    }
+}
+
+quint16 FrameChecksum::crc16Ccitt(const char *data, int size, quint16 crc)
+{
+    const quint16 *table = crc16Tables().ccitt;
+    const uchar *p = reinterpret_cast<const uchar *>(data);
+    for (int i = 0; i < size; ++i) crc = static_cast<quint16>((crc << 8) ^ table[((crc >> 8) ^ p[i]) & 0xFF]);
+    return crc;
+}
+
+quint16 FrameChecksum::crc16Modbus(const char *data, int size, quint16 crc)
+{
+    const quint16 *table = crc16Tables().modbus;
+    const uchar *p = reinterpret_cast<const uchar *>(data);
+    for (int i = 0; i < size; ++i) crc = static_cast<quint16>((crc >> 8) ^ table[(crc ^ p[i]) & 0xFF]);
+    return crc;
+}
+
+quint32 FrameChecksum::crc32(const char *data, int size, quint32 crc)
+{
+    const Crc32Tables &tables = crc32Tables();
+    const uchar *p = reinterpret_cast<const uchar *>(data);
+    crc = ~crc;
+    // 逐字节装配小端字，与主机字节序无关
+    for (; size >= 8; p += 8, size -= 8) {
+        const quint32 one = loadLe32(p) ^ crc;
+        const quint32 two = loadLe32(p + 4);
+        crc = tables.t[7][one & 0xFF] ^ tables.t[6][(one >> 8) & 0xFF]
+                ^ tables.t[5][(one >> 16) & 0xFF] ^ tables.t[4][one >> 24]
+                ^ tables.t[3][two & 0xFF] ^ tables.t[2][(two >> 8) & 0xFF]
+                ^ tables.t[1][(two >> 16) & 0xFF] ^ tables.t[0][two >> 24];
+    }
+    for (; size > 0; ++p, --size) crc = (crc >> 8) ^ tables.t[0][(crc ^ *p) & 0xFF];
+    return ~crc;
+}
@@ -0,0 +1,29 @@
+#ifndef FRAMECHECKSUM_H
+#define FRAMECHECKSUM_H
+
+#include <QString>
+#include <QtGlobal>
+
+// 帧校验：CRC-16 按字节查表，CRC-32 用 slice-by-8（每次 8 字节、8 张表），表在首次使用时生成
+class FrameChecksum
+{
+public:
+    enum Type {
+        None,
+        Crc16Ccitt,      // CRC-16/CCITT-FALSE：多项式 0x1021，初值 0xFFFF，不反射
+        Crc16Modbus,     // CRC-16/MODBUS：多项式 0x8005 反射，初值 0xFFFF
+        Crc32,           // CRC-32/ISO-HDLC（以太网、zlib）
+        TypeCount
+    };
+
+    static int size(Type type);
+    static QString name(Type type);
+    static quint32 compute(Type type, const char *data, int size);
+
+    // crc 为上一段的结果，可分段累计；首段传入各自的初值
+    static quint16 crc16Ccitt(const char *data, int size, quint16 crc = 0xFFFF);
+    static quint16 crc16Modbus(const char *data, int size, quint16 crc = 0xFFFF);
+    static quint32 crc32(const char *data, int size, quint32 crc = 0);
+};
+
+#endif // FRAMECHECKSUM_H
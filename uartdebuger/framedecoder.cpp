@@ -0,0 +1,351 @@
+#include "framedecoder.h"
+
+#include <cstring>
+
+namespace {
+const uchar kSlipEnd = 0xC0;
+const uchar kSlipEsc = 0xDB;
+const uchar kSlipEscEnd = 0xDC;
+const uchar kSlipEscEsc = 0xDD;
+
+quint32 loadUnsigned(const uchar *p, int size, bool bigEndian)
+{
+    quint32 value = 0;
+    for (int i = 0; i < size; ++i) {
+        const int shift = bigEndian ? 8 * (size - 1 - i) : 8 * i;
+        value |= quint32(p[i]) << shift;
+    }
+    return value;
+}
+}
+
+void FrameDecoder::configure(const Config &config)
+{
+    m_config = config;
+    m_config.lengthBytes = qBound(1, m_config.lengthBytes, 2);
+    m_config.maxPayload = qMax(1, m_config.maxPayload);
+    if (m_config.delimiter.isEmpty()) m_config.delimiter = QByteArray("\n");
+    reset();
+}
+
+void FrameDecoder::setEnabled(bool enabled)
+{
+    if (m_enabled == enabled) return;
+    m_enabled = enabled;
+    reset();
+}
+
+int FrameDecoder::subscribe(const Subscriber &subscriber)
+{
+    const int id = m_nextSubscriberId++;
+    m_subscribers.append(qMakePair(id, subscriber));
+    return id;
+}
+
+void FrameDecoder::unsubscribe(int id)
+{
+    for (int i = 0; i < m_subscribers.size(); ++i) {
+        if (m_subscribers[i].first == id) {
+            m_subscribers.remove(i);
+            return;
+        }
+    }
+}
+
+void FrameDecoder::reset()
+{
+    m_frame.clear();
+    m_pending.clear();
+    m_discarding = false;
+    m_frameStarted = false;
+    m_cobsRemaining = 0;
+    m_cobsPendingZero = false;
+    m_slipEscape = false;
+}
+
+void FrameDecoder::feed(const char *data, int size, qint64 timestampNs)
+{
+    if (size <= 0) return;
+    m_stats.bytes += size;
+    m_timestampNs = timestampNs;
+    const uchar *p = reinterpret_cast<const uchar *>(data);
+    switch (m_config.framing) {
+    case Cobs: feedCobs(p, size); break;
+    case Slip: feedSlip(p, size); break;
+    case LengthPrefix: feedLengthPrefixed(data, size); break;
+    case Delimiter: feedDelimited(p, size); break;
+    default: break;
+    }
+}
+
+void FrameDecoder::startDiscard()
+{
+    m_stats.discardedBytes += m_frame.size();
+    m_frame.clear();
+    m_discarding = true;
+    m_frameStarted = false;
+    m_cobsRemaining = 0;
+    m_cobsPendingZero = false;
+    m_slipEscape = false;
+}
+
+void FrameDecoder::feedCobs(const uchar *p, int size)
+{
+    const int limit = m_config.maxPayload + FrameChecksum::size(m_config.checksum);
+    int i = 0;
+    while (i < size) {
+        const uchar c = p[i];
+        if (c == 0) {
+            if (m_discarding) {
+                m_discarding = false;
+            } else if (m_cobsRemaining != 0) {
+                // 分组未收满就遇到结束符：帧被截断
+                ++m_stats.malformed;
+                m_stats.discardedBytes += m_frame.size();
+            } else if (m_frameStarted) {
+                finishFrame(m_frame.constData(), m_frame.size());
+            }
+            m_frame.clear();
+            m_frameStarted = false;
+            m_cobsRemaining = 0;
+            m_cobsPendingZero = false;
+            ++i;
+            continue;
+        }
+        if (m_discarding) {
+            ++m_stats.discardedBytes;
+            ++i;
+            continue;
+        }
+        if (m_cobsRemaining == 0) {
+            // 分组码：上一分组不足 254 字节时其后原本是一个 0x00
+            if (m_cobsPendingZero) m_frame.append('\0');
+            m_cobsRemaining = c - 1;
+            m_cobsPendingZero = c != 0xFF;
+            m_frameStarted = true;
+            ++i;
+        } else {
+            // 分组数据整段复制；段内出现 0x00 说明帧被截断，留给下一轮按结束符处理
+            int n = qMin(m_cobsRemaining, size - i);
+            const void *zero = std::memchr(p + i, 0, n);
+            if (zero) n = static_cast<int>(static_cast<const uchar *>(zero) - (p + i));
+            m_frame.append(reinterpret_cast<const char *>(p + i), n);
+            m_cobsRemaining -= n;
+            i += n;
+        }
+        if (m_frame.size() > limit) {
+            ++m_stats.overlong;
+            startDiscard();
+        }
+    }
+}
+
+void FrameDecoder::feedSlip(const uchar *p, int size)
+{
+    const int limit = m_config.maxPayload + FrameChecksum::size(m_config.checksum);
+    int i = 0;
+    while (i < size) {
+        const uchar c = p[i];
+        if (c == kSlipEnd) {
+            if (m_discarding) {
+                m_discarding = false;
+            } else if (m_slipEscape) {
+                ++m_stats.malformed;
+                m_stats.discardedBytes += m_frame.size();
+            } else if (!m_frame.isEmpty()) {
+                // SLIP 常在帧前也发 END 以冲掉线路噪声，空帧忽略
+                finishFrame(m_frame.constData(), m_frame.size());
+            }
+            m_frame.clear();
+            m_slipEscape = false;
+            ++i;
+            continue;
+        }
+        if (m_discarding) {
+            ++m_stats.discardedBytes;
+            ++i;
+            continue;
+        }
+        if (m_slipEscape) {
+            m_slipEscape = false;
+            if (c == kSlipEscEnd) {
+                m_frame.append(static_cast<char>(kSlipEnd));
+            } else if (c == kSlipEscEsc) {
+                m_frame.append(static_cast<char>(kSlipEsc));
+            } else {
+                ++m_stats.malformed;
+                startDiscard();
+                continue;
+            }
+            ++i;
+        } else if (c == kSlipEsc) {
+            m_slipEscape = true;
+            ++i;
+        } else {
+            // 普通字节整段复制到下一个特殊字节为止
+            int end = i + 1;
+            while (end < size && p[end] != kSlipEnd && p[end] != kSlipEsc) ++end;
+            m_frame.append(reinterpret_cast<const char *>(p + i), end - i);
+            i = end;
+        }
+        if (m_frame.size() > limit) {
+            ++m_stats.overlong;
+            startDiscard();
+        }
+    }
+}
+
+void FrameDecoder::feedDelimited(const uchar *p, int size)
+{
+    const QByteArray &delimiter = m_config.delimiter;
+    const int d = delimiter.size();
+    const uchar last = static_cast<uchar>(delimiter[d - 1]);
+    const int limit = m_config.maxPayload + FrameChecksum::size(m_config.checksum) + d;
+    int i = 0;
+    while (i < size) {
+        // 以分隔符末字节为锚点整段复制，再比对帧尾是否为完整分隔符
+        const void *hit = std::memchr(p + i, last, size - i);
+        const int end = hit ? static_cast<int>(static_cast<const uchar *>(hit) - p) + 1 : size;
+        m_frame.append(reinterpret_cast<const char *>(p + i), end - i);
+        i = end;
+        if (hit && m_frame.size() >= d
+                && std::memcmp(m_frame.constData() + m_frame.size() - d, delimiter.constData(), d) == 0) {
+            if (m_discarding) {
+                m_stats.discardedBytes += m_frame.size() - d;
+                m_discarding = false;
+            } else if (m_frame.size() > d) {
+                finishFrame(m_frame.constData(), m_frame.size() - d);
+            }
+            m_frame.clear();
+            continue;
+        }
+        if (m_frame.size() > limit) {
+            if (!m_discarding) ++m_stats.overlong;
+            // 丢弃时只保留可能是分隔符前缀的尾部
+            const int drop = m_frame.size() - (d - 1);
+            m_stats.discardedBytes += drop;
+            m_frame.remove(0, drop);
+            m_discarding = true;
+        }
+    }
+}
+
+void FrameDecoder::feedLengthPrefixed(const char *data, int size)
+{
+    m_pending.append(data, size);
+    const char *buf = m_pending.constData();
+    const int total = m_pending.size();
+    const QByteArray &sync = m_config.sync;
+    const int syncSize = sync.size();
+    const int lengthBytes = m_config.lengthBytes;
+    const int header = syncSize + lengthBytes;
+    const int checksumSize = FrameChecksum::size(m_config.checksum);
+    int pos = 0;
+    while (total - pos >= header) {
+        if (syncSize > 0 && std::memcmp(buf + pos, sync.constData(), syncSize) != 0) {
+            // 直接跳到下一个同步头首字节
+            const void *hit = std::memchr(buf + pos + 1, sync[0], total - pos - 1);
+            const int next = hit ? static_cast<int>(static_cast<const char *>(hit) - buf) : total;
+            m_stats.discardedBytes += next - pos;
+            pos = next;
+            continue;
+        }
+        const uchar *field = reinterpret_cast<const uchar *>(buf + pos + syncSize);
+        const int length = static_cast<int>(loadUnsigned(field, lengthBytes, m_config.lengthBigEndian));
+        if (length > m_config.maxPayload) {
+            ++m_stats.overlong;
+            ++m_stats.discardedBytes;
+            ++pos;
+            continue;
+        }
+        const int frameSize = header + length + checksumSize;
+        if (total - pos < frameSize) break;
+        if (checksumSize > 0) {
+            const uchar *stored = reinterpret_cast<const uchar *>(buf + pos + header + length);
+            const quint32 expected = FrameChecksum::compute(m_config.checksum, buf + pos + syncSize, lengthBytes + length);
+            if (loadUnsigned(stored, checksumSize, m_config.checksumBigEndian) != expected) {
+                // 可能是把数据误当成了帧头，右移一个字节重新寻找
+                ++m_stats.badChecksum;
+                ++m_stats.discardedBytes;
+                ++pos;
+                continue;
+            }
+        }
+        dispatch(buf + pos + header, length);
+        pos += frameSize;
+    }
+    m_pending.remove(0, pos);
+}
+
+void FrameDecoder::finishFrame(const char *data, int size)
+{
+    const int checksumSize = FrameChecksum::size(m_config.checksum);
+    if (size < checksumSize) {
+        ++m_stats.malformed;
+        m_stats.discardedBytes += size;
+        return;
+    }
+    const int payload = size - checksumSize;
+    if (checksumSize > 0) {
+        const uchar *stored = reinterpret_cast<const uchar *>(data + payload);
+        const quint32 expected = FrameChecksum::compute(m_config.checksum, data, payload);
+        if (loadUnsigned(stored, checksumSize, m_config.checksumBigEndian) != expected) {
+            ++m_stats.badChecksum;
+            m_stats.discardedBytes += size;
+            return;
+        }
+    }
+    dispatch(data, payload);
+}
+
+void FrameDecoder::dispatch(const char *data, int size)
+{
+    Frame frame;
+    frame.data = data;
+    frame.size = size;
+    frame.sequence = static_cast<quint64>(m_stats.frames);
+    frame.timestampNs = m_timestampNs;
+    ++m_stats.frames;
+    m_stats.payloadBytes += size;
+    for (int i = 0; i < m_subscribers.size(); ++i) m_subscribers[i].second(frame);
+}
+
+void FrameDecoder::appendSamples(const Frame &frame, SampleFormat format, QVector<int> *codes)
+{
+    const uchar *p = reinterpret_cast<const uchar *>(frame.data);
+    switch (format) {
+    case UInt8:
+        for (int i = 0; i < frame.size; ++i) codes->append(p[i]);
+        break;
+    case UInt16LE:
+        for (int i = 0; i + 1 < frame.size; i += 2) codes->append(p[i] | (p[i + 1] << 8));
+        break;
+    case UInt16BE:
+        for (int i = 0; i + 1 < frame.size; i += 2) codes->append((p[i] << 8) | p[i + 1]);
+        break;
+    default:
+        break;
+    }
+}
+
+QString FrameDecoder::framingName(Framing framing)
+{
+    switch (framing) {
+    case Cobs: return QStringLiteral("COBS");
+    case Slip: return QStringLiteral("SLIP");
+    case LengthPrefix: return QStringLiteral("长度前缀");
+    case Delimiter: return QStringLiteral("分隔符");
+    default: return QString();
+    }
+}
+
+QString FrameDecoder::sampleFormatName(SampleFormat format)
+{
+    switch (format) {
+    case NoSamples: return QStringLiteral("不送示波器");
+    case UInt8: return QStringLiteral("uint8");
+    case UInt16LE: return QStringLiteral("uint16 小端");
+    case UInt16BE: return QStringLiteral("uint16 大端");
+    default: return QString();
+    }
+}
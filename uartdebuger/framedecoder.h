@@ -0,0 +1,118 @@
+#ifndef FRAMEDECODER_H
+#define FRAMEDECODER_H
+
+#include "framechecksum.h"
+
+#include <QByteArray>
+#include <QPair>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+#include <functional>
+
+// 分帧解码层：位于 readAll() 与各消费者之间，把字节流切成帧、校验并在出错后重新同步。
+// 帧以回调分发给订阅者，回调拿到的是解码器内部缓冲的只读视图，不复制；视图只在回调期间有效。
+//   COBS        0x00 结束，帧内无 0x00
+//   SLIP        0xC0 结束，0xDB 转义（RFC 1055）
+//   长度前缀    [同步头][长度 1/2 字节][载荷][校验]，长度只计载荷，校验覆盖长度与载荷；
+//               同步头不符、长度超限或校验失败时右移一个字节重新寻找帧头
+//   分隔符      以指定字节序列结束（如 0D 0A），分隔符不属于载荷
+// COBS/SLIP/分隔符的校验为解码后帧末尾的 2 或 4 个字节，覆盖其前的全部载荷
+class FrameDecoder
+{
+public:
+    enum Framing {
+        Cobs,
+        Slip,
+        LengthPrefix,
+        Delimiter,
+        FramingCount
+    };
+
+    // 载荷按样本解释时的格式，供示波器订阅
+    enum SampleFormat {
+        NoSamples,
+        UInt8,
+        UInt16LE,
+        UInt16BE,
+        SampleFormatCount
+    };
+
+    struct Config {
+        Framing framing = Cobs;
+        FrameChecksum::Type checksum = FrameChecksum::None;
+        bool checksumBigEndian = false;
+        QByteArray sync;                 // 长度前缀的同步头，可为空
+        int lengthBytes = 1;             // 1 或 2
+        bool lengthBigEndian = false;
+        QByteArray delimiter = QByteArray("\n");
+        int maxPayload = 1024;           // 载荷上限（不含校验），超出按错误处理
+        SampleFormat samples = NoSamples;
+    };
+
+    struct Frame {
+        const char *data = nullptr;      // 载荷（不含帧头与校验）
+        int size = 0;
+        quint64 sequence = 0;            // 有效帧序号，从 0 起
+        qint64 timestampNs = 0;          // 帧末字节所在块的读取时刻
+    };
+
+    struct Stats {
+        qint64 bytes = 0;
+        qint64 frames = 0;               // 校验通过并分发的帧
+        qint64 payloadBytes = 0;
+        qint64 badChecksum = 0;
+        qint64 malformed = 0;            // COBS/SLIP 编码错误、帧短于校验长度
+        qint64 overlong = 0;
+        qint64 discardedBytes = 0;       // 重新同步时丢弃的字节
+    };
+
+    using Subscriber = std::function<void(const Frame &frame)>;
+
+    void configure(const Config &config);
+    const Config &config() const { return m_config; }
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_enabled; }
+
+    // 返回订阅号，用于取消；回调中不得订阅或取消订阅
+    int subscribe(const Subscriber &subscriber);
+    void unsubscribe(int id);
+
+    void feed(const char *data, int size, qint64 timestampNs);
+    void feed(const QByteArray &data, qint64 timestampNs) { feed(data.constData(), data.size(), timestampNs); }
+    // 丢弃未完成的帧，下一块从头同步
+    void reset();
+    const Stats &stats() const { return m_stats; }
+    void resetStats() { m_stats = Stats(); }
+
+    // 按格式把载荷解释为码值追加到 codes，末尾不足一个样本的字节忽略
+    static void appendSamples(const Frame &frame, SampleFormat format, QVector<int> *codes);
+    static QString framingName(Framing framing);
+    static QString sampleFormatName(SampleFormat format);
+
+private:
+    void feedCobs(const uchar *p, int size);
+    void feedSlip(const uchar *p, int size);
+    void feedDelimited(const uchar *p, int size);
+    void feedLengthPrefixed(const char *data, int size);
+    // 校验帧尾并分发；size 含校验字节
+    void finishFrame(const char *data, int size);
+    void dispatch(const char *data, int size);
+    void startDiscard();
+
+    Config m_config;
+    bool m_enabled = false;
+    QVector<QPair<int, Subscriber>> m_subscribers;
+    int m_nextSubscriberId = 1;
+    Stats m_stats;
+    qint64 m_timestampNs = 0;
+    QByteArray m_frame;                  // COBS/SLIP/分隔符：当前帧解码后的字节
+    bool m_discarding = false;           // 出错后丢弃到下一个帧结束符
+    bool m_frameStarted = false;         // COBS：已收到本帧第一个分组码
+    int m_cobsRemaining = 0;             // COBS 当前分组剩余数据字节
+    bool m_cobsPendingZero = false;      // 分组结束，下一分组开始时补 0x00
+    bool m_slipEscape = false;
+    QByteArray m_pending;                // 长度前缀：尚未消费的原始字节
+};
+
+#endif // FRAMEDECODER_H
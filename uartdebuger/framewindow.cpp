@@ -0,0 +1,240 @@
+#include "framewindow.h"
+
+#include "framedecoder.h"
+#include "payloadcache.h"
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QFileDialog>
+#include <QGridLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPlainTextEdit>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QVBoxLayout>
+
+namespace {
+const int kRefreshIntervalMs = 500;
+
+QString hexText(const QByteArray &bytes)
+{
+    return QString::fromLatin1(bytes.toHex(' ').toUpper());
+}
+}
+
+FrameWindow::FrameWindow(FrameDecoder *decoder, QWidget *parent)
+    : QWidget(parent, Qt::Window)
+    , m_decoder(decoder)
+{
+    setWindowTitle(QStringLiteral("分帧解码"));
+    resize(520, 520);
+
+    m_enableCheck = new QCheckBox(QStringLiteral("启用分帧解码（接收区与示波器改为按帧显示）"), this);
+    m_framingCombo = new QComboBox(this);
+    for (int i = 0; i < FrameDecoder::FramingCount; ++i) {
+        m_framingCombo->addItem(FrameDecoder::framingName(static_cast<FrameDecoder::Framing>(i)), i);
+    }
+    m_checksumCombo = new QComboBox(this);
+    for (int i = 0; i < FrameChecksum::TypeCount; ++i) {
+        m_checksumCombo->addItem(FrameChecksum::name(static_cast<FrameChecksum::Type>(i)), i);
+    }
+    m_checksumBigEndianCheck = new QCheckBox(QStringLiteral("大端"), this);
+    m_syncEdit = new QLineEdit(this);
+    m_syncEdit->setPlaceholderText(QStringLiteral("HEX，如 AA 55；可为空"));
+    m_lengthBytesCombo = new QComboBox(this);
+    m_lengthBytesCombo->addItem(QStringLiteral("1 字节"), 1);
+    m_lengthBytesCombo->addItem(QStringLiteral("2 字节"), 2);
+    m_lengthBigEndianCheck = new QCheckBox(QStringLiteral("大端"), this);
+    m_delimiterEdit = new QLineEdit(this);
+    m_delimiterEdit->setPlaceholderText(QStringLiteral("HEX，如 0D 0A"));
+    m_delimiterEdit->setToolTip(QStringLiteral("二进制校验字节中出现分隔符会误切分，二进制帧建议用 COBS/SLIP/长度前缀"));
+    m_maxPayloadSpin = new QSpinBox(this);
+    m_maxPayloadSpin->setRange(1, 65535);
+    m_maxPayloadSpin->setSuffix(QStringLiteral(" 字节"));
+    m_samplesCombo = new QComboBox(this);
+    for (int i = 0; i < FrameDecoder::SampleFormatCount; ++i) {
+        m_samplesCombo->addItem(FrameDecoder::sampleFormatName(static_cast<FrameDecoder::SampleFormat>(i)), i);
+    }
+    m_applyButton = new QPushButton(QStringLiteral("应用"), this);
+    m_resetButton = new QPushButton(QStringLiteral("统计清零"), this);
+    m_logButton = new QPushButton(QStringLiteral("记录到文件…"), this);
+    m_statusLabel = new QLabel(this);
+    m_statusLabel->setWordWrap(true);
+    m_report = new QPlainTextEdit(this);
+    m_report->setReadOnly(true);
+
+    QGridLayout *params = new QGridLayout;
+    params->addWidget(m_enableCheck, 0, 0, 1, 3);
+    params->addWidget(new QLabel(QStringLiteral("帧格式"), this), 1, 0);
+    params->addWidget(m_framingCombo, 1, 1);
+    params->addWidget(new QLabel(QStringLiteral("校验"), this), 2, 0);
+    params->addWidget(m_checksumCombo, 2, 1);
+    params->addWidget(m_checksumBigEndianCheck, 2, 2);
+    params->addWidget(new QLabel(QStringLiteral("同步头"), this), 3, 0);
+    params->addWidget(m_syncEdit, 3, 1, 1, 2);
+    params->addWidget(new QLabel(QStringLiteral("长度字段"), this), 4, 0);
+    params->addWidget(m_lengthBytesCombo, 4, 1);
+    params->addWidget(m_lengthBigEndianCheck, 4, 2);
+    params->addWidget(new QLabel(QStringLiteral("分隔符"), this), 5, 0);
+    params->addWidget(m_delimiterEdit, 5, 1, 1, 2);
+    params->addWidget(new QLabel(QStringLiteral("载荷上限"), this), 6, 0);
+    params->addWidget(m_maxPayloadSpin, 6, 1);
+    params->addWidget(new QLabel(QStringLiteral("示波器样本"), this), 7, 0);
+    params->addWidget(m_samplesCombo, 7, 1);
+    QHBoxLayout *buttons = new QHBoxLayout;
+    buttons->addWidget(m_logButton);
+    buttons->addStretch(1);
+    buttons->addWidget(m_resetButton);
+    buttons->addWidget(m_applyButton);
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(params);
+    layout->addLayout(buttons);
+    layout->addWidget(m_statusLabel);
+    layout->addWidget(m_report, 1);
+
+    // 控件初值取自解码器当前配置
+    const FrameDecoder::Config &cfg = m_decoder->config();
+    m_enableCheck->setChecked(m_decoder->isEnabled());
+    m_framingCombo->setCurrentIndex(cfg.framing);
+    m_checksumCombo->setCurrentIndex(cfg.checksum);
+    m_checksumBigEndianCheck->setChecked(cfg.checksumBigEndian);
+    m_syncEdit->setText(hexText(cfg.sync));
+    m_lengthBytesCombo->setCurrentIndex(cfg.lengthBytes - 1);
+    m_lengthBigEndianCheck->setChecked(cfg.lengthBigEndian);
+    m_delimiterEdit->setText(hexText(cfg.delimiter));
+    m_maxPayloadSpin->setValue(cfg.maxPayload);
+    m_samplesCombo->setCurrentIndex(cfg.samples);
+    updateControls();
+
+    connect(m_framingCombo, static_cast<void(QComboBox::*)(int)>(&QComboBox::currentIndexChanged),
+            this, [this](int) { updateControls(); });
+    connect(m_checksumCombo, static_cast<void(QComboBox::*)(int)>(&QComboBox::currentIndexChanged),
+            this, [this](int) { updateControls(); });
+    connect(m_applyButton, &QPushButton::clicked, this, &FrameWindow::apply);
+    connect(m_resetButton, &QPushButton::clicked, this, [this]() {
+        m_decoder->resetStats();
+        refresh();
+    });
+    connect(m_logButton, &QPushButton::clicked, this, &FrameWindow::toggleLogging);
+    m_refreshTimer.setInterval(kRefreshIntervalMs);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &FrameWindow::refresh);
+}
+
+void FrameWindow::setAppliedHandler(const std::function<void()> &handler)
+{
+    m_appliedHandler = handler;
+}
+
+void FrameWindow::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    refresh();
+    m_refreshTimer.start();
+}
+
+void FrameWindow::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    m_refreshTimer.stop();
+}
+
+void FrameWindow::updateControls()
+{
+    const int framing = m_framingCombo->currentData().toInt();
+    const bool lengthPrefix = framing == FrameDecoder::LengthPrefix;
+    m_syncEdit->setEnabled(lengthPrefix);
+    m_lengthBytesCombo->setEnabled(lengthPrefix);
+    m_lengthBigEndianCheck->setEnabled(lengthPrefix);
+    m_delimiterEdit->setEnabled(framing == FrameDecoder::Delimiter);
+    m_checksumBigEndianCheck->setEnabled(m_checksumCombo->currentData().toInt() != FrameChecksum::None);
+}
+
+void FrameWindow::apply()
+{
+    FrameDecoder::Config cfg;
+    cfg.framing = static_cast<FrameDecoder::Framing>(m_framingCombo->currentData().toInt());
+    cfg.checksum = static_cast<FrameChecksum::Type>(m_checksumCombo->currentData().toInt());
+    cfg.checksumBigEndian = m_checksumBigEndianCheck->isChecked();
+    cfg.lengthBytes = m_lengthBytesCombo->currentData().toInt();
+    cfg.lengthBigEndian = m_lengthBigEndianCheck->isChecked();
+    cfg.maxPayload = m_maxPayloadSpin->value();
+    cfg.samples = static_cast<FrameDecoder::SampleFormat>(m_samplesCombo->currentData().toInt());
+    QString error;
+    if (!PayloadCache::decodeHex(m_syncEdit->text(), &cfg.sync, &error)) {
+        m_statusLabel->setText(QStringLiteral("同步头：") + error);
+        return;
+    }
+    if (!PayloadCache::decodeHex(m_delimiterEdit->text(), &cfg.delimiter, &error)) {
+        m_statusLabel->setText(QStringLiteral("分隔符：") + error);
+        return;
+    }
+    if (cfg.framing == FrameDecoder::Delimiter && cfg.delimiter.isEmpty()) {
+        m_statusLabel->setText(QStringLiteral("分隔符不能为空"));
+        return;
+    }
+    if (cfg.framing == FrameDecoder::LengthPrefix && cfg.sync.isEmpty() && cfg.checksum == FrameChecksum::None) {
+        m_statusLabel->setText(QStringLiteral("提示：长度前缀既无同步头也无校验时，丢一个字节后无法重新同步"));
+    } else {
+        m_statusLabel->clear();
+    }
+    m_decoder->configure(cfg);
+    m_decoder->setEnabled(m_enableCheck->isChecked());
+    if (m_appliedHandler) m_appliedHandler();
+    refresh();
+}
+
+void FrameWindow::toggleLogging()
+{
+    if (m_logSubscription != 0) {
+        m_decoder->unsubscribe(m_logSubscription);
+        m_logSubscription = 0;
+        m_logFile.close();
+        m_logButton->setText(QStringLiteral("记录到文件…"));
+        refresh();
+        return;
+    }
+    const QString fileName = QFileDialog::getSaveFileName(this, QStringLiteral("记录帧"), QString(),
+                                                          QStringLiteral("文本 (*.txt);;所有文件 (*)"));
+    if (fileName.isEmpty()) return;
+    m_logFile.setFileName(fileName);
+    if (!m_logFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        m_statusLabel->setText(QStringLiteral("无法打开 %1").arg(fileName));
+        return;
+    }
+    // 每帧一行：序号、读取时刻（ns）、长度、HEX 载荷
+    m_loggedFrames = 0;
+    m_logSubscription = m_decoder->subscribe([this](const FrameDecoder::Frame &frame) {
+        QByteArray line = QByteArray::number(frame.sequence) + '\t' + QByteArray::number(frame.timestampNs)
+                + '\t' + QByteArray::number(frame.size) + '\t';
+        line += QByteArray::fromRawData(frame.data, frame.size).toHex(' ').toUpper();
+        line += '\n';
+        m_logFile.write(line);
+        ++m_loggedFrames;
+    });
+    m_logButton->setText(QStringLiteral("停止记录"));
+    refresh();
+}
+
+void FrameWindow::refresh()
+{
+    const FrameDecoder::Stats &s = m_decoder->stats();
+    QString text;
+    text += m_decoder->isEnabled() ? QStringLiteral("解码中：%1，校验 %2\n")
+                                     .arg(FrameDecoder::framingName(m_decoder->config().framing))
+                                     .arg(FrameChecksum::name(m_decoder->config().checksum))
+                                   : QStringLiteral("未启用\n");
+    text += QStringLiteral("输入 %1 字节，有效帧 %2（载荷 %3 字节）\n").arg(s.bytes).arg(s.frames).arg(s.payloadBytes);
+    const qint64 bad = s.badChecksum + s.malformed + s.overlong;
+    text += QStringLiteral("坏帧 %1：校验失败 %2，编码错误 %3，超长 %4\n")
+            .arg(bad).arg(s.badChecksum).arg(s.malformed).arg(s.overlong);
+    if (s.frames + bad > 0) {
+        text += QStringLiteral("帧错误率 %1%\n").arg(100.0 * bad / (s.frames + bad), 0, 'f', 3);
+    }
+    text += QStringLiteral("重新同步丢弃 %1 字节\n").arg(s.discardedBytes);
+    if (m_logSubscription != 0) {
+        text += QStringLiteral("\n正在记录到 %1，已写 %2 帧\n").arg(m_logFile.fileName()).arg(m_loggedFrames);
+    }
+    m_report->setPlainText(text);
+}
@@ -0,0 +1,60 @@
+#ifndef FRAMEWINDOW_H
+#define FRAMEWINDOW_H
+
+#include <QFile>
+#include <QTimer>
+#include <QWidget>
+#include <functional>
+
+class FrameDecoder;
+class QCheckBox;
+class QComboBox;
+class QLabel;
+class QLineEdit;
+class QPlainTextEdit;
+class QPushButton;
+class QSpinBox;
+
+// 分帧解码窗口：选择帧格式与校验、启用解码，查看好帧/坏帧统计，并可把解出的帧逐行记录到文件
+class FrameWindow : public QWidget
+{
+public:
+    explicit FrameWindow(FrameDecoder *decoder, QWidget *parent = nullptr);
+
+    // 配置或启用状态变化后调用，用于丢弃旧格式下未处理完的数据
+    void setAppliedHandler(const std::function<void()> &handler);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    void updateControls();
+    void apply();
+    void toggleLogging();
+    void refresh();
+
+    FrameDecoder *m_decoder = nullptr;
+    std::function<void()> m_appliedHandler;
+    QTimer m_refreshTimer;
+    QFile m_logFile;
+    int m_logSubscription = 0;
+    qint64 m_loggedFrames = 0;
+    QCheckBox *m_enableCheck = nullptr;
+    QComboBox *m_framingCombo = nullptr;
+    QComboBox *m_checksumCombo = nullptr;
+    QCheckBox *m_checksumBigEndianCheck = nullptr;
+    QLineEdit *m_syncEdit = nullptr;
+    QComboBox *m_lengthBytesCombo = nullptr;
+    QCheckBox *m_lengthBigEndianCheck = nullptr;
+    QLineEdit *m_delimiterEdit = nullptr;
+    QSpinBox *m_maxPayloadSpin = nullptr;
+    QComboBox *m_samplesCombo = nullptr;
+    QPushButton *m_applyButton = nullptr;
+    QPushButton *m_resetButton = nullptr;
+    QPushButton *m_logButton = nullptr;
+    QLabel *m_statusLabel = nullptr;
+    QPlainTextEdit *m_report = nullptr;
+};
+
+#endif // FRAMEWINDOW_H
@@ -0,0 +1,221 @@
+#include "freqtrackerwindow.h"
+#include "scopefreqtracker.h"
+
+#include <QComboBox>
+#include <QDateTime>
+#include <QFile>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPainter>
+#include <QPainterPath>
+#include <QPushButton>
+#include <QTextStream>
+#include <QVBoxLayout>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const int kRefreshIntervalMs = 500;
+// 漂移曲线最多绘制的记录点数
+const int kMaxPlotPoints = 2000;
+}
+
+// 频率偏差曲线：纵轴为相对全部记录均值的 ppm 偏差
+class FreqDriftPlot : public QWidget
+{
+public:
+    explicit FreqDriftPlot(QWidget *parent = nullptr)
+        : QWidget(parent)
+    {
+        setMinimumSize(420, 200);
+    }
+
+    void setData(const QVector<QPointF> &points, double meanFrequency)
+    {
+        m_points = points;
+        m_mean = meanFrequency;
+        update();
+    }
+
+protected:
+    void paintEvent(QPaintEvent *) override
+    {
+        QPainter p(this);
+        p.setRenderHint(QPainter::Antialiasing);
+        p.fillRect(rect(), QColor("#ffffff"));
+        const QRectF plot = QRectF(rect()).adjusted(68, 8, -8, -8);
+        p.setPen(QPen(QColor("#d1d1d6"), 1));
+        p.drawRect(plot);
+        if (m_points.size() < 2) {
+            p.setPen(QPen(QColor("#8e8e93"), 1));
+            p.drawText(plot, Qt::AlignCenter, QStringLiteral("等待频率锁定..."));
+            return;
+        }
+        double yMin = m_points.first().y();
+        double yMax = yMin;
+        for (const QPointF &pt : m_points) {
+            yMin = std::min(yMin, pt.y());
+            yMax = std::max(yMax, pt.y());
+        }
+        const double pad = std::max(1e-3, (yMax - yMin) * 0.1);
+        yMin -= pad;
+        yMax += pad;
+        const double x0 = m_points.first().x();
+        const double xSpan = std::max(1e-9, m_points.last().x() - x0);
+
+        p.setPen(QPen(QColor("#8e8e93"), 1));
+        for (int i = 0; i <= 4; ++i) {
+            const double y = plot.top() + plot.height() * i / 4;
+            const double v = yMax - (yMax - yMin) * i / 4;
+            p.drawText(QRectF(0, y - 8, 64, 16), Qt::AlignRight | Qt::AlignVCenter,
+                       QString::number(v, 'f', 3) + " ppm");
+        }
+        p.drawText(plot.adjusted(4, 2, -4, -2), Qt::AlignLeft | Qt::AlignTop,
+                   QStringLiteral("均值 %1 Hz，跨度 %2 s").arg(m_mean, 0, 'f', 6).arg(xSpan, 0, 'f', 1));
+
+        QPainterPath path;
+        for (int i = 0; i < m_points.size(); ++i) {
+            const QPointF pt(plot.left() + (m_points[i].x() - x0) / xSpan * plot.width(),
+                             plot.top() + (yMax - m_points[i].y()) / (yMax - yMin) * plot.height());
+            if (i == 0) path.moveTo(pt); else path.lineTo(pt);
+        }
+        p.setPen(QPen(QColor("#007aff"), 1.5));
+        p.drawPath(path);
+    }
+
+private:
+    QVector<QPointF> m_points;
+    double m_mean = 0;
+};
+
+FreqTrackerWindow::FreqTrackerWindow(FreqTracker *tracker, QWidget *parent)
+    : QWidget(parent, Qt::Window)
+    , m_tracker(tracker)
+{
+    setWindowTitle(QStringLiteral("频率跟踪"));
+    resize(640, 420);
+
+    m_windowCombo = new QComboBox(this);
+    for (int n = 512; n <= 16384; n *= 2) {
+        m_windowCombo->addItem(QString::number(n), n);
+    }
+    m_windowCombo->setCurrentIndex(m_windowCombo->findData(m_tracker->config().windowSize));
+    QPushButton *clearButton = new QPushButton(QStringLiteral("清空记录"), this);
+    QPushButton *exportButton = new QPushButton(QStringLiteral("导出 CSV"), this);
+
+    QHBoxLayout *controls = new QHBoxLayout;
+    controls->addWidget(new QLabel(QStringLiteral("拟合窗口"), this));
+    controls->addWidget(m_windowCombo);
+    controls->addStretch();
+    controls->addWidget(clearButton);
+    controls->addWidget(exportButton);
+
+    m_summaryLabel = new QLabel(this);
+    m_summaryLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    m_plot = new FreqDriftPlot(this);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(controls);
+    layout->addWidget(m_summaryLabel);
+    layout->addWidget(m_plot, 1);
+
+    connect(m_windowCombo, static_cast<void(QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, [this](int) { applyWindowSize(); });
+    connect(clearButton, &QPushButton::clicked, this, [this]() {
+        m_tracker->clearLog();
+        refresh();
+    });
+    connect(exportButton, &QPushButton::clicked, this, &FreqTrackerWindow::exportLog);
+    m_refreshTimer.setInterval(kRefreshIntervalMs);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &FreqTrackerWindow::refresh);
+}
+
+void FreqTrackerWindow::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    refresh();
+    m_refreshTimer.start();
+}
+
+void FreqTrackerWindow::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    m_refreshTimer.stop();
+}
+
+void FreqTrackerWindow::applyWindowSize()
+{
+    FreqTracker::Config config = m_tracker->config();
+    config.windowSize = m_windowCombo->currentData().toInt();
+    config.hop = config.windowSize / 4;
+    m_tracker->configure(config);
+    refresh();
+}
+
+void FreqTrackerWindow::refresh()
+{
+    const QVector<FreqTracker::Estimate> &log = m_tracker->log();
+    const double fs = m_tracker->config().sampleRate;
+    // 统计全部记录的均值/标准差，以及首末记录间的漂移
+    double mean = 0;
+    for (const FreqTracker::Estimate &e : log) mean += e.frequency;
+    mean = log.isEmpty() ? 0 : mean / log.size();
+    double var = 0;
+    for (const FreqTracker::Estimate &e : log) var += (e.frequency - mean) * (e.frequency - mean);
+    const double stdPpm = log.size() > 1 && mean > 0 ? std::sqrt(var / (log.size() - 1)) / mean * 1e6 : 0;
+    const double driftPpm = log.size() > 1 && mean > 0 ? (log.last().frequency - log.first().frequency) / mean * 1e6 : 0;
+
+    const FreqTracker::Estimate &cur = m_tracker->current();
+    QString text;
+    if (m_tracker->locked()) {
+        text = QStringLiteral("频率 %1 Hz   幅度 %2 V   相位 %3°   直流 %4 V   残差 %5 V\n")
+                .arg(cur.frequency, 0, 'f', 6)
+                .arg(cur.amplitude, 0, 'f', 4)
+                .arg(cur.phase, 0, 'f', 2)
+                .arg(cur.offset, 0, 'f', 4)
+                .arg(cur.residualRms, 0, 'f', 4);
+    } else {
+        text = QStringLiteral("未锁定：等待足够长度的单频信号\n");
+    }
+    text += QStringLiteral("记录 %1 条   标准差 %2 ppm   首末漂移 %3 ppm   分辨率 %4 Hz/频点")
+            .arg(log.size())
+            .arg(stdPpm, 0, 'f', 3)
+            .arg(driftPpm, 0, 'f', 3)
+            .arg(fs / m_tracker->config().windowSize, 0, 'g', 4);
+    m_summaryLabel->setText(text);
+
+    QVector<QPointF> points;
+    const int step = std::max(1, log.size() / kMaxPlotPoints);
+    points.reserve(log.size() / step + 1);
+    for (int i = 0; i < log.size(); i += step) {
+        points.append(QPointF(log[i].sampleIndex / fs, (log[i].frequency - mean) / mean * 1e6));
+    }
+    m_plot->setData(points, mean);
+}
+
+void FreqTrackerWindow::exportLog()
+{
+    const QVector<FreqTracker::Estimate> &log = m_tracker->log();
+    if (log.isEmpty()) {
+        QMessageBox::information(this, QStringLiteral("导出"), QStringLiteral("暂无跟踪记录"));
+        return;
+    }
+    const QString fileName = QFileDialog::getSaveFileName(this, QStringLiteral("导出频率记录"), QString(), "CSV (*.csv)");
+    if (fileName.isEmpty()) return;
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QMessageBox::warning(this, QStringLiteral("导出"), QStringLiteral("无法写入文件"));
+        return;
+    }
+    QTextStream out(&file);
+    out.setRealNumberPrecision(12);
+    out << "wall_clock,sample_index,time_s,frequency_hz,amplitude_v,phase_deg,offset_v,residual_rms_v\n";
+    const double fs = m_tracker->config().sampleRate;
+    for (const FreqTracker::Estimate &e : log) {
+        out << QDateTime::fromMSecsSinceEpoch(e.wallClockMs).toString(Qt::ISODateWithMs) << ','
+            << e.sampleIndex << ',' << e.sampleIndex / fs << ','
+            << e.frequency << ',' << e.amplitude << ',' << e.phase << ','
+            << e.offset << ',' << e.residualRms << '\n';
+    }
+}
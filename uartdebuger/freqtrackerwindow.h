@@ -0,0 +1,34 @@
+#ifndef FREQTRACKERWINDOW_H
+#define FREQTRACKERWINDOW_H
+
+#include <QWidget>
+#include <QTimer>
+
+class FreqTracker;
+class FreqDriftPlot;
+class QComboBox;
+class QLabel;
+
+// 频率跟踪记录窗口：显示当前估计值与长期漂移曲线，可导出全部记录
+class FreqTrackerWindow : public QWidget
+{
+public:
+    explicit FreqTrackerWindow(FreqTracker *tracker, QWidget *parent = nullptr);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    void refresh();
+    void applyWindowSize();
+    void exportLog();
+
+    FreqTracker *m_tracker = nullptr;
+    QTimer m_refreshTimer;
+    QComboBox *m_windowCombo = nullptr;
+    QLabel *m_summaryLabel = nullptr;
+    FreqDriftPlot *m_plot = nullptr;
+};
+
+#endif // FREQTRACKERWINDOW_H
@@ -0,0 +1,233 @@
+#include "glitchwindow.h"
+#include "scopeglitch.h"
+
+#include <QCheckBox>
+#include <QDateTime>
+#include <QDoubleSpinBox>
+#include <QGridLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QListWidget>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QVBoxLayout>
+#include <algorithm>
+
+namespace {
+const int kRefreshIntervalMs = 500;
+// 列表只显示最近的事件，全部事件仍保存在检测器中
+const int kMaxListed = 1000;
+
+QString glitchKindName(GlitchDetector::EventKind kind)
+{
+    switch (kind) {
+    case GlitchDetector::Slew: return QStringLiteral("跳变");
+    case GlitchDetector::OutOfBand: return QStringLiteral("越界");
+    case GlitchDetector::FlatLine: return QStringLiteral("平直");
+    case GlitchDetector::SequenceGap: return QStringLiteral("断档");
+    case GlitchDetector::LinkGap: return QStringLiteral("中断");
+    default: return QString();
+    }
+}
+
+QString glitchEventText(const GlitchDetector::Event &e)
+{
+    QString detail;
+    switch (e.kind) {
+    case GlitchDetector::Slew:
+        detail = QStringLiteral("最大跳变 %1 V，持续 %2 点").arg(e.value, 0, 'f', 4).arg(e.length);
+        break;
+    case GlitchDetector::OutOfBand:
+        detail = QStringLiteral("极值 %1 V，持续 %2 点").arg(e.value, 0, 'f', 4).arg(e.length);
+        break;
+    case GlitchDetector::FlatLine:
+        detail = QStringLiteral("电平 %1 V，持续 %2 点").arg(e.value, 0, 'f', 4).arg(e.length);
+        break;
+    case GlitchDetector::SequenceGap:
+        detail = e.length > 0 ? QStringLiteral("缺失 %1 个码").arg(e.length)
+                              : QStringLiteral("回退 %1 个码").arg(-e.length);
+        break;
+    case GlitchDetector::LinkGap:
+        detail = QStringLiteral("数据中断 %1 s（断线重连或示波器停止接收），前后样本不连续").arg(e.value, 0, 'f', 3);
+        break;
+    default:
+        break;
+    }
+    return QStringLiteral("%1  #%2  [%3]  %4")
+            .arg(QDateTime::fromMSecsSinceEpoch(e.wallClockMs).toString("HH:mm:ss.zzz"))
+            .arg(e.sampleIndex)
+            .arg(glitchKindName(e.kind))
+            .arg(detail);
+}
+}
+
+GlitchWindow::GlitchWindow(GlitchDetector *detector, QWidget *parent)
+    : QWidget(parent, Qt::Window)
+    , m_detector(detector)
+{
+    setWindowTitle(QStringLiteral("毛刺检测"));
+    resize(620, 520);
+
+    const GlitchDetector::Config &cfg = m_detector->config();
+    m_enableCheck = new QCheckBox(QStringLiteral("启用检测"), this);
+    m_enableCheck->setChecked(m_detector->isEnabled());
+    m_slewCheck = new QCheckBox(QStringLiteral("压摆率上限"), this);
+    m_slewCheck->setChecked(cfg.slewEnabled);
+    m_slewSpin = new QDoubleSpinBox(this);
+    m_slewSpin->setRange(0.0001, 1000.0);
+    m_slewSpin->setDecimals(4);
+    m_slewSpin->setValue(cfg.slewLimit);
+    m_slewSpin->setSuffix(QStringLiteral(" V/点"));
+    m_bandCheck = new QCheckBox(QStringLiteral("允许范围"), this);
+    m_bandCheck->setChecked(cfg.bandEnabled);
+    m_bandLowSpin = new QDoubleSpinBox(this);
+    m_bandLowSpin->setRange(-1000.0, 1000.0);
+    m_bandLowSpin->setDecimals(3);
+    m_bandLowSpin->setValue(cfg.bandLow);
+    m_bandLowSpin->setSuffix(" V");
+    m_bandHighSpin = new QDoubleSpinBox(this);
+    m_bandHighSpin->setRange(-1000.0, 1000.0);
+    m_bandHighSpin->setDecimals(3);
+    m_bandHighSpin->setValue(cfg.bandHigh);
+    m_bandHighSpin->setSuffix(" V");
+    m_flatCheck = new QCheckBox(QStringLiteral("平直段"), this);
+    m_flatCheck->setChecked(cfg.flatEnabled);
+    m_flatSpin = new QSpinBox(this);
+    m_flatSpin->setRange(2, 1000000);
+    m_flatSpin->setValue(cfg.flatSamples);
+    m_flatSpin->setSuffix(QStringLiteral(" 点"));
+    m_flatTolSpin = new QDoubleSpinBox(this);
+    m_flatTolSpin->setRange(0.0, 10.0);
+    m_flatTolSpin->setDecimals(4);
+    m_flatTolSpin->setValue(cfg.flatTolerance);
+    m_flatTolSpin->setPrefix(QStringLiteral("±"));
+    m_flatTolSpin->setSuffix(" V");
+    m_sequenceCheck = new QCheckBox(QStringLiteral("计数序列（原始码逐个 +1）"), this);
+    m_sequenceCheck->setChecked(cfg.sequenceEnabled);
+    QPushButton *clearButton = new QPushButton(QStringLiteral("清空事件"), this);
+    QPushButton *liveButton = new QPushButton(QStringLiteral("返回实时"), this);
+
+    QGridLayout *criteria = new QGridLayout;
+    criteria->addWidget(m_slewCheck, 0, 0);
+    criteria->addWidget(m_slewSpin, 0, 1);
+    criteria->addWidget(m_bandCheck, 1, 0);
+    criteria->addWidget(m_bandLowSpin, 1, 1);
+    criteria->addWidget(m_bandHighSpin, 1, 2);
+    criteria->addWidget(m_flatCheck, 2, 0);
+    criteria->addWidget(m_flatSpin, 2, 1);
+    criteria->addWidget(m_flatTolSpin, 2, 2);
+    criteria->addWidget(m_sequenceCheck, 3, 0, 1, 3);
+    QHBoxLayout *actions = new QHBoxLayout;
+    actions->addWidget(m_enableCheck);
+    actions->addStretch();
+    actions->addWidget(liveButton);
+    actions->addWidget(clearButton);
+
+    m_countLabel = new QLabel(this);
+    m_countLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    m_jumpLabel = new QLabel(QStringLiteral("点击事件在示波器中定位"), this);
+    m_eventList = new QListWidget(this);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(criteria);
+    layout->addLayout(actions);
+    layout->addWidget(m_countLabel);
+    layout->addWidget(m_eventList, 1);
+    layout->addWidget(m_jumpLabel);
+
+    connect(m_enableCheck, &QCheckBox::toggled, this, [this](bool checked) {
+        m_detector->setEnabled(checked);
+    });
+    for (QCheckBox *box : {m_slewCheck, m_bandCheck, m_flatCheck, m_sequenceCheck}) {
+        connect(box, &QCheckBox::toggled, this, [this]() { applyConfig(); });
+    }
+    for (QDoubleSpinBox *spin : {m_slewSpin, m_bandLowSpin, m_bandHighSpin, m_flatTolSpin}) {
+        connect(spin, static_cast<void(QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged), this, [this]() { applyConfig(); });
+    }
+    connect(m_flatSpin, static_cast<void(QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, [this]() { applyConfig(); });
+    connect(clearButton, &QPushButton::clicked, this, [this]() {
+        m_detector->reset();
+        refresh();
+    });
+    connect(liveButton, &QPushButton::clicked, this, [this]() {
+        if (m_liveHandler) m_liveHandler();
+        m_jumpLabel->setText(QStringLiteral("已返回实时显示"));
+    });
+    connect(m_eventList, &QListWidget::itemClicked, this, &GlitchWindow::jumpTo);
+    m_refreshTimer.setInterval(kRefreshIntervalMs);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &GlitchWindow::refresh);
+}
+
+void GlitchWindow::setJumpHandlers(const JumpHandler &jump, const std::function<void()> &live)
+{
+    m_jumpHandler = jump;
+    m_liveHandler = live;
+}
+
+void GlitchWindow::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    refresh();
+    m_refreshTimer.start();
+}
+
+void GlitchWindow::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    m_refreshTimer.stop();
+}
+
+void GlitchWindow::applyConfig()
+{
+    GlitchDetector::Config cfg;
+    cfg.slewEnabled = m_slewCheck->isChecked();
+    cfg.slewLimit = m_slewSpin->value();
+    cfg.bandEnabled = m_bandCheck->isChecked();
+    cfg.bandLow = std::min(m_bandLowSpin->value(), m_bandHighSpin->value());
+    cfg.bandHigh = std::max(m_bandLowSpin->value(), m_bandHighSpin->value());
+    cfg.flatEnabled = m_flatCheck->isChecked();
+    cfg.flatSamples = m_flatSpin->value();
+    cfg.flatTolerance = m_flatTolSpin->value();
+    cfg.sequenceEnabled = m_sequenceCheck->isChecked();
+    m_detector->configure(cfg);
+}
+
+void GlitchWindow::refresh()
+{
+    m_countLabel->setText(QStringLiteral("共 %1 个事件：跳变 %2   越界 %3   平直 %4   断档 %5   中断 %6")
+                          .arg(m_detector->totalEvents())
+                          .arg(m_detector->count(GlitchDetector::Slew))
+                          .arg(m_detector->count(GlitchDetector::OutOfBand))
+                          .arg(m_detector->count(GlitchDetector::FlatLine))
+                          .arg(m_detector->count(GlitchDetector::SequenceGap))
+                          .arg(m_detector->count(GlitchDetector::LinkGap)));
+    const QVector<GlitchDetector::Event> &events = m_detector->events();
+    const int first = std::max(0, events.size() - kMaxListed);
+    if (m_detector->totalEvents() == m_listedTotal && first == m_listedFirst
+            && m_eventList->count() == events.size() - first) {
+        // 事件集合未变，只刷新进行中事件的长度
+        for (int i = 0; i < m_eventList->count(); ++i) {
+            m_eventList->item(i)->setText(glitchEventText(events[first + i]));
+        }
+        return;
+    }
+    m_eventList->clear();
+    for (int i = first; i < events.size(); ++i) {
+        QListWidgetItem *item = new QListWidgetItem(glitchEventText(events[i]), m_eventList);
+        item->setData(Qt::UserRole, events[i].sampleIndex);
+    }
+    m_eventList->scrollToBottom();
+    m_listedTotal = m_detector->totalEvents();
+    m_listedFirst = first;
+}
+
+void GlitchWindow::jumpTo(QListWidgetItem *item)
+{
+    if (!item || !m_jumpHandler) return;
+    const qint64 index = item->data(Qt::UserRole).toLongLong();
+    if (m_jumpHandler(index)) {
+        m_jumpLabel->setText(QStringLiteral("示波器已定位到样本 #%1（红色虚线），点“返回实时”恢复").arg(index));
+    } else {
+        m_jumpLabel->setText(QStringLiteral("样本 #%1 已超出示波器缓存").arg(index));
+    }
+}
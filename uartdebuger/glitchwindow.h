@@ -0,0 +1,58 @@
+#ifndef GLITCHWINDOW_H
+#define GLITCHWINDOW_H
+
+#include <QWidget>
+#include <QTimer>
+#include <QtGlobal>
+#include <functional>
+
+class GlitchDetector;
+class QCheckBox;
+class QDoubleSpinBox;
+class QLabel;
+class QListWidget;
+class QListWidgetItem;
+class QSpinBox;
+
+// 毛刺检测窗口：设置判据、查看事件列表，点击事件把示波器定位到该样本
+class GlitchWindow : public QWidget
+{
+public:
+    // 定位到绝对样本序号，样本已不在缓存中时返回 false
+    using JumpHandler = std::function<bool(qint64)>;
+
+    explicit GlitchWindow(GlitchDetector *detector, QWidget *parent = nullptr);
+
+    void setJumpHandlers(const JumpHandler &jump, const std::function<void()> &live);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    void applyConfig();
+    void refresh();
+    void jumpTo(QListWidgetItem *item);
+
+    GlitchDetector *m_detector = nullptr;
+    JumpHandler m_jumpHandler;
+    std::function<void()> m_liveHandler;
+    QTimer m_refreshTimer;
+    qint64 m_listedTotal = -1;
+    int m_listedFirst = 0;
+    QCheckBox *m_enableCheck = nullptr;
+    QCheckBox *m_slewCheck = nullptr;
+    QDoubleSpinBox *m_slewSpin = nullptr;
+    QCheckBox *m_bandCheck = nullptr;
+    QDoubleSpinBox *m_bandLowSpin = nullptr;
+    QDoubleSpinBox *m_bandHighSpin = nullptr;
+    QCheckBox *m_flatCheck = nullptr;
+    QSpinBox *m_flatSpin = nullptr;
+    QDoubleSpinBox *m_flatTolSpin = nullptr;
+    QCheckBox *m_sequenceCheck = nullptr;
+    QLabel *m_countLabel = nullptr;
+    QLabel *m_jumpLabel = nullptr;
+    QListWidget *m_eventList = nullptr;
+};
+
+#endif // GLITCHWINDOW_H
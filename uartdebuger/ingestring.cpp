@@ -0,0 +1,89 @@
+#include "ingestring.h"
+
+#include <QMutexLocker>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+const int kHeaderSize = 4 + 8;
+}
+
+IngestRing::IngestRing(int capacityBytes)
+{
+    // 容量取 2 的幂，位置对容量取模只需按位与
+    int capacity = 1024;
+    while (capacity < capacityBytes) capacity <<= 1;
+    m_buffer.resize(capacity);
+    m_mask = static_cast<quint64>(capacity - 1);
+}
+
+void IngestRing::copyIn(quint64 position, const char *data, int size)
+{
+    const int offset = static_cast<int>(position & m_mask);
+    const int first = std::min(size, m_buffer.size() - offset);
+    std::memcpy(m_buffer.data() + offset, data, first);
+    std::memcpy(m_buffer.data(), data + first, size - first);
+}
+
+void IngestRing::copyOut(quint64 position, char *data, int size) const
+{
+    const int offset = static_cast<int>(position & m_mask);
+    const int first = std::min(size, m_buffer.size() - offset);
+    std::memcpy(data, m_buffer.constData() + offset, first);
+    std::memcpy(data + first, m_buffer.constData(), size - first);
+}
+
+bool IngestRing::push(const char *data, int size, qint64 timestampNs)
+{
+    if (size <= 0) return true;
+    const quint64 head = m_head.load(std::memory_order_relaxed);
+    const quint64 tail = m_tail.load(std::memory_order_acquire);
+    const quint64 need = static_cast<quint64>(kHeaderSize + size);
+    if (static_cast<quint64>(m_buffer.size()) - (head - tail) < need) {
+        ++m_dropped;
+        return false;
+    }
+    const qint32 length = size;
+    copyIn(head, reinterpret_cast<const char *>(&length), 4);
+    copyIn(head + 4, reinterpret_cast<const char *>(&timestampNs), 8);
+    copyIn(head + kHeaderSize, data, size);
+    m_head.store(head + need);
+    // 与 pop() 中先置 m_waiting 再检查 m_head 的顺序配对（均为顺序一致），不会漏掉唤醒
+    if (m_waiting.load()) {
+        QMutexLocker locker(&m_mutex);
+        m_ready.wakeAll();
+    }
+    return true;
+}
+
+bool IngestRing::pop(Chunk *chunk, int timeoutMs)
+{
+    quint64 tail = m_tail.load(std::memory_order_relaxed);
+    if (m_head.load(std::memory_order_acquire) == tail) {
+        if (timeoutMs <= 0) return false;
+        QMutexLocker locker(&m_mutex);
+        m_waiting.store(true);
+        if (m_head.load() == tail) m_ready.wait(&m_mutex, static_cast<unsigned long>(timeoutMs));
+        m_waiting.store(false);
+        if (m_head.load(std::memory_order_acquire) == tail) return false;
+    }
+    qint32 length = 0;
+    copyOut(tail, reinterpret_cast<char *>(&length), 4);
+    copyOut(tail + 4, reinterpret_cast<char *>(&chunk->timestampNs), 8);
+    chunk->data.resize(length);
+    copyOut(tail + kHeaderSize, chunk->data.data(), length);
+    m_tail.store(tail + kHeaderSize + static_cast<quint64>(length), std::memory_order_release);
+    return true;
+}
+
+void IngestRing::wake()
+{
+    QMutexLocker locker(&m_mutex);
+    m_ready.wakeAll();
+}
+
+void IngestRing::clear()
+{
+    m_tail.store(m_head.load());
+    m_dropped.store(0);
+}
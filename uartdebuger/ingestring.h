@@ -0,0 +1,48 @@
+#ifndef INGESTRING_H
+#define INGESTRING_H
+
+#include <QByteArray>
+#include <QMutex>
+#include <QVector>
+#include <QWaitCondition>
+#include <QtGlobal>
+#include <atomic>
+
+// 接收数据环形缓冲：单生产者（GUI 线程 readyRead）/单消费者（工作线程），无锁。
+// 每块记录 [长度 4 字节][读取时刻 8 字节][数据]，时间戳在 readAll() 处取得；
+// 放不下时整块丢弃并计数，生产者永不阻塞
+class IngestRing
+{
+public:
+    struct Chunk {
+        qint64 timestampNs = 0;     // NativePort::nowNanos() 时钟
+        QByteArray data;
+    };
+
+    explicit IngestRing(int capacityBytes = 1 << 20);
+
+    bool push(const char *data, int size, qint64 timestampNs);
+    bool push(const QByteArray &data, qint64 timestampNs) { return push(data.constData(), data.size(), timestampNs); }
+    // 取出一块；空时最多等待 timeoutMs，超时或被 wake() 唤醒返回 false
+    bool pop(Chunk *chunk, int timeoutMs);
+    // 唤醒等待中的消费者（用于请求停止）
+    void wake();
+    // 仅在消费者未运行时调用
+    void clear();
+    qint64 dropped() const { return m_dropped.load(); }
+
+private:
+    void copyIn(quint64 position, const char *data, int size);
+    void copyOut(quint64 position, char *data, int size) const;
+
+    QVector<char> m_buffer;
+    quint64 m_mask;
+    std::atomic<quint64> m_head{0};     // 生产者写到的位置（单调递增）
+    std::atomic<quint64> m_tail{0};     // 消费者读到的位置
+    std::atomic<qint64> m_dropped{0};
+    std::atomic<bool> m_waiting{false};
+    QMutex m_mutex;
+    QWaitCondition m_ready;
+};
+
+#endif // INGESTRING_H
@@ -0,0 +1,340 @@
+#include "linkprobe.h"
+
+#include "nativeport.h"
+
+#include <QMutexLocker>
+#include <QRandomGenerator>
+#include <algorithm>
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace {
+const int kPollMs = 50;
+const int kChecksumOffset = 20;
+// 已解析部分超过此长度才整体前移，避免每块都搬移缓冲
+const int kCompactBytes = 64 * 1024;
+
+void fletcher(const uchar *data, int size, quint32 *sum1, quint32 *sum2)
+{
+    quint32 a = *sum1;
+    quint32 b = *sum2;
+    for (int i = 0; i < size; ++i) {
+        a = (a + data[i]) % 255;
+        b = (b + a) % 255;
+    }
+    *sum1 = a;
+    *sum2 = b;
+}
+
+// 整帧 Fletcher-16，校验字段按两个 0 字节计
+quint16 frameChecksum(const uchar *frame, int size)
+{
+    quint32 a = 0;
+    quint32 b = 0;
+    fletcher(frame, kChecksumOffset, &a, &b);
+    b = (b + 2 * a) % 255;
+    fletcher(frame + kChecksumOffset + 2, size - kChecksumOffset - 2, &a, &b);
+    return static_cast<quint16>((b << 8) | a);
+}
+
+template <typename T>
+T readLE(const uchar *p)
+{
+    T v = 0;
+    for (int i = static_cast<int>(sizeof(T)) - 1; i >= 0; --i) v = static_cast<T>((v << 8) | p[i]);
+    return v;
+}
+
+template <typename T>
+void writeLE(char *p, T v)
+{
+    for (int i = 0; i < static_cast<int>(sizeof(T)); ++i) {
+        p[i] = static_cast<char>(v & 0xFF);
+        v = static_cast<T>(v >> 8);
+    }
+}
+
+int histogramBucket(double micros)
+{
+    int k = 0;
+    quint64 v = micros >= 1.0 ? static_cast<quint64>(micros) : 1;
+    while (v > 1 && k < LinkProbe::kHistogramBuckets - 1) {
+        v >>= 1;
+        ++k;
+    }
+    return k;
+}
+}
+
+LinkProbe::LinkProbe()
+{
+}
+
+LinkProbe::~LinkProbe()
+{
+    stop();
+}
+
+void LinkProbe::writeFrame(char *frame, int size, quint32 session, quint32 seq, qint64 timestampNs)
+{
+    frame[0] = static_cast<char>(0xA5);
+    frame[1] = static_cast<char>(0x5A);
+    writeLE<quint16>(frame + 2, static_cast<quint16>(size));
+    writeLE<quint32>(frame + 4, session);
+    writeLE<quint32>(frame + 8, seq);
+    writeLE<quint64>(frame + 12, static_cast<quint64>(timestampNs));
+    // 填充为递增字节，其中不会出现 A5 5A，减少误同步
+    for (int i = kHeaderSize; i < size; ++i) frame[i] = static_cast<char>((seq + i) & 0xFF);
+    writeLE<quint16>(frame + kChecksumOffset, frameChecksum(reinterpret_cast<const uchar *>(frame), size));
+}
+
+bool LinkProbe::prepare(const Config &config, QString *error)
+{
+    stop();
+    if (config.frameSize < kHeaderSize || config.frameSize > kMaxFrameSize) {
+        *error = QStringLiteral("帧长须在 %1~%2 字节之间").arg(kHeaderSize).arg(kMaxFrameSize);
+        return false;
+    }
+    m_config = config;
+    m_session = QRandomGenerator::global()->generate();
+    m_buffer.clear();
+    m_consumed = 0;
+    m_seen.clear();
+    m_maxSeq = -1;
+    m_stop = false;
+    QMutexLocker locker(&m_mutex);
+    m_stats = Stats();
+    m_stats.running = true;
+    m_stats.histogram.fill(0, kHistogramBuckets);
+    return true;
+}
+
+bool LinkProbe::startSending(QSerialPort::Handle handle, QString *error)
+{
+    SendScheduler::Config send;
+    send.rate = m_config.rate;
+    send.unit = SendScheduler::MessagesPerSecond;
+    send.count = m_config.count;
+    send.spinMicros = m_config.spinMicros;
+    const quint32 session = m_session;
+    // 发送时刻在调度线程写出前一刻取得，与接收时间戳同一时钟
+    send.compose = [session](qint64 index, QByteArray *payload) {
+        writeFrame(payload->data(), payload->size(), session, static_cast<quint32>(index), NativePort::nowNanos());
+    };
+    m_startNs = NativePort::nowNanos();
+    return m_scheduler.start(handle, QByteArray(m_config.frameSize, '\0'), send, error);
+}
+
+bool LinkProbe::start(QSerialPort::Handle loopbackHandle, const Config &config, QString *error)
+{
+#ifndef Q_OS_UNIX
+    Q_UNUSED(loopbackHandle);
+    Q_UNUSED(config);
+    *error = QStringLiteral("本平台不支持直接读取句柄");
+    return false;
+#else
+    if (!prepare(config, error)) return false;
+    m_handle = loopbackHandle;
+    m_usePort = false;
+    // 先启动发送再启动解析线程，后者以发送线程结束作为收尾条件；其间到达的回波留在 pty 中
+    if (!startSending(loopbackHandle, error)) {
+        QMutexLocker locker(&m_mutex);
+        m_stats.running = false;
+        return false;
+    }
+    QThread::start(QThread::HighPriority);
+    return true;
+#endif
+}
+
+bool LinkProbe::start(const PortSettings &port, const Config &config, QString *error)
+{
+    if (!prepare(config, error)) return false;
+    m_port = port;
+    m_usePort = true;
+    // 串口在工作线程中打开，发送也在打开后由工作线程启动
+    QThread::start(QThread::HighPriority);
+    return true;
+}
+
+void LinkProbe::stop()
+{
+    // 串口模式下工作线程持有句柄并在退出前停止发送，所以先等它结束
+    m_stop = true;
+    wait();
+    m_scheduler.stop();
+}
+
+LinkProbe::Stats LinkProbe::stats() const
+{
+    const SendScheduler::Stats send = m_scheduler.stats();
+    QMutexLocker locker(&m_mutex);
+    Stats s = m_stats;
+    s.sent = send.messages;
+    s.bytesSent = send.bytes;
+    s.txSeconds = send.elapsedSeconds;
+    if (s.error.isEmpty()) s.error = send.error;
+    return s;
+}
+
+void LinkProbe::parse(const char *data, int size, qint64 timestampNs)
+{
+    m_buffer.append(data, size);
+    const uchar *b = reinterpret_cast<const uchar *>(m_buffer.constData());
+    const int n = m_buffer.size();
+    int pos = m_consumed;
+    qint64 received = 0;
+    qint64 bytes = 0;
+    qint64 duplicates = 0;
+    qint64 reordered = 0;
+    qint64 corrupt = 0;
+    qint64 stale = 0;
+    QVector<double> rtts;
+
+    while (n - pos >= kHeaderSize) {
+        if (b[pos] != 0xA5 || b[pos + 1] != 0x5A) {
+            const void *next = std::memchr(b + pos + 1, 0xA5, static_cast<size_t>(n - pos - 1));
+            pos = next ? static_cast<int>(static_cast<const uchar *>(next) - b) : n;
+            continue;
+        }
+        const int length = readLE<quint16>(b + pos + 2);
+        if (length < kHeaderSize || length > kMaxFrameSize) {
+            ++pos;
+            continue;
+        }
+        if (n - pos < length) break;
+        if (readLE<quint16>(b + pos + kChecksumOffset) != frameChecksum(b + pos, length)) {
+            ++corrupt;
+            ++pos;
+            continue;
+        }
+        const quint32 session = readLE<quint32>(b + pos + 4);
+        const quint32 seq = readLE<quint32>(b + pos + 8);
+        const qint64 sentNs = static_cast<qint64>(readLE<quint64>(b + pos + 12));
+        pos += length;
+        if (session != m_session) {
+            ++stale;
+            continue;
+        }
+        ++received;
+        bytes += length;
+        const int word = static_cast<int>(seq >> 6);
+        if (word >= m_seen.size()) m_seen.resize(std::max(word + 1, m_seen.size() * 2));
+        const quint64 bit = quint64(1) << (seq & 63);
+        if (m_seen[word] & bit) {
+            ++duplicates;
+            continue;
+        }
+        m_seen[word] |= bit;
+        if (static_cast<qint64>(seq) < m_maxSeq) ++reordered;
+        m_maxSeq = std::max<qint64>(m_maxSeq, seq);
+        // 本轮解析出的帧末字节都在刚到达的这一块里，读取时刻即其到达时刻
+        rtts.append(std::max<qint64>(0, timestampNs - sentNs) / 1000.0);
+    }
+
+    m_consumed = pos;
+    if (m_consumed == n || m_consumed > kCompactBytes) {
+        m_buffer.remove(0, m_consumed);
+        m_consumed = 0;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_stats.received += received;
+    m_stats.bytesReceived += bytes;
+    m_stats.duplicates += duplicates;
+    m_stats.reordered += reordered;
+    m_stats.corrupt += corrupt;
+    m_stats.stale += stale;
+    for (double rtt : rtts) {
+        m_stats.rtt.add(rtt);
+        ++m_stats.histogram[histogramBucket(rtt)];
+    }
+    if (received > 0) m_stats.rxSeconds = (timestampNs - m_startNs) / 1e9;
+}
+
+bool LinkProbe::drained(qint64 *drainDeadline)
+{
+    if (m_scheduler.isRunning()) return false;
+    const qint64 now = NativePort::nowNanos();
+    if (*drainDeadline == 0) {
+        *drainDeadline = now + m_config.drainMs * 1000000LL;
+        QMutexLocker locker(&m_mutex);
+        m_stats.draining = true;
+    }
+    const qint64 sent = m_scheduler.stats().messages;
+    QMutexLocker locker(&m_mutex);
+    return now >= *drainDeadline || m_stats.unique() >= sent;
+}
+
+void LinkProbe::runLoopback()
+{
+#ifdef Q_OS_UNIX
+    qint64 drainDeadline = 0;
+    char buffer[4096];
+    while (!m_stop) {
+        // pty 回环：本线程直接读，时间戳取在 read() 返回处
+        pollfd pfd;
+        pfd.fd = static_cast<int>(m_handle);
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (::poll(&pfd, 1, kPollMs) > 0) {
+            const ssize_t n = ::read(pfd.fd, buffer, sizeof(buffer));
+            if (n > 0) parse(buffer, static_cast<int>(n), NativePort::nowNanos());
+        }
+        if (drained(&drainDeadline)) break;
+    }
+#endif
+}
+
+void LinkProbe::runPort()
+{
+    // 串口属于本线程，不进事件循环，用 waitForReadyRead() 阻塞等待，时间戳取在本线程的 readAll() 处
+    QSerialPort port;
+    port.setPortName(m_port.portName);
+    port.setBaudRate(m_port.baudRate);
+    port.setDataBits(m_port.dataBits);
+    port.setParity(m_port.parity);
+    port.setStopBits(m_port.stopBits);
+    port.setFlowControl(m_port.flowControl);
+    QString error;
+    if (!port.open(QIODevice::ReadWrite)) {
+        error = QStringLiteral("打开串口失败：%1").arg(port.errorString());
+    } else if (!m_stop && startSending(port.handle(), &error)) {
+        qint64 drainDeadline = 0;
+        while (!m_stop) {
+            if (port.waitForReadyRead(kPollMs)) {
+                const QByteArray data = port.readAll();
+                parse(data.constData(), data.size(), NativePort::nowNanos());
+            } else if (port.error() != QSerialPort::NoError && port.error() != QSerialPort::TimeoutError) {
+                error = port.errorString();
+                break;
+            }
+            if (drained(&drainDeadline)) break;
+        }
+    }
+    // 发送线程直接写句柄，关闭串口前先停止
+    m_scheduler.stop();
+    port.close();
+    if (!error.isEmpty()) {
+        QMutexLocker locker(&m_mutex);
+        m_stats.error = error;
+    }
+}
+
+void LinkProbe::run()
+{
+    if (m_usePort) {
+        runPort();
+    } else {
+        runLoopback();
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_stats.running = false;
+    m_stats.draining = false;
+}
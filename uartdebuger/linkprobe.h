@@ -0,0 +1,109 @@
+#ifndef LINKPROBE_H
+#define LINKPROBE_H
+
+#include "sendscheduler.h"
+#include "streamstats.h"
+
+#include <QByteArray>
+#include <QMutex>
+#include <QSerialPort>
+#include <QThread>
+#include <QVector>
+#include <atomic>
+
+// 往返延迟/吞吐测试：按设定速率发送带序号与发送时刻的探测帧，对端原样回送（物理回环、固件回显或本地 pty），
+// 工作线程解析回波并按接收时间戳计算 RTT，统计分位数、对数直方图、有效吞吐、丢失、重复与乱序。
+// 回波由本线程自己读取（串口在本线程中打开，pty 直接 read()），时间戳取在读取处，不经过 GUI 事件循环。
+//
+// 帧格式（小端）：A5 5A | 总长 u16 | 会话 u32 | 序号 u32 | 发送时刻 ns u64 | Fletcher-16 u16 | 填充
+// 校验覆盖整帧（校验字段按 0 计），会话号用于区分上一轮测试迟到的回波
+class LinkProbe : public QThread
+{
+public:
+    static const int kHeaderSize = 22;
+    static const int kMaxFrameSize = 4096;
+    static const int kHistogramBuckets = 32;     // 第 k 桶为 [2^k, 2^(k+1)) µs
+
+    struct Config {
+        double rate = 100.0;             // 帧/秒
+        int frameSize = 32;              // 字节，kHeaderSize ~ kMaxFrameSize
+        qint64 count = 1000;             // 0 表示一直发送到停止
+        int spinMicros = 200;
+        int drainMs = 1000;              // 发送结束后等待迟到回波的时间
+    };
+
+    // 经串口测试时由本线程按此参数打开串口
+    struct PortSettings {
+        QString portName;
+        qint32 baudRate = 115200;
+        QSerialPort::DataBits dataBits = QSerialPort::Data8;
+        QSerialPort::Parity parity = QSerialPort::NoParity;
+        QSerialPort::StopBits stopBits = QSerialPort::OneStop;
+        QSerialPort::FlowControl flowControl = QSerialPort::NoFlowControl;
+    };
+
+    struct Stats {
+        bool running = false;
+        bool draining = false;           // 已发完，等待迟到回波
+        QString error;
+        qint64 sent = 0;
+        qint64 bytesSent = 0;
+        double txSeconds = 0;
+        qint64 received = 0;             // 校验通过的本轮回波（含重复）
+        qint64 bytesReceived = 0;
+        qint64 duplicates = 0;
+        qint64 reordered = 0;            // 序号小于此前已收到的最大序号
+        qint64 corrupt = 0;              // 帧头合理但校验失败
+        qint64 stale = 0;                // 其他会话的回波
+        double rxSeconds = 0;            // 开始到最后一个回波
+        StreamStats rtt;                 // µs
+        QVector<qint64> histogram;
+
+        qint64 unique() const { return received - duplicates; }
+        // 运行中为尚未回来的帧数，结束后即丢失数
+        qint64 missing() const { return sent - unique(); }
+    };
+
+    LinkProbe();
+    ~LinkProbe();
+
+    // 本地 pty 回环：本线程直接读写 pty 句柄（仅 Unix）
+    bool start(QSerialPort::Handle loopbackHandle, const Config &config, QString *error);
+    // 串口：本线程打开串口后再开始发送，打开失败记在 Stats::error；调用方须先关闭自己持有的同一串口
+    bool start(const PortSettings &port, const Config &config, QString *error);
+    void stop();
+    Stats stats() const;
+
+    // 按序号与发送时刻填写帧（frame 已分配 size 字节）
+    static void writeFrame(char *frame, int size, quint32 session, quint32 seq, qint64 timestampNs);
+
+protected:
+    void run() override;
+
+private:
+    bool prepare(const Config &config, QString *error);
+    bool startSending(QSerialPort::Handle handle, QString *error);
+    void runLoopback();
+    void runPort();
+    // 发送结束后全部回来或等满 drainMs 时返回 true
+    bool drained(qint64 *drainDeadline);
+    void parse(const char *data, int size, qint64 timestampNs);
+
+    SendScheduler m_scheduler;
+    QSerialPort::Handle m_handle = 0;
+    bool m_usePort = false;
+    PortSettings m_port;
+    Config m_config;
+    quint32 m_session = 0;
+    std::atomic<bool> m_stop{false};
+    qint64 m_startNs = 0;
+    // 以下仅工作线程访问
+    QByteArray m_buffer;
+    int m_consumed = 0;
+    QVector<quint64> m_seen;             // 已收到序号的位图
+    qint64 m_maxSeq = -1;
+    mutable QMutex m_mutex;
+    Stats m_stats;
+};
+
+#endif // LINKPROBE_H
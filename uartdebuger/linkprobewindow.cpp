@@ -0,0 +1,235 @@
+#include "linkprobewindow.h"
+
+#include <QCheckBox>
+#include <QDoubleSpinBox>
+#include <QGridLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPlainTextEdit>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QVBoxLayout>
+#include <algorithm>
+
+namespace {
+const int kRefreshIntervalMs = 250;
+const int kHistogramBarWidth = 40;
+
+QString bucketLabel(int k)
+{
+    const auto format = [](quint64 us) {
+        if (us >= 1000000) return QStringLiteral("%1 s").arg(us / 1000000.0, 0, 'g', 3);
+        if (us >= 1000) return QStringLiteral("%1 ms").arg(us / 1000.0, 0, 'g', 3);
+        return QStringLiteral("%1 µs").arg(us);
+    };
+    return QStringLiteral("%1 ~ %2").arg(format(quint64(1) << k), format(quint64(1) << (k + 1)));
+}
+}
+
+LinkProbeWindow::LinkProbeWindow(QWidget *parent)
+    : QWidget(parent, Qt::Window)
+{
+    setWindowTitle(QStringLiteral("链路测试"));
+    resize(600, 620);
+
+    m_rateSpin = new QDoubleSpinBox(this);
+    m_rateSpin->setRange(0.1, 1000000.0);
+    m_rateSpin->setDecimals(1);
+    m_rateSpin->setValue(100.0);
+    m_rateSpin->setSuffix(QStringLiteral(" 帧/秒"));
+    m_sizeSpin = new QSpinBox(this);
+    m_sizeSpin->setRange(LinkProbe::kHeaderSize, LinkProbe::kMaxFrameSize);
+    m_sizeSpin->setValue(32);
+    m_sizeSpin->setSuffix(QStringLiteral(" 字节"));
+    m_countSpin = new QSpinBox(this);
+    m_countSpin->setRange(0, 2000000000);
+    m_countSpin->setValue(1000);
+    m_countSpin->setSpecialValueText(QStringLiteral("不限"));
+    m_drainSpin = new QSpinBox(this);
+    m_drainSpin->setRange(10, 60000);
+    m_drainSpin->setValue(1000);
+    m_drainSpin->setSuffix(QStringLiteral(" ms"));
+    m_loopbackCheck = new QCheckBox(QStringLiteral("本地 pty 回环（不使用串口）"), this);
+    m_loopbackCheck->setEnabled(PtyEcho::isSupported());
+    if (!PtyEcho::isSupported()) {
+        m_loopbackCheck->setToolTip(QStringLiteral("本平台不支持伪终端，可用虚拟串口对加外部回环代替"));
+    }
+    m_startButton = new QPushButton(QStringLiteral("开始"), this);
+    m_stopButton = new QPushButton(QStringLiteral("停止"), this);
+    m_stopButton->setEnabled(false);
+    m_report = new QPlainTextEdit(this);
+    m_report->setReadOnly(true);
+
+    QGridLayout *params = new QGridLayout;
+    params->addWidget(new QLabel(QStringLiteral("发送速率"), this), 0, 0);
+    params->addWidget(m_rateSpin, 0, 1);
+    params->addWidget(new QLabel(QStringLiteral("帧长"), this), 0, 2);
+    params->addWidget(m_sizeSpin, 0, 3);
+    params->addWidget(new QLabel(QStringLiteral("帧数"), this), 1, 0);
+    params->addWidget(m_countSpin, 1, 1);
+    params->addWidget(new QLabel(QStringLiteral("收尾等待"), this), 1, 2);
+    params->addWidget(m_drainSpin, 1, 3);
+    params->addWidget(m_loopbackCheck, 2, 0, 1, 4);
+    QHBoxLayout *buttons = new QHBoxLayout;
+    buttons->addStretch(1);
+    buttons->addWidget(m_startButton);
+    buttons->addWidget(m_stopButton);
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(params);
+    layout->addLayout(buttons);
+    layout->addWidget(m_report, 1);
+
+    connect(m_startButton, &QPushButton::clicked, this, &LinkProbeWindow::start);
+    connect(m_stopButton, &QPushButton::clicked, this, &LinkProbeWindow::stop);
+
+    // 只在测试期间刷新，与窗口是否可见无关，以便及时发现测试结束
+    m_refreshTimer.setInterval(kRefreshIntervalMs);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &LinkProbeWindow::refresh);
+}
+
+LinkProbeWindow::~LinkProbeWindow()
+{
+    m_probe.stop();
+    releaseLoopback();
+    returnPort();
+}
+
+void LinkProbeWindow::setPortLender(const PortLender &lender, const PortReturner &returner)
+{
+    m_portLender = lender;
+    m_portReturner = returner;
+}
+
+void LinkProbeWindow::setSentHandler(const SentHandler &handler)
+{
+    m_sentHandler = handler;
+}
+
+void LinkProbeWindow::releaseLoopback()
+{
+    PtyEcho::closeSlave(m_slaveFd);
+    m_slaveFd = -1;
+    m_echo.stop();
+}
+
+void LinkProbeWindow::returnPort()
+{
+    if (!m_portLent) return;
+    m_portLent = false;
+    if (m_portReturner) m_portReturner();
+}
+
+void LinkProbeWindow::start()
+{
+    m_probe.stop();
+    releaseLoopback();
+    returnPort();
+    LinkProbe::Config cfg;
+    cfg.rate = m_rateSpin->value();
+    cfg.frameSize = m_sizeSpin->value();
+    cfg.count = m_countSpin->value();
+    cfg.drainMs = m_drainSpin->value();
+    QString error;
+    const bool loopback = m_loopbackCheck->isChecked();
+    if (loopback) {
+        QSerialPort::Handle handle = 0;
+        if (!m_echo.start(&error) || (m_slaveFd = m_echo.openSlave(&error)) < 0) {
+            releaseLoopback();
+            m_report->setPlainText(error);
+            return;
+        }
+#ifdef Q_OS_UNIX
+        handle = m_slaveFd;
+#endif
+        if (!m_probe.start(handle, cfg, &error)) {
+            releaseLoopback();
+            m_report->setPlainText(error);
+            return;
+        }
+    } else {
+        // 回波由测试线程自己读取并打时间戳，期间主窗口让出串口
+        LinkProbe::PortSettings port;
+        if (!m_portLender || !m_portLender(&port)) {
+            m_report->setPlainText(QStringLiteral("串口未打开。"));
+            return;
+        }
+        m_portLent = true;
+        if (!m_probe.start(port, cfg, &error)) {
+            returnPort();
+            m_report->setPlainText(error);
+            return;
+        }
+    }
+    m_usingPort = !loopback;
+    m_reportedBytes = 0;
+    m_startButton->setEnabled(false);
+    m_stopButton->setEnabled(true);
+    m_refreshTimer.start();
+}
+
+void LinkProbeWindow::stop()
+{
+    m_probe.stop();
+    if (m_refreshTimer.isActive()) {
+        m_refreshTimer.stop();
+        refresh();
+    }
+    releaseLoopback();
+    returnPort();
+    m_startButton->setEnabled(true);
+    m_stopButton->setEnabled(false);
+}
+
+void LinkProbeWindow::refresh()
+{
+    const LinkProbe::Stats s = m_probe.stats();
+    if (m_usingPort && m_sentHandler && s.bytesSent > m_reportedBytes) m_sentHandler(s.bytesSent - m_reportedBytes);
+    m_reportedBytes = s.bytesSent;
+
+    QString text;
+    if (s.running) {
+        text += s.draining ? QStringLiteral("发送完毕，等待迟到回波…\n") : QStringLiteral("测试中\n");
+    } else {
+        text += QStringLiteral("已结束\n");
+    }
+    if (!s.error.isEmpty()) text += s.error + '\n';
+    text += QStringLiteral("发送 %1 帧，%2 字节").arg(s.sent).arg(s.bytesSent);
+    if (s.txSeconds > 0) {
+        text += QStringLiteral("（%1 帧/秒，%2 字节/秒）")
+                .arg(s.sent / s.txSeconds, 0, 'f', 1).arg(s.bytesSent / s.txSeconds, 0, 'f', 0);
+    }
+    text += QStringLiteral("\n回波 %1 帧，%2 字节").arg(s.received).arg(s.bytesReceived);
+    if (s.rxSeconds > 0) {
+        text += QStringLiteral("，有效吞吐 %1 字节/秒").arg(s.bytesReceived / s.rxSeconds, 0, 'f', 0);
+    }
+    const qint64 missing = std::max<qint64>(0, s.missing());
+    text += QStringLiteral("\n%1 %2（%3 %），重复 %4，乱序 %5，校验错 %6，过期 %7\n")
+            .arg(s.running ? QStringLiteral("未回") : QStringLiteral("丢失"))
+            .arg(missing).arg(s.sent > 0 ? 100.0 * missing / s.sent : 0.0, 0, 'f', 3)
+            .arg(s.duplicates).arg(s.reordered).arg(s.corrupt).arg(s.stale);
+
+    const RunningMoments &m = s.rtt.moments();
+    if (m.count() > 0) {
+        text += QStringLiteral("\nRTT (µs)：均值 %1，标准差 %2，最小 %3，最大 %4\n")
+                .arg(m.mean(), 0, 'f', 1).arg(m.stddev(), 0, 'f', 1).arg(m.min(), 0, 'f', 1).arg(m.max(), 0, 'f', 1);
+        text += QStringLiteral("  P50 %1  P90 %2  P99 %3  P99.9 %4\n\n")
+                .arg(s.rtt.quantile(0.5), 0, 'f', 1).arg(s.rtt.quantile(0.9), 0, 'f', 1)
+                .arg(s.rtt.quantile(0.99), 0, 'f', 1).arg(s.rtt.quantile(0.999), 0, 'f', 1);
+        const qint64 peak = *std::max_element(s.histogram.constBegin(), s.histogram.constEnd());
+        for (int k = 0; k < s.histogram.size(); ++k) {
+            const qint64 c = s.histogram[k];
+            if (c == 0) continue;
+            const int bar = std::max(1, static_cast<int>(kHistogramBarWidth * c / std::max<qint64>(1, peak)));
+            text += QStringLiteral("%1  %2 %3\n").arg(bucketLabel(k), -20).arg(QString(bar, QChar('#'))).arg(c);
+        }
+    }
+    m_report->setPlainText(text);
+
+    if (!s.running && m_refreshTimer.isActive()) {
+        m_refreshTimer.stop();
+        releaseLoopback();
+        returnPort();
+        m_startButton->setEnabled(true);
+        m_stopButton->setEnabled(false);
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef LINKPROBEWINDOW_H
+#define LINKPROBEWINDOW_H
+
+#include "linkprobe.h"
+#include "ptyecho.h"
+
+#include <QTimer>
+#include <QWidget>
+#include <functional>
+
+class QCheckBox;
+class QDoubleSpinBox;
+class QPlainTextEdit;
+class QPushButton;
+class QSpinBox;
+
+// 链路测试窗口：往返延迟分布、有效吞吐、丢失/重复/乱序；可用当前串口或本地 pty 回环
+class LinkProbeWindow : public QWidget
+{
+public:
+    // 借出当前串口：串口已打开时由调用方关闭并给出其参数，返回 true；测试线程按参数自行打开
+    using PortLender = std::function<bool(LinkProbe::PortSettings *settings)>;
+    // 测试结束后归还串口，由调用方重新打开
+    using PortReturner = std::function<void()>;
+    // 每次刷新时报告经当前串口新写出的字节数
+    using SentHandler = std::function<void(qint64 bytes)>;
+
+    explicit LinkProbeWindow(QWidget *parent = nullptr);
+    ~LinkProbeWindow();
+
+    void setPortLender(const PortLender &lender, const PortReturner &returner);
+    void setSentHandler(const SentHandler &handler);
+    // 串口关闭前必须调用
+    void stop();
+
+private:
+    void start();
+    void refresh();
+    void releaseLoopback();
+    void returnPort();
+
+    LinkProbe m_probe;
+    PtyEcho m_echo;
+    int m_slaveFd = -1;
+    bool m_usingPort = false;
+    bool m_portLent = false;             // 串口已借出，结束时须归还
+    PortLender m_portLender;
+    PortReturner m_portReturner;
+    SentHandler m_sentHandler;
+    QTimer m_refreshTimer;
+    qint64 m_reportedBytes = 0;
+    QDoubleSpinBox *m_rateSpin = nullptr;
+    QSpinBox *m_sizeSpin = nullptr;
+    QSpinBox *m_countSpin = nullptr;
+    QSpinBox *m_drainSpin = nullptr;
+    QCheckBox *m_loopbackCheck = nullptr;
+    QPushButton *m_startButton = nullptr;
+    QPushButton *m_stopButton = nullptr;
+    QPlainTextEdit *m_report = nullptr;
+};
+
+#endif // LINKPROBEWINDOW_H
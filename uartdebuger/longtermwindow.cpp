@@ -0,0 +1,133 @@
+#include "longtermwindow.h"
+#include "scopelongterm.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QTextStream>
+#include <QVBoxLayout>
+
+namespace {
+const int kRefreshIntervalMs = 500;
+// 表格列出的分位点
+const double kQuantiles[] = {0.5, 0.9, 0.99, 0.999};
+const int kQuantileCount = sizeof(kQuantiles) / sizeof(kQuantiles[0]);
+}
+
+LongTermWindow::LongTermWindow(ScopeLongTermStats *stats, QWidget *parent)
+    : QWidget(parent, Qt::Window)
+    , m_stats(stats)
+{
+    setWindowTitle(QStringLiteral("长期统计"));
+    resize(760, 340);
+
+    QPushButton *resetButton = new QPushButton(QStringLiteral("清零"), this);
+    QPushButton *exportButton = new QPushButton(QStringLiteral("导出 CSV"), this);
+    m_summaryLabel = new QLabel(this);
+
+    QStringList headers;
+    headers << QStringLiteral("单位") << QStringLiteral("次数") << QStringLiteral("均值") << QStringLiteral("标准差")
+            << QStringLiteral("最小") << QStringLiteral("最大")
+            << "P50" << "P90" << "P99" << "P99.9";
+    QStringList rows;
+    for (int m = 0; m < ScopeLongTermStats::MeasurementCount; ++m) {
+        rows << ScopeLongTermStats::name(static_cast<ScopeLongTermStats::Measurement>(m));
+    }
+    m_table = new QTableWidget(rows.size(), headers.size(), this);
+    m_table->setHorizontalHeaderLabels(headers);
+    m_table->setVerticalHeaderLabels(rows);
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    for (int r = 0; r < rows.size(); ++r) {
+        for (int c = 0; c < headers.size(); ++c) {
+            QTableWidgetItem *item = new QTableWidgetItem;
+            item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            m_table->setItem(r, c, item);
+        }
+    }
+
+    QHBoxLayout *controls = new QHBoxLayout;
+    controls->addWidget(m_summaryLabel, 1);
+    controls->addWidget(resetButton);
+    controls->addWidget(exportButton);
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(controls);
+    layout->addWidget(m_table, 1);
+
+    connect(resetButton, &QPushButton::clicked, this, [this]() {
+        m_stats->reset();
+        refresh();
+    });
+    connect(exportButton, &QPushButton::clicked, this, &LongTermWindow::exportCsv);
+    m_refreshTimer.setInterval(kRefreshIntervalMs);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &LongTermWindow::refresh);
+}
+
+void LongTermWindow::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    refresh();
+    m_refreshTimer.start();
+}
+
+void LongTermWindow::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    m_refreshTimer.stop();
+}
+
+void LongTermWindow::refresh()
+{
+    const qint64 elapsedSec = (QDateTime::currentMSecsSinceEpoch() - m_stats->startedMs()) / 1000;
+    m_summaryLabel->setText(QStringLiteral("自 %1 起（%2:%3:%4），共记录 %5 屏")
+                            .arg(QDateTime::fromMSecsSinceEpoch(m_stats->startedMs()).toString("yyyy-MM-dd HH:mm:ss"))
+                            .arg(elapsedSec / 3600)
+                            .arg(elapsedSec / 60 % 60, 2, 10, QChar('0'))
+                            .arg(elapsedSec % 60, 2, 10, QChar('0'))
+                            .arg(m_stats->windows()));
+    for (int m = 0; m < ScopeLongTermStats::MeasurementCount; ++m) {
+        const auto id = static_cast<ScopeLongTermStats::Measurement>(m);
+        const StreamStats &s = m_stats->stats(id);
+        const double scale = ScopeLongTermStats::displayScale(id);
+        auto cell = [&](int col, double v) {
+            m_table->item(m, col)->setText(s.count() > 0 ? QString::number(v * scale, 'g', 6) : QStringLiteral("-"));
+        };
+        m_table->item(m, 0)->setText(ScopeLongTermStats::unit(id));
+        m_table->item(m, 1)->setText(QString::number(s.count()));
+        cell(2, s.moments().mean());
+        cell(3, s.moments().stddev());
+        cell(4, s.moments().min());
+        cell(5, s.moments().max());
+        for (int q = 0; q < kQuantileCount; ++q) cell(6 + q, s.quantile(kQuantiles[q]));
+    }
+}
+
+void LongTermWindow::exportCsv()
+{
+    const QString fileName = QFileDialog::getSaveFileName(this, QStringLiteral("导出长期统计"), QString(), "CSV (*.csv)");
+    if (fileName.isEmpty()) return;
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QMessageBox::warning(this, QStringLiteral("导出"), QStringLiteral("无法写入文件"));
+        return;
+    }
+    QTextStream out(&file);
+    out.setRealNumberPrecision(10);
+    out << "measurement,unit,count,mean,stddev,min,max,p50,p90,p99,p999\n";
+    for (int m = 0; m < ScopeLongTermStats::MeasurementCount; ++m) {
+        const auto id = static_cast<ScopeLongTermStats::Measurement>(m);
+        const StreamStats &s = m_stats->stats(id);
+        const double scale = ScopeLongTermStats::displayScale(id);
+        out << ScopeLongTermStats::name(id) << ',' << ScopeLongTermStats::unit(id) << ',' << s.count() << ','
+            << s.moments().mean() * scale << ',' << s.moments().stddev() * scale << ','
+            << s.moments().min() * scale << ',' << s.moments().max() * scale;
+        for (int q = 0; q < kQuantileCount; ++q) out << ',' << s.quantile(kQuantiles[q]) * scale;
+        out << '\n';
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef LONGTERMWINDOW_H
+#define LONGTERMWINDOW_H
+
+#include <QWidget>
+#include <QTimer>
+
+class ScopeLongTermStats;
+class QLabel;
+class QTableWidget;
+
+// 长期统计窗口：按测量量列出次数、均值、标准差、最值与分位数，可清零与导出
+class LongTermWindow : public QWidget
+{
+public:
+    explicit LongTermWindow(ScopeLongTermStats *stats, QWidget *parent = nullptr);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    void refresh();
+    void exportCsv();
+
+    ScopeLongTermStats *m_stats = nullptr;
+    QTimer m_refreshTimer;
+    QLabel *m_summaryLabel = nullptr;
+    QTableWidget *m_table = nullptr;
+};
+
+#endif // LONGTERMWINDOW_H
@@ -1,5 +1,24 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
+#include "oscilloscopewidget.h"
+#include "scopeautoset.h"
+#include "scopemeasure.h"
+#include "spectrogramwindow.h"
+#include "freqtrackerwindow.h"
+#include "referencewindow.h"
+#include "maskwindow.h"
+#include "longtermwindow.h"
+#include "glitchwindow.h"
+#include "offlinewindow.h"
+#include "trendwindow.h"
+#include "precisesendwindow.h"
+#include "sequencewindow.h"
+#include "linkprobewindow.h"
+#include "alerthighlighter.h"
+#include "alertwindow.h"
+#include "framewindow.h"
+#include "sessionwindow.h"
+#include "nativeport.h"
 
 #include <QMessageBox>
 #include <QDateTime>
@@ -13,264 +32,22 @@
 #include <QTextCursor>
 #include <QGraphicsOpacityEffect>
 #include <QEasingCurve>
-#include <QPainter>
 #include <QStyleOption>
+#include <QApplication>
+#include <QSignalBlocker>
 #include <cmath>
 #include <algorithm>
 #include <QtGlobal>
 
-// 简易示波器绘制组件：负责波形显示及基本测量计算
-class OscilloscopeWidget : public QWidget
-{
-public:
-    struct Stats {
-        double min = 0;
-        double max = 0;
-        double peakToPeak = 0;
-        double rms = 0;
-        double mean = 0;
-        double period = 0;
-        double freq = 0;
-        double riseTime = 0;
-        double fallTime = 0;
-        double pulseWidth = 0;
-        double duty = 0;
-        bool hasPeriod = false;
-        int samples = 0;
-    };
-
-    explicit OscilloscopeWidget(QWidget *parent = nullptr)
-        : QWidget(parent)
-    {
-        setMinimumHeight(240);
-        setAutoFillBackground(true);
-    }
-
-    void configure(double sampleRate, double timeBaseMs, double gain, double vMin, double vMax)
-    {
-        m_sampleRate = std::max(1.0, sampleRate);
-        m_timeBaseMs = std::max(0.1, timeBaseMs);
-        m_gain = std::max(0.001, gain);
-        m_vMin = vMin;
-        m_vMax = vMax;
-        update();
-    }
-
-    void setValues(const QVector<double> &values)
-    {
-        m_values = values;
-        computeStats();
-        update();
-    }
-
-    const Stats &stats() const { return m_stats; }
-
-protected:
-    void paintEvent(QPaintEvent *) override
-    {
-        QPainter p(this);
-        p.setRenderHint(QPainter::Antialiasing);
-
-        const qreal leftMargin = 68.0;
-        const qreal topMargin = 8.0;
-        const qreal rightMargin = 8.0;
-        const qreal bottomMargin = 8.0;
-        QRectF rect = this->rect().adjusted(leftMargin, topMargin, -rightMargin, -bottomMargin);
-        p.fillRect(rect, QColor("#ffffff"));
-
-        // Grid
-        p.setPen(QPen(QColor("#d1d1d6"), 1));
-        const int divs = 10;
-        for (int i = 0; i <= divs; ++i) {
-            const double x = rect.left() + rect.width() * i / divs;
-            p.drawLine(QPointF(x, rect.top()), QPointF(x, rect.bottom()));
-            const double y = rect.top() + rect.height() * i / divs;
-            p.drawLine(QPointF(rect.left(), y), QPointF(rect.right(), y));
-        }
-
-        // Left ruler labels
-        double labelMin = m_vMin;
-        double labelMax = m_vMax;
-        QVector<double> visible = visibleValues();
-        if (!visible.isEmpty()) {
-            labelMin = *std::min_element(visible.begin(), visible.end());
-            labelMax = *std::max_element(visible.begin(), visible.end());
-        }
-        double labelSpan = labelMax - labelMin;
-        if (labelSpan < 1e-9) labelSpan = 1.0;
-        p.setPen(QPen(QColor("#3a3a3c"), 1.2));
-        const int ticks = 5;
-        for (int i = 0; i <= ticks; ++i) {
-            double t = static_cast<double>(i) / ticks;
-            double y = rect.top() + rect.height() * t;
-            double value = labelMax - t * (labelMax - labelMin);
-            p.drawText(QRectF(4, y - 10, leftMargin - 12, 20), Qt::AlignRight | Qt::AlignVCenter,
-                       QString::number(value, 'f', 2) + " V");
-        }
-
-        if (visible.isEmpty()) {
-            p.setPen(QPen(QColor("#8e8e93"), 1.2));
-            p.drawText(rect, Qt::AlignCenter, QStringLiteral("等待波形数据..."));
-            return;
-        }
-
-        const double minVal = *std::min_element(visible.begin(), visible.end());
-        const double maxVal = *std::max_element(visible.begin(), visible.end());
-        const double span = std::max(1e-9, maxVal - minVal);
-
-        p.setPen(QPen(QColor("#007aff"), 2));
-
-        const int n = visible.size();
-        for (int i = 0; i < n - 1; ++i) {
-            const double t0 = static_cast<double>(i) / (n - 1);
-            const double t1 = static_cast<double>(i + 1) / (n - 1);
-            const double v0 = (visible[i] - minVal) / span;
-            const double v1 = (visible[i + 1] - minVal) / span;
-            QPointF p0(rect.left() + t0 * rect.width(),
-                       rect.bottom() - v0 * rect.height());
-            QPointF p1(rect.left() + t1 * rect.width(),
-                       rect.bottom() - v1 * rect.height());
-            p.drawLine(p0, p1);
-        }
-    }
-
-private:
-    QVector<double> visibleValues() const
-    {
-        // 计算当前时基下需要展示的样本数
-        const double totalTimeSec = (m_timeBaseMs / 1000.0) * 10.0; // 10 div
-        const int samples = static_cast<int>(totalTimeSec * m_sampleRate);
-        if (samples <= 0 || m_values.isEmpty()) return {};
-        // 仅截取尾部窗口，避免全量渲染过多数据
-        const int start = std::max(0, m_values.size() - samples);
-        return m_values.mid(start);
-    }
-
-    void computeStats()
-    {
-        // 只对当前可见的数据窗口做统计，避免超大数据影响实时性
-        QVector<double> values = visibleValues();
-        m_stats = Stats();
-        if (values.isEmpty()) {
-            return;
-        }
-        const int n = values.size(); // 当前可见采样点数
-        m_stats.samples = n;
-        double minV = values.first(); // 初始最小值
-        double maxV = values.first();
-        double sum = 0; // 求和用于均值
-        double sumSq = 0;
-        for (double v : values) {
-            minV = std::min(minV, v);
-            maxV = std::max(maxV, v);
-            sum += v;
-            sumSq += v * v;
-        }
-        m_stats.min = minV;
-        m_stats.max = maxV;
-        m_stats.peakToPeak = maxV - minV;
-        m_stats.mean = sum / n;
-        m_stats.rms = std::sqrt(sumSq / n); // 均方根
-
-        const double dt = 1.0 / m_sampleRate; // 采样周期
-        // Zero-crossing for period/freq（均值作为阈值）
-        double lastCross = -1; // 上一次零交叉时间
-        QVector<double> periods; // 周期集合
-        for (int i = 1; i < n; ++i) {
-            const double v0 = values[i - 1] - m_stats.mean;
-            const double v1 = values[i] - m_stats.mean;
-            if ((v0 <= 0 && v1 > 0) || (v0 >= 0 && v1 < 0)) {
-                double frac = std::abs(v0 - v1) > 1e-9 ? std::abs(v0) / std::abs(v0 - v1) : 0.0;
-                double t = (i - 1 + frac) * dt;
-                if (lastCross >= 0) {
-                    periods.append(t - lastCross);
-                }
-                lastCross = t;
-            }
-        }
-        if (!periods.isEmpty()) {
-            double avg = 0;
-            for (double pVal : periods) avg += pVal;
-            avg /= periods.size();
-            m_stats.period = avg;
-            m_stats.freq = (avg > 0) ? 1.0 / avg : 0;
-            m_stats.hasPeriod = true;
-        }
-
-        // Rise/fall/pulse/duty (simple threshold method，使用 10%/90% 阈值)
-        const double highThresh = m_stats.min + 0.9 * (m_stats.peakToPeak);
-        const double lowThresh = m_stats.min + 0.1 * (m_stats.peakToPeak);
-        int firstLow = -1, firstHigh = -1;
-        double riseStart = -1, riseEnd = -1, fallStart = -1, fallEnd = -1;
-        QVector<double> highDurations; // 高电平持续时间
-        QVector<double> risingEdges;   // 上升沿时间点
-        double currentHighStart = -1;  // 当前高电平开始时间
-        for (int i = 1; i < n; ++i) {
-            double prev = values[i - 1];
-            double curr = values[i];
-            double t = i * dt;
-            if (prev < lowThresh && curr >= lowThresh && firstLow < 0) {
-                firstLow = i;
-            }
-            if (prev < highThresh && curr >= highThresh) {
-                risingEdges.append(t);
-                if (riseStart < 0) riseStart = (i - 1) * dt;
-                riseEnd = t;
-                currentHighStart = t;
-            }
-            if (prev > highThresh && curr <= highThresh) {
-                fallStart = (i - 1) * dt;
-                fallEnd = t;
-                if (currentHighStart >= 0) {
-                    highDurations.append(t - currentHighStart);
-                }
-                currentHighStart = -1;
-            }
-            if (prev < highThresh && curr >= highThresh && firstHigh < 0) {
-                firstHigh = i;
-            }
-        }
-        if (riseStart >= 0 && riseEnd >= 0) m_stats.riseTime = riseEnd - riseStart;
-        if (fallStart >= 0 && fallEnd >= 0) m_stats.fallTime = fallEnd - fallStart;
-
-        // Refine period using rising edges if available
-        if (risingEdges.size() >= 2) {
-            QVector<double> risePeriods;
-            for (int i = 1; i < risingEdges.size(); ++i) {
-                risePeriods.append(risingEdges[i] - risingEdges[i - 1]);
-            }
-            double sumP = 0;
-            for (double pVal : risePeriods) sumP += pVal;
-            double avg = sumP / risePeriods.size();
-            if (avg > 0) {
-                m_stats.period = avg;
-                m_stats.freq = 1.0 / avg;
-                m_stats.hasPeriod = true;
-            }
-        }
-
-        if (!highDurations.isEmpty()) {
-            double sumHigh = 0;
-            for (double d : highDurations) sumHigh += d;
-            double avgHigh = sumHigh / highDurations.size();
-            m_stats.pulseWidth = avgHigh;
-            if (m_stats.hasPeriod && m_stats.period > 0) {
-                m_stats.duty = std::min(100.0, std::max(0.0, (avgHigh / m_stats.period) * 100.0));
-            }
-        }
-    }
-
-    QVector<double> m_values;
-    Stats m_stats;
-    double m_sampleRate = 1000.0;
-    double m_timeBaseMs = 50.0;
-    double m_gain = 1.0;
-    double m_vMin = 0.0;
-    double m_vMax = 3.3;
-};
+#ifdef Q_OS_WIN
+#include <qt_windows.h>
+#include <dbt.h>
+#endif
 
 namespace {
 const char *kSettingsGroup = "MainWindow";
+const int kReconnectRetryMs = 50;
+const qint64 kReconnectWindowNs = 3000 * 1000000LL;   // 对同一端口名连续重试的时长，之后只等热插拔通知
 }
 
 MainWindow::MainWindow(QWidget *parent)
@@ -279,7 +56,10 @@ MainWindow::MainWindow(QWidget *parent)
     , m_settings("uartdebuger", "uartdebuger")
 {
     ui->setupUi(this);
+    m_scopeValues.reset(new SampleRing(m_scopeMaxSamples));
     m_scopeWidget = new OscilloscopeWidget(this);
+    // 大窗口的测量由后台线程送回，送达后刷新测量标签
+    m_scopeWidget->setStatsListener([this]() { updateScopeLabels(); });
     if (QLayout *lay = ui->scopePlotContainer->layout()) {
         lay->addWidget(m_scopeWidget);
         if (QWidget *placeholder = ui->scopePlaceholderLabel) {
@@ -292,18 +72,34 @@ MainWindow::MainWindow(QWidget *parent)
 
     updatePortList(true);
     applySettings();
+    updatePayloadFormat();
     setConnected(false);
 
-    m_portRefreshTimer.setInterval(2500);
-    connect(&m_portRefreshTimer, &QTimer::timeout, this, [this]() { updatePortList(); });
-    m_portRefreshTimer.start();
+    m_portWatcher.start(m_lastPorts, this, [this](const PortWatcher::Change &change) { applyPortChange(change); });
+    m_reconnectTimer.setInterval(kReconnectRetryMs);
+    connect(&m_reconnectTimer, &QTimer::timeout, this, [this]() {
+        if (m_reconnectCandidate.isEmpty()) return;
+        if (NativePort::nowNanos() > m_reconnectDeadlineNs) {
+            m_reconnectCandidate.clear();
+            return;
+        }
+        tryReconnect(m_reconnectCandidate);
+    });
 
+    applyScopeTriggerConfig();
+    applyScopeAverageConfig();
     refreshScopeView();
+    updateScopeGate();
 }
 
 MainWindow::~MainWindow()
 {
     persistSettings();
+    stopPortWorkers();
+    m_alertMonitor.stop();
+    m_portWatcher.stop();
+    m_baudDetector.stop();
+    if (m_sessionWindow) m_sessionWindow->closeAll();
     m_serial.close();
     delete ui;
 }
@@ -345,9 +141,51 @@ void MainWindow::initUi()
     ui->newlineComboBox->addItem(QStringLiteral("LF (\\n)"), "\n");
     ui->newlineComboBox->addItem(QStringLiteral("CRLF (\\r\\n)"), "\r\n");
 
+    // 示波器滤波类型
+    ui->scopeFilterComboBox->addItem(QStringLiteral("关闭"), ScopeFilter::None);
+    ui->scopeFilterComboBox->addItem(QStringLiteral("滑动平均"), ScopeFilter::MovingAverage);
+    ui->scopeFilterComboBox->addItem(QStringLiteral("FIR 低通"), ScopeFilter::FirLowPass);
+    ui->scopeFilterComboBox->addItem(QStringLiteral("FIR 高通"), ScopeFilter::FirHighPass);
+    ui->scopeFilterComboBox->addItem(QStringLiteral("FIR 带通"), ScopeFilter::FirBandPass);
+    ui->scopeFilterComboBox->addItem(QStringLiteral("IIR 低通"), ScopeFilter::IirLowPass);
+    ui->scopeFilterComboBox->addItem(QStringLiteral("IIR 高通"), ScopeFilter::IirHighPass);
+    ui->scopeFilterComboBox->addItem(QStringLiteral("IIR 带通"), ScopeFilter::IirBandPass);
+
+    ui->scopeTriggerEdgeComboBox->addItem(QStringLiteral("上升沿"), true);
+    ui->scopeTriggerEdgeComboBox->addItem(QStringLiteral("下降沿"), false);
+    ui->scopeAverageModeComboBox->addItem(QStringLiteral("线性平均"), ScopeAverager::RunningMean);
+    ui->scopeAverageModeComboBox->addItem(QStringLiteral("指数平均"), ScopeAverager::Exponential);
+
     ui->receiveTextEdit->setLineWrapMode(QTextEdit::NoWrap);
     ui->sendTextEdit->setLineWrapMode(QTextEdit::NoWrap);
 
+    // 告警：接收区高亮命中，命中时按设置停止自动发送（回调在 GUI 线程执行）
+    m_alertHighlighter = new AlertHighlighter(ui->receiveTextEdit->document());
+    // 分帧解码启用后，序列的 expectFrame 步骤取整帧，示波器取帧载荷样本，文本区每帧一行
+    m_frameDecoder.subscribe([this](const FrameDecoder::Frame &frame) {
+        if (m_sequenceWindow) m_sequenceWindow->feedFrame(frame);
+        if (scopeCodesWanted()) FrameDecoder::appendSamples(frame, m_frameDecoder.config().samples, &m_frameCodes);
+        if (isScopeMode() || m_pauseText) return;
+        const QByteArray payload = QByteArray::fromRawData(frame.data, frame.size);
+        QString line;
+        if (ui->timestampCheckBox->isChecked()) {
+            line += "[" + QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz") + "] ";
+        }
+        line += QStringLiteral("#%1 (%2) ").arg(frame.sequence).arg(frame.size);
+        line += ui->hexDisplayCheckBox->isChecked() ? QString::fromLatin1(payload.toHex(' ').toUpper())
+                                                    : formatAscii(payload);
+        m_frameLines.append(line);
+    });
+    m_alertMonitor.setActionHandler(this, [this](int pattern) {
+        const bool sending = m_autoSendTimer.isActive() || (m_preciseSendWindow && m_preciseSendWindow->isRunning());
+        if (!sending) return;
+        stopAutoSend();
+        if (m_preciseSendWindow) m_preciseSendWindow->stop();
+        const QStringList lines = m_alertMonitor.patternLines();
+        ui->statusbar->showMessage(QStringLiteral("告警命中“%1”，已停止自动发送")
+                                   .arg(pattern < lines.size() ? lines[pattern] : QString()), 5000);
+    });
+
     // 状态栏初始提示
     ui->statusbar->showMessage(QStringLiteral("已就绪"));
 
@@ -368,6 +206,7 @@ void MainWindow::connectSignals()
     // 串口与收发控制
     connect(ui->refreshPortsButton, &QPushButton::clicked, this, &MainWindow::refreshPorts);
     connect(ui->connectButton, &QPushButton::clicked, this, &MainWindow::toggleConnection);
+    connect(ui->autoBaudButton, &QPushButton::clicked, this, &MainWindow::detectBaudRate);
     connect(ui->sendButton, &QPushButton::clicked, this, &MainWindow::sendData);
     connect(ui->clearSendButton, &QPushButton::clicked, this, &MainWindow::clearSend);
     connect(ui->clearReceiveButton, &QPushButton::clicked, this, &MainWindow::clearReceive);
@@ -377,6 +216,11 @@ void MainWindow::connectSignals()
     connect(ui->startAutoSendButton, &QPushButton::clicked, this, &MainWindow::startAutoSend);
     connect(ui->stopAutoSendButton, &QPushButton::clicked, this, &MainWindow::stopAutoSend);
     connect(ui->searchNextButton, &QPushButton::clicked, this, &MainWindow::findNext);
+    // 发送内容或格式变化时使编译缓存失效，下次发送时重新编译
+    connect(ui->sendTextEdit, &QTextEdit::textChanged, this, [this]() { PayloadCache::invalidate(m_sendPayload); });
+    connect(ui->hexSendCheckBox, &QCheckBox::toggled, this, [this]() { PayloadCache::invalidate(m_sendPayload); });
+    connect(ui->encodingComboBox, static_cast<void(QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, &MainWindow::updatePayloadFormat);
+    connect(ui->newlineComboBox, static_cast<void(QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, &MainWindow::updatePayloadFormat);
 
     // 命令库
     connect(ui->addCommandButton, &QPushButton::clicked, this, &MainWindow::addCommand);
@@ -389,16 +233,63 @@ void MainWindow::connectSignals()
 
     // 示波器与帮助
     connect(ui->receiveTabWidget, &QTabWidget::currentChanged, this, &MainWindow::handleScopeSettingChanged);
+    connect(ui->receiveTabWidget, &QTabWidget::currentChanged, this, &MainWindow::updateScopeGate);
     connect(ui->scopeBitsSpinBox, static_cast<void(QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &MainWindow::handleScopeSettingChanged);
     connect(ui->scopeVMinSpinBox, static_cast<void(QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged), this, &MainWindow::handleScopeSettingChanged);
     connect(ui->scopeVMaxSpinBox, static_cast<void(QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged), this, &MainWindow::handleScopeSettingChanged);
     connect(ui->scopeSampleRateSpinBox, static_cast<void(QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged), this, &MainWindow::handleScopeSettingChanged);
     connect(ui->scopeTimeBaseSpinBox, static_cast<void(QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged), this, &MainWindow::handleScopeSettingChanged);
     connect(ui->scopeGainSpinBox, static_cast<void(QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged), this, &MainWindow::handleScopeSettingChanged);
+    connect(ui->scopeSampleRateSpinBox, static_cast<void(QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged), this, &MainWindow::handleScopeFilterChanged);
+    connect(ui->scopeFilterComboBox, static_cast<void(QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, &MainWindow::handleScopeFilterChanged);
+    connect(ui->scopeFilterLowSpinBox, static_cast<void(QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged), this, &MainWindow::handleScopeFilterChanged);
+    connect(ui->scopeFilterHighSpinBox, static_cast<void(QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged), this, &MainWindow::handleScopeFilterChanged);
+    connect(ui->scopeFilterTapsSpinBox, static_cast<void(QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &MainWindow::handleScopeFilterChanged);
+    connect(ui->scopeShowRawCheckBox, &QCheckBox::toggled, this, &MainWindow::handleScopeSettingChanged);
+    connect(ui->scopeDepthSpinBox, static_cast<void(QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, [this](int depth) {
+        m_scopeMaxSamples = depth;
+        // 按新深度重新分配并保留最新的样本，放大时等新数据填满；旧缓冲由仍在读取的后台线程最后释放
+        m_scopeValues = m_scopeValues->withDepth(depth);
+        if (m_scopeFilteredValues) m_scopeFilteredValues = m_scopeFilteredValues->withDepth(depth);
+        handleScopeSettingChanged();
+    });
+    connect(ui->scopeSincCheckBox, &QCheckBox::toggled, this, [this](bool checked) {
+        if (m_scopeWidget) m_scopeWidget->setSincInterpolation(checked);
+    });
+    connect(ui->scopeCursorCheckBox, &QCheckBox::toggled, this, [this](bool checked) {
+        if (m_scopeWidget) m_scopeWidget->setCursorsEnabled(checked);
+    });
+    connect(ui->scopeSampleRateSpinBox, static_cast<void(QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged), this, &MainWindow::handleScopeTriggerChanged);
+    connect(ui->scopeTimeBaseSpinBox, static_cast<void(QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged), this, &MainWindow::handleScopeTriggerChanged);
+    connect(ui->scopeTriggerLevelSpinBox, static_cast<void(QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged), this, &MainWindow::handleScopeTriggerChanged);
+    connect(ui->scopeTriggerAutoCheckBox, &QCheckBox::toggled, this, &MainWindow::handleScopeTriggerChanged);
+    connect(ui->scopeTriggerEdgeComboBox, static_cast<void(QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, &MainWindow::handleScopeTriggerChanged);
+    connect(ui->scopePersistenceCheckBox, &QCheckBox::toggled, this, &MainWindow::togglePersistence);
+    connect(ui->scopePersistenceDecaySpinBox, static_cast<void(QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged), this, [this](double value) {
+        if (m_scopeWidget && m_scopeWidget->persistenceEnabled()) m_scopeWidget->setPersistenceDecay(value);
+    });
+    connect(ui->scopeAverageCheckBox, &QCheckBox::toggled, this, &MainWindow::handleScopeAverageChanged);
+    connect(ui->scopeAverageModeComboBox, static_cast<void(QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, &MainWindow::handleScopeAverageChanged);
+    connect(ui->scopeAverageCountSpinBox, static_cast<void(QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &MainWindow::handleScopeAverageChanged);
     connect(ui->autoScopeButton, &QPushButton::clicked, this, &MainWindow::autoScope);
     connect(ui->clearScopeButton, &QPushButton::clicked, this, &MainWindow::clearScope);
     connect(ui->pauseTextCheckBox, &QCheckBox::toggled, this, &MainWindow::togglePauseText);
     connect(ui->pauseScopeCheckBox, &QCheckBox::toggled, this, &MainWindow::togglePauseScope);
+    connect(ui->actionFilterBenchmark, &QAction::triggered, this, &MainWindow::runFilterBenchmark);
+    connect(ui->actionSpectrogram, &QAction::triggered, this, &MainWindow::showSpectrogram);
+    connect(ui->actionFreqTracker, &QAction::triggered, this, &MainWindow::showFreqTracker);
+    connect(ui->actionReferenceCompare, &QAction::triggered, this, &MainWindow::showReferenceCompare);
+    connect(ui->actionMaskTest, &QAction::triggered, this, &MainWindow::showMaskTest);
+    connect(ui->actionLongTermStats, &QAction::triggered, this, &MainWindow::showLongTermStats);
+    connect(ui->actionGlitchDetector, &QAction::triggered, this, &MainWindow::showGlitchDetector);
+    connect(ui->actionOfflineAnalysis, &QAction::triggered, this, &MainWindow::showOfflineAnalysis);
+    connect(ui->actionTrend, &QAction::triggered, this, &MainWindow::showTrend);
+    connect(ui->actionPreciseSend, &QAction::triggered, this, &MainWindow::showPreciseSend);
+    connect(ui->actionSequence, &QAction::triggered, this, &MainWindow::showSequence);
+    connect(ui->actionLinkProbe, &QAction::triggered, this, &MainWindow::showLinkProbe);
+    connect(ui->actionAlerts, &QAction::triggered, this, &MainWindow::showAlerts);
+    connect(ui->actionFrameDecoder, &QAction::triggered, this, &MainWindow::showFrameDecoder);
+    connect(ui->actionSessions, &QAction::triggered, this, &MainWindow::showSessions);
     connect(ui->actionHelpGuide, &QAction::triggered, this, &MainWindow::showHelpGuide);
 
     connect(&m_serial, &QSerialPort::readyRead, this, &MainWindow::handleReadyRead);
@@ -517,6 +408,150 @@ void MainWindow::updatePortList(bool force)
     }
 }
 
+void MainWindow::applyPortChange(const PortWatcher::Change &change)
+{
+    // 正在使用的串口被拔出时不改变当前选择，便于重新插入后直接再打开
+    const QString currentPort = ui->portComboBox->currentData().toString();
+    for (const QString &name : change.removed) {
+        m_lastPorts.removeAll(name);
+        if (name == currentPort && m_serial.isOpen()) continue;
+        const int index = ui->portComboBox->findData(name);
+        if (index >= 0) ui->portComboBox->removeItem(index);
+    }
+    for (const QSerialPortInfo &info : change.added) {
+        if (!m_lastPorts.contains(info.portName())) m_lastPorts << info.portName();
+        QString text = info.portName();
+        if (!info.description().isEmpty()) {
+            text += " (" + info.description() + ")";
+        }
+        const int index = ui->portComboBox->findData(info.portName());
+        if (index >= 0) {
+            ui->portComboBox->setItemText(index, text);
+        } else {
+            ui->portComboBox->addItem(text, info.portName());
+        }
+    }
+    if (ui->portComboBox->currentIndex() < 0 && ui->portComboBox->count() > 0) {
+        ui->portComboBox->setCurrentIndex(0);
+    }
+    if (!m_reconnecting) {
+        return;
+    }
+    if (change.removed.contains(m_reconnectCandidate)) {
+        m_reconnectCandidate.clear();
+    }
+    // 优先原端口名；换了名字时只接受序列号一致或唯一一个 VID/PID 相同的设备，避免接到另一块同型号转接板
+    QString candidate;
+    QStringList sameModel;
+    for (const QSerialPortInfo &info : change.added) {
+        if (!isSameDevice(m_portIdentity, info)) continue;
+        if (info.portName() == m_portIdentity.portName()) {
+            candidate = info.portName();
+            break;
+        }
+        sameModel << info.portName();
+    }
+    if (candidate.isEmpty() && (sameModel.size() == 1 || (!sameModel.isEmpty() && !m_portIdentity.serialNumber().isEmpty()))) {
+        candidate = sameModel.first();
+    }
+    if (!candidate.isEmpty()) {
+        // 设备节点可能稍后才可访问，打不开时由重试定时器继续
+        m_reconnectCandidate = candidate;
+        m_reconnectDeadlineNs = NativePort::nowNanos() + kReconnectWindowNs;
+        tryReconnect(m_reconnectCandidate);
+    }
+}
+
+bool MainWindow::isSameDevice(const QSerialPortInfo &opened, const QSerialPortInfo &candidate)
+{
+    if (!opened.hasVendorIdentifier() || !opened.hasProductIdentifier()) {
+        return opened.portName() == candidate.portName();
+    }
+    return candidate.hasVendorIdentifier() && candidate.hasProductIdentifier()
+            && opened.vendorIdentifier() == candidate.vendorIdentifier()
+            && opened.productIdentifier() == candidate.productIdentifier()
+            && (opened.serialNumber().isEmpty() || opened.serialNumber() == candidate.serialNumber());
+}
+
+void MainWindow::beginReconnect(const QString &reason)
+{
+    m_reconnecting = true;
+    m_gapStartNs = NativePort::nowNanos();
+    m_gapStartTime = QDateTime::currentDateTime();
+    stopAutoSend();
+    stopPortWorkers();
+    m_serial.close();
+    // 先按原端口名快速重试，覆盖复位后节点名不变、热插拔通知尚未送达的情况
+    m_reconnectCandidate = m_serial.portName();
+    m_reconnectDeadlineNs = m_gapStartNs + kReconnectWindowNs;
+    m_reconnectTimer.start();
+    appendReceiveText(QStringLiteral("==== 断线 %1（%2），等待设备重新接入 ====")
+                      .arg(m_gapStartTime.toString("yyyy-MM-dd hh:mm:ss.zzz"), reason));
+    setConnected(false);
+    ui->connectButton->setText(QStringLiteral("停止重连"));
+    ui->connectionStateLabel->setText(QStringLiteral("重连中"));
+    ui->connectionStateLabel->setStyleSheet("color: rgb(230,140,0);");
+    ui->statusbar->showMessage(QStringLiteral("串口断开，等待设备重新接入"));
+}
+
+bool MainWindow::tryReconnect(const QString &portName)
+{
+    // 波特率等参数在关闭后仍保存在 m_serial 中，open() 时重新应用
+    m_serial.setPortName(portName);
+    if (!m_serial.open(QIODevice::ReadWrite)) {
+        return false;
+    }
+    const qint64 gapNs = NativePort::nowNanos() - m_gapStartNs;
+    m_reconnecting = false;
+    m_reconnectTimer.stop();
+    m_reconnectCandidate.clear();
+    ++m_reconnectCount;
+    // 断线前未完成的帧与数字不能和重连后的数据拼接，逐样本的状态也不能跨越断点；
+    // 样本序号保持连续，断点作为事件记录在毛刺列表中，可点击定位
+    m_frameDecoder.reset();
+    m_scopePending.clear();
+    m_scopeFilter.reset();
+    m_scopeTrigger.reset();
+    m_scopeAverager.reset();
+    m_referenceChecker.restartAlignment();
+    m_glitchDetector.markLinkGap(m_scopeSampleCount, gapNs / 1e9, m_gapStartTime.toMSecsSinceEpoch());
+    appendReceiveText(QStringLiteral("==== 已重连 %1 %2，断线 %3 s ====")
+                      .arg(portName, QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz"))
+                      .arg(gapNs / 1e9, 0, 'f', 3));
+    const int index = ui->portComboBox->findData(portName);
+    if (index >= 0) {
+        ui->portComboBox->setCurrentIndex(index);
+    }
+    setConnected(true);
+    ui->connectionStateLabel->setText(QStringLiteral("已连接（重连 %1 次）").arg(m_reconnectCount));
+    setLastError(QStringLiteral("已自动重连，断线 %1 s").arg(gapNs / 1e9, 0, 'f', 3));
+    return true;
+}
+
+void MainWindow::cancelReconnect()
+{
+    m_reconnecting = false;
+    m_reconnectTimer.stop();
+    m_reconnectCandidate.clear();
+    appendReceiveText(QStringLiteral("==== 已停止重连 %1 ====")
+                      .arg(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz")));
+    setConnected(false);
+}
+
+#ifdef Q_OS_WIN
+bool MainWindow::nativeEvent(const QByteArray &eventType, void *message, long *result)
+{
+    // 端口到达/移除与设备树变化的通知会广播给所有顶层窗口，无需注册
+    const MSG *msg = static_cast<const MSG *>(message);
+    if (msg->message == WM_DEVICECHANGE
+            && (msg->wParam == DBT_DEVICEARRIVAL || msg->wParam == DBT_DEVICEREMOVECOMPLETE
+                || msg->wParam == DBT_DEVNODES_CHANGED)) {
+        m_portWatcher.requestRescan();
+    }
+    return QMainWindow::nativeEvent(eventType, message, result);
+}
+#endif
+
 void MainWindow::applySettings()
 {
     // 启动时将持久化的界面/通信参数还原
@@ -532,6 +567,7 @@ void MainWindow::applySettings()
     ui->hexSendCheckBox->setChecked(m_settings.value("hexSend", false).toBool());
     ui->hexDisplayCheckBox->setChecked(m_settings.value("hexDisplay", false).toBool());
     ui->timestampCheckBox->setChecked(m_settings.value("timestamps", false).toBool());
+    ui->autoReconnectCheckBox->setChecked(m_settings.value("autoReconnect", false).toBool());
     ui->bufferSizeSpinBox->setValue(m_settings.value("bufferSize", 0).toInt());
     ui->sendIntervalSpinBox->setValue(m_settings.value("autoInterval", 1000).toInt());
     ui->autoSendCountSpinBox->setValue(m_settings.value("autoCount", 0).toInt());
@@ -543,6 +579,18 @@ void MainWindow::applySettings()
     }
     m_commands = commandsFromSettings();
     reloadCommandList();
+    // 长时间浸泡测试中程序重启后继续记录趋势
+    if (m_settings.value("trendRecording", false).toBool() && m_trendRecorder.open(TrendRecorder::defaultDirectory())) {
+        m_trendRecorder.setEnabled(true);
+    }
+    AlertMonitor::Options alertOptions;
+    alertOptions.ignoreCase = m_settings.value("alertIgnoreCase", false).toBool();
+    alertOptions.snapshot = m_settings.value("alertSnapshot", false).toBool();
+    alertOptions.stopAutoSend = m_settings.value("alertStopAutoSend", false).toBool();
+    QString alertError;
+    if (m_alertMonitor.setPatterns(m_settings.value("alertPatterns").toStringList(), alertOptions, &alertError)) {
+        m_alertHighlighter->setMatcher(m_alertMonitor.matcher());
+    }
     m_settings.endGroup();
 }
 
@@ -562,10 +610,17 @@ void MainWindow::persistSettings()
     m_settings.setValue("hexSend", ui->hexSendCheckBox->isChecked());
     m_settings.setValue("hexDisplay", ui->hexDisplayCheckBox->isChecked());
     m_settings.setValue("timestamps", ui->timestampCheckBox->isChecked());
+    m_settings.setValue("autoReconnect", ui->autoReconnectCheckBox->isChecked());
     m_settings.setValue("bufferSize", ui->bufferSizeSpinBox->value());
     m_settings.setValue("autoInterval", ui->sendIntervalSpinBox->value());
     m_settings.setValue("autoCount", ui->autoSendCountSpinBox->value());
     m_settings.setValue("autoScroll", ui->autoScrollCheckBox->isChecked());
+    m_settings.setValue("trendRecording", m_trendRecorder.isOpen() && m_trendRecorder.isEnabled());
+    const AlertMonitor::Options alertOptions = m_alertMonitor.options();
+    m_settings.setValue("alertPatterns", m_alertMonitor.patternLines());
+    m_settings.setValue("alertIgnoreCase", alertOptions.ignoreCase);
+    m_settings.setValue("alertSnapshot", alertOptions.snapshot);
+    m_settings.setValue("alertStopAutoSend", alertOptions.stopAutoSend);
     saveCommandsToSettings();
     m_settings.endGroup();
 }
@@ -598,9 +653,14 @@ void MainWindow::refreshPorts()
 
 void MainWindow::toggleConnection()
 {
+    if (m_reconnecting) {
+        cancelReconnect();
+        return;
+    }
     if (m_serial.isOpen()) {
         // 已连接则关闭
         stopAutoSend();
+        stopPortWorkers();
         m_serial.close();
         setConnected(false);
         return;
@@ -650,27 +710,88 @@ void MainWindow::toggleConnection()
         return;
     }
 
+    // 记录设备身份供断线后识别；只在打开时枚举一次
+    m_portIdentity = QSerialPortInfo(portName);
+    m_reconnectCount = 0;
     resetStats();
     setConnected(true);
     setLastError("-");
 }
 
+void MainWindow::detectBaudRate()
+{
+    if (m_serial.isOpen() || m_reconnecting) {
+        QMessageBox::warning(this, QStringLiteral("自动识别"), QStringLiteral("请先关闭串口。"));
+        return;
+    }
+    const QString portName = ui->portComboBox->currentData().toString().isEmpty()
+            ? ui->portComboBox->currentText()
+            : ui->portComboBox->currentData().toString();
+    if (portName.isEmpty()) {
+        QMessageBox::warning(this, QStringLiteral("串口"), QStringLiteral("未选择串口。"));
+        return;
+    }
+    // 最常用的 115200 先试，命中即可提前结束
+    QList<qint32> bauds;
+    bauds << 115200;
+    for (int i = 0; i < ui->baudRateComboBox->count(); ++i) {
+        const qint32 baud = ui->baudRateComboBox->itemText(i).toInt();
+        if (baud > 0 && !bauds.contains(baud)) bauds << baud;
+    }
+    ui->autoBaudButton->setEnabled(false);
+    ui->autoBaudButton->setText(QStringLiteral("识别中…"));
+    ui->connectButton->setEnabled(false);
+    ui->statusbar->showMessage(QStringLiteral("正在识别 %1 的波特率，请让设备持续发送数据").arg(portName));
+    m_baudDetector.start(portName, bauds, this, [this](const BaudDetector::Result &result) { applyBaudDetection(result); });
+}
+
+void MainWindow::applyBaudDetection(const BaudDetector::Result &result)
+{
+    ui->autoBaudButton->setEnabled(true);
+    ui->autoBaudButton->setText(QStringLiteral("识别"));
+    ui->connectButton->setEnabled(true);
+    if (!result.ok) {
+        setLastError(result.error);
+        ui->statusbar->showMessage(QStringLiteral("自动识别失败：") + result.error, 5000);
+        return;
+    }
+    ui->baudRateComboBox->setEditText(QString::number(result.baudRate));
+    ui->dataBitsComboBox->setCurrentIndex(ui->dataBitsComboBox->findData(int(result.format.dataBits)));
+    ui->parityComboBox->setCurrentIndex(ui->parityComboBox->findData(int(result.format.parity)));
+    ui->stopBitsComboBox->setCurrentIndex(ui->stopBitsComboBox->findData(int(result.format.stopBits)));
+    ui->flowControlComboBox->setCurrentIndex(ui->flowControlComboBox->findData(int(QSerialPort::NoFlowControl)));
+    toggleConnection();
+    ui->statusbar->showMessage(QStringLiteral("已识别为 %1 %2（%3，得分 %4，%5 个窗口，用时 %6 ms%7）")
+                               .arg(result.baudRate).arg(BaudDetector::formatName(result.format), result.content)
+                               .arg(result.score, 0, 'f', 2).arg(result.windows).arg(result.elapsedMs)
+                               .arg(result.errorCounting ? QString() : QStringLiteral("，无线路错误计数")), 8000);
+}
+
 void MainWindow::handleReadyRead()
 {
-    // 读取串口缓冲中的全部可用数据
+    // 读取串口缓冲中的全部可用数据，时间戳取在读取点
     const QByteArray data = m_serial.readAll();
     if (data.isEmpty()) {
         return;
     }
+    const qint64 readNs = NativePort::nowNanos();
+    // 序列引擎与告警匹配不受文本/示波器暂停影响
+    m_alertMonitor.feed(data, readNs);
+    if (m_sequenceWindow) {
+        m_sequenceWindow->feed(data, readNs);
+    }
     // 更新接收字节计数并显示
     m_rxBytes += data.size();
     ui->rxBytesLabel->setText(QString::number(m_rxBytes));
 
-    if (isScopeMode()) {
-        if (m_pauseScope) {
-            return;
-        }
+    if (m_frameDecoder.isEnabled()) {
+        processFrameData(data, readNs);
+        return;
+    }
+    if (scopeCodesWanted()) {
         processScopeData(data);
+    }
+    if (isScopeMode()) {
         return;
     }
 
@@ -702,6 +823,20 @@ void MainWindow::handleReadyRead()
     }
 }
 
+void MainWindow::processFrameData(const QByteArray &data, qint64 readNs)
+{
+    // 解码器统计不受暂停影响，暂停只决定订阅者是否收集
+    m_frameDecoder.feed(data, readNs);
+    if (!m_frameCodes.isEmpty()) {
+        ingestScopeCodes(m_frameCodes);
+        m_frameCodes.clear();
+    }
+    if (!m_frameLines.isEmpty()) {
+        appendReceiveText(m_frameLines.join('\n'));
+        m_frameLines.clear();
+    }
+}
+
 void MainWindow::handleSerialError(QSerialPort::SerialPortError error)
 {
     // 捕获串口异常；致命错误会强制断开
@@ -709,8 +844,17 @@ void MainWindow::handleSerialError(QSerialPort::SerialPortError error)
         return;
     }
     setLastError(m_serial.errorString());
+    // 重连期间打开失败的错误由重连流程处理
+    if (m_reconnecting) {
+        return;
+    }
     if (error == QSerialPort::ResourceError || error == QSerialPort::PermissionError || error == QSerialPort::DeviceNotFoundError) {
+        if (ui->autoReconnectCheckBox->isChecked() && m_serial.isOpen()) {
+            beginReconnect(m_serial.errorString());
+            return;
+        }
         stopAutoSend();
+        stopPortWorkers();
         QMessageBox::critical(this, QStringLiteral("串口错误"), m_serial.errorString());
         m_serial.close();
         setConnected(false);
@@ -720,15 +864,7 @@ void MainWindow::handleSerialError(QSerialPort::SerialPortError error)
 QByteArray MainWindow::encodeText(const QString &text) const
 {
     // 按当前选择的编码将 Unicode 文本转为字节
-    const QByteArray codecName = ui->encodingComboBox->currentData().toByteArray();
-    if (codecName.isEmpty()) {
-        return text.toLocal8Bit();
-    }
-    QTextCodec *codec = QTextCodec::codecForName(codecName);
-    if (!codec) {
-        return text.toUtf8();
-    }
-    return codec->fromUnicode(text);
+    return PayloadCache::encodeText(text, ui->encodingComboBox->currentData().toByteArray());
 }
 
 QString MainWindow::decodeBytes(const QByteArray &bytes) const
@@ -745,38 +881,21 @@ QString MainWindow::decodeBytes(const QByteArray &bytes) const
     return codec->toUnicode(bytes);
 }
 
-QByteArray MainWindow::buildPayload(bool *ok, QString *error) const
-{
-    // 根据当前发送模式构造 payload：HEX 文本转字节或普通文本按编码转字节
-    *ok = false;
-    QByteArray payload;
-    const QString newline = ui->newlineComboBox->currentData().toString();
-    if (ui->hexSendCheckBox->isChecked()) {
-        QString hex = ui->sendTextEdit->toPlainText();
-        hex.remove(' ');
-        hex.remove('\n');
-        hex.remove('\r');
-        if (hex.length() % 2 != 0) {
-            *error = QStringLiteral("HEX 字符串长度必须为偶数。");
-            return QByteArray();
-        }
-        for (int i = 0; i < hex.length(); i += 2) {
-            bool byteOk = false;
-            int value = hex.mid(i, 2).toInt(&byteOk, 16);
-            if (!byteOk) {
-                *error = QStringLiteral("HEX 内容无效。");
-                return QByteArray();
-            }
-            payload.append(static_cast<char>(value));
-        }
-        payload.append(newline.toUtf8());
-    } else {
-        QString text = ui->sendTextEdit->toPlainText();
-        text.append(newline);
-        payload = encodeText(text);
+QByteArray MainWindow::buildPayload(bool *ok, QString *error)
+{
+    // 发送区内容、HEX 模式、编码与换行都未变化时直接返回上次编译的字节，自动发送每次只剩写串口
+    if (!m_payloadCache.isCurrent(m_sendPayload)) {
+        m_payloadCache.compile(m_sendPayload, ui->sendTextEdit->toPlainText(), ui->hexSendCheckBox->isChecked());
     }
-    *ok = true;
-    return payload;
+    *ok = m_sendPayload.ok;
+    *error = m_sendPayload.error;
+    return m_sendPayload.payload;
+}
+
+void MainWindow::updatePayloadFormat()
+{
+    m_payloadCache.setFormat(ui->encodingComboBox->currentData().toByteArray(),
+                             ui->newlineComboBox->currentData().toString());
 }
 
 void MainWindow::sendData()
@@ -989,15 +1108,48 @@ bool MainWindow::isScopeMode() const
     return ui->receiveTabWidget->currentIndex() == 1;
 }
 
+bool MainWindow::scopeReceiving() const
+{
+    return isScopeMode() && !m_pauseScope;
+}
+
+bool MainWindow::scopeCodesWanted() const
+{
+    return scopeReceiving() || (m_trendRecorder.isOpen() && m_trendRecorder.isEnabled());
+}
+
+void MainWindow::updateScopeGate()
+{
+    const bool open = scopeReceiving();
+    if (open == m_scopeGateOpen) return;
+    m_scopeGateOpen = open;
+    if (!open) {
+        m_scopeGateClosedNs = NativePort::nowNanos();
+        m_scopeGateClosedTime = QDateTime::currentDateTime();
+        m_scopeGateClosedRx = m_rxBytes;
+        return;
+    }
+    if (m_rxBytes == m_scopeGateClosedRx || m_scopeSampleCount == 0) return;
+    // 停止接收期间的数据已丢弃，缺口两侧的样本不连续：与重连一样，未完数字与跨缺口的滤波、
+    // 触发状态作废，参考比对重新对齐，毛刺检测登记断点，避免把缺口误判为失锁、丢样、跳变或断档
+    // 趋势记录开启时数字流一直在解析，未完数字仍然有效
+    if (!m_trendRecorder.isOpen() || !m_trendRecorder.isEnabled()) m_scopePending.clear();
+    m_scopeFilter.reset();
+    m_scopeTrigger.reset();
+    m_referenceChecker.restartAlignment();
+    m_glitchDetector.markLinkGap(m_scopeSampleCount, (NativePort::nowNanos() - m_scopeGateClosedNs) / 1e9,
+                                 m_scopeGateClosedTime.toMSecsSinceEpoch());
+}
+
 void MainWindow::processScopeData(const QByteArray &data)//示波器接收
 {
-    // 按当前配置将串口收到的数字流转换为电压并缓存
-    const double vMin = ui->scopeVMinSpinBox->value();
-    const double vMax = ui->scopeVMaxSpinBox->value();
-    const int bits = ui->scopeBitsSpinBox->value();
-    const double maxCode = std::max(1.0, std::pow(2.0, bits) - 1.0);
-    const double gain = ui->scopeGainSpinBox->value();
+    ingestScopeCodes(parseScopeCodes(data));
+}
 
+QVector<int> MainWindow::parseScopeCodes(const QByteArray &data)
+{
+    // 按当前配置将串口收到的数字流转换为码值
+    QVector<int> rawBlock; // 本次 readyRead 解码出的原始码值
     for (char c : data) {
         // 用空格/逗号/换行等作为分隔符
         if (c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == ',' || c == ';') {
@@ -1005,14 +1157,7 @@ void MainWindow::processScopeData(const QByteArray &data)//示波器接收
                 bool ok = false;
                 int raw = m_scopePending.toInt(&ok, 10);
                 if (ok) {
-                    // 数字映射为电压：0->vMin，满量程->vMax，再乘放大倍数
-                    double clamped = std::max(0.0, std::min(maxCode, static_cast<double>(raw)));
-                    double volt = vMin + (clamped / maxCode) * (vMax - vMin);
-                    volt *= gain;
-                    m_scopeValues.append(volt);
-                    if (m_scopeValues.size() > m_scopeMaxSamples) {
-                        m_scopeValues.remove(0, m_scopeValues.size() - m_scopeMaxSamples);
-                    }
+                    rawBlock.append(raw);
                 }
                 m_scopePending.clear();
             }
@@ -1021,8 +1166,225 @@ void MainWindow::processScopeData(const QByteArray &data)//示波器接收
             m_scopePending.append(QChar(c));
         }
     }
+    return rawBlock;
+}
+
+QVector<double> MainWindow::scopeCodesToVolts(const QVector<int> &rawBlock) const
+{
+    const double vMin = ui->scopeVMinSpinBox->value();
+    const double vMax = ui->scopeVMaxSpinBox->value();
+    const int bits = ui->scopeBitsSpinBox->value();
+    const double maxCode = std::max(1.0, std::pow(2.0, bits) - 1.0);
+    const double gain = ui->scopeGainSpinBox->value();
+
+    QVector<double> block(rawBlock.size()); // 对应的电压样本
+    for (int i = 0; i < rawBlock.size(); ++i) {
+        // 数字映射为电压：0->vMin，满量程->vMax，再乘放大倍数
+        double clamped = std::max(0.0, std::min(maxCode, static_cast<double>(rawBlock[i])));
+        block[i] = (vMin + (clamped / maxCode) * (vMax - vMin)) * gain;
+    }
+    return block;
+}
+
+void MainWindow::ingestScopeCodes(const QVector<int> &rawBlock)
+{
+    // 文本数字流与帧载荷样本都经过这里：趋势记录不受标签页与暂停影响，示波器只在接收时处理
+    const QVector<double> block = scopeCodesToVolts(rawBlock);
+    if (!block.isEmpty()) {
+        // 趋势记录滤波前的电压
+        m_trendRecorder.add(block.constData(), block.size(), QDateTime::currentMSecsSinceEpoch());
+    }
+    if (scopeReceiving()) processScopeCodes(rawBlock, block);
+}
+
+void MainWindow::processScopeCodes(const QVector<int> &rawBlock, QVector<double> block)
+{
+    // 电压样本送入缓冲、检测与显示
+    const double maxCode = std::max(1.0, std::pow(2.0, ui->scopeBitsSpinBox->value()) - 1.0);
+    if (!rawBlock.isEmpty() && m_referenceChecker.state() != ReferenceChecker::Idle) {
+        m_referenceChecker.process(rawBlock.constData(), rawBlock.size());
+    }
+    const qint64 firstIndex = m_scopeSampleCount;
+    m_scopeSampleCount += block.size();
+    if (!block.isEmpty() && m_glitchDetector.isEnabled()) {
+        // 在滤波之前检测，避免毛刺被平滑掉
+        m_glitchDetector.setCounterModulus(static_cast<int>(maxCode) + 1);
+        m_glitchDetector.process(block.constData(), rawBlock.constData(), block.size(), firstIndex,
+                                 QDateTime::currentMSecsSinceEpoch());
+    }
+    if (!block.isEmpty()) {
+        // 环形缓冲只写入本块，最旧的样本按深度自然淘汰
+        m_scopeValues->append(block.constData(), block.size());
+        if (m_scopeFilter.isActive()) {
+            // 整块送入滤波器，延迟线状态在两次 readyRead 之间保持
+            QVector<float> work(block.size());
+            for (int i = 0; i < block.size(); ++i) work[i] = static_cast<float>(block[i]);
+            m_scopeFilter.process(work.constData(), work.data(), work.size());
+            for (int i = 0; i < work.size(); ++i) block[i] = work[i];
+            m_scopeFilteredValues->append(block.constData(), block.size());
+        }
+        dispatchTriggeredFrames(block);
+        if (!qFuzzyCompare(m_freqTracker.config().sampleRate, ui->scopeSampleRateSpinBox->value())) {
+            FreqTracker::Config trackerConfig = m_freqTracker.config();
+            trackerConfig.sampleRate = ui->scopeSampleRateSpinBox->value();
+            m_freqTracker.configure(trackerConfig);
+        }
+        m_freqTracker.push(block.constData(), block.size(), QDateTime::currentMSecsSinceEpoch());
+        if (!qFuzzyCompare(m_stft.config().sampleRate, ui->scopeSampleRateSpinBox->value())) {
+            // 采样率变化后旧历史的时间/频率刻度不再一致，重新开始
+            StftEngine::Config stftConfig = m_stft.config();
+            stftConfig.sampleRate = ui->scopeSampleRateSpinBox->value();
+            m_stft.configure(stftConfig);
+            if (m_spectrogramWindow) m_spectrogramWindow->engineReset();
+        }
+        const int stftRows = m_stft.push(block.constData(), block.size());
+        if (stftRows > 0 && m_spectrogramWindow) m_spectrogramWindow->rowsAdded(stftRows);
+    }
     // 推动波形刷新与测量
     refreshScopeView();
+    if (!block.isEmpty()) recordLongTermStats(block.size());
+}
+
+void MainWindow::applyScopeFilterConfig()
+{
+    ScopeFilter::Config cfg;
+    cfg.type = static_cast<ScopeFilter::Type>(ui->scopeFilterComboBox->currentData().toInt());
+    cfg.sampleRate = ui->scopeSampleRateSpinBox->value();
+    cfg.cutoffLow = ui->scopeFilterLowSpinBox->value();
+    cfg.cutoffHigh = ui->scopeFilterHighSpinBox->value();
+    cfg.taps = ui->scopeFilterTapsSpinBox->value();
+    m_scopeFilter.configure(cfg);
+
+    if (!m_scopeFilter.isActive()) {
+        m_scopeFilteredValues.reset();
+        return;
+    }
+    // 已缓存的原始数据分段重新滤波到新的缓冲，之后新数据沿用滤波器状态继续处理；
+    // 不原地改写，后台线程可能仍在读取旧的滤波结果
+    const int kChunk = 1 << 16;
+    QSharedPointer<SampleRing> filtered(new SampleRing(m_scopeMaxSamples, m_scopeValues->begin()));
+    QVector<float> work;
+    QVector<double> out;
+    for (qint64 first = m_scopeValues->begin(); first < m_scopeValues->end(); first += kChunk) {
+        const int n = static_cast<int>(std::min<qint64>(kChunk, m_scopeValues->end() - first));
+        const SampleRing::Span raw = m_scopeValues->span(first, n);
+        work.resize(n);
+        out.resize(n);
+        for (int i = 0; i < n; ++i) work[i] = static_cast<float>(raw[i]);
+        m_scopeFilter.process(work.constData(), work.data(), n);
+        std::copy(work.constBegin(), work.constEnd(), out.begin());
+        filtered->append(out.constData(), n);
+    }
+    m_scopeFilteredValues = filtered;
+}
+
+void MainWindow::applyScopeTriggerConfig()
+{
+    // 一帧对应屏幕上的 10 格，触发点放在第 1 格
+    ScopeTrigger::Config cfg;
+    const double windowSec = ui->scopeTimeBaseSpinBox->value() / 1000.0 * 10.0;
+    cfg.frameLength = std::min(1000000, std::max(16, static_cast<int>(windowSec * ui->scopeSampleRateSpinBox->value())));
+    cfg.preTrigger = cfg.frameLength / 10;
+    cfg.autoLevel = ui->scopeTriggerAutoCheckBox->isChecked();
+    cfg.level = ui->scopeTriggerLevelSpinBox->value();
+    cfg.rising = ui->scopeTriggerEdgeComboBox->currentData().toBool();
+    m_scopeTrigger.configure(cfg);
+    ui->scopeTriggerLevelSpinBox->setEnabled(!cfg.autoLevel);
+}
+
+void MainWindow::dispatchTriggeredFrames(const QVector<double> &block)
+{
+    // 仅在有消费者时才做触发检测
+    const bool averaging = ui->scopeAverageCheckBox->isChecked();
+    const bool masking = m_scopeMask.isEnabled();
+    if (!m_scopeWidget || (!m_scopeWidget->persistenceEnabled() && !averaging && !masking)) {
+        return;
+    }
+    QVector<float> frames;
+    const int count = m_scopeTrigger.process(block.constData(), block.size(), frames);
+    if (count == 0) return;
+    if (m_scopeWidget->persistenceEnabled()) {
+        m_scopeWidget->addPersistenceFrames(frames, m_scopeTrigger.config().frameLength);
+    }
+    if (averaging) {
+        m_scopeAverager.addFrames(frames.constData(), count);
+    }
+    if (masking) {
+        m_scopeMask.testFrames(frames.constData(), count, m_scopeTrigger.config().frameLength,
+                               QDateTime::currentMSecsSinceEpoch());
+    }
+}
+
+void MainWindow::recordLongTermStats(int newSamples)
+{
+    // 测量取实时数据的末尾，与屏幕显示的是回看窗口还是平均帧无关；测量的正是这一屏新到的样本
+    const int window = std::max(1, static_cast<int>(ui->scopeTimeBaseSpinBox->value() / 1000.0 * 10.0
+                                                    * ui->scopeSampleRateSpinBox->value()));
+    const qint64 interval = m_longTermStats.advance(newSamples, window);
+    const SampleRing &history = m_scopeFilter.isActive() ? *m_scopeFilteredValues : *m_scopeValues;
+    const int count = static_cast<int>(std::min<qint64>(interval, history.size()));
+    if (count <= 0) return;
+    const ScopeMeasure::Result s = ScopeMeasure::measure(history.span(history.end() - count, count),
+                                                         ui->scopeSampleRateSpinBox->value());
+    m_longTermStats.add(ScopeLongTermStats::PeakToPeak, s.peakToPeak);
+    m_longTermStats.add(ScopeLongTermStats::Rms, s.rms);
+    m_longTermStats.add(ScopeLongTermStats::Mean, s.mean);
+    // 与测量标签一致：正弦拟合锁定时取拟合频率
+    if (m_freqTracker.locked()) {
+        m_longTermStats.add(ScopeLongTermStats::Frequency, m_freqTracker.current().frequency);
+    } else if (s.hasPeriod && s.freq > 0) {
+        m_longTermStats.add(ScopeLongTermStats::Frequency, s.freq);
+    }
+    if (s.duty > 0) m_longTermStats.add(ScopeLongTermStats::Duty, s.duty);
+    if (s.riseTime > 0) m_longTermStats.add(ScopeLongTermStats::RiseTime, s.riseTime);
+    if (s.fallTime > 0) m_longTermStats.add(ScopeLongTermStats::FallTime, s.fallTime);
+    if (s.pulseWidth > 0) m_longTermStats.add(ScopeLongTermStats::PulseWidth, s.pulseWidth);
+}
+
+QVector<float> MainWindow::maskTemplateFromCapture() const
+{
+    if (ui->scopeAverageCheckBox->isChecked() && m_scopeAverager.framesAveraged() > 0
+            && m_scopeAverager.frameLength() == m_scopeTrigger.config().frameLength) {
+        return m_scopeAverager.average();
+    }
+    const SampleRing &history = m_scopeFilter.isActive() ? *m_scopeFilteredValues : *m_scopeValues;
+    const QVector<double> values = history.toVector(history.begin(), history.size());
+    ScopeTrigger trigger;
+    trigger.configure(m_scopeTrigger.config());
+    QVector<float> frames;
+    const int count = trigger.process(values.constData(), values.size(), frames);
+    const int length = trigger.config().frameLength;
+    if (count == 0) return QVector<float>();
+    return frames.mid((count - 1) * length, length);
+}
+
+QVector<float> MainWindow::maskTemplateFromTable() const
+{
+    // 已在参考比对中加载查找表时沿用，否则使用 sine_wave.m 的默认表
+    const QVector<int> table = m_referenceChecker.table().isEmpty() ? ReferenceChecker::matlabSineTable()
+                                                                    : m_referenceChecker.table();
+    const double vMin = ui->scopeVMinSpinBox->value();
+    const double vMax = ui->scopeVMaxSpinBox->value();
+    const double maxCode = std::max(1.0, std::pow(2.0, ui->scopeBitsSpinBox->value()) - 1.0);
+    const double gain = ui->scopeGainSpinBox->value();
+    QVector<float> period(table.size());
+    float lo = 0, hi = 0;
+    for (int i = 0; i < table.size(); ++i) {
+        // 与 processScopeData 相同的码值到电压映射
+        const double clamped = std::max(0.0, std::min(maxCode, static_cast<double>(table[i])));
+        period[i] = static_cast<float>((vMin + clamped / maxCode * (vMax - vMin)) * gain);
+        lo = i == 0 ? period[i] : std::min(lo, period[i]);
+        hi = i == 0 ? period[i] : std::max(hi, period[i]);
+    }
+    const ScopeTrigger::Config &cfg = m_scopeTrigger.config();
+    const double level = cfg.autoLevel ? 0.5 * (lo + hi) : cfg.level;
+    return ScopeMask::alignPeriodic(period, cfg.frameLength, cfg.preTrigger, level, cfg.rising);
+}
+
+void MainWindow::applyScopeAverageConfig()
+{
+    const auto mode = static_cast<ScopeAverager::Mode>(ui->scopeAverageModeComboBox->currentData().toInt());
+    m_scopeAverager.configure(mode, ui->scopeAverageCountSpinBox->value(), m_scopeTrigger.config().frameLength);
 }
 
 void MainWindow::refreshScopeView()
@@ -1033,10 +1395,73 @@ void MainWindow::refreshScopeView()
                              ui->scopeGainSpinBox->value(),
                              ui->scopeVMinSpinBox->value(),
                              ui->scopeVMaxSpinBox->value());
-    m_scopeWidget->setValues(m_scopeValues);
+    // 余辉纵轴固定为满量程映射后的电压范围
+    m_scopeWidget->setPersistenceRange(ui->scopeVMinSpinBox->value() * ui->scopeGainSpinBox->value(),
+                                       ui->scopeVMaxSpinBox->value() * ui->scopeGainSpinBox->value());
+    if (ui->scopeAverageCheckBox->isChecked() && m_scopeAverager.framesAveraged() > 0) {
+        // 平均模式：显示并测量平均后的触发帧
+        const QVector<float> &avg = m_scopeAverager.average();
+        QVector<double> values(avg.size());
+        std::copy(avg.constBegin(), avg.constEnd(), values.begin());
+        m_scopeWidget->setOverlayValues(QSharedPointer<const SampleRing>());
+        m_scopeWidget->setValues(values);
+        m_scopeWidget->setCaption(QStringLiteral("平均 %1/%2 帧").arg(m_scopeAverager.framesAveraged())
+                                  .arg(m_scopeAverager.count()));
+        m_scopeWidget->setViewOffset(0);
+        m_scopeWidget->setMarkerIndex(-1);
+        updateScopeLabels();
+        return;
+    }
+    m_scopeWidget->setCaption(ui->scopeAverageCheckBox->isChecked() ? QStringLiteral("平均：等待触发") : QString());
+    if (m_scopeFilter.isActive()) {
+        // 测量基于滤波后的波形，原始波形按需叠加显示
+        // 原始波形按滤波器群延迟后移，按绝对样本序号与滤波结果对齐，原始缓冲较短时也以最新样本为准（IIR 群延迟随频率变化，不做补偿）
+        m_scopeWidget->setOverlayValues(ui->scopeShowRawCheckBox->isChecked() ? m_scopeValues
+                                                                              : QSharedPointer<SampleRing>(),
+                                        m_scopeFilter.groupDelay());
+        m_scopeWidget->setValues(m_scopeFilteredValues);
+    } else {
+        m_scopeWidget->setOverlayValues(QSharedPointer<const SampleRing>());
+        m_scopeWidget->setValues(m_scopeValues);
+    }
+    applyScopeViewPosition();
     updateScopeLabels();
 }
 
+void MainWindow::applyScopeViewPosition()
+{
+    if (m_scopeJumpIndex < 0) {
+        m_scopeWidget->setViewOffset(0);
+        m_scopeWidget->setMarkerIndex(-1);
+        return;
+    }
+    const qint64 historyStart = m_scopeValues->begin();
+    const qint64 pos = m_scopeJumpIndex - historyStart;
+    if (pos < 0 || pos >= m_scopeValues->size()) {
+        // 定位点已被新数据挤出缓存，自动回到实时
+        m_scopeJumpIndex = -1;
+        m_scopeWidget->setViewOffset(0);
+        m_scopeWidget->setMarkerIndex(-1);
+        ui->statusbar->showMessage(QStringLiteral("回看位置已超出缓存，返回实时显示"), 2000);
+        return;
+    }
+    // 定位点放在屏幕中央
+    const int window = static_cast<int>(ui->scopeTimeBaseSpinBox->value() / 1000.0 * 10.0
+                                        * ui->scopeSampleRateSpinBox->value());
+    m_scopeWidget->setViewOffset(static_cast<int>(m_scopeValues->size() - pos - window / 2));
+    m_scopeWidget->setMarkerIndex(static_cast<int>(pos));
+    m_scopeWidget->setCaption(QStringLiteral("回看 #%1").arg(m_scopeJumpIndex));
+}
+
+bool MainWindow::jumpScopeToSample(qint64 index)
+{
+    if (index < m_scopeValues->begin() || index >= m_scopeSampleCount) return false;
+    m_scopeJumpIndex = index;
+    ui->receiveTabWidget->setCurrentIndex(1);
+    refreshScopeView();
+    return true;
+}
+
 void MainWindow::updateScopeLabels()
 {
     if (!m_scopeWidget) return;
@@ -1061,8 +1486,16 @@ void MainWindow::updateScopeLabels()
     ui->scopePkPkLabel->setText(fmt(s.peakToPeak, " V"));
     ui->scopeRmsLabel->setText(fmt(s.rms, " V"));
     ui->scopeDcLabel->setText(fmt(s.mean, " V"));
-    ui->scopePeriodLabel->setText(s.hasPeriod ? fmt(s.period * 1000.0, " ms", 3) : "-");
-    ui->scopeFreqLabel->setText(s.hasPeriod && s.freq > 0 ? fmt(s.freq, " Hz", 3) : "-");
+    if (m_freqTracker.locked()) {
+        // 正弦拟合锁定时优先显示高精度结果，保留到约 1 ppm 的有效位
+        const double f = m_freqTracker.current().frequency;
+        const int prec = std::max(3, 6 - static_cast<int>(std::floor(std::log10(f))));
+        ui->scopePeriodLabel->setText(fmt(1000.0 / f, " ms", prec + 1));
+        ui->scopeFreqLabel->setText(fmt(f, " Hz", prec));
+    } else {
+        ui->scopePeriodLabel->setText(s.hasPeriod ? fmt(s.period * 1000.0, " ms", 3) : "-");
+        ui->scopeFreqLabel->setText(s.hasPeriod && s.freq > 0 ? fmt(s.freq, " Hz", 3) : "-");
+    }
     ui->scopeRiseLabel->setText(s.riseTime > 0 ? fmt(s.riseTime * 1000.0, " ms", 3) : "-");
     ui->scopeFallLabel->setText(s.fallTime > 0 ? fmt(s.fallTime * 1000.0, " ms", 3) : "-");
     ui->scopePulseLabel->setText(s.pulseWidth > 0 ? fmt(s.pulseWidth * 1000.0, " ms", 3) : "-");
@@ -1108,6 +1541,7 @@ void MainWindow::editCommand()
     entry.name = newName;
     entry.data = newData;
     entry.hexMode = (hexChoice == QMessageBox::Yes);
+    PayloadCache::invalidate(entry.compiled);
     m_commands[row] = entry;
     reloadCommandList();
 }
@@ -1204,8 +1638,17 @@ void MainWindow::commandDoubleClicked(QListWidgetItem *item)
 
 void MainWindow::clearScope()
 {
-    m_scopeValues.clear();
+    m_scopeValues->clear();
+    if (m_scopeFilteredValues) m_scopeFilteredValues->clear();
+    m_scopeFilter.reset();
+    m_scopeTrigger.reset();
+    m_scopeAverager.reset();
     m_scopePending.clear();
+    m_scopeJumpIndex = -1;
+    if (m_scopeWidget) m_scopeWidget->clearPersistence();
+    m_stft.reset();
+    if (m_spectrogramWindow) m_spectrogramWindow->engineReset();
+    m_freqTracker.resetWindow();
     refreshScopeView();
 }
 
@@ -1216,40 +1659,335 @@ void MainWindow::handleScopeSettingChanged()
     }
 }
 
+void MainWindow::handleScopeFilterChanged()
+{
+    applyScopeFilterConfig();
+    handleScopeSettingChanged();
+}
+
+void MainWindow::handleScopeTriggerChanged()
+{
+    applyScopeTriggerConfig();
+    applyScopeAverageConfig();
+    // 帧长或触发条件变化后旧的余辉不再可比
+    if (m_scopeWidget) m_scopeWidget->clearPersistence();
+}
+
+void MainWindow::handleScopeAverageChanged()
+{
+    applyScopeAverageConfig();
+    handleScopeSettingChanged();
+}
+
+void MainWindow::togglePersistence(bool checked)
+{
+    if (!m_scopeWidget) return;
+    m_scopeTrigger.reset();
+    m_scopeWidget->setPersistenceEnabled(checked);
+    if (checked) {
+        m_scopeWidget->setPersistenceDecay(ui->scopePersistenceDecaySpinBox->value());
+    }
+    refreshScopeView();
+}
+
+void MainWindow::runFilterBenchmark()
+{
+    // 以合成信号测试不同抽头数下 FIR 的吞吐量
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    QString report = QStringLiteral("FIR 滤波吞吐量（块大小 1024）：\n");
+    const int taps[] = {15, 31, 63, 127, 255, 511};
+    for (int t : taps) {
+        const double rate = ScopeFilter::benchmark(t, 4000000);
+        report += QStringLiteral("%1 抽头：%2 M 样本/秒\n").arg(t).arg(rate / 1e6, 0, 'f', 2);
+    }
+    QApplication::restoreOverrideCursor();
+    QMessageBox::information(this, QStringLiteral("滤波器性能测试"), report);
+}
+
+void MainWindow::showSpectrogram()
+{
+    // 频谱历史由主窗口持续计算，窗口首次打开时创建，关闭后仅隐藏，保留缩放状态
+    if (!m_spectrogramWindow) {
+        m_spectrogramWindow = new SpectrogramWindow(&m_stft, this);
+    }
+    m_spectrogramWindow->show();
+    m_spectrogramWindow->raise();
+    m_spectrogramWindow->activateWindow();
+}
+
+void MainWindow::showReferenceCompare()
+{
+    if (!m_referenceWindow) {
+        m_referenceWindow = new ReferenceWindow(&m_referenceChecker, this);
+    }
+    m_referenceWindow->show();
+    m_referenceWindow->raise();
+    m_referenceWindow->activateWindow();
+}
+
+void MainWindow::showMaskTest()
+{
+    if (!m_maskWindow) {
+        m_maskWindow = new MaskWindow(&m_scopeMask, this);
+        m_maskWindow->setTemplateProviders([this]() { return maskTemplateFromCapture(); },
+                                           [this]() { return maskTemplateFromTable(); });
+    }
+    m_maskWindow->show();
+    m_maskWindow->raise();
+    m_maskWindow->activateWindow();
+}
+
+void MainWindow::showLongTermStats()
+{
+    if (!m_longTermWindow) {
+        m_longTermWindow = new LongTermWindow(&m_longTermStats, this);
+    }
+    m_longTermWindow->show();
+    m_longTermWindow->raise();
+    m_longTermWindow->activateWindow();
+}
+
+void MainWindow::showGlitchDetector()
+{
+    if (!m_glitchWindow) {
+        m_glitchWindow = new GlitchWindow(&m_glitchDetector, this);
+        m_glitchWindow->setJumpHandlers([this](qint64 index) { return jumpScopeToSample(index); },
+                                        [this]() {
+                                            m_scopeJumpIndex = -1;
+                                            refreshScopeView();
+                                        });
+    }
+    m_glitchWindow->show();
+    m_glitchWindow->raise();
+    m_glitchWindow->activateWindow();
+}
+
+void MainWindow::showOfflineAnalysis()
+{
+    if (!m_offlineWindow) {
+        m_offlineWindow = new OfflineWindow(this);
+        // 每次分析时读取当前设置，文件按与实时接收相同的码值映射与毛刺判据处理
+        m_offlineWindow->setConfigProvider([this]() {
+            CaptureAnalyzer::Config cfg;
+            cfg.vMin = ui->scopeVMinSpinBox->value();
+            cfg.vMax = ui->scopeVMaxSpinBox->value();
+            cfg.bits = ui->scopeBitsSpinBox->value();
+            cfg.gain = ui->scopeGainSpinBox->value();
+            cfg.sampleRate = ui->scopeSampleRateSpinBox->value();
+            cfg.glitch = m_glitchDetector.config();
+            return cfg;
+        });
+    }
+    m_offlineWindow->show();
+    m_offlineWindow->raise();
+    m_offlineWindow->activateWindow();
+}
+
+void MainWindow::showTrend()
+{
+    if (!m_trendWindow) {
+        m_trendWindow = new TrendWindow(&m_trendRecorder, this);
+    }
+    m_trendWindow->show();
+    m_trendWindow->raise();
+    m_trendWindow->activateWindow();
+}
+
+void MainWindow::showPreciseSend()
+{
+    if (!m_preciseSendWindow) {
+        m_preciseSendWindow = new PreciseSendWindow(this);
+        m_preciseSendWindow->setPayloadProvider([this](bool *ok, QString *error) {
+            return buildPayload(ok, error);
+        });
+        m_preciseSendWindow->setPortProvider([this](QSerialPort::Handle *handle) {
+            if (!m_serial.isOpen()) return false;
+            *handle = m_serial.handle();
+            return true;
+        });
+        m_preciseSendWindow->setSentHandler([this](qint64 bytes) {
+            m_txBytes += bytes;
+            ui->txBytesLabel->setText(QString::number(m_txBytes));
+        });
+    }
+    m_preciseSendWindow->show();
+    m_preciseSendWindow->raise();
+    m_preciseSendWindow->activateWindow();
+}
+
+void MainWindow::showSequence()
+{
+    if (!m_sequenceWindow) {
+        m_sequenceWindow = new SequenceWindow(this);
+        m_sequenceWindow->setPortProvider([this](QSerialPort::Handle *handle) {
+            if (!m_serial.isOpen()) return false;
+            *handle = m_serial.handle();
+            return true;
+        });
+        m_sequenceWindow->setCodecProvider([this]() {
+            return ui->encodingComboBox->currentData().toByteArray();
+        });
+        m_sequenceWindow->setSentHandler([this](qint64 bytes) {
+            m_txBytes += bytes;
+            ui->txBytesLabel->setText(QString::number(m_txBytes));
+        });
+    }
+    m_sequenceWindow->show();
+    m_sequenceWindow->raise();
+    m_sequenceWindow->activateWindow();
+}
+
+void MainWindow::showLinkProbe()
+{
+    if (!m_linkProbeWindow) {
+        m_linkProbeWindow = new LinkProbeWindow(this);
+        // 链路测试在自己的线程里打开串口、在读取处打时间戳，RTT 不含 GUI 事件循环的排队；期间本窗口关闭串口
+        m_linkProbeWindow->setPortLender([this](LinkProbe::PortSettings *settings) {
+            if (!m_serial.isOpen()) return false;
+            stopAutoSend();
+            if (m_preciseSendWindow) m_preciseSendWindow->stop();
+            if (m_sequenceWindow) m_sequenceWindow->stop();
+            settings->portName = m_serial.portName();
+            settings->baudRate = m_serial.baudRate();
+            settings->dataBits = m_serial.dataBits();
+            settings->parity = m_serial.parity();
+            settings->stopBits = m_serial.stopBits();
+            settings->flowControl = m_serial.flowControl();
+            m_serial.close();
+            ui->connectButton->setEnabled(false);
+            ui->sendButton->setEnabled(false);
+            ui->sendFileButton->setEnabled(false);
+            ui->startAutoSendButton->setEnabled(false);
+            ui->connectionStateLabel->setText(QStringLiteral("链路测试中"));
+            ui->connectionStateLabel->setStyleSheet("color: rgb(230,140,0);");
+            ui->statusbar->showMessage(QStringLiteral("链路测试占用串口，结束后自动重新打开"));
+            return true;
+        }, [this]() {
+            // 测试期间收到的数据未经本窗口，分帧与样本状态不能跨越这段空白
+            const bool reopened = m_serial.open(QIODevice::ReadWrite);
+            m_frameDecoder.reset();
+            m_scopePending.clear();
+            setConnected(reopened);
+            if (!reopened) ui->statusbar->showMessage(QStringLiteral("链路测试结束后重新打开串口失败：") + m_serial.errorString());
+        });
+        m_linkProbeWindow->setSentHandler([this](qint64 bytes) {
+            m_txBytes += bytes;
+            ui->txBytesLabel->setText(QString::number(m_txBytes));
+        });
+    }
+    m_linkProbeWindow->show();
+    m_linkProbeWindow->raise();
+    m_linkProbeWindow->activateWindow();
+}
+
+void MainWindow::showAlerts()
+{
+    if (!m_alertWindow) {
+        m_alertWindow = new AlertWindow(&m_alertMonitor, this);
+        m_alertWindow->setAppliedHandler([this]() {
+            m_alertHighlighter->setMatcher(m_alertMonitor.matcher());
+        });
+    }
+    m_alertWindow->show();
+    m_alertWindow->raise();
+    m_alertWindow->activateWindow();
+}
+
+void MainWindow::showFrameDecoder()
+{
+    if (!m_frameWindow) {
+        m_frameWindow = new FrameWindow(&m_frameDecoder, this);
+        m_frameWindow->setAppliedHandler([this]() {
+            m_scopePending.clear();
+            m_frameCodes.clear();
+            m_frameLines.clear();
+        });
+    }
+    m_frameWindow->show();
+    m_frameWindow->raise();
+    m_frameWindow->activateWindow();
+}
+
+void MainWindow::showSessions()
+{
+    if (!m_sessionWindow) {
+        m_sessionWindow = new SessionWindow(this);
+        m_sessionWindow->setFrameConfigProvider([this]() { return m_frameDecoder.config(); });
+    }
+    m_sessionWindow->show();
+    m_sessionWindow->raise();
+    m_sessionWindow->activateWindow();
+}
+
+void MainWindow::stopPortWorkers()
+{
+    // 工作线程直接写串口句柄，关闭串口前必须先让其退出
+    if (m_preciseSendWindow) m_preciseSendWindow->stop();
+    if (m_sequenceWindow) m_sequenceWindow->stop();
+    if (m_linkProbeWindow) m_linkProbeWindow->stop();
+}
+
+void MainWindow::showFreqTracker()
+{
+    if (!m_freqTrackerWindow) {
+        m_freqTrackerWindow = new FreqTrackerWindow(&m_freqTracker, this);
+    }
+    m_freqTrackerWindow->show();
+    m_freqTrackerWindow->raise();
+    m_freqTrackerWindow->activateWindow();
+}
+
 void MainWindow::autoScope()
 {
-    if (m_scopeValues.isEmpty() || !m_scopeWidget) {
+    if (m_scopeValues->isEmpty() || !m_scopeWidget) {
         ui->statusbar->showMessage(QStringLiteral("没有波形数据，无法自动调整"), 2000);
         return;
     }
-    refreshScopeView();
-    const auto &s = m_scopeWidget->stats();
-    const double vSpanRaw = s.peakToPeak;
-    double gain = ui->scopeGainSpinBox->value();
-    const double gainMin = ui->scopeGainSpinBox->minimum();
-    const double gainMax = ui->scopeGainSpinBox->maximum();
-    const double desiredSpan = (ui->scopeVMaxSpinBox->value() - ui->scopeVMinSpinBox->value()) * 0.7;
-    if (vSpanRaw > 0.0 && desiredSpan > 0.0) {
-        double targetGain = gain * (desiredSpan / vSpanRaw);
-        targetGain = std::min(std::max(targetGain, gainMin), gainMax);
-        ui->scopeGainSpinBox->setValue(targetGain);
-        gain = targetGain;
+    // 对整段缓存做一次分析，不依赖当前可见窗口是否包含完整周期
+    // 自动设置本就只分析最近 kMaxSamples 个样本，只复制这一段
+    const SampleRing &ring = m_scopeFilter.isActive() ? *m_scopeFilteredValues : *m_scopeValues;
+    const int count = std::min(ring.size(), ScopeAutoset::kMaxSamples);
+    const QVector<double> history = ring.toVector(ring.end() - count, count);
+    const double sampleRate = ui->scopeSampleRateSpinBox->value();
+    const ScopeAutoset::Result r = ScopeAutoset::analyse(history, sampleRate);
+    if (!r.valid) {
+        ui->statusbar->showMessage(QStringLiteral("数据太少，无法自动调整"), 2000);
+        return;
     }
 
-    if (s.hasPeriod && s.period > 0) {
-        double windowSec = s.period * 3.0; // show about 3 periods
-        double timeBaseMs = (windowSec * 1000.0) / 10.0; // per division
-        double clamped = std::min(std::max(timeBaseMs, ui->scopeTimeBaseSpinBox->minimum()), ui->scopeTimeBaseSpinBox->maximum());
-        ui->scopeTimeBaseSpinBox->setValue(clamped);
-    } else if (ui->scopeSampleRateSpinBox->value() > 0 && s.samples > 0) {
-        double windowSec = static_cast<double>(s.samples) / ui->scopeSampleRateSpinBox->value();
-        double timeBaseMs = (windowSec * 1000.0) / 10.0;
-        double clamped = std::min(std::max(timeBaseMs, ui->scopeTimeBaseSpinBox->minimum()), ui->scopeTimeBaseSpinBox->maximum());
-        ui->scopeTimeBaseSpinBox->setValue(clamped);
+    // 放大倍数：稳健峰峰值占满量程的 70%
+    const double gain = ui->scopeGainSpinBox->value();
+    double newGain = gain;
+    const double span = r.high - r.low;
+    const double desiredSpan = (ui->scopeVMaxSpinBox->value() - ui->scopeVMinSpinBox->value()) * 0.7;
+    if (span > 0.0 && desiredSpan > 0.0) {
+        newGain = std::min(std::max(gain * desiredSpan / span, ui->scopeGainSpinBox->minimum()),
+                           ui->scopeGainSpinBox->maximum());
     }
 
+    // 时基：周期信号显示约 3 个周期，否则显示全部缓存
+    const double windowSec = r.periodic ? 3.0 / r.frequency : static_cast<double>(r.samples) / sampleRate;
+    const double timeBaseMs = std::min(std::max(windowSec * 1000.0 / 10.0, ui->scopeTimeBaseSpinBox->minimum()),
+                                       ui->scopeTimeBaseSpinBox->maximum());
+
+    // 触发电平取分位数中点；放大倍数只作用于之后收到的样本，电平按新旧倍数之比换算
+    // 各控件改值时屏蔽信号，避免逐个触发刷新，最后统一应用一次
+    const double level = r.triggerLevel * newGain / gain;
+    {
+        const QSignalBlocker blockGain(ui->scopeGainSpinBox);
+        const QSignalBlocker blockTimeBase(ui->scopeTimeBaseSpinBox);
+        const QSignalBlocker blockLevel(ui->scopeTriggerLevelSpinBox);
+        const QSignalBlocker blockAuto(ui->scopeTriggerAutoCheckBox);
+        ui->scopeGainSpinBox->setValue(newGain);
+        ui->scopeTimeBaseSpinBox->setValue(timeBaseMs);
+        ui->scopeTriggerLevelSpinBox->setValue(level);
+        ui->scopeTriggerAutoCheckBox->setChecked(false);
+    }
+    handleScopeTriggerChanged();
     refreshScopeView();
-    ui->statusbar->showMessage(QStringLiteral("AUTO 已调整波形显示"), 1500);
+    ui->statusbar->showMessage(r.periodic ? QStringLiteral("AUTO：基频 %1 Hz，触发电平 %2 V")
+                                            .arg(r.frequency, 0, 'g', 6).arg(level, 0, 'f', 3)
+                                          : QStringLiteral("AUTO：未检测到周期，显示全部缓存"), 3000);
 }
 
 void MainWindow::togglePauseText(bool checked)
@@ -1265,6 +2003,7 @@ void MainWindow::togglePauseText(bool checked)
 void MainWindow::togglePauseScope(bool checked)
 {
     m_pauseScope = checked;
+    updateScopeGate();
     if (checked) {
         ui->statusbar->showMessage(QStringLiteral("波形接收已暂停"), 1500);
     } else {
@@ -1279,12 +2018,33 @@ void MainWindow::showHelpGuide()
         "串口调试助手使用说明：\n"
         "by@星辰所向 2025 持续更新中\n"
         "\n"
-        "1. 串口：在左侧选择端口、波特率、数据位、校验位、停止位后点击“打开”。\n"
+        "1. 串口：在左侧选择端口、波特率、数据位、校验位、停止位后点击“打开”；插拔 USB 串口时端口列表自动更新。\n"
         "2. 发送：可文本或 HEX 发送，支持换行设置和自动发送。\n"
         "3. 接收：文本模式可查找/保存；示波器模式将串口发来的数字映射为电压波形。\n"
         "4. 示波器输入格式：发送 ASCII 数字并以换行结束，例如 printf(\"%d\\r\\n\", n); n 为正整数，分隔符可用空格/逗号/换行。\n"
-        "5. 示波器参数：设置分辨率 n、0 对应电压、满量程电压、采样率、时基、电压放大，点击 AUTO 可自动调整显示。\n"
+        "5. 示波器参数：设置分辨率 n、0 对应电压、满量程电压、采样率、时基、电压放大，点击 AUTO 会对整段缓存做一次频谱分析，自动设置放大倍数、时基与触发电平；记录深度（最多 1000 万点）决定保留多少历史样本，历史存放在预分配的环形缓冲中；一屏超过 8192 点时由后台线程直接读取缓冲绘制并测量。\n"
         "6. 暂停：文本/波形均可单独暂停接收。\n"
+        "7. 滤波：示波器可选滑动平均、FIR 低通/高通/带通或 IIR 级联滤波，测量基于滤波后波形，可叠加原始波形对比。\n"
+        "8. 余辉：勾选“余辉显示”后按触发电平对齐每一帧并累积成密度图，偶发毛刺会以冷色保留，衰减为 0 时无限余辉。\n"
+        "9. 频谱瀑布图：工具菜单打开，按 FFT 点数/重叠率滑动计算频谱，滚轮缩放频率、Ctrl+滚轮压缩时间，可导出 CSV。\n"
+        "10. 频率跟踪：FFT 粗估后做四参数正弦拟合，锁定时频率/周期标签显示高精度结果；工具菜单可查看漂移曲线并导出记录。\n"
+        "11. 参考波形比对：加载 MATLAB 打印的查找表后自动做相关对齐，逐样本比对原始码值，统计丢样/重复/错误并列出位置。\n"
+        "12. 平均：勾选“平均”后按触发对齐累积 N 帧做线性或指数平均，显示与测量均基于平均波形，可显著压低随机噪声。\n"
+        "13. 模板测试：以当前波形或查找表加容差建立上下包络，启用后逐帧比较，统计通过率并保存最初的失败快照。\n"
+        "14. 长期统计：每攒满一屏新数据记录一次频率、峰峰值、RMS、占空比、边沿时间等，给出均值/标准差/最值与 P50~P99.9 分位数，内存不随运行时长增长。\n"
+        "15. 毛刺检测：对滤波前的数据逐样本检查压摆率、越界、平直段和计数序列断档，事件带时间戳与样本序号，点击事件可把示波器定位到该处回看。\n"
+        "16. sin(x)/x 插值：勾选后放大到每个样本间隔不少于 4 像素时，按加窗 sinc 带限重建显示波形，圆点为实际采样点。\n"
+        "17. 测量光标：勾选后拖动橙色时间光标与绿色电压光标，读出 Δt、1/Δt、ΔV、光标处样本值以及两光标间的最小/最大/均值。\n"
+        "18. 离线分析：工具菜单打开，选择保存的示波器接收日志，按当前示波器设置多线程计算统计量、码值分布、功率谱基波/THD 与毛刺事件；多核性能测试给出不同线程数下的加速比；分析在后台进行，窗口显示进度并可随时取消。\n"
+        "19. 长期趋势：勾选“记录趋势”后按 1 秒/1 分钟/1 小时三级保存最小/最大/均值/RMS 到磁盘环形文件（约 7 MB，重启后继续），切换到文本页、暂停文本或波形时照常记录，分帧解码启用时记录帧载荷样本；图表滚轮缩放、拖动平移，双击回到最新。\n"
+        "20. 精确定时发送：独立线程按绝对截止时刻发送发送区内容，可设条/秒或字节/秒速率、突发数与总条数，显示实际速率、唤醒滞后分位数与超限次数（忙等尾段越长越准，但占用一个核心）。\n"
+        "21. 发送/等待序列：用 JSON 步骤表（send/sendHex/expect/expectFrame/delay/repeat，expect 可用正则并以 save 保存捕获值供 ${变量} 引用，expectFrame 等待分帧解码输出的整帧并按载荷 HEX 前缀匹配；正则匹配到已收数据末尾时会等后续数据或超时再判定，模式以 \\r\\n 等结尾可立即判定）自动执行收发测试，在工作线程中按接收时间戳统计每步延迟，失败即停止并指出步骤。\n"
+        "22. 链路测试：以设定速率/帧长发送带序号与时间戳的探测帧，对端原样回送（物理回环、固件回显；Linux 下可勾选本地 pty 回环自检），经串口测试时由测试线程独占串口并在读取处打时间戳（主窗口暂时关闭串口，结束后自动重新打开），统计 RTT 分位数与直方图、有效吞吐、丢失、重复与乱序。\n"
+        "23. 告警匹配：每行一个模式（支持 \\xNN 等转义），在工作线程中对原始接收字节做多模式匹配，可跨数据块命中；接收区高亮命中，窗口中查看各模式次数与最近上下文，可选命中时保存前后原始字节快照或停止自动发送。\n"
+        "24. 分帧解码：工具菜单启用后按 COBS/SLIP/长度前缀/分隔符切分接收流，可加 CRC-16/CRC-32 校验，出错自动重新同步；文本区每帧一行，示波器可把帧载荷按 uint8/uint16 样本显示，并可把帧记录到文件。\n"
+        "25. 多串口会话：工具菜单中可另外同时打开多个串口（不占用主窗口串口），各路在独立线程中接收并按读取时刻打时间戳，以文本行/HEX/分帧方式合并到同一条时间线，可记录为制表符分隔文件；文本行与分帧模式还把解析出的样本连同读取时刻缓存在各路，可按时刻合并导出。\n"
+        "26. 自动重连：勾选“断线自动重连”后，设备复位或 USB 重新枚举导致断线时不弹窗，优先原端口名、其次按 VID/PID/序列号识别同一设备并以原参数重新打开，接收区以带时间的标记行记录断线区间，毛刺列表在断点样本处记录“中断”事件（示波器暂停或切到其他页期间丢弃了数据时同样记录），滤波、触发、平均与参考比对从断点重新开始。\n"
+        "27. 自动识别：串口关闭时点击波特率旁的“识别”，在设备持续发送期间依次试探常用波特率并判断 7/8 位数据与奇偶校验，按文本或 12 位二进制的字节统计与线路错误计数打分，识别后自动打开。\n"
         "如需更多帮助，可根据实际硬件需求调整相关参数。");
     QMessageBox::information(this, QStringLiteral("使用说明"), text);
 }
@@ -1294,6 +2054,13 @@ void MainWindow::handleCommandSend(const CommandEntry &entry, bool sendNow)
     // 将命令内容加载到发送区，必要时立即发送
     ui->sendTextEdit->setPlainText(entry.data);
     ui->hexSendCheckBox->setChecked(entry.hexMode);
+    // 发送区与条目内容一致时沿用条目自己的编译结果，反复发送同一命令无需重新解析
+    if (!m_payloadCache.isCurrent(entry.compiled)) {
+        m_payloadCache.compile(entry.compiled, entry.data, entry.hexMode);
+    }
+    if (ui->sendTextEdit->toPlainText() == entry.data) {
+        m_sendPayload = entry.compiled;
+    }
     if (sendNow) {
         sendData();
     }
@@ -12,12 +12,45 @@
 #include <QPropertyAnimation>
 #include <QGraphicsOpacityEffect>
 #include <QVector>
+#include <QDateTime>
+
+#include "alertmonitor.h"
+#include "bauddetector.h"
+#include "framedecoder.h"
+#include "payloadcache.h"
+#include "portwatcher.h"
+#include "scopeaverager.h"
+#include "scopefilter.h"
+#include "scopefreqtracker.h"
+#include "scopeglitch.h"
+#include "scopelongterm.h"
+#include "scopemask.h"
+#include "scopereference.h"
+#include "scopering.h"
+#include "scopestft.h"
+#include "scopetrend.h"
+#include "scopetrigger.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
 QT_END_NAMESPACE
 
 class OscilloscopeWidget;
+class SpectrogramWindow;
+class FreqTrackerWindow;
+class ReferenceWindow;
+class MaskWindow;
+class LongTermWindow;
+class GlitchWindow;
+class OfflineWindow;
+class TrendWindow;
+class PreciseSendWindow;
+class SequenceWindow;
+class LinkProbeWindow;
+class AlertWindow;
+class AlertHighlighter;
+class FrameWindow;
+class SessionWindow;
 
 class MainWindow : public QMainWindow
 {
@@ -27,12 +60,20 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+protected:
+#ifdef Q_OS_WIN
+    // 收到 WM_DEVICECHANGE 时通知串口监视线程重新枚举
+    bool nativeEvent(const QByteArray &eventType, void *message, long *result) override;
+#endif
+
 private:
     struct CommandEntry {
         // 常用命令条目：名称、原始文本、是否按 HEX 发送
         QString name;
         QString data;
         bool hexMode = false;
+        // 编译后的发送字节，不持久化；条目以 const 引用传递，故为 mutable
+        mutable PayloadCache::Entry compiled;
     };
 
     // 初始化 UI 控件配置
@@ -43,6 +84,15 @@ private:
     void applyStyleSheet();
     // 刷新串口列表，force 为 true 时强制刷新
     void updatePortList(bool force = false);
+    // 按热插拔监视给出的增删差异更新串口列表，不重新枚举
+    void applyPortChange(const PortWatcher::Change &change);
+    // 断线自动重连：关闭串口并等待同一设备重新出现，接收区记录断线标记
+    void beginReconnect(const QString &reason);
+    // 以原有参数打开 portName，成功则结束重连并记录间隔
+    bool tryReconnect(const QString &portName);
+    void cancelReconnect();
+    // 有 VID/PID 时按 VID/PID（及序列号）判断，否则按端口名
+    static bool isSameDevice(const QSerialPortInfo &opened, const QSerialPortInfo &candidate);
     // 从 QSettings 读取设置到界面
     void applySettings();
     // 将当前配置写入 QSettings
@@ -53,8 +103,10 @@ private:
     void resetStats();
     // 发送当前构造的 payload；showDialogs 控制是否提示
     bool transmitPayload(bool showDialogs);
-    // 组装发送数据（文本或 HEX），返回 QByteArray
-    QByteArray buildPayload(bool *ok, QString *error) const;
+    // 组装发送数据（文本或 HEX），返回 QByteArray；内容与格式未变时直接返回缓存
+    QByteArray buildPayload(bool *ok, QString *error);
+    // 编码/换行选择变化后更新发送缓存的格式
+    void updatePayloadFormat();
     // 字符串按选择的编码转字节
     QByteArray encodeText(const QString &text) const;
     // 字节按选择的编码转字符串
@@ -75,16 +127,53 @@ private:
     void setLastError(const QString &errorText);
     // 更新示波器测量标签
     void updateScopeLabels();
-    // 解析串口数据到示波器缓冲
+    // 解析串口数字流，送趋势记录与示波器
     void processScopeData(const QByteArray &data);
+    // 按分隔符把数字流解析为码值，跨 readyRead 的未完数字保存在 m_scopePending
+    QVector<int> parseScopeCodes(const QByteArray &data);
+    // 码值按分辨率、电压范围与放大倍数换算为电压
+    QVector<double> scopeCodesToVolts(const QVector<int> &rawBlock) const;
+    // 所有样本的唯一入口：原始码值换算为电压，送趋势记录，示波器接收时再交给 processScopeCodes
+    void ingestScopeCodes(const QVector<int> &rawBlock);
+    // block 为 rawBlock 换算出的电压，送入缓冲、检测与显示
+    void processScopeCodes(const QVector<int> &rawBlock, QVector<double> block);
+    // 分帧解码：订阅者在 feed 期间收集，feed 返回后一次送示波器/文本区
+    void processFrameData(const QByteArray &data, qint64 readNs);
     // 更新示波器配置与绘制
     void refreshScopeView();
+    // 按界面参数重建滤波器，并对已缓存的原始数据重新滤波
+    void applyScopeFilterConfig();
+    // 按时基/采样率与触发控件更新触发器配置
+    void applyScopeTriggerConfig();
+    // 将新样本送入触发器，并把完成的触发帧分发给余辉等显示模式
+    void dispatchTriggeredFrames(const QVector<double> &block);
+    // 按平均控件与当前帧长重建平均器
+    void applyScopeAverageConfig();
+    // 回看定位：把示波器窗口移到绝对样本序号 index 附近，已超出缓存返回 false
+    bool jumpScopeToSample(qint64 index);
+    // 回看时按定位点计算窗口偏移与标记，实时模式清除偏移
+    void applyScopeViewPosition();
+    // 每攒满一屏新样本，测量这段新样本并记入长期统计
+    void recordLongTermStats(int newSamples);
+    // 模板测试的中心波形：优先取平均帧，否则在当前缓存上重新触发取最后一帧
+    QVector<float> maskTemplateFromCapture() const;
+    // 模板测试的中心波形：参考查找表按当前量程换算并对齐到触发点
+    QVector<float> maskTemplateFromTable() const;
     // 当前是否处于示波器页
     bool isScopeMode() const;
+    // 示波器是否在接收：处于示波器页且未暂停
+    bool scopeReceiving() const;
+    // 是否需要解析样本：示波器在接收，或趋势记录开启
+    bool scopeCodesWanted() const;
+    // 暂停或切换标签页后调用：示波器停止接收时记下起点，恢复接收时若其间丢弃过数据则重新同步逐样本检测
+    void updateScopeGate();
 
 private slots:
     void refreshPorts();
     void toggleConnection();
+    // 自动识别所选串口的波特率与帧格式，成功后按结果打开
+    void detectBaudRate();
+    void applyBaudDetection(const BaudDetector::Result &result);
     void handleReadyRead();
     void handleSerialError(QSerialPort::SerialPortError error);
     void sendData();
@@ -106,6 +195,26 @@ private slots:
     void commandDoubleClicked(QListWidgetItem *item);
     void clearScope();
     void handleScopeSettingChanged();
+    void handleScopeFilterChanged();
+    void handleScopeTriggerChanged();
+    void togglePersistence(bool checked);
+    void handleScopeAverageChanged();
+    void runFilterBenchmark();
+    void showSpectrogram();
+    void showFreqTracker();
+    void showReferenceCompare();
+    void showMaskTest();
+    void showLongTermStats();
+    void showGlitchDetector();
+    void showOfflineAnalysis();
+    void showTrend();
+    void showPreciseSend();
+    void showSequence();
+    void showLinkProbe();
+    void showAlerts();
+    void showFrameDecoder();
+    void showSessions();
+    void stopPortWorkers();
     void autoScope();
     void togglePauseText(bool checked);
     void togglePauseScope(bool checked);
@@ -114,9 +223,33 @@ private slots:
 private:
     Ui::MainWindow *ui;
     OscilloscopeWidget *m_scopeWidget = nullptr;
+    SpectrogramWindow *m_spectrogramWindow = nullptr;
+    FreqTrackerWindow *m_freqTrackerWindow = nullptr;
+    ReferenceWindow *m_referenceWindow = nullptr;
+    MaskWindow *m_maskWindow = nullptr;
+    LongTermWindow *m_longTermWindow = nullptr;
+    GlitchWindow *m_glitchWindow = nullptr;
+    OfflineWindow *m_offlineWindow = nullptr;
+    TrendWindow *m_trendWindow = nullptr;
+    PreciseSendWindow *m_preciseSendWindow = nullptr;
+    SequenceWindow *m_sequenceWindow = nullptr;
+    LinkProbeWindow *m_linkProbeWindow = nullptr;
+    AlertWindow *m_alertWindow = nullptr;
+    AlertHighlighter *m_alertHighlighter = nullptr;
+    FrameWindow *m_frameWindow = nullptr;
+    SessionWindow *m_sessionWindow = nullptr;
     QSerialPort m_serial;
     QTimer m_autoSendTimer;
-    QTimer m_portRefreshTimer;
+    PortWatcher m_portWatcher;
+    BaudDetector m_baudDetector;
+    QTimer m_reconnectTimer;
+    bool m_reconnecting = false;
+    QSerialPortInfo m_portIdentity;          // 打开时记录的设备身份
+    QString m_reconnectCandidate;            // 正在尝试打开的端口名，空则等待设备出现
+    qint64 m_reconnectDeadlineNs = 0;
+    qint64 m_gapStartNs = 0;
+    QDateTime m_gapStartTime;
+    int m_reconnectCount = 0;
     QSettings m_settings;
     QGraphicsOpacityEffect *m_rxEffect = nullptr;
     QPropertyAnimation *m_rxHighlightAnim = nullptr;
@@ -128,8 +261,36 @@ private:
     int m_autoSendRemaining = 0;
     QStringList m_lastPorts;
     QList<CommandEntry> m_commands;
-    QVector<double> m_scopeValues;
+    PayloadCache m_payloadCache;
+    PayloadCache::Entry m_sendPayload;      // 发送区内容的编译结果
+    // 示波器历史：预分配的环形缓冲，绝对样本序号与 m_scopeSampleCount 一致，追加不移动已有样本；
+    // 滤波结果只在滤波启用时分配
+    QSharedPointer<SampleRing> m_scopeValues;
+    QSharedPointer<SampleRing> m_scopeFilteredValues;
+    ScopeFilter m_scopeFilter;
+    ScopeTrigger m_scopeTrigger;
+    ScopeAverager m_scopeAverager;
+    ScopeMask m_scopeMask;
+    FreqTracker m_freqTracker;
+    StftEngine m_stft;                   // 瀑布图的频谱历史，窗口隐藏时也持续计算
+    ReferenceChecker m_referenceChecker;
+    ScopeLongTermStats m_longTermStats;
+    GlitchDetector m_glitchDetector;
+    TrendRecorder m_trendRecorder;
+    AlertMonitor m_alertMonitor;
+    FrameDecoder m_frameDecoder;
+    QVector<int> m_frameCodes;              // 本次 feed 中帧载荷解出的示波器码值
+    QStringList m_frameLines;               // 本次 feed 中待显示的帧
     QString m_scopePending;
-    int m_scopeMaxSamples = 6000;
+    int m_scopeMaxSamples = 200000;          // 记录深度，与 scopeDepthSpinBox 同步
+    // 累计接收的样本数，即下一个样本的绝对序号，等于 m_scopeValues->end()
+    qint64 m_scopeSampleCount = 0;
+    // 回看定位的绝对样本序号，-1 表示实时
+    qint64 m_scopeJumpIndex = -1;
+    // 示波器接收状态，以及停止接收时的时间与接收字节数（用于判断其间是否丢弃过数据）
+    bool m_scopeGateOpen = false;
+    qint64 m_scopeGateClosedNs = 0;
+    QDateTime m_scopeGateClosedTime;
+    qint64 m_scopeGateClosedRx = 0;
 };
 #endif // MAINWINDOW_H
@@ -0,0 +1,234 @@
+#include "maskwindow.h"
+#include "scopemask.h"
+
+#include <QCheckBox>
+#include <QDateTime>
+#include <QDoubleSpinBox>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QListWidget>
+#include <QMessageBox>
+#include <QPainter>
+#include <QPainterPath>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QVBoxLayout>
+#include <algorithm>
+
+namespace {
+const int kRefreshIntervalMs = 500;
+}
+
+// 包络与失败帧预览：灰色为允许区域，蓝线为帧波形，红点为越界位置
+class MaskPlot : public QWidget
+{
+public:
+    explicit MaskPlot(QWidget *parent = nullptr)
+        : QWidget(parent)
+    {
+        setMinimumSize(420, 200);
+    }
+
+    void setEnvelope(const QVector<float> &upper, const QVector<float> &lower)
+    {
+        m_upper = upper;
+        m_lower = lower;
+        update();
+    }
+
+    void setFrame(const QVector<float> &frame)
+    {
+        m_frame = frame;
+        update();
+    }
+
+protected:
+    void paintEvent(QPaintEvent *) override
+    {
+        QPainter p(this);
+        p.setRenderHint(QPainter::Antialiasing);
+        p.fillRect(rect(), QColor("#ffffff"));
+        const QRectF plot = QRectF(rect()).adjusted(8, 8, -8, -8);
+        p.setPen(QPen(QColor("#d1d1d6"), 1));
+        p.drawRect(plot);
+        const int n = m_upper.size();
+        if (n < 2) {
+            p.setPen(QPen(QColor("#8e8e93"), 1));
+            p.drawText(plot, Qt::AlignCenter, QStringLiteral("尚未建立模板"));
+            return;
+        }
+        float vMin = *std::min_element(m_lower.constBegin(), m_lower.constEnd());
+        float vMax = *std::max_element(m_upper.constBegin(), m_upper.constEnd());
+        if (m_frame.size() == n) {
+            vMin = std::min(vMin, *std::min_element(m_frame.constBegin(), m_frame.constEnd()));
+            vMax = std::max(vMax, *std::max_element(m_frame.constBegin(), m_frame.constEnd()));
+        }
+        const double span = std::max(1e-9f, vMax - vMin);
+        auto toPoint = [&](int i, float v) {
+            return QPointF(plot.left() + plot.width() * i / (n - 1),
+                           plot.bottom() - (v - vMin) / span * plot.height());
+        };
+
+        QPainterPath band;
+        band.moveTo(toPoint(0, m_upper[0]));
+        for (int i = 1; i < n; ++i) band.lineTo(toPoint(i, m_upper[i]));
+        for (int i = n - 1; i >= 0; --i) band.lineTo(toPoint(i, m_lower[i]));
+        band.closeSubpath();
+        p.fillPath(band, QColor(0xd1, 0xd1, 0xd6, 160));
+
+        if (m_frame.size() != n) return;
+        QPainterPath trace;
+        trace.moveTo(toPoint(0, m_frame[0]));
+        for (int i = 1; i < n; ++i) trace.lineTo(toPoint(i, m_frame[i]));
+        p.setPen(QPen(QColor("#007aff"), 1.5));
+        p.drawPath(trace);
+        p.setPen(Qt::NoPen);
+        p.setBrush(QColor("#ff3b30"));
+        for (int i = 0; i < n; ++i) {
+            if (m_frame[i] > m_upper[i] || m_frame[i] < m_lower[i]) {
+                p.drawEllipse(toPoint(i, m_frame[i]), 2.5, 2.5);
+            }
+        }
+    }
+
+private:
+    QVector<float> m_upper;
+    QVector<float> m_lower;
+    QVector<float> m_frame;
+};
+
+MaskWindow::MaskWindow(ScopeMask *mask, QWidget *parent)
+    : QWidget(parent, Qt::Window)
+    , m_mask(mask)
+{
+    setWindowTitle(QStringLiteral("模板测试"));
+    resize(640, 520);
+
+    m_vToleranceSpin = new QDoubleSpinBox(this);
+    m_vToleranceSpin->setRange(0.0, 100.0);
+    m_vToleranceSpin->setDecimals(3);
+    m_vToleranceSpin->setValue(0.1);
+    m_vToleranceSpin->setSuffix(" V");
+    m_hToleranceSpin = new QSpinBox(this);
+    m_hToleranceSpin->setRange(0, 1000);
+    m_hToleranceSpin->setValue(2);
+    m_hToleranceSpin->setSuffix(QStringLiteral(" 点"));
+    QPushButton *captureButton = new QPushButton(QStringLiteral("用当前波形建模板"), this);
+    QPushButton *tableButton = new QPushButton(QStringLiteral("用查找表建模板"), this);
+    m_enableCheck = new QCheckBox(QStringLiteral("启用测试"), this);
+    QPushButton *resetButton = new QPushButton(QStringLiteral("清零统计"), this);
+
+    QHBoxLayout *tolerance = new QHBoxLayout;
+    tolerance->addWidget(new QLabel(QStringLiteral("纵向容差"), this));
+    tolerance->addWidget(m_vToleranceSpin);
+    tolerance->addWidget(new QLabel(QStringLiteral("横向容差"), this));
+    tolerance->addWidget(m_hToleranceSpin);
+    tolerance->addStretch();
+    QHBoxLayout *actions = new QHBoxLayout;
+    actions->addWidget(captureButton);
+    actions->addWidget(tableButton);
+    actions->addStretch();
+    actions->addWidget(m_enableCheck);
+    actions->addWidget(resetButton);
+
+    m_templateLabel = new QLabel(QStringLiteral("模板：未建立"), this);
+    m_statsLabel = new QLabel(this);
+    m_statsLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    m_failureList = new QListWidget(this);
+    m_failureList->setMaximumHeight(120);
+    m_plot = new MaskPlot(this);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(tolerance);
+    layout->addLayout(actions);
+    layout->addWidget(m_templateLabel);
+    layout->addWidget(m_statsLabel);
+    layout->addWidget(new QLabel(QStringLiteral("失败快照（点击查看）："), this));
+    layout->addWidget(m_failureList);
+    layout->addWidget(m_plot, 1);
+
+    connect(captureButton, &QPushButton::clicked, this, [this]() {
+        buildFrom(m_captureProvider, QStringLiteral("当前波形"));
+    });
+    connect(tableButton, &QPushButton::clicked, this, [this]() {
+        buildFrom(m_tableProvider, QStringLiteral("查找表"));
+    });
+    connect(m_enableCheck, &QCheckBox::toggled, this, [this](bool checked) {
+        m_mask->setEnabled(checked);
+    });
+    connect(resetButton, &QPushButton::clicked, this, [this]() {
+        m_mask->resetStats();
+        m_plot->setFrame(QVector<float>());
+        refresh();
+    });
+    connect(m_failureList, &QListWidget::currentRowChanged, this, &MaskWindow::showFailure);
+    m_refreshTimer.setInterval(kRefreshIntervalMs);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &MaskWindow::refresh);
+}
+
+void MaskWindow::setTemplateProviders(const TemplateProvider &capture, const TemplateProvider &table)
+{
+    m_captureProvider = capture;
+    m_tableProvider = table;
+}
+
+void MaskWindow::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    refresh();
+    m_refreshTimer.start();
+}
+
+void MaskWindow::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    m_refreshTimer.stop();
+}
+
+void MaskWindow::buildFrom(const TemplateProvider &provider, const QString &source)
+{
+    const QVector<float> center = provider ? provider() : QVector<float>();
+    if (center.size() < 2) {
+        QMessageBox::information(this, QStringLiteral("模板测试"), QStringLiteral("没有可用的触发帧，无法建立模板"));
+        return;
+    }
+    m_mask->build(center, m_vToleranceSpin->value(), m_hToleranceSpin->value());
+    m_templateLabel->setText(QStringLiteral("模板：%1，%2 点，纵向 ±%3 V，横向 ±%4 点")
+                             .arg(source)
+                             .arg(center.size())
+                             .arg(m_vToleranceSpin->value(), 0, 'f', 3)
+                             .arg(m_hToleranceSpin->value()));
+    m_plot->setEnvelope(m_mask->upper(), m_mask->lower());
+    m_plot->setFrame(QVector<float>());
+    refresh();
+}
+
+void MaskWindow::refresh()
+{
+    const ScopeMask::Stats &s = m_mask->stats();
+    m_statsLabel->setText(QStringLiteral("已测 %1 帧   失败 %2 帧   通过率 %3 %   越界点 %4   帧长不符跳过 %5")
+                          .arg(s.tested)
+                          .arg(s.failed)
+                          .arg(m_mask->passRate(), 0, 'f', 3)
+                          .arg(s.violations)
+                          .arg(s.skipped));
+    const QVector<ScopeMask::Failure> &failures = m_mask->failures();
+    if (m_failureList->count() == failures.size()) return;
+    if (m_failureList->count() > failures.size()) m_failureList->clear();
+    for (int i = m_failureList->count(); i < failures.size(); ++i) {
+        const ScopeMask::Failure &f = failures[i];
+        m_failureList->addItem(QStringLiteral("%1  第 %2 帧：%3 点越界，首个在帧内第 %4 点")
+                               .arg(QDateTime::fromMSecsSinceEpoch(f.wallClockMs).toString("HH:mm:ss.zzz"))
+                               .arg(f.frameIndex)
+                               .arg(f.violations)
+                               .arg(f.firstViolation));
+    }
+}
+
+void MaskWindow::showFailure(int row)
+{
+    const QVector<ScopeMask::Failure> &failures = m_mask->failures();
+    if (row < 0 || row >= failures.size()) return;
+    m_plot->setEnvelope(m_mask->upper(), m_mask->lower());
+    m_plot->setFrame(failures[row].frame);
+}
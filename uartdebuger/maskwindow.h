@@ -0,0 +1,50 @@
+#ifndef MASKWINDOW_H
+#define MASKWINDOW_H
+
+#include <QWidget>
+#include <QTimer>
+#include <QVector>
+#include <functional>
+
+class ScopeMask;
+class MaskPlot;
+class QCheckBox;
+class QDoubleSpinBox;
+class QLabel;
+class QListWidget;
+class QSpinBox;
+
+// 模板测试窗口：建立包络、开关测试、查看通过率与失败快照
+class MaskWindow : public QWidget
+{
+public:
+    // 提供模板中心波形（与当前触发帧等长），失败时返回空
+    using TemplateProvider = std::function<QVector<float>()>;
+
+    explicit MaskWindow(ScopeMask *mask, QWidget *parent = nullptr);
+
+    void setTemplateProviders(const TemplateProvider &capture, const TemplateProvider &table);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    void buildFrom(const TemplateProvider &provider, const QString &source);
+    void refresh();
+    void showFailure(int row);
+
+    ScopeMask *m_mask = nullptr;
+    TemplateProvider m_captureProvider;
+    TemplateProvider m_tableProvider;
+    QTimer m_refreshTimer;
+    QDoubleSpinBox *m_vToleranceSpin = nullptr;
+    QSpinBox *m_hToleranceSpin = nullptr;
+    QCheckBox *m_enableCheck = nullptr;
+    QLabel *m_templateLabel = nullptr;
+    QLabel *m_statsLabel = nullptr;
+    QListWidget *m_failureList = nullptr;
+    MaskPlot *m_plot = nullptr;
+};
+
+#endif // MASKWINDOW_H
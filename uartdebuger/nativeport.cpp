@@ -0,0 +1,140 @@
+#include "nativeport.h"
+
+#ifdef Q_OS_WIN
+#include <qt_windows.h>
+#else
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef Q_OS_LINUX
+#include <linux/serial.h>
+#endif
+#endif
+
+namespace {
+const int kWriteTimeoutMs = 1000;
+}
+
+NativePort::NativePort(QSerialPort::Handle handle)
+    : m_handle(handle)
+{
+#ifdef Q_OS_WIN
+    m_event = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+#endif
+}
+
+NativePort::~NativePort()
+{
+#ifdef Q_OS_WIN
+    if (m_event) CloseHandle(m_event);
+#endif
+}
+
+qint64 NativePort::nowNanos()
+{
+#ifdef Q_OS_WIN
+    static const qint64 frequency = [] {
+        LARGE_INTEGER f;
+        QueryPerformanceFrequency(&f);
+        return static_cast<qint64>(f.QuadPart);
+    }();
+    LARGE_INTEGER c;
+    QueryPerformanceCounter(&c);
+    const qint64 ticks = static_cast<qint64>(c.QuadPart);
+    return ticks / frequency * 1000000000LL + ticks % frequency * 1000000000LL / frequency;
+#else
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<qint64>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+#endif
+}
+
+bool NativePort::lineErrorCount(QSerialPort::Handle handle, qint64 *total)
+{
+#ifdef Q_OS_WIN
+    DWORD errors = 0;
+    if (!ClearCommError(reinterpret_cast<HANDLE>(handle), &errors, nullptr)) return false;
+    if (errors & (CE_FRAME | CE_RXPARITY | CE_BREAK)) ++*total;
+    return true;
+#elif defined(Q_OS_LINUX) && defined(TIOCGICOUNT)
+    serial_icounter_struct counters;
+    memset(&counters, 0, sizeof(counters));
+    if (::ioctl(static_cast<int>(handle), TIOCGICOUNT, &counters) != 0) return false;
+    *total = static_cast<qint64>(counters.frame) + counters.parity + counters.brk;
+    return true;
+#else
+    Q_UNUSED(handle);
+    Q_UNUSED(total);
+    return false;
+#endif
+}
+
+bool NativePort::lineErrorCountIsExact()
+{
+#ifdef Q_OS_WIN
+    return false;
+#else
+    return true;
+#endif
+}
+
+bool NativePort::fail(qint64 code)
+{
+#ifdef Q_OS_WIN
+    m_error = QStringLiteral("写串口失败（错误码 %1）").arg(code);
+#else
+    m_error = QStringLiteral("写串口失败：%1").arg(QString::fromLocal8Bit(strerror(static_cast<int>(code))));
+#endif
+    return false;
+}
+
+bool NativePort::writeAll(const char *data, qint64 size)
+{
+#ifdef Q_OS_WIN
+    // QSerialPort 以重叠方式打开句柄，这里用独立的 OVERLAPPED 与事件，不影响其读操作
+    HANDLE port = reinterpret_cast<HANDLE>(m_handle);
+    HANDLE event = static_cast<HANDLE>(m_event);
+    while (size > 0) {
+        OVERLAPPED ov;
+        ZeroMemory(&ov, sizeof(ov));
+        ov.hEvent = event;
+        DWORD written = 0;
+        if (!WriteFile(port, data, static_cast<DWORD>(size), &written, &ov)) {
+            if (GetLastError() != ERROR_IO_PENDING) return fail(GetLastError());
+            if (WaitForSingleObject(event, kWriteTimeoutMs) != WAIT_OBJECT_0) {
+                CancelIoEx(port, &ov);
+                GetOverlappedResult(port, &ov, &written, TRUE);
+                return fail(WAIT_TIMEOUT);
+            }
+            if (!GetOverlappedResult(port, &ov, &written, FALSE)) return fail(GetLastError());
+        }
+        data += written;
+        size -= written;
+    }
+    return true;
+#else
+    // QSerialPort 以非阻塞方式打开，驱动缓冲区满时等待可写
+    const int fd = static_cast<int>(m_handle);
+    while (size > 0) {
+        const ssize_t n = ::write(fd, data, static_cast<size_t>(size));
+        if (n > 0) {
+            data += n;
+            size -= n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) return fail(errno);
+        pollfd pfd;
+        pfd.fd = fd;
+        pfd.events = POLLOUT;
+        pfd.revents = 0;
+        const int ready = ::poll(&pfd, 1, kWriteTimeoutMs);
+        if (ready == 0) return fail(ETIMEDOUT);
+        if (ready < 0 && errno != EINTR) return fail(errno);
+    }
+    return true;
+#endif
+}
@@ -0,0 +1,43 @@
+#ifndef NATIVEPORT_H
+#define NATIVEPORT_H
+
+#include <QSerialPort>
+#include <QString>
+#include <QtGlobal>
+
+// 直接写已打开串口的系统句柄，供工作线程在不经过 GUI 事件循环的情况下发送；
+// 句柄仍由 GUI 线程的 QSerialPort 打开和关闭，使用者须在串口关闭前停止写入
+class NativePort
+{
+public:
+    explicit NativePort(QSerialPort::Handle handle);
+    ~NativePort();
+
+    // 写出全部字节；驱动缓冲区满时最多等待 1 s
+    bool writeAll(const char *data, qint64 size);
+    bool writeAll(const QByteArray &data) { return writeAll(data.constData(), data.size()); }
+    QString errorString() const { return m_error; }
+
+    // 单调时钟（纳秒）：Windows 为 QueryPerformanceCounter，其余平台为 CLOCK_MONOTONIC。
+    // 接收时间戳与发送调度共用此时钟，彼此可直接相减
+    static qint64 nowNanos();
+
+    // 读取串口硬件的线路错误（帧错误、校验错误、break）计数到 *total，调用方比较前后差值。
+    // Linux 为驱动的 TIOCGICOUNT 累计值；Windows 只能得到自上次查询以来是否出错，出错时 *total 加 1。
+    // 驱动或平台不支持时返回 false
+    static bool lineErrorCount(QSerialPort::Handle handle, qint64 *total);
+    // lineErrorCount 是否逐个计数；为 false 时只能按“出过错的查询次数”估计错误率
+    static bool lineErrorCountIsExact();
+
+private:
+    NativePort(const NativePort &) = delete;
+    NativePort &operator=(const NativePort &) = delete;
+
+    bool fail(qint64 code);
+
+    QSerialPort::Handle m_handle;
+    void *m_event = nullptr;    // Windows 重叠写的完成事件
+    QString m_error;
+};
+
+#endif // NATIVEPORT_H
@@ -0,0 +1,279 @@
+#include "offlinewindow.h"
+
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPlainTextEdit>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QVBoxLayout>
+#include <algorithm>
+
+namespace {
+// 报告中最多列出的事件数
+const int kMaxReportedEvents = 200;
+const int kHistogramBins = 16;
+const int kProgressIntervalMs = 100;
+const int kProgressSteps = 1000;
+
+QString kindName(GlitchDetector::EventKind kind)
+{
+    switch (kind) {
+    case GlitchDetector::Slew: return QStringLiteral("跳变");
+    case GlitchDetector::OutOfBand: return QStringLiteral("越界");
+    case GlitchDetector::FlatLine: return QStringLiteral("平直");
+    case GlitchDetector::SequenceGap: return QStringLiteral("断档");
+    case GlitchDetector::LinkGap: return QStringLiteral("中断");
+    default: return QString();
+    }
+}
+}
+
+OfflineJob::~OfflineJob()
+{
+    cancel();
+    wait();
+}
+
+void OfflineJob::start(Kind kind, const QString &fileName, const CaptureAnalyzer::Config &config, int maxThreads)
+{
+    if (isRunning()) return;
+    m_kind = kind;
+    m_fileName = fileName;
+    m_config = config;
+    m_maxThreads = maxThreads;
+    m_monitor.doneBytes = 0;
+    m_monitor.totalBytes = 0;
+    m_monitor.cancel = false;
+    m_result = CaptureAnalyzer::Result();
+    m_points.clear();
+    m_error.clear();
+    QThread::start();
+}
+
+double OfflineJob::progress() const
+{
+    const qint64 total = m_monitor.totalBytes.load();
+    return total > 0 ? std::min(1.0, static_cast<double>(m_monitor.doneBytes.load()) / total) : 0.0;
+}
+
+void OfflineJob::run()
+{
+    if (m_kind == Analyse) {
+        m_result = CaptureAnalyzer::analyseFile(m_fileName, m_config, &m_monitor);
+    } else {
+        m_points = CaptureAnalyzer::benchmarkFile(m_fileName, m_config, m_maxThreads, &m_error, &m_monitor);
+    }
+}
+
+OfflineWindow::OfflineWindow(QWidget *parent)
+    : QWidget(parent, Qt::Window)
+{
+    setWindowTitle(QStringLiteral("离线分析"));
+    resize(720, 560);
+
+    m_fileEdit = new QLineEdit(this);
+    m_fileEdit->setPlaceholderText(QStringLiteral("保存的示波器接收日志（十进制码值）"));
+    QPushButton *browseButton = new QPushButton(QStringLiteral("浏览…"), this);
+    m_threadSpin = new QSpinBox(this);
+    m_threadSpin->setRange(1, 256);
+    m_threadSpin->setValue(std::max(1, QThread::idealThreadCount()));
+    m_threadSpin->setPrefix(QStringLiteral("线程 "));
+    m_fftSpin = new QSpinBox(this);
+    m_fftSpin->setRange(8, 16);
+    m_fftSpin->setValue(12);
+    m_fftSpin->setPrefix(QStringLiteral("FFT 2^"));
+    m_analyseButton = new QPushButton(QStringLiteral("分析"), this);
+    m_benchmarkButton = new QPushButton(QStringLiteral("多核性能测试"), this);
+    m_cancelButton = new QPushButton(QStringLiteral("取消"), this);
+    m_cancelButton->setEnabled(false);
+    m_progress = new QProgressBar(this);
+    m_progress->setRange(0, kProgressSteps);
+    m_progress->setValue(0);
+    m_report = new QPlainTextEdit(this);
+    m_report->setReadOnly(true);
+
+    QHBoxLayout *fileRow = new QHBoxLayout;
+    fileRow->addWidget(new QLabel(QStringLiteral("文件"), this));
+    fileRow->addWidget(m_fileEdit, 1);
+    fileRow->addWidget(browseButton);
+    QHBoxLayout *controls = new QHBoxLayout;
+    controls->addWidget(m_threadSpin);
+    controls->addWidget(m_fftSpin);
+    controls->addStretch(1);
+    controls->addWidget(m_analyseButton);
+    controls->addWidget(m_benchmarkButton);
+    controls->addWidget(m_cancelButton);
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(fileRow);
+    layout->addLayout(controls);
+    layout->addWidget(m_progress);
+    layout->addWidget(m_report, 1);
+
+    connect(browseButton, &QPushButton::clicked, this, &OfflineWindow::browse);
+    connect(m_analyseButton, &QPushButton::clicked, this, &OfflineWindow::analyse);
+    connect(m_benchmarkButton, &QPushButton::clicked, this, &OfflineWindow::runBenchmark);
+    connect(m_cancelButton, &QPushButton::clicked, this, [this]() { m_job.cancel(); });
+    // finished 在工作线程发出，排队到界面线程处理
+    connect(&m_job, &QThread::finished, this, &OfflineWindow::jobFinished);
+    m_progressTimer.setInterval(kProgressIntervalMs);
+    connect(&m_progressTimer, &QTimer::timeout, this, [this]() {
+        m_progress->setValue(static_cast<int>(m_job.progress() * kProgressSteps));
+    });
+}
+
+OfflineWindow::~OfflineWindow()
+{
+    // 先停下后台线程，再析构它引用的控件
+    m_job.cancel();
+    m_job.wait();
+}
+
+void OfflineWindow::setConfigProvider(const ConfigProvider &provider)
+{
+    m_configProvider = provider;
+}
+
+void OfflineWindow::browse()
+{
+    const QString fileName = QFileDialog::getOpenFileName(this, QStringLiteral("选择采集文件"), QString(),
+                                                          QStringLiteral("文本 (*.txt *.csv);;所有文件 (*)"));
+    if (!fileName.isEmpty()) m_fileEdit->setText(fileName);
+}
+
+CaptureAnalyzer::Config OfflineWindow::currentConfig() const
+{
+    CaptureAnalyzer::Config cfg = m_configProvider ? m_configProvider() : CaptureAnalyzer::Config();
+    cfg.threads = m_threadSpin->value();
+    cfg.fftSize = 1 << m_fftSpin->value();
+    return cfg;
+}
+
+void OfflineWindow::analyse()
+{
+    startJob(OfflineJob::Analyse);
+}
+
+void OfflineWindow::runBenchmark()
+{
+    startJob(OfflineJob::Benchmark);
+}
+
+void OfflineWindow::startJob(OfflineJob::Kind kind)
+{
+    const QString fileName = m_fileEdit->text();
+    if (fileName.isEmpty() || m_job.isRunning()) return;
+    m_job.start(kind, fileName, currentConfig(), m_threadSpin->value());
+    setBusy(true);
+    m_report->setPlainText(kind == OfflineJob::Analyse ? QStringLiteral("正在分析…") : QStringLiteral("正在测试…"));
+}
+
+void OfflineWindow::jobFinished()
+{
+    setBusy(false);
+    if (m_job.kind() == OfflineJob::Analyse) {
+        showAnalysis();
+    } else {
+        showBenchmark();
+    }
+}
+
+void OfflineWindow::setBusy(bool busy)
+{
+    m_analyseButton->setEnabled(!busy);
+    m_benchmarkButton->setEnabled(!busy);
+    m_cancelButton->setEnabled(busy);
+    m_progress->setValue(busy ? 0 : kProgressSteps);
+    if (busy) {
+        m_progressTimer.start();
+    } else {
+        m_progressTimer.stop();
+    }
+}
+
+void OfflineWindow::showAnalysis()
+{
+    const QString &fileName = m_job.fileName();
+    const CaptureAnalyzer::Config &cfg = m_job.config();
+    const CaptureAnalyzer::Result &r = m_job.result();
+    if (!r.ok) {
+        m_report->setPlainText(QStringLiteral("分析失败：%1").arg(r.error));
+        return;
+    }
+
+    const CaptureAnalyzer::Partial &t = r.total;
+    QString text;
+    text += QStringLiteral("文件：%1（%2 MB）\n").arg(QFileInfo(fileName).fileName()).arg(r.bytes / 1048576.0, 0, 'f', 1);
+    text += QStringLiteral("耗时 %1 ms，%2 线程，%3 块（窃取 %4 次），%5 MB/s\n")
+            .arg(r.elapsedMs, 0, 'f', 1).arg(r.threads).arg(r.blocks).arg(r.steals)
+            .arg(r.elapsedMs > 0 ? r.bytes / 1048576.0 / (r.elapsedMs / 1000.0) : 0.0, 0, 'f', 1);
+    text += QStringLiteral("样本 %1，无效片段 %2，时长 %3 s\n\n")
+            .arg(t.samples).arg(t.badTokens).arg(cfg.sampleRate > 0 ? t.samples / cfg.sampleRate : 0.0, 0, 'f', 3);
+    if (t.samples > 0) {
+        text += QStringLiteral("均值 %1 V，标准差 %2 V，最小 %3 V，最大 %4 V\n")
+                .arg(t.moments.mean(), 0, 'f', 6).arg(t.moments.stddev(), 0, 'f', 6)
+                .arg(t.moments.min(), 0, 'f', 4).arg(t.moments.max(), 0, 'f', 4);
+    }
+    if (r.fundamental > 0) {
+        text += QStringLiteral("基波 %1 Hz，THD（2~%2 次）%3 %（%4 段平均，分辨率 %5 Hz）\n")
+                .arg(r.fundamental, 0, 'g', 8).arg(CaptureAnalyzer::kMaxHarmonic).arg(r.thdPercent, 0, 'f', 4)
+                .arg(t.segments).arg(r.binWidth, 0, 'g', 4);
+    } else {
+        text += QStringLiteral("功率谱中未检测到明显的基波（%1 段平均）\n").arg(t.segments);
+    }
+
+    // 直方图按 kHistogramBins 个区间汇总显示
+    if (!t.histogram.isEmpty() && t.samples > 0) {
+        text += QStringLiteral("\n码值分布：\n");
+        const int bins = t.histogram.size();
+        const int step = std::max(1, bins / kHistogramBins);
+        for (int b = 0; b < bins; b += step) {
+            qint64 sum = 0;
+            for (int k = b; k < std::min(bins, b + step); ++k) sum += t.histogram[k];
+            const int bar = static_cast<int>(60.0 * sum / t.samples + 0.5);
+            text += QStringLiteral("%1%  %2\n").arg(100.0 * b / bins, 5, 'f', 1)
+                    .arg(QString(bar, QChar('#')));
+        }
+    }
+
+    if (cfg.glitchEnabled) {
+        text += QStringLiteral("\n毛刺事件：");
+        for (int k = 0; k < GlitchDetector::KindCount; ++k) {
+            // 文件中没有断线事件
+            if (k == GlitchDetector::LinkGap) continue;
+            text += QStringLiteral("%1 %2  ").arg(kindName(static_cast<GlitchDetector::EventKind>(k))).arg(t.counts[k]);
+        }
+        text += '\n';
+        const int shown = std::min(kMaxReportedEvents, t.events.size());
+        for (int i = 0; i < shown; ++i) {
+            const GlitchDetector::Event &e = t.events[i];
+            text += QStringLiteral("#%1  %2 s  [%3]  %4 V，持续 %5 点\n")
+                    .arg(e.sampleIndex)
+                    .arg(cfg.sampleRate > 0 ? e.sampleIndex / cfg.sampleRate : 0.0, 0, 'f', 6)
+                    .arg(kindName(e.kind))
+                    .arg(e.value, 0, 'f', 4)
+                    .arg(e.length);
+        }
+        if (t.events.size() > shown) text += QStringLiteral("……（仅列出前 %1 条）\n").arg(shown);
+    }
+    m_report->setPlainText(text);
+}
+
+void OfflineWindow::showBenchmark()
+{
+    const QVector<CaptureAnalyzer::BenchmarkPoint> &points = m_job.points();
+    if (points.isEmpty()) {
+        m_report->setPlainText(QStringLiteral("测试失败：%1").arg(m_job.error()));
+        return;
+    }
+    QString text = QStringLiteral("多核加速比（同一文件、相同分块，仅改变线程数）：\n");
+    for (const CaptureAnalyzer::BenchmarkPoint &p : points) {
+        text += QStringLiteral("%1 线程：%2 ms，加速比 %3，%4 MB/s，结果%5\n")
+                .arg(p.threads, 3).arg(p.elapsedMs, 0, 'f', 1).arg(p.speedup, 0, 'f', 2).arg(p.mbPerSecond, 0, 'f', 1)
+                .arg(p.identical ? QStringLiteral("与单线程一致") : QStringLiteral("与单线程不一致"));
+    }
+    m_report->setPlainText(text);
+}
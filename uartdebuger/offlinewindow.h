@@ -0,0 +1,93 @@
+#ifndef OFFLINEWINDOW_H
+#define OFFLINEWINDOW_H
+
+#include "scopeoffline.h"
+
+#include <QThread>
+#include <QTimer>
+#include <QWidget>
+#include <functional>
+
+class QLineEdit;
+class QPlainTextEdit;
+class QProgressBar;
+class QPushButton;
+class QSpinBox;
+
+// 离线分析的后台线程：一次执行一项分析或性能测试，结束后界面线程经 finished 信号（排队连接）取结果
+class OfflineJob : public QThread
+{
+public:
+    enum Kind {
+        Analyse,
+        Benchmark
+    };
+
+    ~OfflineJob();
+
+    // 正在运行时忽略
+    void start(Kind kind, const QString &fileName, const CaptureAnalyzer::Config &config, int maxThreads);
+    void cancel() { m_monitor.cancel = true; }
+    // 0~1，运行中可随时读取
+    double progress() const;
+
+    // 以下在 finished 之后读取
+    Kind kind() const { return m_kind; }
+    const QString &fileName() const { return m_fileName; }
+    const CaptureAnalyzer::Config &config() const { return m_config; }
+    const CaptureAnalyzer::Result &result() const { return m_result; }
+    const QVector<CaptureAnalyzer::BenchmarkPoint> &points() const { return m_points; }
+    const QString &error() const { return m_error; }
+
+protected:
+    void run() override;
+
+private:
+    Kind m_kind = Analyse;
+    QString m_fileName;
+    CaptureAnalyzer::Config m_config;
+    int m_maxThreads = 1;
+    CaptureAnalyzer::Monitor m_monitor;
+    CaptureAnalyzer::Result m_result;
+    QVector<CaptureAnalyzer::BenchmarkPoint> m_points;
+    QString m_error;
+};
+
+// 离线分析窗口：选择保存的采集文件，多线程计算统计量、功率谱/THD 与毛刺事件，并可测试多核加速比；
+// 分析在后台线程进行，界面显示进度并可取消
+class OfflineWindow : public QWidget
+{
+public:
+    // 返回与当前示波器设置一致的分析参数（码值映射、采样率、毛刺判据）
+    using ConfigProvider = std::function<CaptureAnalyzer::Config()>;
+
+    explicit OfflineWindow(QWidget *parent = nullptr);
+    ~OfflineWindow();
+
+    void setConfigProvider(const ConfigProvider &provider);
+
+private:
+    void browse();
+    CaptureAnalyzer::Config currentConfig() const;
+    void analyse();
+    void runBenchmark();
+    void startJob(OfflineJob::Kind kind);
+    void jobFinished();
+    void setBusy(bool busy);
+    void showAnalysis();
+    void showBenchmark();
+
+    ConfigProvider m_configProvider;
+    OfflineJob m_job;
+    QTimer m_progressTimer;
+    QLineEdit *m_fileEdit = nullptr;
+    QSpinBox *m_threadSpin = nullptr;
+    QSpinBox *m_fftSpin = nullptr;
+    QPushButton *m_analyseButton = nullptr;
+    QPushButton *m_benchmarkButton = nullptr;
+    QPushButton *m_cancelButton = nullptr;
+    QProgressBar *m_progress = nullptr;
+    QPlainTextEdit *m_report = nullptr;
+};
+
+#endif // OFFLINEWINDOW_H
@@ -0,0 +1,619 @@
+#include "oscilloscopewidget.h"
+#include "scopepersistence.h"
+#include "scoperaster.h"
+
+#include <QMouseEvent>
+#include <QPainter>
+#include <QThread>
+#include <cmath>
+#include <algorithm>
+
+namespace {
+const qreal kLeftMargin = 68.0;
+const qreal kTopMargin = 8.0;
+const qreal kRightMargin = 8.0;
+const qreal kBottomMargin = 8.0;
+// 可见样本数达到该值时改由后台线程光栅化
+const int kRasterThreshold = 8192;
+// 每个样本间隔至少这么多像素时才做 sin(x)/x 重建，更密时折线已足够准确
+const double kSincMinPixelsPerSample = 4.0;
+// 鼠标距光标线小于该像素数时可拖动
+const double kCursorGrabDistance = 6.0;
+
+QString formatSeconds(double sec)
+{
+    const double a = std::fabs(sec);
+    if (a >= 1.0) return QString::number(sec, 'f', 4) + " s";
+    if (a >= 1e-3) return QString::number(sec * 1e3, 'f', 4) + " ms";
+    return QString::number(sec * 1e6, 'f', 3) + " us";
+}
+}
+
+OscilloscopeWidget::OscilloscopeWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    setMinimumHeight(240);
+    setAutoFillBackground(true);
+}
+
+OscilloscopeWidget::~OscilloscopeWidget()
+{
+    // 工作对象随线程结束由 deleteLater 释放
+    if (m_persistThread) {
+        m_persistThread->quit();
+        m_persistThread->wait();
+    }
+    if (m_rasterThread) {
+        m_rasterThread->quit();
+        m_rasterThread->wait();
+    }
+}
+
+void OscilloscopeWidget::configure(double sampleRate, double timeBaseMs, double gain, double vMin, double vMax)
+{
+    m_sampleRate = std::max(1.0, sampleRate);
+    m_timeBaseMs = std::max(0.1, timeBaseMs);
+    m_gain = std::max(0.001, gain);
+    m_vMin = vMin;
+    m_vMax = vMax;
+    requestTraceRender();
+    update();
+}
+
+void OscilloscopeWidget::setValues(const QSharedPointer<const SampleRing> &values)
+{
+    m_values = values;
+    m_rangeIndexDirty = true;
+    computeStats();
+    requestTraceRender();
+    update();
+}
+
+void OscilloscopeWidget::setValues(const QVector<double> &values)
+{
+    setValues(SampleRing::fromVector(values));
+}
+
+void OscilloscopeWidget::setOverlayValues(const QSharedPointer<const SampleRing> &values, int delay)
+{
+    m_overlayValues = values;
+    m_overlayDelay = std::max(0, delay);
+    requestTraceRender();
+    update();
+}
+
+void OscilloscopeWidget::setCaption(const QString &caption)
+{
+    if (caption == m_caption) return;
+    m_caption = caption;
+    update();
+}
+
+void OscilloscopeWidget::setViewOffset(int samplesFromEnd)
+{
+    samplesFromEnd = std::max(0, samplesFromEnd);
+    if (samplesFromEnd == m_viewOffset) return;
+    m_viewOffset = samplesFromEnd;
+    computeStats();
+    requestTraceRender();
+    update();
+}
+
+void OscilloscopeWidget::setMarkerIndex(int index)
+{
+    if (index == m_markerIndex) return;
+    m_markerIndex = index;
+    update();
+}
+
+void OscilloscopeWidget::setSincInterpolation(bool enabled)
+{
+    if (enabled == m_sincEnabled) return;
+    m_sincEnabled = enabled;
+    update();
+}
+
+void OscilloscopeWidget::setCursorsEnabled(bool enabled)
+{
+    if (enabled == m_cursorsEnabled) return;
+    m_cursorsEnabled = enabled;
+    m_dragCursor = NoCursor;
+    // 电压光标在首次显示时放到当前纵轴的 1/3、2/3 处
+    m_voltCursorsPlaced = false;
+    setMouseTracking(enabled);
+    if (!enabled) unsetCursor();
+    update();
+}
+
+void OscilloscopeWidget::setPersistenceEnabled(bool enabled)
+{
+    if (enabled == m_persistenceEnabled) return;
+    m_persistenceEnabled = enabled;
+    if (enabled) {
+        ensurePersistenceWorker();
+        clearPersistence();
+    } else {
+        requestTraceRender();
+    }
+    update();
+}
+
+void OscilloscopeWidget::setPersistenceRange(double vLow, double vHigh)
+{
+    if (vHigh < vLow) std::swap(vLow, vHigh);
+    if (vHigh - vLow < 1e-9) vHigh = vLow + 1.0;
+    m_persistLow = vLow;
+    m_persistHigh = vHigh;
+    if (m_persistWorker) {
+        QMetaObject::invokeMethod(m_persistWorker, "setRange", Qt::QueuedConnection,
+                                  Q_ARG(double, vLow), Q_ARG(double, vHigh));
+    }
+}
+
+void OscilloscopeWidget::setPersistenceDecay(double percentPerSecond)
+{
+    ensurePersistenceWorker();
+    QMetaObject::invokeMethod(m_persistWorker, "setDecayPerSecond", Qt::QueuedConnection,
+                              Q_ARG(double, percentPerSecond));
+}
+
+void OscilloscopeWidget::addPersistenceFrames(const QVector<float> &frames, int frameLength)
+{
+    if (!m_persistenceEnabled || frames.isEmpty() || !m_persistWorker) return;
+    // 帧数据按值传入工作线程（隐式共享，不复制）
+    QMetaObject::invokeMethod(m_persistWorker, "addFrames", Qt::QueuedConnection,
+                              Q_ARG(QVector<float>, frames), Q_ARG(int, frameLength));
+}
+
+void OscilloscopeWidget::clearPersistence()
+{
+    m_persistImage = QImage();
+    m_persistFrames = 0;
+    if (m_persistWorker) {
+        QMetaObject::invokeMethod(m_persistWorker, "clear", Qt::QueuedConnection);
+    }
+    update();
+}
+
+void OscilloscopeWidget::ensurePersistenceWorker()
+{
+    if (m_persistWorker) return;
+    qRegisterMetaType<QVector<float>>("QVector<float>");
+    m_persistThread = new QThread(this);
+    m_persistWorker = new PersistenceWorker;
+    m_persistWorker->moveToThread(m_persistThread);
+    connect(m_persistThread, &QThread::started, m_persistWorker, &PersistenceWorker::start);
+    connect(m_persistThread, &QThread::finished, m_persistWorker, &QObject::deleteLater);
+    connect(m_persistWorker, &PersistenceWorker::imageReady, this, [this](const QImage &image, qint64 frames) {
+        m_persistImage = image;
+        m_persistFrames = frames;
+        if (m_persistenceEnabled) update();
+    });
+    m_persistThread->start();
+    QMetaObject::invokeMethod(m_persistWorker, "setRange", Qt::QueuedConnection,
+                              Q_ARG(double, m_persistLow), Q_ARG(double, m_persistHigh));
+    updatePersistenceGeometry();
+}
+
+void OscilloscopeWidget::updatePersistenceGeometry()
+{
+    if (!m_persistWorker) return;
+    const QRect r = plotRect().toRect();
+    QMetaObject::invokeMethod(m_persistWorker, "setGeometry", Qt::QueuedConnection,
+                              Q_ARG(int, std::max(1, r.width())), Q_ARG(int, std::max(1, r.height())));
+}
+
+void OscilloscopeWidget::ensureRasterWorker()
+{
+    if (m_rasterWorker) return;
+    qRegisterMetaType<TraceRenderRequest>("TraceRenderRequest");
+    qRegisterMetaType<ScopeMeasure::Result>("ScopeMeasure::Result");
+    m_rasterThread = new QThread(this);
+    m_rasterWorker = new TraceRenderWorker;
+    m_rasterWorker->moveToThread(m_rasterThread);
+    connect(m_rasterThread, &QThread::finished, m_rasterWorker, &QObject::deleteLater);
+    connect(m_rasterWorker, &TraceRenderWorker::frameReady, this,
+            [this](const QImage &image, double minVal, double maxVal, const ScopeMeasure::Result &stats, int) {
+        int start = 0, end = 0;
+        visibleRange(valueCount(), &start, &end);
+        // 期间可见点数已降到阈值以下时，界面线程已按新的窗口测量并直接绘制
+        if (end - start < kRasterThreshold) return;
+        m_stats = stats;
+        if (m_statsListener) m_statsListener();
+        if (image.isNull()) return;
+        m_traceImage = image;
+        m_traceMin = minVal;
+        m_traceMax = maxVal;
+        if (!m_persistenceEnabled) update();
+    });
+    m_rasterThread->start();
+}
+
+void OscilloscopeWidget::requestTraceRender()
+{
+    int start = 0, end = 0;
+    visibleRange(valueCount(), &start, &end);
+    if (end - start < kRasterThreshold) {
+        m_traceImage = QImage();
+        return;
+    }
+    ensureRasterWorker();
+    // 只传缓冲与序号区间，工作线程直接读取；请求号让排队中的旧请求作废
+    TraceRenderRequest request;
+    request.values = m_values;
+    request.first = m_values->begin() + start;
+    request.count = end - start;
+    overlayRange(request.first, request.count, &request.overlayFirst, &request.overlayCount, &request.overlayOffset);
+    if (request.overlayCount > 0) request.overlay = m_overlayValues;
+    request.sampleRate = m_sampleRate;
+    // 余辉模式不画波形，只借后台线程测量
+    request.draw = !m_persistenceEnabled;
+    const QRect r = plotRect().toRect();
+    request.width = std::max(1, r.width());
+    request.height = std::max(1, r.height());
+    m_rasterWorker->setLatestSerial(++m_renderSerial);
+    request.serial = m_renderSerial;
+    QMetaObject::invokeMethod(m_rasterWorker, "render", Qt::QueuedConnection, Q_ARG(TraceRenderRequest, request));
+}
+
+void OscilloscopeWidget::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    updatePersistenceGeometry();
+    requestTraceRender();
+}
+
+QRectF OscilloscopeWidget::plotRect() const
+{
+    return QRectF(rect()).adjusted(kLeftMargin, kTopMargin, -kRightMargin, -kBottomMargin);
+}
+
+void OscilloscopeWidget::paintEvent(QPaintEvent *)
+{
+    QPainter p(this);
+    p.setRenderHint(QPainter::Antialiasing);
+
+    QRectF rect = plotRect();
+    p.fillRect(rect, QColor("#ffffff"));
+
+    // Grid
+    p.setPen(QPen(QColor("#d1d1d6"), 1));
+    const int divs = 10;
+    for (int i = 0; i <= divs; ++i) {
+        const double x = rect.left() + rect.width() * i / divs;
+        p.drawLine(QPointF(x, rect.top()), QPointF(x, rect.bottom()));
+        const double y = rect.top() + rect.height() * i / divs;
+        p.drawLine(QPointF(rect.left(), y), QPointF(rect.right(), y));
+    }
+
+    if (m_persistenceEnabled) {
+        // 余辉模式使用固定纵轴，密度图由后台线程生成，这里只贴图
+        drawRulerLabels(p, rect, m_persistLow, m_persistHigh);
+        if (!m_persistImage.isNull()) {
+            p.drawImage(rect, m_persistImage);
+        }
+        p.setPen(QPen(QColor("#8e8e93"), 1.2));
+        p.drawText(rect.adjusted(6, 4, -6, -4), Qt::AlignRight | Qt::AlignTop,
+                   QStringLiteral("余辉 %1 帧").arg(m_persistFrames));
+        return;
+    }
+
+    int visibleStart = 0, visibleEnd = 0;
+    visibleRange(valueCount(), &visibleStart, &visibleEnd);
+    if (visibleEnd - visibleStart >= kRasterThreshold) {
+        // 大数据量：贴上后台线程最近完成的一帧，刻度使用该帧的纵轴范围
+        if (m_traceImage.isNull()) {
+            drawRulerLabels(p, rect, m_vMin, m_vMax);
+            p.setPen(QPen(QColor("#8e8e93"), 1.2));
+            p.drawText(rect, Qt::AlignCenter, QStringLiteral("渲染中..."));
+            return;
+        }
+        drawRulerLabels(p, rect, m_traceMin, m_traceMax);
+        p.drawImage(rect, m_traceImage);
+        m_axisMin = m_traceMin;
+        m_axisMax = m_traceMax;
+        drawMarkerAndCaption(p, rect, visibleStart, visibleEnd - visibleStart);
+        drawCursors(p, rect, visibleStart, visibleEnd - visibleStart);
+        return;
+    }
+
+    // Left ruler labels
+    double labelMin = m_vMin;
+    double labelMax = m_vMax;
+    const SampleRing::Span visible = visibleSpan(visibleStart, visibleEnd);
+    qint64 overlayFirst = 0;
+    int overlayCount = 0, overlayOffset = 0;
+    if (!visible.isEmpty()) {
+        overlayRange(m_values->begin() + visibleStart, visible.size(), &overlayFirst, &overlayCount, &overlayOffset);
+    }
+    const SampleRing::Span overlay = overlayCount > 0 ? m_overlayValues->span(overlayFirst, overlayCount)
+                                                      : SampleRing::Span();
+    // 稀疏放大时只对可见区间做带限重建，邻近样本取自可见区外的历史数据
+    QVector<double> reconstructed;
+    if (m_sincEnabled && visible.size() >= 2
+            && rect.width() / (visible.size() - 1) >= kSincMinPixelsPerSample) {
+        const int from = std::max(0, visibleStart - SincInterpolator::kTaps);
+        const int to = std::min(valueCount(), visibleEnd + SincInterpolator::kTaps);
+        const QVector<double> history = m_values->toVector(m_values->begin() + from, to - from);
+        reconstructed.resize(static_cast<int>(rect.width()) + 1);
+        m_sinc.interpolate(history.constData(), history.size(), visibleStart - from, visible.size(),
+                           reconstructed.size(), reconstructed.data());
+    }
+    if (!visible.isEmpty()) {
+        TraceRaster::valueRange(reconstructed.isEmpty() ? visible
+                                                        : SampleRing::Span(reconstructed.constData(), reconstructed.size()),
+                                &labelMin, &labelMax);
+    }
+    if (!visible.isEmpty() && !overlay.isEmpty()) {
+        // 叠加波形与主波形共用纵轴
+        double overlayMin, overlayMax;
+        TraceRaster::valueRange(overlay, &overlayMin, &overlayMax);
+        labelMin = std::min(labelMin, overlayMin);
+        labelMax = std::max(labelMax, overlayMax);
+    }
+    drawRulerLabels(p, rect, labelMin, labelMax);
+
+    if (visible.isEmpty()) {
+        p.setPen(QPen(QColor("#8e8e93"), 1.2));
+        p.drawText(rect, Qt::AlignCenter, QStringLiteral("等待波形数据..."));
+        return;
+    }
+
+    const double minVal = labelMin;
+    const double span = std::max(1e-9, labelMax - labelMin);
+    m_axisMin = minVal;
+    m_axisMax = minVal + span;
+
+    if (overlay.size() > 1 && visible.size() > 1) {
+        // 叠加波形按样本位置对齐主波形，不足一屏时只画在对应的一段宽度内
+        const double last = visible.size() - 1;
+        QRectF overlayRect = rect;
+        overlayRect.setLeft(rect.left() + rect.width() * overlayOffset / last);
+        overlayRect.setRight(rect.left() + rect.width() * (overlayOffset + overlay.size() - 1) / last);
+        p.setPen(QPen(QColor("#c7c7cc"), 1));
+        drawTrace(p, overlayRect, overlay, minVal, span);
+    }
+    if (reconstructed.isEmpty()) {
+        p.setPen(QPen(QColor("#007aff"), 2));
+        drawTrace(p, rect, visible, minVal, span);
+    } else {
+        // 重建曲线 + 实际采样点，避免把插值误认为测量值
+        p.setPen(QPen(QColor("#007aff"), 2));
+        drawTrace(p, rect, SampleRing::Span(reconstructed.constData(), reconstructed.size()), minVal, span);
+        p.setPen(Qt::NoPen);
+        p.setBrush(QColor("#007aff"));
+        for (int i = 0; i < visible.size(); ++i) {
+            const double x = rect.left() + rect.width() * i / (visible.size() - 1);
+            const double y = rect.bottom() - (visible[i] - minVal) / span * rect.height();
+            p.drawEllipse(QPointF(x, y), 3.0, 3.0);
+        }
+        p.setBrush(Qt::NoBrush);
+    }
+    drawMarkerAndCaption(p, rect, visibleStart, visible.size());
+    drawCursors(p, rect, visibleStart, visible.size());
+}
+
+void OscilloscopeWidget::drawCursors(QPainter &p, const QRectF &rect, int visibleStart, int visibleCount)
+{
+    if (!m_cursorsEnabled || visibleCount < 2) return;
+    const double span = std::max(1e-9, m_axisMax - m_axisMin);
+    if (!m_voltCursorsPlaced) {
+        m_voltCursor[0] = m_axisMin + span * 2.0 / 3.0;
+        m_voltCursor[1] = m_axisMin + span / 3.0;
+        m_voltCursorsPlaced = true;
+    }
+
+    const QColor timeColor("#ff9500");
+    const QColor voltColor("#34c759");
+    p.setPen(QPen(timeColor, 1.2, Qt::DashLine));
+    for (double t : m_timeCursor) {
+        const double x = rect.left() + t * rect.width();
+        p.drawLine(QPointF(x, rect.top()), QPointF(x, rect.bottom()));
+    }
+    p.setPen(QPen(voltColor, 1.2, Qt::DashLine));
+    for (double v : m_voltCursor) {
+        const double y = rect.bottom() - (v - m_axisMin) / span * rect.height();
+        if (y >= rect.top() && y <= rect.bottom()) p.drawLine(QPointF(rect.left(), y), QPointF(rect.right(), y));
+    }
+
+    // 光标处的样本与两光标之间的区间统计，区间查询走块汇总线段树
+    if (m_rangeIndexDirty) {
+        // 同一缓冲只汇总新增与被淘汰的块
+        m_rangeIndex.update(m_values);
+        m_rangeIndexDirty = false;
+    }
+    int index[2];
+    for (int c = 0; c < 2; ++c) {
+        index[c] = visibleStart + static_cast<int>(m_timeCursor[c] * (visibleCount - 1) + 0.5);
+    }
+    const double t1 = (index[0] - visibleStart) / m_sampleRate;
+    const double t2 = (index[1] - visibleStart) / m_sampleRate;
+    const double dt = t2 - t1;
+    const RangeIndex::Summary between = m_rangeIndex.query(std::min(index[0], index[1]), std::max(index[0], index[1]));
+    const auto volts = [](double v) { return QString::number(v, 'f', 4) + " V"; };
+
+    QStringList lines;
+    lines << QStringLiteral("T1 %1   T2 %2   Δt %3   1/Δt %4")
+             .arg(formatSeconds(t1), formatSeconds(t2), formatSeconds(dt),
+                  std::fabs(dt) > 0 ? QString::number(1.0 / std::fabs(dt), 'g', 6) + " Hz" : QStringLiteral("-"));
+    lines << QStringLiteral("V(T1) %1   V(T2) %2").arg(volts(valueAt(index[0])), volts(valueAt(index[1])));
+    lines << QStringLiteral("V1 %1   V2 %2   ΔV %3")
+             .arg(volts(m_voltCursor[0]), volts(m_voltCursor[1]), volts(m_voltCursor[0] - m_voltCursor[1]));
+    lines << QStringLiteral("区间 %1 点：最小 %2   最大 %3   均值 %4")
+             .arg(between.count).arg(volts(between.min), volts(between.max), volts(between.mean()));
+
+    const QFontMetrics fm = p.fontMetrics();
+    int textWidth = 0;
+    for (const QString &line : lines) textWidth = std::max(textWidth, fm.horizontalAdvance(line));
+    const QRectF box(rect.left() + 6, rect.top() + 4, textWidth + 12, fm.height() * lines.size() + 8);
+    p.setPen(QPen(QColor("#d1d1d6"), 1));
+    p.setBrush(QColor(255, 255, 255, 220));
+    p.drawRect(box);
+    p.setBrush(Qt::NoBrush);
+    p.setPen(QPen(QColor("#3a3a3c"), 1));
+    for (int i = 0; i < lines.size(); ++i) {
+        p.drawText(QRectF(box.left() + 6, box.top() + 4 + i * fm.height(), textWidth, fm.height()),
+                   Qt::AlignLeft | Qt::AlignVCenter, lines[i]);
+    }
+}
+
+OscilloscopeWidget::CursorId OscilloscopeWidget::cursorAt(const QPointF &pos) const
+{
+    const QRectF rect = plotRect();
+    if (!m_cursorsEnabled || !rect.adjusted(-kCursorGrabDistance, -kCursorGrabDistance,
+                                            kCursorGrabDistance, kCursorGrabDistance).contains(pos)) {
+        return NoCursor;
+    }
+    for (int c = 0; c < 2; ++c) {
+        const double x = rect.left() + m_timeCursor[c] * rect.width();
+        if (std::fabs(pos.x() - x) <= kCursorGrabDistance) return c == 0 ? TimeCursor1 : TimeCursor2;
+    }
+    const double span = std::max(1e-9, m_axisMax - m_axisMin);
+    for (int c = 0; c < 2; ++c) {
+        const double y = rect.bottom() - (m_voltCursor[c] - m_axisMin) / span * rect.height();
+        if (std::fabs(pos.y() - y) <= kCursorGrabDistance) return c == 0 ? VoltCursor1 : VoltCursor2;
+    }
+    return NoCursor;
+}
+
+void OscilloscopeWidget::mousePressEvent(QMouseEvent *event)
+{
+    m_dragCursor = event->button() == Qt::LeftButton ? cursorAt(event->localPos()) : NoCursor;
+    if (m_dragCursor == NoCursor) QWidget::mousePressEvent(event);
+}
+
+void OscilloscopeWidget::mouseMoveEvent(QMouseEvent *event)
+{
+    if (!m_cursorsEnabled) {
+        QWidget::mouseMoveEvent(event);
+        return;
+    }
+    const QRectF rect = plotRect();
+    const QPointF pos = event->localPos();
+    switch (m_dragCursor) {
+    case TimeCursor1:
+    case TimeCursor2:
+        m_timeCursor[m_dragCursor - TimeCursor1] =
+                std::min(1.0, std::max(0.0, (pos.x() - rect.left()) / std::max(1.0, rect.width())));
+        update();
+        return;
+    case VoltCursor1:
+    case VoltCursor2: {
+        const double t = std::min(1.0, std::max(0.0, (rect.bottom() - pos.y()) / std::max(1.0, rect.height())));
+        m_voltCursor[m_dragCursor - VoltCursor1] = m_axisMin + t * (m_axisMax - m_axisMin);
+        update();
+        return;
+    }
+    default:
+        break;
+    }
+    // 悬停时提示可拖动方向
+    const CursorId hover = cursorAt(pos);
+    if (hover == TimeCursor1 || hover == TimeCursor2) {
+        setCursor(Qt::SizeHorCursor);
+    } else if (hover == VoltCursor1 || hover == VoltCursor2) {
+        setCursor(Qt::SizeVerCursor);
+    } else {
+        unsetCursor();
+    }
+}
+
+void OscilloscopeWidget::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (m_dragCursor == NoCursor) QWidget::mouseReleaseEvent(event);
+    m_dragCursor = NoCursor;
+}
+
+void OscilloscopeWidget::drawMarkerAndCaption(QPainter &p, const QRectF &rect, int visibleStart, int visibleCount) const
+{
+    const int marker = m_markerIndex - visibleStart;
+    if (m_markerIndex >= 0 && marker >= 0 && marker < visibleCount && visibleCount > 1) {
+        // 事件标记：红色虚线
+        const double x = rect.left() + rect.width() * marker / (visibleCount - 1);
+        p.setPen(QPen(QColor("#ff3b30"), 1.5, Qt::DashLine));
+        p.drawLine(QPointF(x, rect.top()), QPointF(x, rect.bottom()));
+    }
+    if (!m_caption.isEmpty()) {
+        p.setPen(QPen(QColor("#8e8e93"), 1.2));
+        p.drawText(rect.adjusted(6, 4, -6, -4), Qt::AlignRight | Qt::AlignTop, m_caption);
+    }
+}
+
+void OscilloscopeWidget::drawRulerLabels(QPainter &p, const QRectF &rect, double labelMin, double labelMax) const
+{
+    p.setPen(QPen(QColor("#3a3a3c"), 1.2));
+    const int ticks = 5;
+    for (int i = 0; i <= ticks; ++i) {
+        double t = static_cast<double>(i) / ticks;
+        double y = rect.top() + rect.height() * t;
+        double value = labelMax - t * (labelMax - labelMin);
+        p.drawText(QRectF(4, y - 10, kLeftMargin - 12, 20), Qt::AlignRight | Qt::AlignVCenter,
+                   QString::number(value, 'f', 2) + " V");
+    }
+}
+
+void OscilloscopeWidget::drawTrace(QPainter &p, const QRectF &rect, const SampleRing::Span &values, double minVal, double span) const
+{
+    const int n = values.size();
+    for (int i = 0; i < n - 1; ++i) {
+        const double t0 = static_cast<double>(i) / (n - 1);
+        const double t1 = static_cast<double>(i + 1) / (n - 1);
+        const double v0 = (values[i] - minVal) / span;
+        const double v1 = (values[i + 1] - minVal) / span;
+        QPointF p0(rect.left() + t0 * rect.width(),
+                   rect.bottom() - v0 * rect.height());
+        QPointF p1(rect.left() + t1 * rect.width(),
+                   rect.bottom() - v1 * rect.height());
+        p.drawLine(p0, p1);
+    }
+}
+
+double OscilloscopeWidget::valueAt(int index) const
+{
+    if (index < 0 || index >= valueCount()) return 0.0;
+    return m_values->at(m_values->begin() + index);
+}
+
+void OscilloscopeWidget::visibleRange(int size, int *start, int *end) const
+{
+    // 计算当前时基下需要展示的样本数
+    const double totalTimeSec = (m_timeBaseMs / 1000.0) * 10.0; // 10 div
+    const int samples = static_cast<int>(std::min(2e9, totalTimeSec * m_sampleRate));
+    *start = 0;
+    *end = 0;
+    if (samples <= 0 || size <= 0) return;
+    // 仅截取尾部窗口（回看时向前平移），避免全量渲染过多数据
+    *end = std::max(std::min(samples, size), size - m_viewOffset);
+    *start = std::max(0, *end - samples);
+}
+
+SampleRing::Span OscilloscopeWidget::visibleSpan(int start, int end) const
+{
+    if (!m_values || end <= start) return SampleRing::Span();
+    return m_values->span(m_values->begin() + start, end - start);
+}
+
+void OscilloscopeWidget::overlayRange(qint64 first, int count, qint64 *overlayFirst, int *overlayCount,
+                                      int *offset) const
+{
+    // 按绝对序号对齐：叠加波形样本 k 画在主波形样本 k + delay 处，两者都以最新样本为准
+    *overlayFirst = 0;
+    *overlayCount = 0;
+    *offset = 0;
+    if (!m_overlayValues || count <= 0) return;
+    const qint64 from = std::max(first - m_overlayDelay, m_overlayValues->begin());
+    const qint64 to = std::min(first + count - m_overlayDelay, m_overlayValues->end());
+    if (to <= from) return;
+    *overlayFirst = from;
+    *overlayCount = static_cast<int>(to - from);
+    *offset = static_cast<int>(from + m_overlayDelay - first);
+}
+
+void OscilloscopeWidget::computeStats()
+{
+    // 只对当前可见的数据窗口做统计；点多时交给光栅化线程，避免在界面线程扫描整屏
+    int start = 0, end = 0;
+    visibleRange(valueCount(), &start, &end);
+    if (end - start >= kRasterThreshold) return;
+    m_stats = ScopeMeasure::measure(visibleSpan(start, end), m_sampleRate);
+}
@@ -0,0 +1,141 @@
+#ifndef OSCILLOSCOPEWIDGET_H
+#define OSCILLOSCOPEWIDGET_H
+
+#include <QWidget>
+#include <QVector>
+#include <QImage>
+#include <functional>
+
+#include "scopeindex.h"
+#include "scopeinterp.h"
+#include "scopemeasure.h"
+#include "scopering.h"
+
+class QPainter;
+class QThread;
+class PersistenceWorker;
+class TraceRenderWorker;
+
+// 简易示波器绘制组件：负责波形显示及基本测量计算
+class OscilloscopeWidget : public QWidget
+{
+public:
+    using Stats = ScopeMeasure::Result;
+
+    explicit OscilloscopeWidget(QWidget *parent = nullptr);
+    ~OscilloscopeWidget() override;
+
+    void configure(double sampleRate, double timeBaseMs, double gain, double vMin, double vMax);
+    // 实时历史：直接引用界面线程追加的环形缓冲，不复制；下文的样本位置均以缓冲的 begin() 为 0
+    // 同一缓冲只在末尾追加时光标统计索引增量更新，换了缓冲则整体重建
+    void setValues(const QSharedPointer<const SampleRing> &values);
+    // 独立的一段数据（如平均帧）
+    void setValues(const QVector<double> &values);
+    // 叠加显示的参考波形（如滤波前的原始数据），不参与测量，与主波形使用同一套绝对样本序号；
+    // delay 为主波形相对它的延迟样本数（如滤波器群延迟），其样本 k 画在主波形样本 k + delay 处；空指针不显示
+    void setOverlayValues(const QSharedPointer<const SampleRing> &values, int delay = 0);
+    // 可见样本少时测量在 setValues 中完成，多时由后台线程随绘制算好，送回后调用 listener
+    const Stats &stats() const { return m_stats; }
+    void setStatsListener(const std::function<void()> &listener) { m_statsListener = listener; }
+    // 绘图区右上角的模式说明（如平均帧数），空字符串不显示
+    void setCaption(const QString &caption);
+    // 回看：窗口右端距数据末尾的样本数，0 为实时跟随最新数据
+    void setViewOffset(int samplesFromEnd);
+    int viewOffset() const { return m_viewOffset; }
+    // 在 setValues 数据中第 index 个样本处画竖线标记，-1 不显示
+    void setMarkerIndex(int index);
+    // 放大到每个样本占多个像素时用 sin(x)/x 重建波形代替折线
+    void setSincInterpolation(bool enabled);
+    bool sincInterpolation() const { return m_sincEnabled; }
+    // 测量光标：两条时间光标与两条电压光标，鼠标拖动，读数显示在绘图区左上角
+    void setCursorsEnabled(bool enabled);
+    bool cursorsEnabled() const { return m_cursorsEnabled; }
+
+    // 余辉模式：触发帧在后台线程累积为命中密度图，界面只负责贴图
+    void setPersistenceEnabled(bool enabled);
+    bool persistenceEnabled() const { return m_persistenceEnabled; }
+    void setPersistenceRange(double vLow, double vHigh);
+    void setPersistenceDecay(double percentPerSecond);
+    void addPersistenceFrames(const QVector<float> &frames, int frameLength);
+    void clearPersistence();
+
+protected:
+    void paintEvent(QPaintEvent *) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+
+private:
+    enum CursorId {
+        NoCursor = -1,
+        TimeCursor1,
+        TimeCursor2,
+        VoltCursor1,
+        VoltCursor2
+    };
+
+    QRectF plotRect() const;
+    void drawTrace(QPainter &p, const QRectF &rect, const SampleRing::Span &values, double minVal, double span) const;
+    void drawRulerLabels(QPainter &p, const QRectF &rect, double labelMin, double labelMax) const;
+    void ensurePersistenceWorker();
+    void updatePersistenceGeometry();
+    void ensureRasterWorker();
+    // 可见样本多时交给后台线程光栅化，少时仍由 paintEvent 直接绘制
+    void requestTraceRender();
+    void drawMarkerAndCaption(QPainter &p, const QRectF &rect, int visibleStart, int visibleCount) const;
+    void drawCursors(QPainter &p, const QRectF &rect, int visibleStart, int visibleCount);
+    CursorId cursorAt(const QPointF &pos) const;
+    int valueCount() const { return m_values ? m_values->size() : 0; }
+    // 位置 index 处的样本，越界返回 0
+    double valueAt(int index) const;
+    // 当前时基与回看偏移下的可见区间 [start, end)，不复制数据
+    void visibleRange(int size, int *start, int *end) const;
+    SampleRing::Span visibleSpan(int start, int end) const;
+    // 主波形绝对序号区间 [first, first + count) 对应的叠加波形区间，offset 为其首样本在主波形区间中的位置
+    void overlayRange(qint64 first, int count, qint64 *overlayFirst, int *overlayCount, int *offset) const;
+    void computeStats();
+
+    QSharedPointer<const SampleRing> m_values;
+    QSharedPointer<const SampleRing> m_overlayValues;
+    int m_overlayDelay = 0;
+    QString m_caption;
+    int m_viewOffset = 0;
+    int m_markerIndex = -1;
+    bool m_sincEnabled = false;
+    SincInterpolator m_sinc;
+
+    bool m_cursorsEnabled = false;
+    double m_timeCursor[2] = {0.25, 0.75};   // 占绘图区宽度的比例
+    double m_voltCursor[2] = {0.0, 0.0};     // 电压值
+    bool m_voltCursorsPlaced = false;
+    CursorId m_dragCursor = NoCursor;
+    double m_axisMin = 0.0;                  // 最近一次绘制的纵轴范围，供鼠标位置换算
+    double m_axisMax = 1.0;
+    RangeIndex m_rangeIndex;                 // 光标区间统计，数据变化后在下次绘制光标时更新
+    bool m_rangeIndexDirty = true;
+    Stats m_stats;
+    std::function<void()> m_statsListener;
+    double m_sampleRate = 1000.0;
+    double m_timeBaseMs = 50.0;
+    double m_gain = 1.0;
+    double m_vMin = 0.0;
+    double m_vMax = 3.3;
+
+    bool m_persistenceEnabled = false;
+    double m_persistLow = 0.0;
+    double m_persistHigh = 3.3;
+    QThread *m_persistThread = nullptr;
+    PersistenceWorker *m_persistWorker = nullptr;
+    QImage m_persistImage;
+    qint64 m_persistFrames = 0;
+
+    QThread *m_rasterThread = nullptr;
+    TraceRenderWorker *m_rasterWorker = nullptr;
+    QImage m_traceImage;       // 最近完成的一帧，界面线程只负责贴图
+    double m_traceMin = 0.0;   // 该帧使用的纵轴范围
+    double m_traceMax = 0.0;
+    int m_renderSerial = 0;
+};
+
+#endif // OSCILLOSCOPEWIDGET_H
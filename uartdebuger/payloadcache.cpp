@@ -0,0 +1,103 @@
+#include "payloadcache.h"
+
+#include <QTextCodec>
+
+namespace {
+const qint8 kSkip = -2;
+const qint8 kInvalid = -1;
+
+// ASCII 到半字节值的查找表：十六进制数字为 0~15，可忽略的空白为 kSkip，其余无效
+struct HexTable {
+    qint8 values[128];
+    HexTable()
+    {
+        for (int c = 0; c < 128; ++c) values[c] = kInvalid;
+        for (int c = '0'; c <= '9'; ++c) values[c] = static_cast<qint8>(c - '0');
+        for (int c = 'a'; c <= 'f'; ++c) values[c] = static_cast<qint8>(c - 'a' + 10);
+        for (int c = 'A'; c <= 'F'; ++c) values[c] = static_cast<qint8>(c - 'A' + 10);
+        values[' '] = kSkip;
+        values['\n'] = kSkip;
+        values['\r'] = kSkip;
+    }
+};
+
+const HexTable &hexTable()
+{
+    static const HexTable t;
+    return t;
+}
+}
+
+void PayloadCache::setFormat(const QByteArray &codecName, const QString &newline)
+{
+    if (m_generation > 1 && codecName == m_codecName && newline == m_newline) return;
+    m_codecName = codecName;
+    m_newline = newline;
+    m_hexNewline = newline.toUtf8();
+    ++m_generation;
+}
+
+void PayloadCache::compile(Entry &entry, const QString &text, bool hex) const
+{
+    entry.payload.clear();
+    entry.error.clear();
+    if (hex) {
+        entry.ok = decodeHex(text, &entry.payload, &entry.error);
+        if (entry.ok) entry.payload.append(m_hexNewline);
+    } else {
+        entry.payload = encodeText(text + m_newline, m_codecName);
+        entry.ok = true;
+    }
+    if (!entry.ok) entry.payload.clear();
+    entry.generation = m_generation;
+}
+
+bool PayloadCache::decodeHex(const QString &text, QByteArray *out, QString *error)
+{
+    const qint8 *table = hexTable().values;
+    const QChar *chars = text.constData();
+    const int n = text.size();
+    out->clear();
+    out->reserve(n / 2);
+    int digits = 0;
+    bool valid = true;
+    int high = 0;
+    for (int i = 0; i < n; ++i) {
+        const ushort c = chars[i].unicode();
+        const qint8 v = c < 128 ? table[c] : kInvalid;
+        if (v == kSkip) continue;
+        ++digits;
+        if (v < 0) {
+            valid = false;
+            continue;
+        }
+        if (digits & 1) {
+            high = v;
+        } else {
+            out->append(static_cast<char>((high << 4) | v));
+        }
+    }
+    // 与逐字节解析时的提示顺序一致：先检查长度，再检查内容
+    if (digits & 1) {
+        *error = QStringLiteral("HEX 字符串长度必须为偶数。");
+        return false;
+    }
+    if (!valid) {
+        *error = QStringLiteral("HEX 内容无效。");
+        return false;
+    }
+    return true;
+}
+
+QByteArray PayloadCache::encodeText(const QString &text, const QByteArray &codecName)
+{
+    // 按选择的编码将 Unicode 文本转为字节
+    if (codecName.isEmpty()) {
+        return text.toLocal8Bit();
+    }
+    QTextCodec *codec = QTextCodec::codecForName(codecName);
+    if (!codec) {
+        return text.toUtf8();
+    }
+    return codec->fromUnicode(text);
+}
@@ -0,0 +1,40 @@
+#ifndef PAYLOADCACHE_H
+#define PAYLOADCACHE_H
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+
+// 发送内容编译缓存：文本/HEX 只在内容、编码或换行变化后编译一次，之后每次发送直接复用字节数组
+// 编码与换行属于全局格式，变化时递增代号，使所有已编译条目一并失效
+class PayloadCache
+{
+public:
+    // 一段发送内容的编译结果；generation 与缓存当前代号不同即视为过期
+    struct Entry {
+        quint64 generation = 0;
+        bool ok = false;
+        QByteArray payload;
+        QString error;
+    };
+
+    // codecName 为空表示本地 8 位编码；格式未变化时不会使条目失效
+    void setFormat(const QByteArray &codecName, const QString &newline);
+    quint64 generation() const { return m_generation; }
+    bool isCurrent(const Entry &entry) const { return entry.generation == m_generation; }
+    // 按当前格式编译 text，结果写入 entry
+    void compile(Entry &entry, const QString &text, bool hex) const;
+    static void invalidate(Entry &entry) { entry.generation = 0; }
+
+    // 查表解码 HEX 文本，忽略空格与换行
+    static bool decodeHex(const QString &text, QByteArray *out, QString *error);
+    static QByteArray encodeText(const QString &text, const QByteArray &codecName);
+
+private:
+    QByteArray m_codecName;
+    QString m_newline;
+    QByteArray m_hexNewline;    // HEX 模式追加的换行（UTF-8）
+    quint64 m_generation = 1;
+};
+
+#endif // PAYLOADCACHE_H
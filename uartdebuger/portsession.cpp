@@ -0,0 +1,300 @@
+#include "portsession.h"
+
+#include "nativeport.h"
+
+#include <QTimer>
+#include <QtAlgorithms>
+#include <algorithm>
+
+namespace {
+const int kLineFlushMs = 100;
+const int kMaxLineBytes = 4096;
+}
+
+PortSession::PortSession()
+{
+    m_decoder.subscribe([this](const FrameDecoder::Frame &frame) {
+        addRecord(frame.timestampNs, QStringLiteral("#%1 (%2) %3").arg(frame.sequence).arg(frame.size)
+                  .arg(QString::fromLatin1(QByteArray::fromRawData(frame.data, frame.size).toHex(' ').toUpper())));
+        m_frameCodes.clear();
+        FrameDecoder::appendSamples(frame, m_config.frames.samples, &m_frameCodes);
+        addSamples(m_frameCodes, frame.timestampNs);
+    });
+}
+
+PortSession::~PortSession()
+{
+    stop();
+}
+
+QString PortSession::modeName(Mode mode)
+{
+    switch (mode) {
+    case Lines: return QStringLiteral("文本行");
+    case Hex: return QStringLiteral("HEX");
+    case Frames: return QStringLiteral("分帧");
+    default: return QString();
+    }
+}
+
+void PortSession::start(const Config &config)
+{
+    stop();
+    m_config = config;
+    m_stop = false;
+    m_line.clear();
+    m_sampleToken.clear();
+    m_decoder.configure(config.frames);
+    m_decoder.setEnabled(config.mode == Frames);
+    {
+        QMutexLocker locker(&m_mutex);
+        m_pending.clear();
+        m_samples = Samples();
+        m_stats = Stats();
+    }
+    QThread::start(QThread::HighPriority);
+}
+
+void PortSession::stop()
+{
+    m_stop = true;
+    // 事件循环尚未开始时 exec() 会立即返回
+    quit();
+    wait();
+    QMutexLocker locker(&m_mutex);
+    m_stats.open = false;
+}
+
+PortSession::Stats PortSession::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stats;
+}
+
+void PortSession::takeRecords(QVector<Record> *out)
+{
+    QMutexLocker locker(&m_mutex);
+    *out += m_pending;
+    m_pending.clear();
+}
+
+PortSession::Samples PortSession::samples() const
+{
+    QMutexLocker locker(&m_mutex);
+    Samples s = m_samples;
+    const int excess = s.codes.size() - kMaxSamples;
+    if (excess > 0) {
+        s.codes.remove(0, excess);
+        s.timestampsNs.remove(0, excess);
+        s.firstIndex += excess;
+    }
+    return s;
+}
+
+void PortSession::run()
+{
+    // 串口对象必须在使用它的线程中创建，其通知才会投递到本线程的事件循环
+    QSerialPort port;
+    port.setPortName(m_config.portName);
+    const bool configured = port.setBaudRate(m_config.baudRate) && port.setDataBits(m_config.dataBits)
+            && port.setParity(m_config.parity) && port.setStopBits(m_config.stopBits)
+            && port.setFlowControl(m_config.flowControl);
+    if (!configured || !port.open(QIODevice::ReadOnly)) {
+        QMutexLocker locker(&m_mutex);
+        m_stats.error = QStringLiteral("无法打开：") + port.errorString();
+        return;
+    }
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stats.open = true;
+    }
+
+    connect(&port, &QSerialPort::readyRead, &port, [this, &port]() {
+        const QByteArray data = port.readAll();
+        if (!data.isEmpty()) handleData(data, NativePort::nowNanos());
+    });
+    connect(&port, &QSerialPort::errorOccurred, &port, [this, &port](QSerialPort::SerialPortError error) {
+        if (error != QSerialPort::ResourceError && error != QSerialPort::PermissionError
+                && error != QSerialPort::DeviceNotFoundError) {
+            return;
+        }
+        {
+            QMutexLocker locker(&m_mutex);
+            m_stats.error = port.errorString();
+        }
+        quit();
+    });
+    // 文本行模式下，没有换行的数据超过 100 ms 也送出
+    QTimer flushTimer;
+    flushTimer.setInterval(kLineFlushMs);
+    connect(&flushTimer, &QTimer::timeout, &port, [this]() { flushLine(false); });
+    if (m_config.mode == Lines) flushTimer.start();
+
+    if (!m_stop.load()) exec();
+    flushLine(true);
+    port.close();
+}
+
+void PortSession::handleData(const QByteArray &data, qint64 timestampNs)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stats.bytes += data.size();
+    }
+    m_lastDataNs = timestampNs;
+    switch (m_config.mode) {
+    case Lines: {
+        int from = 0;
+        while (from < data.size()) {
+            if (m_line.isEmpty()) {
+                m_lineTimestampNs = timestampNs;
+                m_pendingLineNs = timestampNs;
+            }
+            const int newline = data.indexOf('\n', from);
+            const int end = newline < 0 ? data.size() : newline;
+            m_line.append(data.constData() + from, end - from);
+            from = end + 1;
+            if (newline >= 0 || m_line.size() >= kMaxLineBytes) flushLine(true);
+        }
+        parseSamples(data, timestampNs);
+        break;
+    }
+    case Hex:
+        addRecord(timestampNs, QString::fromLatin1(data.toHex(' ').toUpper()));
+        break;
+    case Frames:
+        m_decoder.feed(data, timestampNs);
+        {
+            QMutexLocker locker(&m_mutex);
+            m_stats.frames = m_decoder.stats();
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void PortSession::flushLine(bool force)
+{
+    if (m_line.isEmpty()) return;
+    if (!force && NativePort::nowNanos() - m_lastDataNs < kLineFlushMs * 1000000LL) return;
+    if (m_line.endsWith('\r')) m_line.chop(1);
+    addRecord(m_lineTimestampNs, QString::fromUtf8(m_line));
+    m_line.clear();
+    // 记录已进入待取队列后再撤下低水位，collect 先读低水位再取记录，不会两头都错过
+    m_pendingLineNs = std::numeric_limits<qint64>::max();
+}
+
+void PortSession::addRecord(qint64 timestampNs, const QString &text)
+{
+    Record record;
+    record.timestampNs = timestampNs;
+    record.text = text;
+    QMutexLocker locker(&m_mutex);
+    m_pending.append(record);
+    ++m_stats.records;
+    if (m_pending.size() > kMaxPendingRecords) {
+        const int drop = m_pending.size() - kMaxPendingRecords;
+        m_pending.remove(0, drop);
+        m_stats.droppedRecords += drop;
+    }
+}
+
+void PortSession::parseSamples(const QByteArray &data, qint64 timestampNs)
+{
+    // 分隔符与示波器的数字流一致
+    QVector<int> codes;
+    for (char c : data) {
+        if (c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == ',' || c == ';') {
+            if (!m_sampleToken.isEmpty()) {
+                bool ok = false;
+                const int code = m_sampleToken.toInt(&ok, 10);
+                if (ok) codes.append(code);
+                m_sampleToken.clear();
+            }
+        } else if (m_sampleToken.size() < kMaxLineBytes) {
+            m_sampleToken.append(c);
+        }
+    }
+    addSamples(codes, timestampNs);
+}
+
+void PortSession::addSamples(const QVector<int> &codes, qint64 timestampNs)
+{
+    if (codes.isEmpty()) return;
+    QMutexLocker locker(&m_mutex);
+    m_samples.codes += codes;
+    const int from = m_samples.timestampsNs.size();
+    m_samples.timestampsNs.resize(from + codes.size());
+    std::fill(m_samples.timestampsNs.begin() + from, m_samples.timestampsNs.end(), timestampNs);
+    m_stats.samples += codes.size();
+    if (m_samples.codes.size() > 2 * kMaxSamples) {
+        const int drop = m_samples.codes.size() - kMaxSamples;
+        m_samples.codes.remove(0, drop);
+        m_samples.timestampsNs.remove(0, drop);
+        m_samples.firstIndex += drop;
+    }
+}
+
+SessionManager::~SessionManager()
+{
+    clear();
+}
+
+int SessionManager::add(const PortSession::Config &config)
+{
+    if (m_sessions.isEmpty() && m_backlog.isEmpty()) m_epochNs = NativePort::nowNanos();
+    PortSession *session = new PortSession;
+    m_sessions.append(session);
+    session->start(config);
+    return m_sessions.size() - 1;
+}
+
+void SessionManager::remove(int index)
+{
+    PortSession *session = m_sessions[index];
+    session->stop();
+    delete session;
+    m_sessions.remove(index);
+    // 后面会话的序号前移；被移除会话尚未输出的记录一并丢弃
+    QVector<PortSession::Record> kept;
+    for (const PortSession::Record &r : m_backlog) {
+        if (r.session == index) continue;
+        kept.append(r);
+        if (r.session > index) --kept.last().session;
+    }
+    m_backlog = kept;
+}
+
+void SessionManager::clear()
+{
+    qDeleteAll(m_sessions);
+    m_sessions.clear();
+    m_backlog.clear();
+}
+
+void SessionManager::collect(qint64 holdbackNs, QVector<PortSession::Record> *out, bool flushAll)
+{
+    // 先读各路半行的时间戳再取记录：半行送出时的时间戳不早于这里读到的值
+    qint64 watermark = NativePort::nowNanos() - holdbackNs;
+    for (const PortSession *session : m_sessions) watermark = std::min(watermark, session->pendingLineNs());
+    const int before = m_backlog.size();
+    for (int i = 0; i < m_sessions.size(); ++i) {
+        const int from = m_backlog.size();
+        m_sessions[i]->takeRecords(&m_backlog);
+        for (int k = from; k < m_backlog.size(); ++k) m_backlog[k].session = i;
+    }
+    auto earlier = [](const PortSession::Record &a, const PortSession::Record &b) {
+        return a.timestampNs < b.timestampNs;
+    };
+    // 积压部分本已有序，只需把新到的部分排序后归并
+    if (m_backlog.size() > before) {
+        std::stable_sort(m_backlog.begin() + before, m_backlog.end(), earlier);
+        std::inplace_merge(m_backlog.begin(), m_backlog.begin() + before, m_backlog.end(), earlier);
+    }
+    int ready = 0;
+    while (ready < m_backlog.size() && (flushAll || m_backlog[ready].timestampNs <= watermark)) ++ready;
+    if (ready == 0) return;
+    out->append(m_backlog.mid(0, ready));
+    m_backlog.remove(0, ready);
+}
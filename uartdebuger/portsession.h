@@ -0,0 +1,136 @@
+#ifndef PORTSESSION_H
+#define PORTSESSION_H
+
+#include "framedecoder.h"
+
+#include <QByteArray>
+#include <QMutex>
+#include <QSerialPort>
+#include <QString>
+#include <QThread>
+#include <QVector>
+#include <atomic>
+#include <limits>
+
+// 多串口会话中的一路：串口在自己的线程里打开并运行事件循环，readAll() 处用共享单调时钟
+// （NativePort::nowNanos）打时间戳，在本线程内分行/转 HEX/分帧成记录并解析出样本，
+// GUI 线程只取走格式化好的记录或样本快照
+class PortSession : public QThread
+{
+public:
+    enum Mode {
+        Lines,           // 按 \n 分行，无换行时 100 ms 后把半行也送出
+        Hex,             // 每个接收块一条 HEX 记录
+        Frames,          // 按分帧配置解码，每帧一条
+        ModeCount
+    };
+
+    struct Config {
+        QString portName;
+        QString label;                   // 合并视图中的名称，空则用端口名
+        qint32 baudRate = 115200;
+        QSerialPort::DataBits dataBits = QSerialPort::Data8;
+        QSerialPort::Parity parity = QSerialPort::NoParity;
+        QSerialPort::StopBits stopBits = QSerialPort::OneStop;
+        QSerialPort::FlowControl flowControl = QSerialPort::NoFlowControl;
+        Mode mode = Lines;
+        FrameDecoder::Config frames;     // Frames 模式使用
+    };
+
+    struct Record {
+        qint64 timestampNs = 0;          // 记录首字节所在块的读取时刻
+        int session = -1;                // 由 SessionManager 填写
+        QString text;
+    };
+
+    struct Stats {
+        bool open = false;
+        QString error;
+        qint64 bytes = 0;
+        qint64 records = 0;
+        qint64 droppedRecords = 0;       // GUI 取得太慢、积压超限丢弃的记录
+        qint64 samples = 0;              // 累计解析出的样本数
+        FrameDecoder::Stats frames;
+    };
+
+    // 本路样本缓冲：文本行模式按示波器相同的分隔符解析数字流，分帧模式按分帧配置取载荷样本，
+    // HEX 模式不产生样本；每个样本带所在块的读取时刻
+    struct Samples {
+        qint64 firstIndex = 0;           // codes[0] 的绝对样本序号
+        QVector<int> codes;
+        QVector<qint64> timestampsNs;
+    };
+
+    // 未取走记录的上限，超出丢弃最旧的
+    static const int kMaxPendingRecords = 50000;
+    // 样本缓冲保留最近的样本数
+    static const int kMaxSamples = 262144;
+
+    PortSession();
+    ~PortSession();
+
+    void start(const Config &config);
+    void stop();
+    const Config &config() const { return m_config; }
+    QString label() const { return m_config.label.isEmpty() ? m_config.portName : m_config.label; }
+    Stats stats() const;
+    // 取走新记录（按时间先后）追加到 out
+    void takeRecords(QVector<Record> *out);
+    // 样本缓冲的快照，最多 kMaxSamples 个
+    Samples samples() const;
+    // 尚未送出的半行的时间戳（即它送出时的记录时间戳），没有半行时为 qint64 最大值；可在其他线程读取
+    qint64 pendingLineNs() const { return m_pendingLineNs.load(); }
+
+    static QString modeName(Mode mode);
+
+protected:
+    void run() override;
+
+private:
+    void handleData(const QByteArray &data, qint64 timestampNs);
+    void flushLine(bool force);
+    void addRecord(qint64 timestampNs, const QString &text);
+    void parseSamples(const QByteArray &data, qint64 timestampNs);
+    void addSamples(const QVector<int> &codes, qint64 timestampNs);
+
+    Config m_config;
+    std::atomic<bool> m_stop{false};
+    std::atomic<qint64> m_pendingLineNs{std::numeric_limits<qint64>::max()};
+    // 以下仅工作线程访问
+    FrameDecoder m_decoder;
+    QByteArray m_line;
+    qint64 m_lineTimestampNs = 0;
+    qint64 m_lastDataNs = 0;
+    QByteArray m_sampleToken;            // 跨块未完的数字
+    QVector<int> m_frameCodes;           // 单帧载荷解出的样本，复用缓冲
+    mutable QMutex m_mutex;
+    QVector<Record> m_pending;
+    Samples m_samples;                   // 超过 2 * kMaxSamples 时一次丢弃最旧的部分
+    Stats m_stats;
+};
+
+// 会话管理：持有 N 路 PortSession，把各路记录按时间戳归并成一条时间线。
+// 各路记录各自有序，但线程间到达有先后，只输出早于“当前时刻 - 保留窗口”的记录；文本行记录带首字节的时刻，
+// 却要等换行才送出，所以还不能晚于任一路尚未送出的半行（各路的低水位），保证合并后仍然有序
+class SessionManager
+{
+public:
+    ~SessionManager();
+
+    int add(const PortSession::Config &config);
+    void remove(int index);
+    void clear();
+    int count() const { return m_sessions.size(); }
+    const PortSession *session(int index) const { return m_sessions[index]; }
+    // 合并视图的时间零点（首个会话打开时刻）
+    qint64 epochNs() const { return m_epochNs; }
+    // 取出各路已到期的记录并按时间戳归并追加到 out；flushAll 时不保留窗口
+    void collect(qint64 holdbackNs, QVector<PortSession::Record> *out, bool flushAll = false);
+
+private:
+    QVector<PortSession *> m_sessions;
+    QVector<PortSession::Record> m_backlog;   // 尚未到期的记录，已按时间排序
+    qint64 m_epochNs = 0;
+};
+
+#endif // PORTSESSION_H
@@ -0,0 +1,172 @@
+#include "portwatcher.h"
+
+#include "nativeport.h"
+
+#ifdef Q_OS_LINUX
+#include <errno.h>
+#include <linux/netlink.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+const int kWaitMs = 100;
+const qint64 kSettleNs = 150 * 1000000LL;      // 一次插拔会连发多条通知，且设备节点稍后才就绪
+const qint64 kFallbackPollNs = 2500 * 1000000LL;
+
+#ifdef Q_OS_LINUX
+// uevent 报文："add@/devices/...\0ACTION=add\0SUBSYSTEM=tty\0DEVNAME=ttyUSB0\0..."
+bool isTtyAddRemove(const char *buffer, int size)
+{
+    bool tty = false;
+    bool addRemove = false;
+    int pos = 0;
+    while (pos < size) {
+        const char *field = buffer + pos;
+        const int length = static_cast<int>(strnlen(field, static_cast<size_t>(size - pos)));
+        if (length == 13 && strncmp(field, "SUBSYSTEM=tty", 13) == 0) tty = true;
+        if ((length == 10 && strncmp(field, "ACTION=add", 10) == 0)
+                || (length == 13 && strncmp(field, "ACTION=remove", 13) == 0)) {
+            addRemove = true;
+        }
+        pos += length + 1;
+    }
+    return tty && addRemove;
+}
+#endif
+}
+
+PortWatcher::PortWatcher()
+{
+}
+
+PortWatcher::~PortWatcher()
+{
+    stop();
+}
+
+void PortWatcher::start(const QStringList &known, QObject *context, const ChangeHandler &handler)
+{
+    stop();
+    m_known = known;
+    m_context = context;
+    m_handler = handler;
+    m_stop = false;
+    m_rescanRequested = false;
+    m_eventDriven = false;
+#ifdef Q_OS_LINUX
+    m_socket = ::socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_KOBJECT_UEVENT);
+    if (m_socket >= 0) {
+        sockaddr_nl addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.nl_family = AF_NETLINK;
+        addr.nl_groups = 1;    // 内核广播组；不依赖 udevd 与 libudev
+        if (::bind(m_socket, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+            ::close(m_socket);
+            m_socket = -1;
+        }
+    }
+    m_eventDriven = m_socket >= 0;
+#elif defined(Q_OS_WIN)
+    m_eventDriven = true;
+#endif
+    QThread::start(QThread::LowPriority);
+}
+
+void PortWatcher::stop()
+{
+    m_stop = true;
+    {
+        QMutexLocker locker(&m_wakeMutex);
+        m_wake.wakeAll();
+    }
+    wait();
+#ifdef Q_OS_LINUX
+    if (m_socket >= 0) ::close(m_socket);
+#endif
+    m_socket = -1;
+}
+
+void PortWatcher::requestRescan()
+{
+    QMutexLocker locker(&m_wakeMutex);
+    m_rescanRequested = true;
+    m_wake.wakeAll();
+}
+
+bool PortWatcher::waitForHint(int timeoutMs)
+{
+#ifdef Q_OS_LINUX
+    if (m_socket >= 0) {
+        pollfd pfd;
+        pfd.fd = m_socket;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (::poll(&pfd, 1, timeoutMs) <= 0) return false;
+        bool hint = false;
+        char buffer[8192];
+        for (;;) {
+            sockaddr_nl sender;
+            socklen_t senderSize = sizeof(sender);
+            const ssize_t n = ::recvfrom(m_socket, buffer, sizeof(buffer), 0,
+                                         reinterpret_cast<sockaddr *>(&sender), &senderSize);
+            if (n < 0) {
+                // 接收缓冲溢出说明错过了通知，按有变化处理
+                if (errno == ENOBUFS) hint = true;
+                if (errno == EINTR || errno == ENOBUFS) continue;
+                break;
+            }
+            // 只接受内核发出的报文
+            if (sender.nl_pid == 0 && isTtyAddRemove(buffer, static_cast<int>(n))) hint = true;
+        }
+        return hint;
+    }
+#endif
+    QMutexLocker locker(&m_wakeMutex);
+    if (!m_rescanRequested.load() && !m_stop.load()) m_wake.wait(&m_wakeMutex, static_cast<unsigned long>(timeoutMs));
+    return false;
+}
+
+void PortWatcher::run()
+{
+    // 启动时枚举一次，补上调用方枚举之后的变化
+    qint64 dueNs = NativePort::nowNanos();
+    qint64 lastScanNs = dueNs;
+    while (!m_stop.load()) {
+        const qint64 now = NativePort::nowNanos();
+        if (dueNs != 0 && now >= dueNs) {
+            rescan();
+            dueNs = 0;
+            lastScanNs = now;
+        }
+        const int timeoutMs = dueNs != 0 ? qBound<int>(1, static_cast<int>((dueNs - now) / 1000000), kWaitMs) : kWaitMs;
+        const bool hint = waitForHint(timeoutMs);
+        if (m_stop.load()) break;
+        const qint64 after = NativePort::nowNanos();
+        if (hint || m_rescanRequested.exchange(false)) {
+            dueNs = after + kSettleNs;
+        } else if (!m_eventDriven.load() && dueNs == 0 && after - lastScanNs >= kFallbackPollNs) {
+            dueNs = after;
+        }
+    }
+}
+
+void PortWatcher::rescan()
+{
+    const QList<QSerialPortInfo> ports = QSerialPortInfo::availablePorts();
+    Change change;
+    QStringList names;
+    for (const QSerialPortInfo &info : ports) {
+        names << info.portName();
+        if (!m_known.contains(info.portName())) change.added.append(info);
+    }
+    for (const QString &name : m_known) {
+        if (!names.contains(name)) change.removed << name;
+    }
+    m_known = names;
+    if ((change.added.isEmpty() && change.removed.isEmpty()) || !m_handler || !m_context) return;
+    const ChangeHandler handler = m_handler;
+    QMetaObject::invokeMethod(m_context, [handler, change]() { handler(change); }, Qt::QueuedConnection);
+}
@@ -0,0 +1,58 @@
+#ifndef PORTWATCHER_H
+#define PORTWATCHER_H
+
+#include <QList>
+#include <QMutex>
+#include <QSerialPortInfo>
+#include <QStringList>
+#include <QThread>
+#include <QWaitCondition>
+#include <atomic>
+#include <functional>
+
+// 串口热插拔监视：工作线程等待系统的设备变化通知，收到后（合并 150 ms 内的连续通知）才枚举一次串口，
+// 与上次结果比对后只把增删差异投递给 GUI 线程；无设备变化时不做任何枚举。
+//   Linux    监听内核 uevent（NETLINK_KOBJECT_UEVENT）中 SUBSYSTEM=tty 的 add/remove
+//   Windows  由主窗口收到 WM_DEVICECHANGE 时调用 requestRescan()
+//   其他平台或 netlink 不可用时，在工作线程中每 2.5 s 枚举一次
+class PortWatcher : public QThread
+{
+public:
+    struct Change {
+        QList<QSerialPortInfo> added;
+        QStringList removed;             // 端口名
+    };
+
+    using ChangeHandler = std::function<void(const Change &change)>;
+
+    PortWatcher();
+    ~PortWatcher();
+
+    // known 为调用方已显示的端口名，首次枚举与之比对；回调以 QueuedConnection 投递到 context 所在线程
+    void start(const QStringList &known, QObject *context, const ChangeHandler &handler);
+    void stop();
+    // 外部得知设备可能变化时调用，可在任意线程
+    void requestRescan();
+    // 是否使用了系统通知（否则为工作线程定时枚举）
+    bool isEventDriven() const { return m_eventDriven.load(); }
+
+protected:
+    void run() override;
+
+private:
+    // 等待至多 timeoutMs，期间收到设备变化通知返回 true
+    bool waitForHint(int timeoutMs);
+    void rescan();
+
+    QStringList m_known;                 // 仅工作线程访问
+    QObject *m_context = nullptr;
+    ChangeHandler m_handler;
+    int m_socket = -1;
+    std::atomic<bool> m_stop{false};
+    std::atomic<bool> m_rescanRequested{false};
+    std::atomic<bool> m_eventDriven{false};
+    QMutex m_wakeMutex;
+    QWaitCondition m_wake;
+};
+
+#endif // PORTWATCHER_H
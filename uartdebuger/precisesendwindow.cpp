@@ -0,0 +1,199 @@
+#include "precisesendwindow.h"
+
+#include <QComboBox>
+#include <QDoubleSpinBox>
+#include <QGridLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPlainTextEdit>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QVBoxLayout>
+
+namespace {
+const int kRefreshIntervalMs = 250;
+}
+
+PreciseSendWindow::PreciseSendWindow(QWidget *parent)
+    : QWidget(parent, Qt::Window)
+{
+    setWindowTitle(QStringLiteral("精确定时发送"));
+    resize(560, 440);
+
+    m_rateSpin = new QDoubleSpinBox(this);
+    m_rateSpin->setRange(0.01, 10000000.0);
+    m_rateSpin->setDecimals(2);
+    m_rateSpin->setValue(100.0);
+    m_unitCombo = new QComboBox(this);
+    m_unitCombo->addItem(QStringLiteral("条/秒"), SendScheduler::MessagesPerSecond);
+    m_unitCombo->addItem(QStringLiteral("字节/秒"), SendScheduler::BytesPerSecond);
+    m_burstSpin = new QSpinBox(this);
+    m_burstSpin->setRange(1, 100000);
+    m_countSpin = new QSpinBox(this);
+    m_countSpin->setRange(0, 2000000000);
+    m_countSpin->setSpecialValueText(QStringLiteral("不限"));
+    m_spinMicrosSpin = new QSpinBox(this);
+    m_spinMicrosSpin->setRange(0, 20000);
+    m_spinMicrosSpin->setValue(200);
+    m_spinMicrosSpin->setSuffix(QStringLiteral(" µs"));
+    m_spinMicrosSpin->setToolTip(QStringLiteral("截止时刻前改为忙等的时长，越大越准但占用一个核心越多"));
+    m_periodLabel = new QLabel(this);
+    m_startButton = new QPushButton(QStringLiteral("开始"), this);
+    m_stopButton = new QPushButton(QStringLiteral("停止"), this);
+    m_stopButton->setEnabled(false);
+    m_report = new QPlainTextEdit(this);
+    m_report->setReadOnly(true);
+
+    QGridLayout *params = new QGridLayout;
+    params->addWidget(new QLabel(QStringLiteral("目标速率"), this), 0, 0);
+    params->addWidget(m_rateSpin, 0, 1);
+    params->addWidget(m_unitCombo, 0, 2);
+    params->addWidget(new QLabel(QStringLiteral("突发数"), this), 1, 0);
+    params->addWidget(m_burstSpin, 1, 1);
+    params->addWidget(new QLabel(QStringLiteral("总条数"), this), 2, 0);
+    params->addWidget(m_countSpin, 2, 1);
+    params->addWidget(new QLabel(QStringLiteral("忙等尾段"), this), 3, 0);
+    params->addWidget(m_spinMicrosSpin, 3, 1);
+    params->addWidget(m_periodLabel, 4, 0, 1, 3);
+    QHBoxLayout *buttons = new QHBoxLayout;
+    buttons->addStretch(1);
+    buttons->addWidget(m_startButton);
+    buttons->addWidget(m_stopButton);
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(params);
+    layout->addLayout(buttons);
+    layout->addWidget(m_report, 1);
+
+    connect(m_rateSpin, static_cast<void(QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged),
+            this, [this](double) { updatePeriodLabel(); });
+    connect(m_unitCombo, static_cast<void(QComboBox::*)(int)>(&QComboBox::currentIndexChanged),
+            this, [this](int) { updatePeriodLabel(); });
+    connect(m_burstSpin, static_cast<void(QSpinBox::*)(int)>(&QSpinBox::valueChanged),
+            this, [this](int) { updatePeriodLabel(); });
+    connect(m_startButton, &QPushButton::clicked, this, &PreciseSendWindow::start);
+    connect(m_stopButton, &QPushButton::clicked, this, &PreciseSendWindow::stop);
+
+    // 统计刷新只在发送期间运行，与窗口是否可见无关，以便及时发现发送结束
+    m_refreshTimer.setInterval(kRefreshIntervalMs);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &PreciseSendWindow::refresh);
+    updatePeriodLabel();
+}
+
+void PreciseSendWindow::setPayloadProvider(const PayloadProvider &provider)
+{
+    m_payloadProvider = provider;
+    updatePeriodLabel();
+}
+
+void PreciseSendWindow::setPortProvider(const PortProvider &provider)
+{
+    m_portProvider = provider;
+}
+
+void PreciseSendWindow::setSentHandler(const SentHandler &handler)
+{
+    m_sentHandler = handler;
+}
+
+void PreciseSendWindow::updatePeriodLabel()
+{
+    SendScheduler::Config cfg;
+    cfg.rate = m_rateSpin->value();
+    cfg.unit = static_cast<SendScheduler::RateUnit>(m_unitCombo->currentData().toInt());
+    cfg.burst = m_burstSpin->value();
+    int size = 0;
+    if (m_payloadProvider) {
+        bool ok = false;
+        QString error;
+        size = m_payloadProvider(&ok, &error).size();
+    }
+    const double period = SendScheduler::periodMicros(cfg, size);
+    if (period <= 0) {
+        m_periodLabel->setText(QStringLiteral("节拍周期：发送区为空"));
+        return;
+    }
+    m_periodLabel->setText(QStringLiteral("每条 %1 字节，节拍周期 %2 µs（%3 节拍/秒）")
+                           .arg(size).arg(period, 0, 'f', 1).arg(1e6 / period, 0, 'f', 1));
+}
+
+void PreciseSendWindow::start()
+{
+    QSerialPort::Handle handle = 0;
+    if (!m_portProvider || !m_portProvider(&handle)) {
+        m_report->setPlainText(QStringLiteral("串口未打开。"));
+        return;
+    }
+    bool ok = false;
+    QString error;
+    const QByteArray payload = m_payloadProvider ? m_payloadProvider(&ok, &error) : QByteArray();
+    if (!ok) {
+        m_report->setPlainText(error);
+        return;
+    }
+    SendScheduler::Config cfg;
+    cfg.rate = m_rateSpin->value();
+    cfg.unit = static_cast<SendScheduler::RateUnit>(m_unitCombo->currentData().toInt());
+    cfg.burst = m_burstSpin->value();
+    cfg.count = m_countSpin->value();
+    cfg.spinMicros = m_spinMicrosSpin->value();
+    m_reportedBytes = 0;
+    if (!m_scheduler.start(handle, payload, cfg, &error)) {
+        m_report->setPlainText(error);
+        return;
+    }
+    updatePeriodLabel();
+    m_startButton->setEnabled(false);
+    m_stopButton->setEnabled(true);
+    m_refreshTimer.start();
+}
+
+void PreciseSendWindow::stop()
+{
+    m_scheduler.stop();
+    if (m_refreshTimer.isActive()) {
+        m_refreshTimer.stop();
+        refresh();
+    }
+    m_startButton->setEnabled(true);
+    m_stopButton->setEnabled(false);
+}
+
+void PreciseSendWindow::refresh()
+{
+    const SendScheduler::Stats s = m_scheduler.stats();
+    if (m_sentHandler && s.bytes > m_reportedBytes) m_sentHandler(s.bytes - m_reportedBytes);
+    m_reportedBytes = s.bytes;
+
+    QString text;
+    text += s.running ? QStringLiteral("发送中\n") : QStringLiteral("已停止\n");
+    if (!s.error.isEmpty()) text += s.error + '\n';
+    text += QStringLiteral("已发送 %1 条，%2 字节，用时 %3 s\n")
+            .arg(s.messages).arg(s.bytes).arg(s.elapsedSeconds, 0, 'f', 3);
+    if (s.elapsedSeconds > 0) {
+        text += QStringLiteral("实际速率 %1 条/秒，%2 字节/秒（目标节拍 %3 µs）\n")
+                .arg(s.messages / s.elapsedSeconds, 0, 'f', 1).arg(s.bytes / s.elapsedSeconds, 0, 'f', 0)
+                .arg(s.periodMicros, 0, 'f', 1);
+    }
+    text += QStringLiteral("节拍 %1，超限 %2 次（跳过 %3 个节拍）\n")
+            .arg(s.ticks).arg(s.overruns).arg(s.skippedTicks);
+    const RunningMoments &late = s.lateness.moments();
+    if (late.count() > 0) {
+        text += QStringLiteral("\n唤醒滞后 (µs)：均值 %1，标准差 %2，最大 %3\n")
+                .arg(late.mean(), 0, 'f', 2).arg(late.stddev(), 0, 'f', 2).arg(late.max(), 0, 'f', 2);
+        text += QStringLiteral("  P50 %1  P90 %2  P99 %3  P99.9 %4\n")
+                .arg(s.lateness.quantile(0.5), 0, 'f', 2).arg(s.lateness.quantile(0.9), 0, 'f', 2)
+                .arg(s.lateness.quantile(0.99), 0, 'f', 2).arg(s.lateness.quantile(0.999), 0, 'f', 2);
+    }
+    const RunningMoments &write = s.writeMicros.moments();
+    if (write.count() > 0) {
+        text += QStringLiteral("单节拍写入耗时 (µs)：均值 %1，P99 %2，最大 %3\n")
+                .arg(write.mean(), 0, 'f', 2).arg(s.writeMicros.quantile(0.99), 0, 'f', 2).arg(write.max(), 0, 'f', 2);
+    }
+    m_report->setPlainText(text);
+
+    if (!s.running && m_refreshTimer.isActive()) {
+        m_refreshTimer.stop();
+        m_startButton->setEnabled(true);
+        m_stopButton->setEnabled(false);
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef PRECISESENDWINDOW_H
+#define PRECISESENDWINDOW_H
+
+#include "sendscheduler.h"
+
+#include <QTimer>
+#include <QWidget>
+#include <functional>
+
+class QComboBox;
+class QDoubleSpinBox;
+class QLabel;
+class QPlainTextEdit;
+class QPushButton;
+class QSpinBox;
+
+// 精确定时发送窗口：按条/秒或字节/秒的目标速率、突发数与总数发送当前发送区内容，
+// 实时显示实际速率、唤醒滞后（抖动）分布与超限次数，用于压测固件的 UART 接收路径
+class PreciseSendWindow : public QWidget
+{
+public:
+    // 返回当前发送区编译后的字节
+    using PayloadProvider = std::function<QByteArray(bool *ok, QString *error)>;
+    // 串口已打开时给出系统句柄并返回 true
+    using PortProvider = std::function<bool(QSerialPort::Handle *handle)>;
+    // 每次刷新时报告新写出的字节数，用于累计发送计数
+    using SentHandler = std::function<void(qint64 bytes)>;
+
+    explicit PreciseSendWindow(QWidget *parent = nullptr);
+
+    void setPayloadProvider(const PayloadProvider &provider);
+    void setPortProvider(const PortProvider &provider);
+    void setSentHandler(const SentHandler &handler);
+    bool isRunning() const { return m_scheduler.isRunning(); }
+    // 串口关闭前必须调用，保证工作线程不再使用句柄
+    void stop();
+
+private:
+    void start();
+    void updatePeriodLabel();
+    void refresh();
+
+    SendScheduler m_scheduler;
+    PayloadProvider m_payloadProvider;
+    PortProvider m_portProvider;
+    SentHandler m_sentHandler;
+    QTimer m_refreshTimer;
+    qint64 m_reportedBytes = 0;
+    QDoubleSpinBox *m_rateSpin = nullptr;
+    QComboBox *m_unitCombo = nullptr;
+    QSpinBox *m_burstSpin = nullptr;
+    QSpinBox *m_countSpin = nullptr;
+    QSpinBox *m_spinMicrosSpin = nullptr;
+    QLabel *m_periodLabel = nullptr;
+    QPushButton *m_startButton = nullptr;
+    QPushButton *m_stopButton = nullptr;
+    QPlainTextEdit *m_report = nullptr;
+};
+
+#endif // PRECISESENDWINDOW_H
@@ -0,0 +1,141 @@
+#include "ptyecho.h"
+
+#ifdef Q_OS_UNIX
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+namespace {
+const int kPollMs = 50;
+
+#ifdef Q_OS_UNIX
+QString errnoText()
+{
+    return QString::fromLocal8Bit(strerror(errno));
+}
+
+// 关闭行规程的回显与换行转换，否则写入的数据会被终端层改写或回显
+bool makeRaw(int fd)
+{
+    termios tio;
+    if (tcgetattr(fd, &tio) != 0) return false;
+    cfmakeraw(&tio);
+    return tcsetattr(fd, TCSANOW, &tio) == 0;
+}
+#endif
+}
+
+PtyEcho::PtyEcho()
+{
+}
+
+PtyEcho::~PtyEcho()
+{
+    stop();
+}
+
+bool PtyEcho::isSupported()
+{
+#ifdef Q_OS_UNIX
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool PtyEcho::start(QString *error)
+{
+    stop();
+#ifdef Q_OS_UNIX
+    m_master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (m_master < 0 || grantpt(m_master) != 0 || unlockpt(m_master) != 0 || !makeRaw(m_master)) {
+        *error = QStringLiteral("创建伪终端失败：%1").arg(errnoText());
+        if (m_master >= 0) ::close(m_master);
+        m_master = -1;
+        return false;
+    }
+    m_slaveName = QString::fromLocal8Bit(ptsname(m_master));
+    m_stop = false;
+    m_echoed = 0;
+    QThread::start();
+    return true;
+#else
+    *error = QStringLiteral("本平台不支持伪终端，请使用虚拟串口对加外部回环");
+    return false;
+#endif
+}
+
+void PtyEcho::stop()
+{
+    m_stop = true;
+    wait();
+#ifdef Q_OS_UNIX
+    if (m_master >= 0) ::close(m_master);
+#endif
+    m_master = -1;
+    m_slaveName.clear();
+}
+
+int PtyEcho::openSlave(QString *error) const
+{
+#ifdef Q_OS_UNIX
+    if (m_slaveName.isEmpty()) {
+        *error = QStringLiteral("回环未启动");
+        return -1;
+    }
+    const int fd = ::open(m_slaveName.toLocal8Bit().constData(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0 || !makeRaw(fd)) {
+        *error = QStringLiteral("打开 %1 失败：%2").arg(m_slaveName, errnoText());
+        if (fd >= 0) ::close(fd);
+        return -1;
+    }
+    return fd;
+#else
+    *error = QStringLiteral("本平台不支持伪终端");
+    return -1;
+#endif
+}
+
+void PtyEcho::closeSlave(int fd)
+{
+#ifdef Q_OS_UNIX
+    if (fd >= 0) ::close(fd);
+#else
+    Q_UNUSED(fd);
+#endif
+}
+
+void PtyEcho::run()
+{
+#ifdef Q_OS_UNIX
+    char buffer[4096];
+    while (!m_stop) {
+        pollfd pfd;
+        pfd.fd = m_master;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (::poll(&pfd, 1, kPollMs) <= 0) continue;
+        // 从端尚未打开或已关闭时读到 EIO，稍后重试
+        const ssize_t n = ::read(m_master, buffer, sizeof(buffer));
+        if (n <= 0) {
+            if (n < 0 && errno != EINTR && errno != EAGAIN) QThread::msleep(kPollMs);
+            continue;
+        }
+        ssize_t done = 0;
+        while (done < n && !m_stop) {
+            const ssize_t w = ::write(m_master, buffer + done, static_cast<size_t>(n - done));
+            if (w > 0) {
+                done += w;
+            } else if (w < 0 && errno != EINTR && errno != EAGAIN) {
+                break;
+            }
+        }
+        m_echoed += done;
+    }
+#endif
+}
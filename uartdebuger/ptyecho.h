@@ -0,0 +1,37 @@
+#ifndef PTYECHO_H
+#define PTYECHO_H
+
+#include <QString>
+#include <QThread>
+#include <atomic>
+
+// 本地回环替身：创建伪终端对，工作线程把写入从端的数据原样写回，用于在没有硬件时检验链路测试本身。
+// 仅 Unix 可用；Windows 请使用 com0com 等虚拟串口对加外部回环
+class PtyEcho : public QThread
+{
+public:
+    PtyEcho();
+    ~PtyEcho();
+
+    static bool isSupported();
+
+    bool start(QString *error);
+    void stop();
+    // 从端设备路径，如 /dev/pts/3
+    QString slaveName() const { return m_slaveName; }
+    // 以原始模式、非阻塞方式打开从端，返回文件描述符，失败返回 -1
+    int openSlave(QString *error) const;
+    static void closeSlave(int fd);
+    qint64 echoedBytes() const { return m_echoed.load(); }
+
+protected:
+    void run() override;
+
+private:
+    int m_master = -1;
+    QString m_slaveName;
+    std::atomic<bool> m_stop{false};
+    std::atomic<qint64> m_echoed{0};
+};
+
+#endif // PTYECHO_H
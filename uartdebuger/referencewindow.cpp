@@ -0,0 +1,156 @@
+#include "referencewindow.h"
+#include "scopereference.h"
+
+#include <QFile>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QListWidget>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QVBoxLayout>
+
+namespace {
+const int kRefreshIntervalMs = 500;
+
+QString eventText(const ReferenceChecker::Event &e)
+{
+    switch (e.kind) {
+    case ReferenceChecker::Dropped:
+        return QStringLiteral("样本 #%1：丢失 %2 个样本（期望表下标 %3）").arg(e.streamIndex).arg(e.count).arg(e.lutIndex);
+    case ReferenceChecker::Duplicated:
+        return QStringLiteral("样本 #%1：重复 %2 个样本（期望表下标 %3）").arg(e.streamIndex).arg(e.count).arg(e.lutIndex);
+    case ReferenceChecker::Corrupted:
+        return QStringLiteral("样本 #%1：码值偏差 %2（期望表下标 %3）").arg(e.streamIndex).arg(e.count).arg(e.lutIndex);
+    case ReferenceChecker::Relock:
+        return QStringLiteral("样本 #%1：无法局部恢复，重新对齐").arg(e.streamIndex);
+    }
+    return QString();
+}
+}
+
+ReferenceWindow::ReferenceWindow(ReferenceChecker *checker, QWidget *parent)
+    : QWidget(parent, Qt::Window)
+    , m_checker(checker)
+{
+    setWindowTitle(QStringLiteral("参考波形比对"));
+    resize(560, 440);
+
+    QPushButton *loadButton = new QPushButton(QStringLiteral("加载查找表..."), this);
+    QPushButton *builtinButton = new QPushButton(QStringLiteral("使用 sine_wave.m 表"), this);
+    QPushButton *resetButton = new QPushButton(QStringLiteral("清零并重新对齐"), this);
+    m_toleranceSpin = new QSpinBox(this);
+    m_toleranceSpin->setRange(0, 4095);
+    m_toleranceSpin->setValue(m_checker->tolerance());
+    m_toleranceSpin->setSuffix(QStringLiteral(" 码"));
+
+    QHBoxLayout *controls = new QHBoxLayout;
+    controls->addWidget(loadButton);
+    controls->addWidget(builtinButton);
+    controls->addWidget(new QLabel(QStringLiteral("容差"), this));
+    controls->addWidget(m_toleranceSpin);
+    controls->addStretch();
+    controls->addWidget(resetButton);
+
+    m_tableLabel = new QLabel(this);
+    m_statsLabel = new QLabel(this);
+    m_statsLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    m_eventList = new QListWidget(this);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(controls);
+    layout->addWidget(m_tableLabel);
+    layout->addWidget(m_statsLabel);
+    layout->addWidget(new QLabel(QStringLiteral("不连续位置（按接收样本序号）："), this));
+    layout->addWidget(m_eventList, 1);
+
+    connect(loadButton, &QPushButton::clicked, this, &ReferenceWindow::loadTableFile);
+    connect(builtinButton, &QPushButton::clicked, this, &ReferenceWindow::useBuiltinTable);
+    connect(resetButton, &QPushButton::clicked, this, [this]() {
+        m_checker->reset();
+        refresh();
+    });
+    connect(m_toleranceSpin, static_cast<void(QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, [this](int value) {
+        m_checker->setTolerance(value);
+    });
+    m_refreshTimer.setInterval(kRefreshIntervalMs);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &ReferenceWindow::refresh);
+}
+
+void ReferenceWindow::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    refresh();
+    m_refreshTimer.start();
+}
+
+void ReferenceWindow::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    m_refreshTimer.stop();
+}
+
+void ReferenceWindow::loadTableFile()
+{
+    const QString fileName = QFileDialog::getOpenFileName(this, QStringLiteral("加载查找表"), QString(), "CSV/Text (*.csv *.txt);;All Files (*)");
+    if (fileName.isEmpty()) return;
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QMessageBox::warning(this, QStringLiteral("加载查找表"), QStringLiteral("无法打开文件"));
+        return;
+    }
+    QString error;
+    if (!m_checker->loadTable(QString::fromLatin1(file.readAll()), &error)) {
+        QMessageBox::warning(this, QStringLiteral("加载查找表"), error);
+        return;
+    }
+    m_tableLabel->setText(QStringLiteral("参考表：%1（%2 点）").arg(fileName).arg(m_checker->table().size()));
+    refresh();
+}
+
+void ReferenceWindow::useBuiltinTable()
+{
+    m_checker->setTable(ReferenceChecker::matlabSineTable());
+    m_tableLabel->setText(QStringLiteral("参考表：sine_wave.m（%1 点，0~4095）").arg(m_checker->table().size()));
+    refresh();
+}
+
+void ReferenceWindow::refresh()
+{
+    const ReferenceChecker::Stats &s = m_checker->stats();
+    QString state;
+    switch (m_checker->state()) {
+    case ReferenceChecker::Idle:
+        state = QStringLiteral("未加载参考表");
+        break;
+    case ReferenceChecker::Acquiring:
+        state = QStringLiteral("对齐中");
+        break;
+    case ReferenceChecker::Locked:
+        state = QStringLiteral("已锁定");
+        break;
+    }
+    m_statsLabel->setText(QStringLiteral("状态：%1   起始相位：表下标 %2\n"
+                                         "已比对 %3   不一致 %4   最大偏差 %5 码\n"
+                                         "丢样 %6   重复 %7   单点错误 %8   重新对齐 %9")
+                          .arg(state)
+                          .arg(s.phaseOffset)
+                          .arg(s.compared)
+                          .arg(s.mismatched)
+                          .arg(s.maxError)
+                          .arg(s.dropped)
+                          .arg(s.duplicated)
+                          .arg(s.corrupted)
+                          .arg(s.relocks));
+
+    // 事件列表只在有变化时重建
+    const QVector<ReferenceChecker::Event> &events = m_checker->events();
+    if (m_checker->totalEvents() == m_shownEvents) return;
+    m_shownEvents = m_checker->totalEvents();
+    m_eventList->clear();
+    for (const ReferenceChecker::Event &e : events) {
+        m_eventList->addItem(eventText(e));
+    }
+    m_eventList->scrollToBottom();
+}
@@ -0,0 +1,36 @@
+#ifndef REFERENCEWINDOW_H
+#define REFERENCEWINDOW_H
+
+#include <QWidget>
+#include <QTimer>
+
+class ReferenceChecker;
+class QLabel;
+class QListWidget;
+class QSpinBox;
+
+// 参考波形比对窗口：加载查找表、显示比对统计与不连续位置
+class ReferenceWindow : public QWidget
+{
+public:
+    explicit ReferenceWindow(ReferenceChecker *checker, QWidget *parent = nullptr);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    void loadTableFile();
+    void useBuiltinTable();
+    void refresh();
+
+    ReferenceChecker *m_checker = nullptr;
+    QTimer m_refreshTimer;
+    QLabel *m_tableLabel = nullptr;
+    QLabel *m_statsLabel = nullptr;
+    QSpinBox *m_toleranceSpin = nullptr;
+    QListWidget *m_eventList = nullptr;
+    qint64 m_shownEvents = -1;
+};
+
+#endif // REFERENCEWINDOW_H
@@ -0,0 +1,82 @@
+#include "scopeautoset.h"
+#include "scopefft.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// 分位数只需大致准确，样本过多时等间隔抽取这么多个
+const int kMaxQuantileSamples = 1 << 16;
+// 峰值功率需高于谱功率中位数这么多倍才认为是周期信号
+const double kMinPeakToMedian = 30.0;
+}
+
+ScopeAutoset::Result ScopeAutoset::analyse(const QVector<double> &values, double sampleRate)
+{
+    Result r;
+    const int total = values.size();
+    const int n = std::min(total, kMaxSamples);
+    if (n < 16 || sampleRate <= 0) return r;
+    const double *x = values.constData() + (total - n);
+    r.samples = n;
+
+    // 稳健分位数：抽样后 nth_element，单个毛刺不会撑大量程
+    const int stride = std::max(1, n / kMaxQuantileSamples);
+    QVector<double> sorted;
+    sorted.reserve(n / stride + 1);
+    for (int i = 0; i < n; i += stride) sorted.append(x[i]);
+    auto quantile = [&sorted](double q) {
+        const int k = std::min(sorted.size() - 1, static_cast<int>(q * (sorted.size() - 1) + 0.5));
+        std::nth_element(sorted.begin(), sorted.begin() + k, sorted.end());
+        return sorted[k];
+    };
+    r.low = quantile(0.005);
+    r.high = quantile(0.995);
+    r.median = quantile(0.5);
+    r.triggerLevel = 0.5 * (quantile(0.05) + quantile(0.95));
+    r.valid = true;
+
+    // 抽取：相邻 decim 个样本取平均（兼作抗混叠），使点数不超过 FFT 上限
+    const int decim = std::max(1, (n + kMaxFftSize - 1) / kMaxFftSize);
+    const int m = n / decim;
+    int fftSize = ScopeFft::nextPowerOfTwo(m);
+    if (fftSize > m) fftSize /= 2;
+    if (fftSize < 16) return r;
+    const int offset = n - fftSize * decim;   // 取最新的数据
+    QVector<float> input(fftSize);
+    double mean = 0;
+    for (int i = 0; i < fftSize; ++i) {
+        double acc = 0;
+        const double *block = x + offset + i * decim;
+        for (int k = 0; k < decim; ++k) acc += block[k];
+        input[i] = static_cast<float>(acc / decim);
+        mean += input[i];
+    }
+    mean /= fftSize;
+    for (float &v : input) v -= static_cast<float>(mean);
+
+    ScopeFft fft(fftSize);
+    const QVector<float> window = ScopeFft::hannWindow(fftSize);
+    QVector<float> power(fftSize / 2 + 1);
+    fft.powerSpectrum(input.constData(), window.constData(), power.data());
+    // 跳过直流附近的两个 bin（Hann 窗主瓣宽度）
+    int peak = 2;
+    for (int k = 3; k < power.size() - 1; ++k) {
+        if (power[k] > power[peak]) peak = k;
+    }
+    QVector<float> ordered = power;
+    std::nth_element(ordered.begin(), ordered.begin() + ordered.size() / 2, ordered.end());
+    const double floorPower = std::max(1e-30, static_cast<double>(ordered[ordered.size() / 2]));
+    if (power[peak] < kMinPeakToMedian * floorPower) return r;
+
+    // 抛物线插值细化峰值位置
+    const double a = std::log(std::max(1e-30f, power[peak - 1]));
+    const double b = std::log(std::max(1e-30f, power[peak]));
+    const double c = std::log(std::max(1e-30f, power[peak + 1]));
+    const double denom = a - 2 * b + c;
+    const double delta = std::fabs(denom) > 1e-12 ? 0.5 * (a - c) / denom : 0.0;
+    const double binWidth = sampleRate / decim / fftSize;
+    r.frequency = (peak + delta) * binWidth;
+    r.periodic = r.frequency > 0;
+    return r;
+}
@@ -0,0 +1,28 @@
+#ifndef SCOPEAUTOSET_H
+#define SCOPEAUTOSET_H
+
+#include <QVector>
+
+// 自动设置：对整段历史只做一遍分析，抽取后的 FFT 估计基频，分位数给出稳健的幅度与触发电平
+// 计算量有上界：最多分析最近 kMaxSamples 个样本，FFT 不超过 kMaxFftSize 点
+class ScopeAutoset
+{
+public:
+    static const int kMaxSamples = 1 << 22;
+    static const int kMaxFftSize = 1 << 16;
+
+    struct Result {
+        bool valid = false;
+        bool periodic = false;
+        double frequency = 0;     // Hz
+        double low = 0;           // 0.5% 分位
+        double high = 0;          // 99.5% 分位
+        double median = 0;
+        double triggerLevel = 0;  // 5%/95% 分位的中点
+        int samples = 0;          // 参与分析的样本数
+    };
+
+    static Result analyse(const QVector<double> &values, double sampleRate);
+};
+
+#endif // SCOPEAUTOSET_H
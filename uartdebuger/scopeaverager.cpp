@@ -0,0 +1,110 @@
+#include "scopeaverager.h"
+#include "scopesimd.h"
+
+#include <algorithm>
+
+namespace {
+// 线性模式下 float 累加和反复加减会积累舍入误差，每隔若干帧从历史重新求和
+const int kRebuildInterval = 256;
+// 线性模式历史帧存储上限（float 个数），超过时减少保留帧数
+const int kMaxHistoryFloats = 8 * 1024 * 1024;
+}
+
+ScopeAverager::ScopeAverager()
+{
+}
+
+void ScopeAverager::configure(Mode mode, int count, int frameLength)
+{
+    m_mode = mode;
+    m_frameLength = std::max(1, frameLength);
+    m_count = std::max(1, count);
+    if (mode == RunningMean) {
+        m_count = std::min(m_count, std::max(1, kMaxHistoryFloats / m_frameLength));
+    }
+    reset();
+}
+
+void ScopeAverager::reset()
+{
+    m_sum.fill(0.0f, m_frameLength);
+    m_average.fill(0.0f, m_frameLength);
+    if (m_mode == RunningMean) {
+        m_history.fill(0.0f, m_count * m_frameLength);
+    } else {
+        m_history.clear();
+    }
+    m_head = 0;
+    m_filled = 0;
+    m_sinceRebuild = 0;
+}
+
+void ScopeAverager::addFrames(const float *frames, int frameCount)
+{
+    for (int f = 0; f < frameCount; ++f) {
+        addFrame(frames + static_cast<qptrdiff>(f) * m_frameLength);
+    }
+}
+
+void ScopeAverager::addFrame(const float *frame)
+{
+    const int n = m_frameLength;
+    float *avg = m_average.data();
+    if (m_mode == Exponential) {
+        // 首帧直接作为初值；之后 avg += (x - avg) / k，k 封顶为 N，前 N 帧等价于算术平均
+        if (m_filled < m_count) ++m_filled;
+        const float alpha = 1.0f / std::min(m_filled, m_count);
+        int i = 0;
+#ifdef SCOPE_HAVE_SSE
+        const __m128 va = _mm_set1_ps(alpha);
+        for (; i + 4 <= n; i += 4) {
+            const __m128 a = _mm_loadu_ps(avg + i);
+            const __m128 x = _mm_loadu_ps(frame + i);
+            _mm_storeu_ps(avg + i, _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(x, a), va)));
+        }
+#endif
+        for (; i < n; ++i) avg[i] += (frame[i] - avg[i]) * alpha;
+        return;
+    }
+
+    // 线性模式：sum += 新帧 - 被替换的最旧帧
+    float *slot = m_history.data() + static_cast<qptrdiff>(m_head) * n;
+    float *sum = m_sum.data();
+    m_filled = std::min(m_filled + 1, m_count);
+    m_head = (m_head + 1) % m_count;
+    const float inv = 1.0f / m_filled;
+    int i = 0;
+#ifdef SCOPE_HAVE_SSE
+    const __m128 vinv = _mm_set1_ps(inv);
+    for (; i + 4 <= n; i += 4) {
+        const __m128 x = _mm_loadu_ps(frame + i);
+        const __m128 s = _mm_add_ps(_mm_sub_ps(_mm_loadu_ps(sum + i), _mm_loadu_ps(slot + i)), x);
+        _mm_storeu_ps(sum + i, s);
+        _mm_storeu_ps(slot + i, x);
+        _mm_storeu_ps(avg + i, _mm_mul_ps(s, vinv));
+    }
+#endif
+    for (; i < n; ++i) {
+        sum[i] += frame[i] - slot[i];
+        slot[i] = frame[i];
+        avg[i] = sum[i] * inv;
+    }
+    if (++m_sinceRebuild >= kRebuildInterval) {
+        rebuildSum();
+    }
+}
+
+void ScopeAverager::rebuildSum()
+{
+    m_sinceRebuild = 0;
+    const int n = m_frameLength;
+    std::fill(m_sum.begin(), m_sum.end(), 0.0f);
+    float *sum = m_sum.data();
+    // 未填满时历史中其余槽位为 0，直接全部累加不影响结果
+    for (int f = 0; f < m_count; ++f) {
+        const float *slot = m_history.constData() + static_cast<qptrdiff>(f) * n;
+        for (int i = 0; i < n; ++i) sum[i] += slot[i];
+    }
+    const float inv = 1.0f / std::max(1, m_filled);
+    for (int i = 0; i < n; ++i) m_average[i] = m_sum[i] * inv;
+}
@@ -0,0 +1,44 @@
+#ifndef SCOPEAVERAGER_H
+#define SCOPEAVERAGER_H
+
+#include <QVector>
+
+// 触发帧平均：线性模式保留最近 N 帧并维护逐点累加和，指数模式按 1/N 权重递推
+// 每来一帧只做 O(帧长) 的加减，内层循环为连续 float 运算便于向量化
+class ScopeAverager
+{
+public:
+    enum Mode {
+        RunningMean,
+        Exponential
+    };
+
+    ScopeAverager();
+
+    void configure(Mode mode, int count, int frameLength);
+    Mode mode() const { return m_mode; }
+    int count() const { return m_count; }
+    int frameLength() const { return m_frameLength; }
+    void reset();
+    // frames 为若干帧首尾相接的数据，长度须为 frameLength 的整数倍
+    void addFrames(const float *frames, int frameCount);
+    // 当前参与平均的帧数，最多 N
+    int framesAveraged() const { return m_filled; }
+    const QVector<float> &average() const { return m_average; }
+
+private:
+    void addFrame(const float *frame);
+    void rebuildSum();
+
+    Mode m_mode = RunningMean;
+    int m_count = 16;
+    int m_frameLength = 0;
+    QVector<float> m_history;   // count * frameLength 的环形帧存储
+    QVector<float> m_sum;
+    QVector<float> m_average;
+    int m_head = 0;
+    int m_filled = 0;
+    int m_sinceRebuild = 0;
+};
+
+#endif // SCOPEAVERAGER_H
@@ -0,0 +1,121 @@
+#include "scopefft.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const double kPi = 3.14159265358979323846;
+}
+
+ScopeFft::ScopeFft(int size)
+{
+    if (size > 0) setSize(size);
+}
+
+int ScopeFft::nextPowerOfTwo(int n)
+{
+    int p = 1;
+    while (p < n && p < (1 << 30)) p <<= 1;
+    return p;
+}
+
+QVector<float> ScopeFft::hannWindow(int n, double *coherentGain)
+{
+    QVector<float> w(n);
+    double sum = 0;
+    for (int i = 0; i < n; ++i) {
+        w[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * kPi * i / n));
+        sum += w[i];
+    }
+    if (coherentGain) *coherentGain = n > 0 ? sum / n : 1.0;
+    return w;
+}
+
+void ScopeFft::setSize(int size)
+{
+    if (!isPowerOfTwo(size)) size = nextPowerOfTwo(std::max(2, size));
+    if (size == m_size) return;
+    m_size = size;
+    m_cos.resize(size / 2);
+    m_sin.resize(size / 2);
+    for (int i = 0; i < size / 2; ++i) {
+        m_cos[i] = static_cast<float>(std::cos(2.0 * kPi * i / size));
+        m_sin[i] = static_cast<float>(-std::sin(2.0 * kPi * i / size));
+    }
+    int bits = 0;
+    while ((1 << bits) < size) ++bits;
+    m_bitrev.resize(size);
+    for (int i = 0; i < size; ++i) {
+        int r = 0;
+        for (int b = 0; b < bits; ++b) {
+            if (i & (1 << b)) r |= 1 << (bits - 1 - b);
+        }
+        m_bitrev[i] = r;
+    }
+    m_scratchRe.resize(size);
+    m_scratchIm.resize(size);
+}
+
+void ScopeFft::forward(float *re, float *im) const
+{
+    transform(re, im, false);
+}
+
+void ScopeFft::inverse(float *re, float *im) const
+{
+    transform(re, im, true);
+    const float scale = 1.0f / m_size;
+    for (int i = 0; i < m_size; ++i) {
+        re[i] *= scale;
+        im[i] *= scale;
+    }
+}
+
+void ScopeFft::transform(float *re, float *im, bool inverse) const
+{
+    const int n = m_size;
+    for (int i = 0; i < n; ++i) {
+        const int j = m_bitrev[i];
+        if (j > i) {
+            std::swap(re[i], re[j]);
+            std::swap(im[i], im[j]);
+        }
+    }
+    const float sign = inverse ? -1.0f : 1.0f;
+    for (int len = 2; len <= n; len <<= 1) {
+        const int half = len / 2;
+        const int step = n / len;
+        for (int start = 0; start < n; start += len) {
+            // 同一级内的蝶形共享旋转因子表，内层循环连续访问便于编译器向量化
+            float *r0 = re + start;
+            float *i0 = im + start;
+            float *r1 = r0 + half;
+            float *i1 = i0 + half;
+            for (int k = 0; k < half; ++k) {
+                const float wr = m_cos[k * step];
+                const float wi = sign * m_sin[k * step];
+                const float tr = r1[k] * wr - i1[k] * wi;
+                const float ti = r1[k] * wi + i1[k] * wr;
+                r1[k] = r0[k] - tr;
+                i1[k] = i0[k] - ti;
+                r0[k] += tr;
+                i0[k] += ti;
+            }
+        }
+    }
+}
+
+void ScopeFft::powerSpectrum(const float *input, const float *window, float *power) const
+{
+    const int n = m_size;
+    float *re = m_scratchRe.data();
+    float *im = m_scratchIm.data();
+    for (int i = 0; i < n; ++i) {
+        re[i] = window ? input[i] * window[i] : input[i];
+        im[i] = 0.0f;
+    }
+    forward(re, im);
+    for (int k = 0; k <= n / 2; ++k) {
+        power[k] = re[k] * re[k] + im[k] * im[k];
+    }
+}
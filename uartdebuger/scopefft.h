@@ -0,0 +1,38 @@
+#ifndef SCOPEFFT_H
+#define SCOPEFFT_H
+
+#include <QVector>
+
+// 基 2 复数 FFT：实部/虚部分开存放，旋转因子与位反转表按尺寸预计算
+class ScopeFft
+{
+public:
+    explicit ScopeFft(int size = 0);
+
+    // 设置变换点数（必须为 2 的幂），重建查找表
+    void setSize(int size);
+    int size() const { return m_size; }
+    // 原地正变换
+    void forward(float *re, float *im) const;
+    // 原地逆变换（含 1/N 归一化）
+    void inverse(float *re, float *im) const;
+    // 实信号加窗后的单边功率谱，输出 size/2+1 个点；window 为空时不加窗
+    void powerSpectrum(const float *input, const float *window, float *power) const;
+
+    static bool isPowerOfTwo(int n) { return n > 0 && (n & (n - 1)) == 0; }
+    static int nextPowerOfTwo(int n);
+    // Hann 窗系数，同时返回相干增益 (窗系数均值)
+    static QVector<float> hannWindow(int n, double *coherentGain = nullptr);
+
+private:
+    void transform(float *re, float *im, bool inverse) const;
+
+    int m_size = 0;
+    QVector<float> m_cos;
+    QVector<float> m_sin;
+    QVector<int> m_bitrev;
+    mutable QVector<float> m_scratchRe;
+    mutable QVector<float> m_scratchIm;
+};
+
+#endif // SCOPEFFT_H
@@ -0,0 +1,295 @@
+#include "scopefilter.h"
+#include "scopesimd.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+const double kPi = 3.14159265358979323846;
+
+// Blackman 窗加权的 sinc 低通原型，fc 为归一化截止频率 (0, 0.5)
+QVector<double> sincLowPass(int taps, double fc)
+{
+    QVector<double> h(taps);
+    const int m = taps - 1;
+    double sum = 0;
+    for (int n = 0; n < taps; ++n) {
+        const double x = n - m / 2.0;
+        const double sinc = std::abs(x) < 1e-12 ? 2.0 * fc : std::sin(2.0 * kPi * fc * x) / (kPi * x);
+        const double w = 0.42 - 0.5 * std::cos(2.0 * kPi * n / m) + 0.08 * std::cos(4.0 * kPi * n / m);
+        h[n] = sinc * w;
+        sum += h[n];
+    }
+    // 直流增益归一化为 1
+    if (std::abs(sum) > 1e-12) {
+        for (double &v : h) v /= sum;
+    }
+    return h;
+}
+
+double normalizedCutoff(double freq, double sampleRate)
+{
+    return std::min(0.499, std::max(1e-6, freq / sampleRate));
+}
+}
+
+ScopeFilter::ScopeFilter()
+{
+}
+
+void ScopeFilter::configure(const Config &config)
+{
+    m_config = config;
+    m_config.sampleRate = std::max(1.0, m_config.sampleRate);
+    m_coeffs.clear();
+    m_sections.clear();
+    m_ring.clear();
+    switch (m_config.type) {
+    case MovingAverage:
+        m_ring.fill(0.0f, std::min(4096, std::max(1, m_config.taps)));
+        break;
+    case FirLowPass:
+    case FirHighPass:
+    case FirBandPass:
+        designFir();
+        break;
+    case IirLowPass:
+    case IirHighPass:
+    case IirBandPass:
+        designBiquads();
+        break;
+    case None:
+        break;
+    }
+    reset();
+}
+
+void ScopeFilter::reset()
+{
+    m_work.fill(0.0f, std::max(0, m_coeffs.size() - 1));
+    std::fill(m_ring.begin(), m_ring.end(), 0.0f);
+    m_ringSum = 0;
+    m_ringPos = 0;
+    m_ringFill = 0;
+    for (Biquad &s : m_sections) {
+        s.z1 = 0;
+        s.z2 = 0;
+    }
+}
+
+void ScopeFilter::process(const float *in, float *out, int count)
+{
+    if (count <= 0) return;
+    switch (m_config.type) {
+    case MovingAverage:
+        processMovingAverage(in, out, count);
+        break;
+    case FirLowPass:
+    case FirHighPass:
+    case FirBandPass:
+        processFir(in, out, count);
+        break;
+    case IirLowPass:
+    case IirHighPass:
+    case IirBandPass:
+        processIir(in, out, count);
+        break;
+    case None:
+        if (in != out) std::copy(in, in + count, out);
+        break;
+    }
+}
+
+int ScopeFilter::groupDelay() const
+{
+    switch (m_config.type) {
+    case MovingAverage:
+        return (m_ring.size() - 1) / 2;
+    case FirLowPass:
+    case FirHighPass:
+    case FirBandPass:
+        return (m_coeffs.size() - 1) / 2;
+    default:
+        return 0;
+    }
+}
+
+void ScopeFilter::designFir()
+{
+    // 抽头数取奇数，保证线性相位且高通/带通可由谱反转得到
+    int taps = std::min(1023, std::max(3, m_config.taps));
+    if (taps % 2 == 0) ++taps;
+    const double fs = m_config.sampleRate;
+    QVector<double> h;
+    if (m_config.type == FirLowPass) {
+        h = sincLowPass(taps, normalizedCutoff(m_config.cutoffLow, fs));
+    } else if (m_config.type == FirHighPass) {
+        h = sincLowPass(taps, normalizedCutoff(m_config.cutoffLow, fs));
+        for (double &v : h) v = -v;
+        h[taps / 2] += 1.0;
+    } else {
+        const double lo = normalizedCutoff(std::min(m_config.cutoffLow, m_config.cutoffHigh), fs);
+        const double hi = normalizedCutoff(std::max(m_config.cutoffLow, m_config.cutoffHigh), fs);
+        const QVector<double> hHigh = sincLowPass(taps, hi);
+        const QVector<double> hLow = sincLowPass(taps, lo);
+        h.resize(taps);
+        for (int i = 0; i < taps; ++i) h[i] = hHigh[i] - hLow[i];
+    }
+    m_coeffs.resize(taps);
+    for (int i = 0; i < taps; ++i) {
+        m_coeffs[i] = static_cast<float>(h[taps - 1 - i]);
+    }
+}
+
+void ScopeFilter::designBiquads()
+{
+    // RBJ 二阶节级联；低通/高通按 Butterworth 极点分配 Q 值
+    const int sections = std::min(8, std::max(1, m_config.taps));
+    const double fs = m_config.sampleRate;
+    for (int k = 0; k < sections; ++k) {
+        double f0 = normalizedCutoff(m_config.cutoffLow, fs) * fs;
+        double q = 1.0 / (2.0 * std::cos(kPi * (2 * k + 1) / (4.0 * sections)));
+        if (m_config.type == IirBandPass) {
+            const double lo = std::max(1e-6, std::min(m_config.cutoffLow, m_config.cutoffHigh));
+            const double hi = std::max(lo * 1.0001, std::max(m_config.cutoffLow, m_config.cutoffHigh));
+            f0 = normalizedCutoff(std::sqrt(lo * hi), fs) * fs;
+            q = f0 / (hi - lo);
+        }
+        const double w0 = 2.0 * kPi * f0 / fs;
+        const double cosw = std::cos(w0);
+        const double alpha = std::sin(w0) / (2.0 * q);
+        double b0, b1, b2;
+        if (m_config.type == IirLowPass) {
+            b0 = (1.0 - cosw) / 2.0;
+            b1 = 1.0 - cosw;
+            b2 = b0;
+        } else if (m_config.type == IirHighPass) {
+            b0 = (1.0 + cosw) / 2.0;
+            b1 = -(1.0 + cosw);
+            b2 = b0;
+        } else {
+            b0 = alpha;
+            b1 = 0.0;
+            b2 = -alpha;
+        }
+        const double a0 = 1.0 + alpha;
+        Biquad s;
+        s.b0 = b0 / a0;
+        s.b1 = b1 / a0;
+        s.b2 = b2 / a0;
+        s.a1 = -2.0 * cosw / a0;
+        s.a2 = (1.0 - alpha) / a0;
+        m_sections.append(s);
+    }
+}
+
+void ScopeFilter::processMovingAverage(const float *in, float *out, int count)
+{
+    // 环形缓冲 + 运行和，每样本 O(1)；未填满前按已有点数平均
+    const int n = m_ring.size();
+    float *ring = m_ring.data();
+    for (int i = 0; i < count; ++i) {
+        const float x = in[i];
+        m_ringSum += x - ring[m_ringPos];
+        ring[m_ringPos] = x;
+        if (++m_ringPos == n) m_ringPos = 0;
+        if (m_ringFill < n) ++m_ringFill;
+        out[i] = static_cast<float>(m_ringSum / m_ringFill);
+    }
+}
+
+void ScopeFilter::processFir(const float *in, float *out, int count)
+{
+    // 延迟线与当前块拼成连续区，每次并行计算 4 个输出（系数广播 × 非对齐加载）
+    const int taps = m_coeffs.size();
+    const int history = taps - 1;
+    m_work.resize(history + count);
+    float *work = m_work.data();
+    std::copy(in, in + count, work + history);
+    const float *c = m_coeffs.constData();
+
+    int i = 0;
+#ifdef SCOPE_HAVE_SSE
+    for (; i + 4 <= count; i += 4) {
+        __m128 acc = _mm_setzero_ps();
+        const float *x = work + i;
+        for (int k = 0; k < taps; ++k) {
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(c[k]), _mm_loadu_ps(x + k)));
+        }
+        _mm_storeu_ps(out + i, acc);
+    }
+#else
+    for (; i + 4 <= count; i += 4) {
+        float a0 = 0, a1 = 0, a2 = 0, a3 = 0;
+        const float *x = work + i;
+        for (int k = 0; k < taps; ++k) {
+            const float ck = c[k];
+            a0 += ck * x[k];
+            a1 += ck * x[k + 1];
+            a2 += ck * x[k + 2];
+            a3 += ck * x[k + 3];
+        }
+        out[i] = a0;
+        out[i + 1] = a1;
+        out[i + 2] = a2;
+        out[i + 3] = a3;
+    }
+#endif
+    for (; i < count; ++i) {
+        float acc = 0;
+        const float *x = work + i;
+        for (int k = 0; k < taps; ++k) acc += c[k] * x[k];
+        out[i] = acc;
+    }
+
+    // 保留末尾 taps-1 个样本作为下一块的历史
+    std::copy(work + count, work + count + history, work);
+    m_work.resize(history);
+}
+
+void ScopeFilter::processIir(const float *in, float *out, int count)
+{
+    // 按节遍历整块（转置直接 II 型），状态使用双精度避免低截止频率下失稳
+    if (in != out) std::copy(in, in + count, out);
+    for (Biquad &s : m_sections) {
+        double z1 = s.z1;
+        double z2 = s.z2;
+        for (int i = 0; i < count; ++i) {
+            const double x = out[i];
+            const double y = s.b0 * x + z1;
+            z1 = s.b1 * x - s.a1 * y + z2;
+            z2 = s.b2 * x - s.a2 * y;
+            out[i] = static_cast<float>(y);
+        }
+        s.z1 = z1;
+        s.z2 = z2;
+    }
+}
+
+double ScopeFilter::benchmark(int taps, int samples)
+{
+    Config cfg;
+    cfg.type = FirLowPass;
+    cfg.sampleRate = 1000.0;
+    cfg.cutoffLow = 50.0;
+    cfg.taps = taps;
+    ScopeFilter filter;
+    filter.configure(cfg);
+
+    const int block = 1024;
+    QVector<float> input(block);
+    QVector<float> output(block);
+    for (int i = 0; i < block; ++i) {
+        input[i] = static_cast<float>(std::sin(2.0 * kPi * i / 64.0) + 0.1 * ((i * 7919) % 13 - 6));
+    }
+    const auto start = std::chrono::steady_clock::now();
+    int done = 0;
+    while (done < samples) {
+        const int n = std::min(block, samples - done);
+        filter.process(input.constData(), output.data(), n);
+        done += n;
+    }
+    const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return sec > 0 ? done / sec : 0.0;
+}
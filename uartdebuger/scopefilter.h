@@ -0,0 +1,67 @@
+#ifndef SCOPEFILTER_H
+#define SCOPEFILTER_H
+
+#include <QVector>
+
+// 示波器滤波级：位于数字解码与波形缓存之间，按块处理并跨 readyRead 保持状态
+class ScopeFilter
+{
+public:
+    enum Type {
+        None = 0,
+        MovingAverage,
+        FirLowPass,
+        FirHighPass,
+        FirBandPass,
+        IirLowPass,
+        IirHighPass,
+        IirBandPass
+    };
+
+    struct Config {
+        Type type = None;
+        double sampleRate = 1000.0;
+        double cutoffLow = 50.0;   // 低通/高通截止频率，带通下限
+        double cutoffHigh = 200.0; // 带通上限
+        int taps = 63;             // FIR 抽头数 / 滑动平均点数 / IIR 二阶节数
+    };
+
+    ScopeFilter();
+
+    // 应用新配置并重新设计系数，状态随之清零
+    void configure(const Config &config);
+    const Config &config() const { return m_config; }
+    // 清空延迟线与 IIR 状态
+    void reset();
+    bool isActive() const { return m_config.type != None; }
+    // 块处理：in/out 可为同一缓冲，count 为样本数
+    void process(const float *in, float *out, int count);
+    // 当前滤波器的群延迟（样本数），IIR 返回 0
+    int groupDelay() const;
+
+    // 性能测试：返回指定抽头数的 FIR 吞吐量（样本/秒）
+    static double benchmark(int taps, int samples);
+
+private:
+    struct Biquad {
+        double b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+        double z1 = 0, z2 = 0;
+    };
+
+    void designFir();
+    void designBiquads();
+    void processMovingAverage(const float *in, float *out, int count);
+    void processFir(const float *in, float *out, int count);
+    void processIir(const float *in, float *out, int count);
+
+    Config m_config;
+    QVector<float> m_coeffs;   // FIR 系数（已反转，便于与延迟线顺序点积）
+    QVector<float> m_work;     // 延迟线 + 当前块的连续工作区
+    QVector<float> m_ring;     // 滑动平均环形缓冲
+    QVector<Biquad> m_sections;
+    double m_ringSum = 0;
+    int m_ringPos = 0;
+    int m_ringFill = 0;
+};
+
+#endif // SCOPEFILTER_H
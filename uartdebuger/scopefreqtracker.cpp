@@ -0,0 +1,219 @@
+#include "scopefreqtracker.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const double kPi = 3.14159265358979323846;
+const int kMaxIterations = 10;
+// 残差超过幅度的该比例视为拟合失败（非正弦或多分量信号）
+const double kMaxResidualRatio = 0.5;
+
+// 带部分主元的高斯消元，原地求解 dim 阶方程组，奇异时返回 false
+bool solveLinear(double m[4][4], double b[4], int dim)
+{
+    for (int col = 0; col < dim; ++col) {
+        int pivot = col;
+        for (int r = col + 1; r < dim; ++r) {
+            if (std::fabs(m[r][col]) > std::fabs(m[pivot][col])) pivot = r;
+        }
+        if (std::fabs(m[pivot][col]) < 1e-300) return false;
+        if (pivot != col) {
+            for (int c = 0; c < dim; ++c) std::swap(m[col][c], m[pivot][c]);
+            std::swap(b[col], b[pivot]);
+        }
+        for (int r = col + 1; r < dim; ++r) {
+            const double f = m[r][col] / m[col][col];
+            for (int c = col; c < dim; ++c) m[r][c] -= f * m[col][c];
+            b[r] -= f * b[col];
+        }
+    }
+    for (int r = dim - 1; r >= 0; --r) {
+        double v = b[r];
+        for (int c = r + 1; c < dim; ++c) v -= m[r][c] * b[c];
+        b[r] = v / m[r][r];
+    }
+    return true;
+}
+}
+
+FreqTracker::FreqTracker()
+{
+    configure(Config());
+}
+
+void FreqTracker::configure(const Config &config)
+{
+    m_config = config;
+    m_config.sampleRate = std::max(1e-3, m_config.sampleRate);
+    m_config.windowSize = std::max(64, m_config.windowSize);
+    m_config.hop = std::min(m_config.windowSize, std::max(1, m_config.hop));
+    m_config.logCapacity = std::max(16, m_config.logCapacity);
+    // 粗估 FFT 补零到两倍窗口长度，峰值插值误差更小
+    const int fftSize = ScopeFft::nextPowerOfTwo(m_config.windowSize * 2);
+    m_fft.setSize(fftSize);
+    const QVector<float> hann = ScopeFft::hannWindow(m_config.windowSize);
+    m_fftWindow.fill(0.0f, fftSize);
+    std::copy(hann.constBegin(), hann.constEnd(), m_fftWindow.begin());
+    m_fftInput.resize(fftSize);
+    m_power.resize(fftSize / 2 + 1);
+    m_ring.fill(0.0, m_config.windowSize);
+    m_frame.resize(m_config.windowSize);
+    resetWindow();
+}
+
+void FreqTracker::resetWindow()
+{
+    m_ringPos = 0;
+    m_filled = 0;
+    m_sinceUpdate = 0;
+    m_locked = false;
+    m_current = Estimate();
+}
+
+void FreqTracker::clearLog()
+{
+    m_log.clear();
+}
+
+int FreqTracker::push(const double *samples, int count, qint64 wallClockMs)
+{
+    const int n = m_config.windowSize;
+    int produced = 0;
+    for (int i = 0; i < count; ++i) {
+        m_ring[m_ringPos] = samples[i];
+        m_ringPos = (m_ringPos + 1) % n;
+        m_filled = std::min(m_filled + 1, n);
+        ++m_sampleCount;
+        if (++m_sinceUpdate < m_config.hop || m_filled < n) continue;
+        m_sinceUpdate = 0;
+
+        Estimate e;
+        e.sampleIndex = m_sampleCount - 1;
+        e.wallClockMs = wallClockMs;
+        if (!estimate(&e)) continue;
+        m_current = e;
+        if (m_log.size() >= m_config.logCapacity) {
+            // 一次丢弃 1/8，避免每条记录都搬移整个数组
+            m_log.remove(0, m_config.logCapacity / 8);
+        }
+        m_log.append(e);
+        ++produced;
+    }
+    return produced;
+}
+
+bool FreqTracker::estimate(Estimate *out)
+{
+    const int n = m_config.windowSize;
+    // 环形缓冲展开为按时间顺序排列的窗口
+    std::copy(m_ring.constBegin() + m_ringPos, m_ring.constEnd(), m_frame.begin());
+    std::copy(m_ring.constBegin(), m_ring.constBegin() + m_ringPos, m_frame.begin() + (n - m_ringPos));
+
+    const double fs = m_config.sampleRate;
+    if (m_locked && sineFit(m_frame.constData(), n, 2.0 * kPi * m_current.frequency / fs, out)) {
+        return true;
+    }
+    m_locked = false;
+    const double coarse = coarseFrequency(m_frame.constData(), n);
+    if (coarse <= 0 || !sineFit(m_frame.constData(), n, 2.0 * kPi * coarse / fs, out)) {
+        return false;
+    }
+    m_locked = true;
+    return true;
+}
+
+double FreqTracker::coarseFrequency(const double *frame, int n)
+{
+    double mean = 0;
+    for (int i = 0; i < n; ++i) mean += frame[i];
+    mean /= n;
+    const int fftSize = m_fft.size();
+    for (int i = 0; i < n; ++i) m_fftInput[i] = static_cast<float>(frame[i] - mean);
+    std::fill(m_fftInput.begin() + n, m_fftInput.end(), 0.0f);
+    m_fft.powerSpectrum(m_fftInput.constData(), m_fftWindow.constData(), m_power.data());
+
+    int peak = 0;
+    for (int k = 2; k < m_power.size() - 1; ++k) {
+        if (m_power[k] > (peak ? m_power[peak] : 0.0f)) peak = k;
+    }
+    if (peak == 0 || m_power[peak] <= 0) return 0;
+    // 对数幅度抛物线插值得到亚频点位置
+    const double a = std::log(std::max(1e-30f, m_power[peak - 1]));
+    const double b = std::log(m_power[peak]);
+    const double c = std::log(std::max(1e-30f, m_power[peak + 1]));
+    const double denom = a - 2.0 * b + c;
+    const double delta = denom != 0 ? 0.5 * (a - c) / denom : 0.0;
+    return (peak + std::max(-0.5, std::min(0.5, delta))) * m_config.sampleRate / fftSize;
+}
+
+bool FreqTracker::sineFit(const double *frame, int n, double omega, Estimate *out) const
+{
+    // 模型 x = A cos(w t) + B sin(w t) + C，t 以窗口中心为零点改善条件数
+    const double center = 0.5 * (n - 1);
+    const double omega0 = omega;
+    double A = 0, B = 0, C = 0;
+    bool haveLinear = false;
+    for (int iter = 0; iter <= kMaxIterations; ++iter) {
+        const int dim = haveLinear ? 4 : 3;
+        double m[4][4] = {};
+        double rhs[4] = {};
+        const double stepC = std::cos(omega);
+        const double stepS = std::sin(omega);
+        double c = 0, s = 0;
+        for (int i = 0; i < n; ++i) {
+            // 旋转递推求 cos/sin，定期用库函数校正累计误差
+            if ((i & 255) == 0) {
+                c = std::cos(omega * (i - center));
+                s = std::sin(omega * (i - center));
+            }
+            const double t = i - center;
+            const double col[4] = {c, s, 1.0, t * (B * c - A * s)};
+            for (int r = 0; r < dim; ++r) {
+                for (int k = r; k < dim; ++k) m[r][k] += col[r] * col[k];
+                rhs[r] += col[r] * frame[i];
+            }
+            const double nc = c * stepC - s * stepS;
+            s = s * stepC + c * stepS;
+            c = nc;
+        }
+        for (int r = 0; r < dim; ++r) {
+            for (int k = 0; k < r; ++k) m[r][k] = m[k][r];
+        }
+        if (!solveLinear(m, rhs, dim)) return false;
+        A = rhs[0];
+        B = rhs[1];
+        C = rhs[2];
+        if (!haveLinear) {
+            haveLinear = true;
+            continue;
+        }
+        omega += rhs[3];
+        if (!(omega > 0 && omega < kPi)) return false;
+        if (std::fabs(rhs[3]) < omega * 1e-13) break;
+    }
+    // 收敛到相邻峰（偏离初值超过两个频点）视为失锁
+    if (std::fabs(omega - omega0) > 4.0 * kPi / n) return false;
+
+    const double amplitude = std::sqrt(A * A + B * B);
+    double sq = 0;
+    for (int i = 0; i < n; ++i) {
+        const double t = i - center;
+        const double r = frame[i] - (A * std::cos(omega * t) + B * std::sin(omega * t) + C);
+        sq += r * r;
+    }
+    const double residual = std::sqrt(sq / n);
+    if (amplitude <= 0 || residual > kMaxResidualRatio * amplitude) return false;
+
+    out->frequency = omega * m_config.sampleRate / (2.0 * kPi);
+    out->amplitude = amplitude;
+    out->offset = C;
+    out->residualRms = residual;
+    // A cos + B sin = amp*cos(w t + phi)，phi = atan2(-B, A)，换算到窗口末端
+    double phase = std::atan2(-B, A) + omega * center;
+    phase = std::fmod(phase, 2.0 * kPi);
+    if (phase > kPi) phase -= 2.0 * kPi;
+    if (phase < -kPi) phase += 2.0 * kPi;
+    out->phase = phase * 180.0 / kPi;
+    return true;
+}
@@ -0,0 +1,66 @@
+#ifndef SCOPEFREQTRACKER_H
+#define SCOPEFREQTRACKER_H
+
+#include <QVector>
+#include <QtGlobal>
+
+#include "scopefft.h"
+
+// 高精度频率跟踪：FFT 峰值插值粗估，再用四参数正弦拟合 (IEEE 1057) 精估
+// 锁定后以上次结果为初值，每个跳步只做拟合迭代，不再重复 FFT
+class FreqTracker
+{
+public:
+    struct Config {
+        double sampleRate = 1000.0;
+        int windowSize = 2048;      // 拟合窗口长度（样本）
+        int hop = 512;              // 每隔多少新样本更新一次
+        int logCapacity = 20000;    // 记录条数上限，超过后丢弃最旧的记录
+    };
+
+    struct Estimate {
+        qint64 sampleIndex = 0;     // 窗口最后一个样本的全局序号
+        qint64 wallClockMs = 0;     // 送入该块数据时的系统时间
+        double frequency = 0;       // Hz
+        double amplitude = 0;       // 峰值
+        double phase = 0;           // 窗口末端相位（度）
+        double offset = 0;          // 直流分量
+        double residualRms = 0;     // 拟合残差 RMS
+    };
+
+    FreqTracker();
+
+    void configure(const Config &config);
+    const Config &config() const { return m_config; }
+    // 清空采样窗口并解除锁定，记录保留
+    void resetWindow();
+    void clearLog();
+    // 送入新样本，返回本次产生的估计次数
+    int push(const double *samples, int count, qint64 wallClockMs = 0);
+
+    bool locked() const { return m_locked; }
+    const Estimate &current() const { return m_current; }
+    const QVector<Estimate> &log() const { return m_log; }
+
+private:
+    bool estimate(Estimate *out);
+    double coarseFrequency(const double *frame, int n);
+    bool sineFit(const double *frame, int n, double omega, Estimate *out) const;
+
+    Config m_config;
+    ScopeFft m_fft;
+    QVector<float> m_fftWindow;
+    QVector<float> m_fftInput;
+    QVector<float> m_power;
+    QVector<double> m_ring;
+    QVector<double> m_frame;
+    int m_ringPos = 0;
+    int m_filled = 0;
+    int m_sinceUpdate = 0;
+    qint64 m_sampleCount = 0;
+    bool m_locked = false;
+    Estimate m_current;
+    QVector<Estimate> m_log;
+};
+
+#endif // SCOPEFREQTRACKER_H
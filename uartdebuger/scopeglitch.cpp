@@ -0,0 +1,196 @@
+#include "scopeglitch.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const int kMaxEvents = 100000;
+}
+
+GlitchDetector::GlitchDetector()
+{
+    reset();
+}
+
+void GlitchDetector::configure(const Config &config)
+{
+    m_config = config;
+    m_config.flatSamples = std::max(2, m_config.flatSamples);
+    // 判据变化后旧的游程不再可比，从下一个样本重新开始
+    m_havePrev = false;
+}
+
+void GlitchDetector::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+    m_havePrev = false;
+}
+
+void GlitchDetector::setCounterModulus(int modulus)
+{
+    m_counterModulus = std::max(2, modulus);
+}
+
+void GlitchDetector::reset()
+{
+    m_events.clear();
+    m_totalEvents = 0;
+    std::fill(m_counts, m_counts + KindCount, 0);
+    m_havePrev = false;
+    m_prevIndex = -1;
+}
+
+void GlitchDetector::markLinkGap(qint64 sampleIndex, double gapSeconds, qint64 wallClockMs)
+{
+    m_slewRun.open = false;
+    m_bandRun.open = false;
+    m_flatRun.open = false;
+    m_havePrev = false;
+    addEvent(LinkGap, sampleIndex, 0, gapSeconds, wallClockMs);
+}
+
+int GlitchDetector::lowerBound(qint64 index) const
+{
+    const auto it = std::lower_bound(m_events.constBegin(), m_events.constEnd(), index,
+                                     [](const Event &e, qint64 i) { return e.sampleIndex < i; });
+    return static_cast<int>(it - m_events.constBegin());
+}
+
+void GlitchDetector::addEvent(EventKind kind, qint64 sampleIndex, int length, double value, qint64 wallClockMs)
+{
+    if (m_events.size() >= kMaxEvents) {
+        m_events.remove(0, kMaxEvents / 8);
+    }
+    Event e;
+    e.sampleIndex = sampleIndex;
+    e.wallClockMs = wallClockMs;
+    e.kind = kind;
+    e.length = length;
+    e.value = value;
+    // 平直段在达到门限时才登记，起点可能早于已有事件，按序号插入保持列表有序
+    const int pos = static_cast<int>(std::upper_bound(m_events.constBegin(), m_events.constEnd(), sampleIndex,
+                                                      [](qint64 i, const Event &x) { return i < x.sampleIndex; })
+                                     - m_events.constBegin());
+    if (pos == m_events.size()) {
+        m_events.append(e);
+    } else {
+        m_events.insert(pos, e);
+    }
+    ++m_totalEvents;
+    ++m_counts[kind];
+}
+
+void GlitchDetector::openRun(EventKind kind, Run &run, qint64 start, int length, double value, qint64 wallClockMs)
+{
+    run.open = true;
+    run.start = start;
+    run.length = length;
+    run.worst = value;
+    addEvent(kind, start, length, value, wallClockMs);
+}
+
+void GlitchDetector::syncRun(EventKind kind, const Run &run)
+{
+    if (!run.open) return;
+    // 进行中的事件总在列表尾部附近，从后往前找
+    for (int i = m_events.size() - 1; i >= 0; --i) {
+        Event &e = m_events[i];
+        if (e.sampleIndex < run.start) break;
+        if (e.kind == kind && e.sampleIndex == run.start) {
+            e.length = run.length;
+            e.value = run.worst;
+            break;
+        }
+    }
+}
+
+void GlitchDetector::process(const double *volts, const int *codes, int count, qint64 firstIndex, qint64 wallClockMs)
+{
+    if (!m_enabled || count <= 0) return;
+    if (m_havePrev && firstIndex != m_prevIndex + 1) {
+        // 中间有未检测的样本（如清空后重新开始），不跨越断点比较
+        m_havePrev = false;
+    }
+    if (!m_havePrev) {
+        m_slewRun.open = false;
+        m_bandRun.open = false;
+        m_flatRun.open = false;
+    }
+    const Config &cfg = m_config;
+    for (int i = 0; i < count; ++i) {
+        const double v = volts[i];
+        const qint64 index = firstIndex + i;
+
+        if (cfg.bandEnabled) {
+            if (v < cfg.bandLow || v > cfg.bandHigh) {
+                const double excess = v < cfg.bandLow ? cfg.bandLow - v : v - cfg.bandHigh;
+                if (!m_bandRun.open) {
+                    openRun(OutOfBand, m_bandRun, index, 1, v, wallClockMs);
+                } else {
+                    ++m_bandRun.length;
+                    const double worst = m_bandRun.worst;
+                    const double worstExcess = worst < cfg.bandLow ? cfg.bandLow - worst : worst - cfg.bandHigh;
+                    if (excess > worstExcess) m_bandRun.worst = v;
+                }
+            } else if (m_bandRun.open) {
+                syncRun(OutOfBand, m_bandRun);
+                m_bandRun.open = false;
+            }
+        }
+
+        if (!m_havePrev) {
+            m_flatLevel = v;
+            m_flatRun.start = index;
+            m_flatRun.length = 1;
+        } else {
+            const double step = v - m_prevVolt;
+            if (cfg.slewEnabled) {
+                if (std::fabs(step) > cfg.slewLimit) {
+                    if (!m_slewRun.open) {
+                        openRun(Slew, m_slewRun, index, 1, step, wallClockMs);
+                    } else {
+                        ++m_slewRun.length;
+                        if (std::fabs(step) > std::fabs(m_slewRun.worst)) m_slewRun.worst = step;
+                    }
+                } else if (m_slewRun.open) {
+                    syncRun(Slew, m_slewRun);
+                    m_slewRun.open = false;
+                }
+            }
+            if (cfg.flatEnabled) {
+                if (std::fabs(v - m_flatLevel) <= cfg.flatTolerance) {
+                    // 平直段达到门限时登记，之后继续延长该事件
+                    if (++m_flatRun.length == cfg.flatSamples) {
+                        openRun(FlatLine, m_flatRun, m_flatRun.start, m_flatRun.length, m_flatLevel, wallClockMs);
+                    }
+                } else {
+                    if (m_flatRun.open) {
+                        syncRun(FlatLine, m_flatRun);
+                        m_flatRun.open = false;
+                    }
+                    m_flatLevel = v;
+                    m_flatRun.start = index;
+                    m_flatRun.length = 1;
+                }
+            }
+            if (cfg.sequenceEnabled) {
+                const int expected = (m_prevCode + 1) % m_counterModulus;
+                if (codes[i] != expected) {
+                    // 前跳按缺失码数记录，回跳记为负值
+                    int missing = (codes[i] - expected) % m_counterModulus;
+                    if (missing < 0) missing += m_counterModulus;
+                    if (missing > m_counterModulus / 2) missing -= m_counterModulus;
+                    addEvent(SequenceGap, index, missing, v, wallClockMs);
+                }
+            }
+        }
+        m_prevVolt = v;
+        m_prevCode = codes[i];
+        m_havePrev = true;
+    }
+    m_prevIndex = firstIndex + count - 1;
+    // 块结束时把仍在进行的游程同步到事件列表，界面可看到实时长度
+    syncRun(Slew, m_slewRun);
+    syncRun(OutOfBand, m_bandRun);
+    syncRun(FlatLine, m_flatRun);
+}
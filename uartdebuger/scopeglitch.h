@@ -0,0 +1,96 @@
+#ifndef SCOPEGLITCH_H
+#define SCOPEGLITCH_H
+
+#include <QVector>
+#include <QtGlobal>
+
+// 毛刺/异常检测：每个接收块单遍扫描，检查压摆率、越界、平直段与计数序列断档
+// 连续违规的样本合并为一条事件，避免噪声信号刷屏
+class GlitchDetector
+{
+public:
+    enum EventKind {
+        Slew,        // 相邻样本跳变超过压摆率上限
+        OutOfBand,   // 电压超出允许范围
+        FlatLine,    // 连续若干样本不变（信号丢失/卡死）
+        SequenceGap, // 计数测试码不连续
+        LinkGap,     // 串口断线重连或示波器暂停期间丢弃了数据，之前与之后的样本不连续
+        KindCount
+    };
+
+    struct Config {
+        bool slewEnabled = true;
+        double slewLimit = 0.5;       // V/样本
+        bool bandEnabled = false;
+        double bandLow = 0.0;
+        double bandHigh = 3.3;
+        bool flatEnabled = true;
+        int flatSamples = 64;         // 连续不变的样本数达到该值即报告
+        double flatTolerance = 0.0;   // 视为“不变”的最大差值 (V)
+        bool sequenceEnabled = false; // 原始码值应逐个 +1 递增（ADC 计数测试模式）
+    };
+
+    struct Event {
+        qint64 sampleIndex = 0;   // 首个违规样本的绝对序号
+        qint64 wallClockMs = 0;
+        EventKind kind = Slew;
+        int length = 1;           // 持续样本数；序列断档时为缺失的码数；断线时为 0
+        double value = 0;         // 最严重处的电压、跳变量或平直电平；断线时为断开的秒数
+    };
+
+    GlitchDetector();
+
+    void configure(const Config &config);
+    const Config &config() const { return m_config; }
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_enabled; }
+    // 计数模式下的码值模数（2^分辨率）
+    void setCounterModulus(int modulus);
+    int counterModulus() const { return m_counterModulus; }
+
+    // volts 与 codes 一一对应，firstIndex 为 volts[0] 的绝对样本序号
+    void process(const double *volts, const int *codes, int count, qint64 firstIndex, qint64 wallClockMs);
+    // 清空事件与状态，下一块重新建立前后关系
+    void reset();
+    // 数据流在 sampleIndex 之前中断（断线重连、暂停或离开示波器页）：登记断线事件，结束进行中的游程，
+    // 断点两侧不做跳变、平直与断档比较；样本序号保持连续
+    void markLinkGap(qint64 sampleIndex, double gapSeconds, qint64 wallClockMs);
+
+    const QVector<Event> &events() const { return m_events; }
+    qint64 totalEvents() const { return m_totalEvents; }
+    qint64 count(EventKind kind) const { return m_counts[kind]; }
+    // 按样本序号二分查找首个 sampleIndex >= index 的事件下标
+    int lowerBound(qint64 index) const;
+
+private:
+    // 进行中的违规游程：首个样本时即登记事件，之后只更新其长度与最严重值
+    struct Run {
+        bool open = false;
+        qint64 start = 0;
+        int length = 0;
+        double worst = 0;
+    };
+
+    void openRun(EventKind kind, Run &run, qint64 start, int length, double value, qint64 wallClockMs);
+    void syncRun(EventKind kind, const Run &run);
+    void addEvent(EventKind kind, qint64 sampleIndex, int length, double value, qint64 wallClockMs);
+
+    Config m_config;
+    bool m_enabled = false;
+    int m_counterModulus = 4096;
+    QVector<Event> m_events;
+    qint64 m_totalEvents = 0;
+    qint64 m_counts[KindCount];
+
+    // 跨块保留的状态
+    bool m_havePrev = false;
+    qint64 m_prevIndex = -1;
+    double m_prevVolt = 0;
+    int m_prevCode = 0;
+    double m_flatLevel = 0;
+    Run m_flatRun;       // length 为当前平直样本数，open 表示已达门限并登记
+    Run m_slewRun;
+    Run m_bandRun;
+};
+
+#endif // SCOPEGLITCH_H
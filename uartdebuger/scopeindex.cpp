@@ -0,0 +1,139 @@
+#include "scopeindex.h"
+
+#include <algorithm>
+
+RangeIndex::Summary RangeIndex::combine(const Summary &a, const Summary &b)
+{
+    if (a.count == 0) return b;
+    if (b.count == 0) return a;
+    Summary s;
+    s.min = std::min(a.min, b.min);
+    s.max = std::max(a.max, b.max);
+    s.sum = a.sum + b.sum;
+    s.count = a.count + b.count;
+    return s;
+}
+
+RangeIndex::Summary RangeIndex::scan(int first, int last) const
+{
+    Summary s;
+    if (first > last) return s;
+    const SampleRing::Span v = m_ring->span(m_first + first, last - first + 1);
+    s.min = v[0];
+    s.max = v[0];
+    auto add = [&s](const double *p, int count) {
+        for (int i = 0; i < count; ++i) {
+            s.min = std::min(s.min, p[i]);
+            s.max = std::max(s.max, p[i]);
+            s.sum += p[i];
+        }
+    };
+    add(v.head, v.headCount);
+    add(v.tail, v.tailCount);
+    s.count = last - first + 1;
+    return s;
+}
+
+void RangeIndex::clear()
+{
+    m_ring.clear();
+    m_tree.clear();
+    m_leaves = 0;
+    m_first = 0;
+    m_size = 0;
+}
+
+void RangeIndex::rebuild()
+{
+    const int n = m_size;
+    const qint64 firstBlock = m_first / kBlock;
+    const int blocks = n > 0 ? static_cast<int>((m_first + n - 1) / kBlock - firstBlock + 1) : 0;
+    // 留一倍余量，流式追加时不必频繁重建
+    m_leaves = 1;
+    while (m_leaves < std::max(1, 2 * blocks)) m_leaves <<= 1;
+    m_tree = QVector<Summary>(2 * m_leaves);
+    for (int b = 0; b < blocks; ++b) {
+        const qint64 block = firstBlock + b;
+        const int first = static_cast<int>(std::max<qint64>(0, block * kBlock - m_first));
+        const int last = static_cast<int>(std::min<qint64>(n, (block + 1) * kBlock - m_first)) - 1;
+        m_tree[m_leaves + static_cast<int>(block % m_leaves)] = scan(first, last);
+    }
+    for (int i = m_leaves - 1; i >= 1; --i) {
+        m_tree[i] = combine(m_tree[2 * i], m_tree[2 * i + 1]);
+    }
+}
+
+void RangeIndex::update(const QSharedPointer<const SampleRing> &ring)
+{
+    if (!ring) {
+        clear();
+        return;
+    }
+    const qint64 firstIndex = ring->begin();
+    const qint64 end = ring->end();
+    const int n = static_cast<int>(end - firstIndex);
+    const qint64 oldFirst = m_first;
+    const qint64 oldEnd = m_first + m_size;
+    const qint64 blocks = n > 0 ? (end - 1) / kBlock - firstIndex / kBlock + 1 : 0;
+    const bool sameRing = ring == m_ring;
+    m_ring = ring;
+    m_first = firstIndex;
+    m_size = n;
+    if (!sameRing || oldEnd == oldFirst || n == 0 || firstIndex < oldFirst || firstIndex > oldEnd || end < oldEnd
+            || blocks > m_leaves) {
+        rebuild();
+        return;
+    }
+    // 开头丢弃的整块清空，被截断的首块重新汇总
+    const qint64 oldFirstBlock = oldFirst / kBlock;
+    const qint64 firstBlock = firstIndex / kBlock;
+    for (qint64 b = oldFirstBlock; b < firstBlock; ++b) setBlock(b);
+    if (firstIndex != oldFirst) setBlock(firstBlock);
+    // 原末块可能不完整，与新增的块一起重新汇总
+    for (qint64 b = std::max(firstBlock, (oldEnd - 1) / kBlock); b <= (end - 1) / kBlock; ++b) setBlock(b);
+}
+
+void RangeIndex::setBlock(qint64 block)
+{
+    const int n = m_size;
+    const qint64 first = std::max<qint64>(0, block * kBlock - m_first);
+    const qint64 last = std::min<qint64>(n, (block + 1) * kBlock - m_first) - 1;
+    int i = m_leaves + static_cast<int>(block % m_leaves);
+    m_tree[i] = first <= last ? scan(static_cast<int>(first), static_cast<int>(last)) : Summary();
+    for (i >>= 1; i >= 1; i >>= 1) {
+        m_tree[i] = combine(m_tree[2 * i], m_tree[2 * i + 1]);
+    }
+}
+
+RangeIndex::Summary RangeIndex::treeQuery(int lo, int hi) const
+{
+    Summary result;
+    lo += m_leaves;
+    hi += m_leaves;
+    while (lo <= hi) {
+        if (lo & 1) result = combine(result, m_tree[lo++]);
+        if (!(hi & 1)) result = combine(result, m_tree[hi--]);
+        lo >>= 1;
+        hi >>= 1;
+    }
+    return result;
+}
+
+RangeIndex::Summary RangeIndex::query(int first, int last) const
+{
+    first = std::max(0, first);
+    last = std::min(m_size - 1, last);
+    if (first > last) return Summary();
+    const qint64 bFirst = (m_first + first) / kBlock;
+    const qint64 bLast = (m_first + last) / kBlock;
+    if (bFirst == bLast) return scan(first, last);
+
+    // 两端不完整的块直接扫描，中间整块走线段树；叶子循环存放，跨越末尾时分两段查询
+    Summary result = combine(scan(first, static_cast<int>((bFirst + 1) * kBlock - m_first) - 1),
+                             scan(static_cast<int>(bLast * kBlock - m_first), last));
+    if (bLast - bFirst < 2) return result;
+    const int lo = static_cast<int>((bFirst + 1) % m_leaves);
+    const int hi = static_cast<int>((bLast - 1) % m_leaves);
+    if (lo <= hi) return combine(result, treeQuery(lo, hi));
+    return combine(result, combine(treeQuery(lo, m_leaves - 1), treeQuery(0, hi)));
+}
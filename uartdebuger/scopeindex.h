@@ -0,0 +1,47 @@
+#ifndef SCOPEINDEX_H
+#define SCOPEINDEX_H
+
+#include "scopering.h"
+
+#include <QVector>
+
+// 区间统计索引：每 kBlock 个样本汇总为一个块，块之上建线段树
+// 任意区间的最小/最大/均值查询只需扫描两端不完整的块加 O(log n) 个树节点
+// 块按环形缓冲的绝对样本序号对齐，叶子按块号循环存放，末尾追加、开头淘汰时只更新变化的块
+class RangeIndex
+{
+public:
+    struct Summary {
+        double min = 0;
+        double max = 0;
+        double sum = 0;
+        int count = 0;
+        double mean() const { return count > 0 ? sum / count : 0.0; }
+    };
+
+    static const int kBlock = 64;
+
+    // 按缓冲当前的 [begin, end) 更新，直接读取缓冲中的样本；
+    // 同一缓冲只在末尾追加、开头淘汰时增量汇总，换了缓冲或数据不衔接时整体重建
+    void update(const QSharedPointer<const SampleRing> &ring);
+    void clear();
+    int size() const { return m_size; }
+    // 闭区间 [first, last]，位置相对 update 时的 begin，越界部分自动裁剪
+    Summary query(int first, int last) const;
+
+private:
+    static Summary combine(const Summary &a, const Summary &b);
+    Summary scan(int first, int last) const;
+    void rebuild();
+    // 重新汇总绝对块号 block 落在当前数据内的部分，并更新到根的路径
+    void setBlock(qint64 block);
+    Summary treeQuery(int lo, int hi) const;
+
+    QSharedPointer<const SampleRing> m_ring;
+    QVector<Summary> m_tree;   // 下标 1 为根，叶子从 m_leaves 开始，块 b 存放在 b % m_leaves
+    int m_leaves = 0;
+    qint64 m_first = 0;        // 位置 0 的绝对序号
+    int m_size = 0;
+};
+
+#endif // SCOPEINDEX_H
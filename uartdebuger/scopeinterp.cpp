@@ -0,0 +1,62 @@
+#include "scopeinterp.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const double kPi = 3.14159265358979323846;
+}
+
+SincInterpolator::SincInterpolator()
+{
+    // 系数 h[p][k] 作用于样本 i - kTaps/2 + 1 + k，Blackman 窗截断 sinc
+    m_table.resize(kPhases * kTaps);
+    const int half = kTaps / 2;
+    for (int p = 0; p < kPhases; ++p) {
+        const double frac = static_cast<double>(p) / kPhases;
+        double sum = 0;
+        for (int k = 0; k < kTaps; ++k) {
+            const double x = (k - half + 1) - frac;      // 样本相对输出点的距离
+            const double sinc = std::fabs(x) < 1e-12 ? 1.0 : std::sin(kPi * x) / (kPi * x);
+            const double w = (x + half) / kTaps;         // 窗位置 0~1
+            const double window = 0.42 - 0.5 * std::cos(2 * kPi * w) + 0.08 * std::cos(4 * kPi * w);
+            const double h = sinc * std::max(0.0, window);
+            m_table[p * kTaps + k] = static_cast<float>(h);
+            sum += h;
+        }
+        // 每相归一化，保证直流增益为 1
+        for (int k = 0; k < kTaps; ++k) {
+            m_table[p * kTaps + k] = static_cast<float>(m_table[p * kTaps + k] / sum);
+        }
+    }
+}
+
+void SincInterpolator::interpolate(const double *values, int total, int first, int count, int outCount,
+                                   double *out) const
+{
+    if (outCount <= 0 || count <= 0 || total <= 0) return;
+    const int half = kTaps / 2;
+    const double step = outCount > 1 ? static_cast<double>(count - 1) / (outCount - 1) : 0.0;
+    for (int j = 0; j < outCount; ++j) {
+        const double pos = first + j * step;
+        int i = static_cast<int>(std::floor(pos));
+        int p = static_cast<int>((pos - i) * kPhases + 0.5);
+        if (p == kPhases) {
+            ++i;
+            p = 0;
+        }
+        const float *h = m_table.constData() + p * kTaps;
+        const int base = i - half + 1;
+        double acc = 0;
+        if (base >= 0 && base + kTaps <= total) {
+            const double *x = values + base;
+            for (int k = 0; k < kTaps; ++k) acc += h[k] * x[k];
+        } else {
+            for (int k = 0; k < kTaps; ++k) {
+                const int idx = std::min(total - 1, std::max(0, base + k));
+                acc += h[k] * values[idx];
+            }
+        }
+        out[j] = acc;
+    }
+}
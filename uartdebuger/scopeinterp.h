@@ -0,0 +1,25 @@
+#ifndef SCOPEINTERP_H
+#define SCOPEINTERP_H
+
+#include <QVector>
+
+// sin(x)/x 带限重建：加窗 sinc 多相系数表预先算好，插值时每个输出点只做 kTaps 次乘加
+// 只对可见区间求值，放大显示稀疏样本时不必对整段记录升采样
+class SincInterpolator
+{
+public:
+    static const int kTaps = 16;     // 每个输出点使用的样本数（左右各 8 个）
+    static const int kPhases = 256;  // 样本间的分数位置量化级数
+
+    SincInterpolator();
+
+    // 在 values[first, first + count) 的样本位置上均匀取 outCount 个点写入 out
+    // 左右邻居越出可见区间时继续读取 values 中 [0, total) 的历史数据，边界外按端点值延拓
+    void interpolate(const double *values, int total, int first, int count, int outCount, double *out) const;
+
+private:
+    // 第 p 相的系数：对应输出点位于样本 i 之后 p/kPhases 处
+    QVector<float> m_table;
+};
+
+#endif // SCOPEINTERP_H
@@ -0,0 +1,64 @@
+#include "scopelongterm.h"
+
+#include <QDateTime>
+
+ScopeLongTermStats::ScopeLongTermStats()
+{
+    reset();
+}
+
+qint64 ScopeLongTermStats::advance(int newSamples, int windowSamples)
+{
+    m_pendingSamples += newSamples;
+    // 只在攒满一屏后记录，相邻两次测量不共享样本，避免同一段波形被重复计数
+    if (windowSamples <= 0 || m_pendingSamples < windowSamples) return 0;
+    const qint64 interval = m_pendingSamples;
+    m_pendingSamples = 0;
+    ++m_windows;
+    return interval;
+}
+
+void ScopeLongTermStats::add(Measurement m, double value)
+{
+    m_stats[m].add(value);
+}
+
+void ScopeLongTermStats::reset()
+{
+    m_stats = QVector<StreamStats>(MeasurementCount);
+    m_pendingSamples = 0;
+    m_windows = 0;
+    m_startedMs = QDateTime::currentMSecsSinceEpoch();
+}
+
+QString ScopeLongTermStats::name(Measurement m)
+{
+    switch (m) {
+    case Frequency: return QStringLiteral("频率");
+    case PeakToPeak: return QStringLiteral("峰峰值");
+    case Rms: return QStringLiteral("RMS");
+    case Mean: return QStringLiteral("直流");
+    case Duty: return QStringLiteral("占空比");
+    case RiseTime: return QStringLiteral("上升时间");
+    case FallTime: return QStringLiteral("下降时间");
+    case PulseWidth: return QStringLiteral("脉宽");
+    default: return QString();
+    }
+}
+
+QString ScopeLongTermStats::unit(Measurement m)
+{
+    switch (m) {
+    case Frequency: return QStringLiteral("Hz");
+    case PeakToPeak:
+    case Rms:
+    case Mean: return QStringLiteral("V");
+    case Duty: return QStringLiteral("%");
+    default: return QStringLiteral("ms");
+    }
+}
+
+double ScopeLongTermStats::displayScale(Measurement m)
+{
+    return (m == RiseTime || m == FallTime || m == PulseWidth) ? 1000.0 : 1.0;
+}
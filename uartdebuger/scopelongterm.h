@@ -0,0 +1,51 @@
+#ifndef SCOPELONGTERM_H
+#define SCOPELONGTERM_H
+
+#include "streamstats.h"
+
+#include <QString>
+#include <QVector>
+
+// 示波器各测量量的长期统计：每攒满一屏新样本记录一次测量，过夜运行内存也保持不变
+class ScopeLongTermStats
+{
+public:
+    enum Measurement {
+        Frequency = 0,
+        PeakToPeak,
+        Rms,
+        Mean,
+        Duty,
+        RiseTime,
+        FallTime,
+        PulseWidth,
+        MeasurementCount
+    };
+
+    ScopeLongTermStats();
+
+    // 新到样本数累加，攒满 windowSamples 个新样本时返回自上次记录以来的样本数，应对这段样本测量一次；
+    // 未攒满返回 0
+    qint64 advance(int newSamples, int windowSamples);
+    // 记录一个测量值（国际单位），NaN/无效值由调用方过滤
+    void add(Measurement m, double value);
+    void reset();
+
+    const StreamStats &stats(Measurement m) const { return m_stats[m]; }
+    // 已记录的测量次数（屏数）
+    qint64 windows() const { return m_windows; }
+    qint64 startedMs() const { return m_startedMs; }
+
+    static QString name(Measurement m);
+    // 显示单位及国际单位到显示单位的倍率
+    static QString unit(Measurement m);
+    static double displayScale(Measurement m);
+
+private:
+    QVector<StreamStats> m_stats;
+    qint64 m_pendingSamples = 0;
+    qint64 m_windows = 0;
+    qint64 m_startedMs = 0;
+};
+
+#endif // SCOPELONGTERM_H
@@ -0,0 +1,151 @@
+#include "scopemask.h"
+#include "scopesimd.h"
+
+#include <algorithm>
+
+namespace {
+// 只保存最先出现的若干次失败，便于追查首个故障而不无限占用内存
+const int kMaxFailureSnapshots = 16;
+
+int popcount4(int bits)
+{
+    return (bits & 1) + ((bits >> 1) & 1) + ((bits >> 2) & 1) + ((bits >> 3) & 1);
+}
+}
+
+ScopeMask::ScopeMask()
+{
+}
+
+void ScopeMask::build(const QVector<float> &center, double vTolerance, int hTolerance)
+{
+    const int n = center.size();
+    m_upper.resize(n);
+    m_lower.resize(n);
+    hTolerance = std::max(0, hTolerance);
+    const float tol = static_cast<float>(std::max(0.0, vTolerance));
+    for (int i = 0; i < n; ++i) {
+        const int a = std::max(0, i - hTolerance);
+        const int b = std::min(n - 1, i + hTolerance);
+        float lo = center[a];
+        float hi = center[a];
+        for (int k = a + 1; k <= b; ++k) {
+            lo = std::min(lo, center[k]);
+            hi = std::max(hi, center[k]);
+        }
+        m_upper[i] = hi + tol;
+        m_lower[i] = lo - tol;
+    }
+    resetStats();
+}
+
+void ScopeMask::clear()
+{
+    m_upper.clear();
+    m_lower.clear();
+    resetStats();
+}
+
+void ScopeMask::resetStats()
+{
+    m_stats = Stats();
+    m_failures.clear();
+}
+
+double ScopeMask::passRate() const
+{
+    return m_stats.tested > 0 ? 100.0 * (m_stats.tested - m_stats.failed) / m_stats.tested : 0.0;
+}
+
+int ScopeMask::testFrame(const float *frame, int *firstViolation) const
+{
+    const int n = m_upper.size();
+    const float *hi = m_upper.constData();
+    const float *lo = m_lower.constData();
+    int violations = 0;
+    int first = -1;
+    int i = 0;
+#ifdef SCOPE_HAVE_SSE
+    // 每次比较 4 点，越界位由 movemask 压成 4 位整数
+    for (; i + 4 <= n; i += 4) {
+        const __m128 x = _mm_loadu_ps(frame + i);
+        const __m128 out = _mm_or_ps(_mm_cmpgt_ps(x, _mm_loadu_ps(hi + i)), _mm_cmplt_ps(x, _mm_loadu_ps(lo + i)));
+        const int bits = _mm_movemask_ps(out);
+        if (bits) {
+            if (first < 0) {
+                int k = 0;
+                while (!(bits & (1 << k))) ++k;
+                first = i + k;
+            }
+            violations += popcount4(bits);
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        if (frame[i] > hi[i] || frame[i] < lo[i]) {
+            if (first < 0) first = i;
+            ++violations;
+        }
+    }
+    if (firstViolation) *firstViolation = first;
+    return violations;
+}
+
+int ScopeMask::testFrames(const float *frames, int frameCount, int frameLength, qint64 wallClockMs)
+{
+    if (!isValid()) return 0;
+    if (frameLength != m_upper.size()) {
+        m_stats.skipped += frameCount;
+        return 0;
+    }
+    int failed = 0;
+    for (int f = 0; f < frameCount; ++f) {
+        const float *frame = frames + static_cast<qptrdiff>(f) * frameLength;
+        int first = -1;
+        const int violations = testFrame(frame, &first);
+        if (violations > 0) {
+            ++failed;
+            if (m_failures.size() < kMaxFailureSnapshots) {
+                Failure fail;
+                fail.frameIndex = m_stats.tested;
+                fail.wallClockMs = wallClockMs;
+                fail.violations = violations;
+                fail.firstViolation = first;
+                fail.frame = QVector<float>(frameLength);
+                std::copy(frame, frame + frameLength, fail.frame.begin());
+                m_failures.append(fail);
+            }
+            m_stats.violations += violations;
+        }
+        ++m_stats.tested;
+    }
+    m_stats.failed += failed;
+    return failed;
+}
+
+QVector<float> ScopeMask::alignPeriodic(const QVector<float> &period, int frameLength, int preTrigger,
+                                        double level, bool rising)
+{
+    QVector<float> frame;
+    const int n = period.size();
+    if (n < 2 || frameLength <= 0) return frame;
+    // 找到与触发器相同方向穿越电平的位置，作为帧内第 preTrigger 个样本
+    // 与 ScopeTrigger 一致按 float 比较电平
+    const float lv = static_cast<float>(level);
+    int crossing = 0;
+    for (int i = 0; i < n; ++i) {
+        const float a = period[i];
+        const float b = period[(i + 1) % n];
+        if (rising ? (a < lv && b >= lv) : (a > lv && b <= lv)) {
+            crossing = (i + 1) % n;
+            break;
+        }
+    }
+    frame.resize(frameLength);
+    for (int i = 0; i < frameLength; ++i) {
+        int idx = (crossing + i - preTrigger) % n;
+        if (idx < 0) idx += n;
+        frame[i] = period[idx];
+    }
+    return frame;
+}
@@ -0,0 +1,60 @@
+#ifndef SCOPEMASK_H
+#define SCOPEMASK_H
+
+#include <QVector>
+#include <QtGlobal>
+
+// 模板 (mask) 测试：上下包络与触发帧逐点比较，统计通过率并保存最初几次失败的快照
+class ScopeMask
+{
+public:
+    struct Failure {
+        qint64 frameIndex = 0;     // 第几帧测试失败（从 0 计）
+        qint64 wallClockMs = 0;
+        int violations = 0;        // 越界点数
+        int firstViolation = 0;    // 第一个越界点在帧内的位置
+        QVector<float> frame;
+    };
+
+    struct Stats {
+        qint64 tested = 0;
+        qint64 failed = 0;
+        qint64 skipped = 0;        // 帧长与模板不一致而未测试的帧
+        qint64 violations = 0;
+    };
+
+    ScopeMask();
+
+    // 以中心波形生成包络：纵向容差 vTolerance，横向容差 hTolerance 个样本（取邻域最值，容忍时间抖动）
+    void build(const QVector<float> &center, double vTolerance, int hTolerance);
+    void clear();
+    bool isValid() const { return !m_upper.isEmpty(); }
+    int frameLength() const { return m_upper.size(); }
+    const QVector<float> &upper() const { return m_upper; }
+    const QVector<float> &lower() const { return m_lower; }
+
+    void setEnabled(bool enabled) { m_enabled = enabled; }
+    bool isEnabled() const { return m_enabled && isValid(); }
+    void resetStats();
+    // 测试若干首尾相接的帧，返回其中失败的帧数
+    int testFrames(const float *frames, int frameCount, int frameLength, qint64 wallClockMs);
+    // 测试单帧，返回越界点数；firstViolation 可为空
+    int testFrame(const float *frame, int *firstViolation) const;
+
+    const Stats &stats() const { return m_stats; }
+    double passRate() const;
+    const QVector<Failure> &failures() const { return m_failures; }
+
+    // 把周期查找表（已换算为电压）对齐到触发帧：按触发沿找到过零点，放在 preTrigger 处
+    static QVector<float> alignPeriodic(const QVector<float> &period, int frameLength, int preTrigger,
+                                       double level, bool rising);
+
+private:
+    QVector<float> m_upper;
+    QVector<float> m_lower;
+    bool m_enabled = false;
+    Stats m_stats;
+    QVector<Failure> m_failures;
+};
+
+#endif // SCOPEMASK_H
@@ -0,0 +1,104 @@
+#include "scopemeasure.h"
+
+#include <algorithm>
+#include <cmath>
+
+ScopeMeasure::Result ScopeMeasure::measure(const SampleRing::Span &values, double sampleRate)
+{
+    Result r;
+    const int n = values.size();
+    if (n == 0 || sampleRate <= 0) {
+        return r;
+    }
+    r.samples = n;
+    double minV = values[0];
+    double maxV = values[0];
+    double sum = 0; // 求和用于均值
+    double sumSq = 0;
+    for (int i = 0; i < n; ++i) {
+        const double v = values[i];
+        minV = std::min(minV, v);
+        maxV = std::max(maxV, v);
+        sum += v;
+        sumSq += v * v;
+    }
+    r.min = minV;
+    r.max = maxV;
+    r.peakToPeak = maxV - minV;
+    r.mean = sum / n;
+    r.rms = std::sqrt(sumSq / n); // 均方根
+
+    const double dt = 1.0 / sampleRate; // 采样周期
+    // 过均值点求周期/频率；相邻过零间隔的平均值等于首末过零之差除以间隔数，不必保存每个间隔
+    double firstCross = -1;
+    double lastCross = -1;
+    int crossings = 0;
+    for (int i = 1; i < n; ++i) {
+        const double v0 = values[i - 1] - r.mean;
+        const double v1 = values[i] - r.mean;
+        if ((v0 <= 0 && v1 > 0) || (v0 >= 0 && v1 < 0)) {
+            const double frac = std::abs(v0 - v1) > 1e-9 ? std::abs(v0) / std::abs(v0 - v1) : 0.0;
+            lastCross = (i - 1 + frac) * dt;
+            if (crossings == 0) firstCross = lastCross;
+            ++crossings;
+        }
+    }
+    if (crossings >= 2) {
+        const double avg = (lastCross - firstCross) / (crossings - 1);
+        r.period = avg;
+        r.freq = (avg > 0) ? 1.0 / avg : 0;
+        r.hasPeriod = true;
+    }
+
+    // 上升/下降时间、脉宽与占空比：10%/90% 阈值
+    const double highThresh = r.min + 0.9 * r.peakToPeak;
+    double riseStart = -1, riseEnd = -1, fallStart = -1, fallEnd = -1;
+    double firstRise = -1, lastRise = -1;
+    int rises = 0;
+    double highSum = 0;            // 高电平持续时间之和
+    int highCount = 0;
+    double currentHighStart = -1;  // 当前高电平开始时间
+    for (int i = 1; i < n; ++i) {
+        const double prev = values[i - 1];
+        const double curr = values[i];
+        const double t = i * dt;
+        if (prev < highThresh && curr >= highThresh) {
+            if (rises == 0) firstRise = t;
+            lastRise = t;
+            ++rises;
+            if (riseStart < 0) riseStart = (i - 1) * dt;
+            riseEnd = t;
+            currentHighStart = t;
+        }
+        if (prev > highThresh && curr <= highThresh) {
+            fallStart = (i - 1) * dt;
+            fallEnd = t;
+            if (currentHighStart >= 0) {
+                highSum += t - currentHighStart;
+                ++highCount;
+            }
+            currentHighStart = -1;
+        }
+    }
+    if (riseStart >= 0 && riseEnd >= 0) r.riseTime = riseEnd - riseStart;
+    if (fallStart >= 0 && fallEnd >= 0) r.fallTime = fallEnd - fallStart;
+
+    // 有两个以上上升沿时改用上升沿间隔求周期
+    if (rises >= 2) {
+        const double avg = (lastRise - firstRise) / (rises - 1);
+        if (avg > 0) {
+            r.period = avg;
+            r.freq = 1.0 / avg;
+            r.hasPeriod = true;
+        }
+    }
+
+    if (highCount > 0) {
+        const double avgHigh = highSum / highCount;
+        r.pulseWidth = avgHigh;
+        if (r.hasPeriod && r.period > 0) {
+            r.duty = std::min(100.0, std::max(0.0, (avgHigh / r.period) * 100.0));
+        }
+    }
+    return r;
+}
@@ -0,0 +1,34 @@
+#ifndef SCOPEMEASURE_H
+#define SCOPEMEASURE_H
+
+#include "scopering.h"
+
+#include <QMetaType>
+
+// 波形自动测量：峰峰值、RMS、均值、周期/频率、上升/下降时间、脉宽与占空比
+// 只读样本视图，可见点少时在界面线程计算，点多时由光栅化线程随绘制一并计算
+class ScopeMeasure
+{
+public:
+    struct Result {
+        double min = 0;
+        double max = 0;
+        double peakToPeak = 0;
+        double rms = 0;
+        double mean = 0;
+        double period = 0;
+        double freq = 0;
+        double riseTime = 0;
+        double fallTime = 0;
+        double pulseWidth = 0;
+        double duty = 0;
+        bool hasPeriod = false;
+        int samples = 0;
+    };
+
+    static Result measure(const SampleRing::Span &values, double sampleRate);
+};
+
+Q_DECLARE_METATYPE(ScopeMeasure::Result)
+
+#endif // SCOPEMEASURE_H
@@ -0,0 +1,669 @@
+#include "scopeoffline.h"
+#include "scopefft.h"
+
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <memory>
+
+namespace {
+// 每块先解析出这么多样本再统一统计，限制每个线程的临时内存
+const int kChunkSamples = 1 << 16;
+const qint64 kMinBlockBytes = 64 << 10;
+// 分块目标数，足够 32 个线程相互窃取；与线程数无关，保证结果不随线程数变化
+const qint64 kTargetBlocks = 256;
+// 块至少为段长的这么多倍（按每个码值约 5 字节计约十几段），各块保存的首尾样本不超过文件大小的 1/8
+const qint64 kBlockBytesPerFftPoint = 64;
+// 平直段判据需要回看的样本数上限，块首向前预热时最多读取这么多个码值
+const int kMaxPrimeSamples = 1 << 16;
+// 预热区按每个码值（含分隔符）这么多字节预留，块首之前最多映射 1 MB
+const qint64 kPrimeBytesPerSample = 16;
+// 合并后的事件列表上限，与实时检测一致，只保留最早的部分
+const int kMaxEvents = 100000;
+// 谐波与基波的功率在峰值附近 ±kPeakBins 个 bin 内求和（覆盖 Hann 窗主瓣）
+const int kPeakBins = 3;
+// 峰值功率需高于谱功率中位数这么多倍才计算基波与 THD
+const double kMinPeakToMedian = 30.0;
+
+inline bool isSeparator(char c)
+{
+    // 与 MainWindow::processScopeData 的分隔符一致
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == ',' || c == ';';
+}
+
+bool parseCode(const char *begin, const char *end, int *code)
+{
+    bool negative = false;
+    if (*begin == '+' || *begin == '-') {
+        negative = *begin == '-';
+        ++begin;
+    }
+    if (begin == end) return false;
+    qint64 value = 0;
+    for (const char *p = begin; p < end; ++p) {
+        const unsigned digit = static_cast<unsigned>(*p - '0');
+        if (digit > 9) return false;
+        value = value * 10 + digit;
+        if (value > std::numeric_limits<int>::max()) return false;
+    }
+    *code = static_cast<int>(negative ? -value : value);
+    return true;
+}
+
+// Welch 平均的一段：去掉段内直流后加窗求功率谱，累加到 acc；segment 会被改写
+void addWelchSegment(const ScopeFft &fft, const QVector<float> &window, float *segment, QVector<float> *power,
+                     double *acc)
+{
+    // 去掉段内直流，避免其泄漏淹没低频 bin
+    const int size = fft.size();
+    double mean = 0;
+    for (int i = 0; i < size; ++i) mean += segment[i];
+    mean /= size;
+    for (int i = 0; i < size; ++i) segment[i] -= static_cast<float>(mean);
+    fft.powerSpectrum(segment, window.constData(), power->data());
+    for (int k = 0; k < power->size(); ++k) acc[k] += (*power)[k];
+}
+
+// 工作窃取的双端队列：任务为连续序号区间，本线程从头部取，其他线程从尾部偷
+class TaskQueue
+{
+public:
+    void assign(int head, int tail)
+    {
+        m_head = head;
+        m_tail = tail;
+    }
+    bool popFront(int *task)
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_head >= m_tail) return false;
+        *task = m_head++;
+        return true;
+    }
+    bool stealBack(int *task)
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_head >= m_tail) return false;
+        *task = --m_tail;
+        return true;
+    }
+
+private:
+    QMutex m_mutex;
+    int m_head = 0;
+    int m_tail = 0;
+};
+
+class PoolThread : public QThread
+{
+public:
+    explicit PoolThread(const std::function<void()> &body) : m_body(body) {}
+
+protected:
+    void run() override { m_body(); }
+
+private:
+    std::function<void()> m_body;
+};
+
+// 单块的处理状态：解析出的样本分批送入各项统计
+class BlockAnalyzer
+{
+public:
+    BlockAnalyzer(const CaptureAnalyzer::Config &config, CaptureAnalyzer::Partial *out)
+        : m_config(config)
+        , m_out(out)
+        , m_maxCode(std::max(1.0, std::pow(2.0, config.bits) - 1.0))
+        , m_bins(std::max(1, config.histogramBins))
+    {
+        m_out->histogram = QVector<qint64>(m_bins, 0);
+        if (ScopeFft::isPowerOfTwo(config.fftSize) && config.fftSize >= 16) {
+            m_fft.setSize(config.fftSize);
+            m_window = ScopeFft::hannWindow(config.fftSize);
+            m_segment.resize(config.fftSize);
+            m_power.resize(config.fftSize / 2 + 1);
+            m_out->spectrum = QVector<double>(config.fftSize / 2 + 1, 0.0);
+        }
+        if (config.glitchEnabled) {
+            m_detector.configure(config.glitch);
+            m_detector.setCounterModulus(1 << std::min(30, std::max(1, config.bits)));
+            m_detector.setEnabled(true);
+        }
+        m_volts.reserve(kChunkSamples);
+        m_codes.reserve(kChunkSamples);
+    }
+
+    // 块首之前的若干样本只用于建立毛刺检测的前后关系，序号为负
+    void prime(const char *begin, const char *end)
+    {
+        if (!m_config.glitchEnabled) return;
+        parse(begin, end);
+        m_detector.process(m_volts.constData(), m_codes.constData(), m_volts.size(), -m_volts.size(), 0);
+        m_volts.clear();
+        m_codes.clear();
+    }
+
+    // 解析 [begin, end) 内开始的码值，最后一个可以越过 end，直至 limit
+    void run(const char *begin, const char *end, const char *limit)
+    {
+        const char *p = begin;
+        while (p < end) {
+            while (p < end && isSeparator(*p)) ++p;
+            if (p >= end) break;
+            const char *q = p;
+            const char *cap = limit - p > CaptureAnalyzer::kMaxTokenBytes ? p + CaptureAnalyzer::kMaxTokenBytes + 1 : limit;
+            while (q < cap && !isSeparator(*q)) ++q;
+            if (q == cap && cap != limit) {
+                // 过长的片段计为一个无效片段，其余部分在本块内跳过，越过块尾的部分由下一块跳过
+                ++m_out->badTokens;
+                while (q < end && !isSeparator(*q)) ++q;
+                p = q;
+                continue;
+            }
+            append(p, q);
+            p = q;
+            if (m_volts.size() >= kChunkSamples) flush();
+        }
+        flush();
+        if (!m_segment.isEmpty()) m_out->tail = m_segment.mid(0, m_fill);
+        const QVector<GlitchDetector::Event> &events = m_detector.events();
+        m_out->events = events;
+        for (int k = 0; k < GlitchDetector::KindCount; ++k) {
+            m_out->counts[k] = m_detector.count(static_cast<GlitchDetector::EventKind>(k));
+        }
+    }
+
+private:
+    void parse(const char *begin, const char *end)
+    {
+        const char *p = begin;
+        while (p < end) {
+            while (p < end && isSeparator(*p)) ++p;
+            if (p >= end) break;
+            const char *q = p;
+            while (q < end && !isSeparator(*q)) ++q;
+            append(p, q);
+            p = q;
+        }
+    }
+
+    void append(const char *begin, const char *end)
+    {
+        int raw = 0;
+        if (!parseCode(begin, end, &raw)) {
+            ++m_out->badTokens;
+            return;
+        }
+        // 与 processScopeData 相同的码值到电压映射
+        const double clamped = std::max(0.0, std::min(m_maxCode, static_cast<double>(raw)));
+        m_volts.append((m_config.vMin + clamped / m_maxCode * (m_config.vMax - m_config.vMin)) * m_config.gain);
+        m_codes.append(raw);
+    }
+
+    void flush()
+    {
+        const int n = m_volts.size();
+        if (n == 0) return;
+        const double *v = m_volts.constData();
+        const int *c = m_codes.constData();
+        for (int i = 0; i < n; ++i) m_out->moments.add(v[i]);
+
+        qint64 *hist = m_out->histogram.data();
+        const qint64 codeRange = static_cast<qint64>(m_maxCode) + 1;
+        for (int i = 0; i < n; ++i) {
+            const qint64 code = std::max(0, std::min(static_cast<int>(m_maxCode), c[i]));
+            ++hist[code * m_bins / codeRange];
+        }
+
+        if (!m_segment.isEmpty()) {
+            const int size = m_segment.size();
+            QVector<float> &head = m_out->head;
+            for (int i = 0; i < n && head.size() < size - 1; ++i) head.append(static_cast<float>(v[i]));
+            for (int i = 0; i < n; ++i) {
+                m_segment[m_fill++] = static_cast<float>(v[i]);
+                if (m_fill == size) addSegment();
+            }
+        }
+
+        if (m_config.glitchEnabled) m_detector.process(v, c, n, m_out->samples, 0);
+        m_out->samples += n;
+        m_volts.clear();
+        m_codes.clear();
+    }
+
+    void addSegment()
+    {
+        addWelchSegment(m_fft, m_window, m_segment.data(), &m_power, m_out->spectrum.data());
+        ++m_out->segments;
+        m_fill = 0;
+    }
+
+    const CaptureAnalyzer::Config &m_config;
+    CaptureAnalyzer::Partial *m_out;
+    const double m_maxCode;
+    const int m_bins;
+    QVector<double> m_volts;
+    QVector<int> m_codes;
+    ScopeFft m_fft;
+    QVector<float> m_window;
+    QVector<float> m_segment;
+    QVector<float> m_power;
+    int m_fill = 0;
+    GlitchDetector m_detector;
+};
+
+// 块首向前找最多 count 个码值的起点，不越过 lower；lower 不是文件开头时，被它截断的码值不算在内
+const char *primeStart(const char *lower, bool lowerIsFileStart, const char *start, int count)
+{
+    const char *p = start;
+    for (int found = 0; found < count; ++found) {
+        const char *q = p;
+        while (q > lower && isSeparator(q[-1])) --q;
+        if (q == lower) break;
+        while (q > lower && !isSeparator(q[-1])) --q;
+        if (q == lower && !lowerIsFileStart) break;
+        p = q;
+    }
+    return p;
+}
+
+// 整体在内存中的数据
+class MemorySource : public CaptureAnalyzer::Source
+{
+public:
+    explicit MemorySource(const char *data) : m_data(data) {}
+    const char *acquire(qint64 from, qint64) override { return m_data + from; }
+    void release(const char *) override {}
+
+private:
+    const char *m_data;
+};
+
+// 文件逐块映射：同一时刻只映射各线程正在处理的块，地址空间占用与文件大小无关
+class MappedFileSource : public CaptureAnalyzer::Source
+{
+public:
+    explicit MappedFileSource(const QString &fileName) : m_file(fileName) {}
+    bool open() { return m_file.open(QIODevice::ReadOnly); }
+    qint64 size() const { return m_file.size(); }
+    const char *acquire(qint64 from, qint64 to) override
+    {
+        // QFile 的映射表不是线程安全的
+        QMutexLocker locker(&m_mutex);
+        return reinterpret_cast<const char *>(m_file.map(from, to - from));
+    }
+    void release(const char *data) override
+    {
+        QMutexLocker locker(&m_mutex);
+        m_file.unmap(reinterpret_cast<uchar *>(const_cast<char *>(data)));
+    }
+
+private:
+    QFile m_file;
+    QMutex m_mutex;
+};
+
+bool isRunKind(GlitchDetector::EventKind kind)
+{
+    return kind != GlitchDetector::SequenceGap && kind != GlitchDetector::LinkGap;
+}
+}
+
+void CaptureAnalyzer::Partial::merge(const Partial &next)
+{
+    const qint64 shift = samples;
+    // 跨块的 Welch 段：本段剩余样本接上下一段开头的样本
+    if (!spectrum.isEmpty() && spectrum.size() == next.spectrum.size()) {
+        const int size = (spectrum.size() - 1) * 2;
+        ScopeFft fft;
+        QVector<float> window;
+        QVector<float> power;
+        auto addSegment = [&](float *segment) {
+            if (fft.size() == 0) {
+                fft.setSize(size);
+                window = ScopeFft::hannWindow(size);
+                power.resize(size / 2 + 1);
+            }
+            addWelchSegment(fft, window, segment, &power, spectrum.data());
+            ++segments;
+        };
+        if (head.size() < size - 1) head += next.head.mid(0, size - 1 - head.size());
+        if (next.segments > 0) {
+            // next 的首段从其第一个样本开始，head 是首段的一部分
+            if (!tail.isEmpty()) {
+                QVector<float> segment = tail;
+                segment += next.head.mid(0, size - tail.size());
+                if (segment.size() == size) addSegment(segment.data());
+            }
+            tail = next.tail;
+        } else {
+            tail += next.tail;
+            int used = 0;
+            while (tail.size() - used >= size) {
+                addSegment(tail.data() + used);
+                used += size;
+            }
+            tail.remove(0, used);
+        }
+    } else if (spectrum.isEmpty()) {
+        head = next.head;
+        tail = next.tail;
+    }
+    samples += next.samples;
+    badTokens += next.badTokens;
+    moments.merge(next.moments);
+    if (histogram.isEmpty()) {
+        histogram = next.histogram;
+    } else {
+        for (int i = 0; i < std::min(histogram.size(), next.histogram.size()); ++i) histogram[i] += next.histogram[i];
+    }
+    if (spectrum.isEmpty()) {
+        spectrum = next.spectrum;
+    } else {
+        for (int i = 0; i < std::min(spectrum.size(), next.spectrum.size()); ++i) spectrum[i] += next.spectrum[i];
+    }
+    segments += next.segments;
+    for (int k = 0; k < GlitchDetector::KindCount; ++k) counts[k] += next.counts[k];
+
+    for (GlitchDetector::Event e : next.events) {
+        e.sampleIndex += shift;
+        if (e.sampleIndex >= shift) {
+            if (events.size() < kMaxEvents) events.append(e);
+            continue;
+        }
+        // 起点落在本段内：由块首预热样本产生，可能是本段已记录事件的重复或延续
+        int match = -1;
+        const qint64 end = e.sampleIndex + (isRunKind(e.kind) ? e.length : 0);
+        for (int j = events.size() - 1; j >= 0; --j) {
+            const GlitchDetector::Event &x = events[j];
+            if (x.kind != e.kind) continue;
+            if (x.sampleIndex > end) continue;
+            // 游程相交或相接即视为同一事件；序列断档只认同一位置
+            if (isRunKind(x.kind) ? x.sampleIndex + x.length >= e.sampleIndex : x.sampleIndex == e.sampleIndex) {
+                match = j;
+            }
+            break;
+        }
+        if (match >= 0) {
+            --counts[e.kind];
+            if (!isRunKind(e.kind)) continue;
+            GlitchDetector::Event x = events[match];
+            const qint64 start = std::min(x.sampleIndex, e.sampleIndex);
+            const qint64 stop = std::max(x.sampleIndex + x.length, e.sampleIndex + e.length);
+            if (e.kind == GlitchDetector::Slew && std::fabs(e.value) > std::fabs(x.value)) x.value = e.value;
+            x.length = static_cast<int>(std::min<qint64>(stop - start, std::numeric_limits<int>::max()));
+            if (start == x.sampleIndex) {
+                events[match] = x;
+                continue;
+            }
+            x.sampleIndex = start;
+            events.remove(match);
+            e = x;
+        }
+        // 本段未登记的事件（如跨块才达到门限的平直段）按序号插入
+        const int pos = static_cast<int>(std::upper_bound(events.constBegin(), events.constEnd(), e.sampleIndex,
+                                                          [](qint64 i, const GlitchDetector::Event &x) {
+                                                              return i < x.sampleIndex;
+                                                          })
+                                         - events.constBegin());
+        if (pos < kMaxEvents) events.insert(pos, e);
+        if (events.size() > kMaxEvents) events.resize(kMaxEvents);
+    }
+}
+
+int CaptureAnalyzer::runParallel(int tasks, int threads, const std::function<void(int)> &task)
+{
+    if (tasks <= 0) return 0;
+    threads = std::max(1, std::min(threads, tasks));
+    std::unique_ptr<TaskQueue[]> queues(new TaskQueue[threads]);
+    for (int t = 0; t < threads; ++t) {
+        queues[t].assign(static_cast<int>(static_cast<qint64>(tasks) * t / threads),
+                         static_cast<int>(static_cast<qint64>(tasks) * (t + 1) / threads));
+    }
+    QVector<int> steals(threads, 0);
+    auto worker = [&](int self) {
+        int index = 0;
+        while (queues[self].popFront(&index)) task(index);
+        // 自己的队列取空后轮流窃取，全部队列都空时退出（任务不会再增加）
+        bool found = true;
+        while (found) {
+            found = false;
+            for (int k = 1; k < threads; ++k) {
+                if (queues[(self + k) % threads].stealBack(&index)) {
+                    task(index);
+                    ++steals[self];
+                    found = true;
+                    break;
+                }
+            }
+        }
+    };
+
+    QVector<PoolThread *> pool;
+    for (int t = 1; t < threads; ++t) {
+        PoolThread *thread = new PoolThread([&worker, t]() { worker(t); });
+        thread->start();
+        pool.append(thread);
+    }
+    worker(0);
+    for (PoolThread *thread : pool) {
+        thread->wait();
+        delete thread;
+    }
+    int total = 0;
+    for (int s : steals) total += s;
+    return total;
+}
+
+CaptureAnalyzer::Result CaptureAnalyzer::analyse(const char *data, qint64 size, const Config &config, Monitor *monitor)
+{
+    MemorySource source(data);
+    return analyse(source, size, config, monitor);
+}
+
+CaptureAnalyzer::Result CaptureAnalyzer::analyse(Source &source, qint64 size, const Config &config, Monitor *monitor)
+{
+    Result r;
+    r.bytes = size;
+    const auto startTime = std::chrono::steady_clock::now();
+    r.threads = config.threads > 0 ? config.threads : std::max(1, QThread::idealThreadCount());
+    // 分块与线程数无关：固定目标块数，下限保证块内有足够多的完整段
+    const qint64 minBlockBytes = std::max(kMinBlockBytes, static_cast<qint64>(config.fftSize) * kBlockBytesPerFftPoint);
+    const qint64 blockBytes = std::max(minBlockBytes, std::min(config.blockBytes, size / kTargetBlocks + 1));
+    const qint64 blocks = size > 0 ? (size + blockBytes - 1) / blockBytes : 0;
+    if (blocks > std::numeric_limits<int>::max()) {
+        r.error = QStringLiteral("文件过大");
+        return r;
+    }
+    r.blocks = static_cast<int>(blocks);
+    const int primeCount = config.glitchEnabled
+            ? std::min(kMaxPrimeSamples, std::max(2, config.glitch.flatSamples) + 1) : 0;
+    // 每块只取块本身加上前后余量：之前为预热区（至少 1 字节，用于判断块首是否在码值中间），
+    // 之后为跨越块尾的最后一个码值
+    const qint64 primeBytes = std::max<qint64>(1, primeCount * kPrimeBytesPerSample);
+
+    QVector<Partial> partials(r.blocks);
+    std::atomic<bool> failed(false);
+    r.steals = runParallel(r.blocks, r.threads, [&](int b) {
+        if (failed.load() || (monitor && monitor->cancel.load())) return;
+        const qint64 blockBegin = b * blockBytes;
+        const qint64 blockEnd = std::min(size, blockBegin + blockBytes);
+        const qint64 from = std::max<qint64>(0, blockBegin - primeBytes);
+        const qint64 to = std::min(size, blockEnd + kMaxTokenBytes + 1);
+        const char *data = source.acquire(from, to);
+        if (!data) {
+            failed = true;
+            return;
+        }
+        const char *lower = data;
+        const char *begin = data + (blockBegin - from);
+        const char *end = data + (blockEnd - from);
+        const char *limit = data + (to - from);
+        // 跨块边界的码值归属于起始字符所在的块
+        const char *start = begin;
+        if (b > 0 && !isSeparator(begin[-1])) {
+            while (start < end && !isSeparator(*start)) ++start;
+        }
+        BlockAnalyzer block(config, &partials[b]);
+        if (b > 0 && primeCount > 0) block.prime(primeStart(lower, from == 0, start, primeCount), start);
+        block.run(start, end, limit);
+        source.release(data);
+        if (monitor) monitor->doneBytes += blockEnd - blockBegin;
+    });
+    if (failed.load()) {
+        r.error = QStringLiteral("内存映射失败");
+        return r;
+    }
+    if (monitor && monitor->cancel.load()) {
+        r.error = QStringLiteral("已取消");
+        return r;
+    }
+    for (const Partial &p : partials) r.total.merge(p);
+
+    const Partial &t = r.total;
+    if (t.segments > 0) {
+        r.spectrum = t.spectrum;
+        for (double &p : r.spectrum) p /= t.segments;
+        r.binWidth = config.sampleRate / config.fftSize;
+        const int n = r.spectrum.size();
+        int peak = kPeakBins;
+        for (int k = kPeakBins + 1; k < n - 1; ++k) {
+            if (r.spectrum[k] > r.spectrum[peak]) peak = k;
+        }
+        QVector<double> ordered = r.spectrum;
+        std::nth_element(ordered.begin(), ordered.begin() + n / 2, ordered.end());
+        const double floorPower = std::max(1e-30, ordered[n / 2]);
+        if (peak < n - 1 && r.spectrum[peak] >= kMinPeakToMedian * floorPower) {
+            const double a = std::log(std::max(1e-30, r.spectrum[peak - 1]));
+            const double b = std::log(std::max(1e-30, r.spectrum[peak]));
+            const double c = std::log(std::max(1e-30, r.spectrum[peak + 1]));
+            const double denom = a - 2 * b + c;
+            const double bin = peak + (std::fabs(denom) > 1e-12 ? 0.5 * (a - c) / denom : 0.0);
+            r.fundamental = bin * r.binWidth;
+            auto bandPower = [&](int center) {
+                double sum = 0;
+                for (int k = std::max(0, center - kPeakBins); k <= std::min(n - 1, center + kPeakBins); ++k) {
+                    sum += r.spectrum[k];
+                }
+                return sum;
+            };
+            const double fundamentalPower = bandPower(peak);
+            double harmonicPower = 0;
+            for (int h = 2; h <= kMaxHarmonic; ++h) {
+                const int center = static_cast<int>(std::lround(bin * h));
+                if (center + kPeakBins >= n) break;
+                harmonicPower += bandPower(center);
+            }
+            r.thdPercent = fundamentalPower > 0 ? 100.0 * std::sqrt(harmonicPower / fundamentalPower) : 0.0;
+        }
+    }
+    r.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    r.ok = true;
+    return r;
+}
+
+CaptureAnalyzer::Result CaptureAnalyzer::analyseFile(const QString &fileName, const Config &config, Monitor *monitor)
+{
+    Result r;
+    MappedFileSource file(fileName);
+    if (!file.open()) {
+        r.error = QStringLiteral("无法打开文件");
+        return r;
+    }
+    const qint64 size = file.size();
+    if (size <= 0) {
+        r.error = QStringLiteral("文件为空");
+        return r;
+    }
+    // 各线程只映射自己正在处理的块，由系统按需分页读入，无需整体读入内存
+    if (monitor) monitor->totalBytes = size;
+    return analyse(file, size, config, monitor);
+}
+
+bool CaptureAnalyzer::sameResult(const Result &a, const Result &b)
+{
+    const Partial &x = a.total;
+    const Partial &y = b.total;
+    if (a.ok != b.ok || x.samples != y.samples || x.badTokens != y.badTokens || x.segments != y.segments
+            || x.histogram != y.histogram || x.spectrum != y.spectrum || x.events.size() != y.events.size()) {
+        return false;
+    }
+    if (x.moments.count() != y.moments.count() || x.moments.mean() != y.moments.mean()
+            || x.moments.variance() != y.moments.variance() || x.moments.min() != y.moments.min()
+            || x.moments.max() != y.moments.max()) {
+        return false;
+    }
+    for (int k = 0; k < GlitchDetector::KindCount; ++k) {
+        if (x.counts[k] != y.counts[k]) return false;
+    }
+    for (int i = 0; i < x.events.size(); ++i) {
+        if (x.events[i].sampleIndex != y.events[i].sampleIndex || x.events[i].kind != y.events[i].kind
+                || x.events[i].length != y.events[i].length) {
+            return false;
+        }
+    }
+    return a.fundamental == b.fundamental && a.thdPercent == b.thdPercent;
+}
+
+QVector<CaptureAnalyzer::BenchmarkPoint> CaptureAnalyzer::benchmark(const char *data, qint64 size, const Config &config,
+                                                                    int maxThreads, QString *error, Monitor *monitor)
+{
+    MemorySource source(data);
+    return benchmark(source, size, config, maxThreads, error, monitor);
+}
+
+QVector<CaptureAnalyzer::BenchmarkPoint> CaptureAnalyzer::benchmark(Source &source, qint64 size, const Config &config,
+                                                                    int maxThreads, QString *error, Monitor *monitor)
+{
+    QVector<BenchmarkPoint> points;
+    maxThreads = std::max(1, maxThreads);
+    QVector<int> counts;
+    for (int t = 1; t < maxThreads; t *= 2) counts.append(t);
+    counts.append(maxThreads);
+
+    Config cfg = config;
+    // 先完整跑一遍，让文件页面进入系统缓存，避免单线程基准额外承担读盘时间
+    cfg.threads = maxThreads;
+    if (monitor && monitor->totalBytes.load() == 0) monitor->totalBytes = size * (counts.size() + 1);
+    analyse(source, size, cfg, monitor);
+    // 分块与线程数无关，各点的工作量相同，结果应与单线程逐位一致
+    double baseMs = 0;
+    Result base;
+    for (int threads : counts) {
+        cfg.threads = threads;
+        const Result r = analyse(source, size, cfg, monitor);
+        if (!r.ok) {
+            if (error) *error = r.error;
+            return QVector<BenchmarkPoint>();
+        }
+        BenchmarkPoint p;
+        p.threads = threads;
+        p.elapsedMs = r.elapsedMs;
+        if (threads == 1) {
+            baseMs = r.elapsedMs;
+            base = r;
+        }
+        p.identical = sameResult(base, r);
+        p.speedup = r.elapsedMs > 0 ? baseMs / r.elapsedMs : 0.0;
+        p.mbPerSecond = r.elapsedMs > 0 ? size / 1048576.0 / (r.elapsedMs / 1000.0) : 0.0;
+        points.append(p);
+    }
+    return points;
+}
+
+QVector<CaptureAnalyzer::BenchmarkPoint> CaptureAnalyzer::benchmarkFile(const QString &fileName, const Config &config,
+                                                                        int maxThreads, QString *error, Monitor *monitor)
+{
+    MappedFileSource file(fileName);
+    const qint64 size = file.open() ? file.size() : 0;
+    if (size <= 0) {
+        if (error) *error = QStringLiteral("无法打开文件或文件为空");
+        return QVector<BenchmarkPoint>();
+    }
+    return benchmark(file, size, config, maxThreads, error, monitor);
+}
@@ -0,0 +1,113 @@
+#ifndef SCOPEOFFLINE_H
+#define SCOPEOFFLINE_H
+
+#include "scopeglitch.h"
+#include "streamstats.h"
+
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <functional>
+
+// 离线分析长时间采集文件（保存的示波器接收日志：以空白/逗号/分号分隔的十进制码值）
+// 文件按字节切块，每块连同前后少量余量单独内存映射（32 位进程也能分析数 GB 的文件），
+// 块交给工作窃取线程池并行处理；每块产生一份部分结果，
+// 部分结果满足结合律，按文件顺序合并即得到与单线程完全相同的矩、直方图与平均功率谱。
+// 分块只由文件大小与段长决定，与线程数无关；块内 Welch 段从块首开始，块尾不足一段的样本
+// 与下一块开头的样本在合并时拼成一段（与下一块首段部分重叠），小于一段的块在合并时连续累积
+class CaptureAnalyzer
+{
+public:
+    struct Config {
+        double vMin = 0.0;
+        double vMax = 3.3;
+        int bits = 12;
+        double gain = 1.0;
+        double sampleRate = 1000.0;
+        int fftSize = 4096;              // Welch 平均的段长（2 的幂）
+        int histogramBins = 256;         // 码值直方图的桶数
+        bool glitchEnabled = true;
+        GlitchDetector::Config glitch;
+        int threads = 0;                 // 0 表示使用全部逻辑核心
+        qint64 blockBytes = 4 << 20;     // 块大小上限；文件较小时自动减小，但不小于 64 倍段长
+    };
+
+    // 一段连续样本的统计，merge() 只要求两段在文件中相邻且 this 在前
+    struct Partial {
+        qint64 samples = 0;
+        qint64 badTokens = 0;            // 无法解析为整数的片段
+        RunningMoments moments;
+        QVector<qint64> histogram;
+        QVector<double> spectrum;        // 各段功率谱之和
+        qint64 segments = 0;
+        QVector<float> head;             // 开头 min(samples, 段长-1) 个样本，供与前一段的剩余样本拼段
+        QVector<float> tail;             // 最后一个完整段之后的样本（无完整段时为全部样本）
+        QVector<GlitchDetector::Event> events;  // 序号相对本段首样本，可为负（来自块前的预热样本）
+        qint64 counts[GlitchDetector::KindCount] = {};
+
+        void merge(const Partial &next);
+    };
+
+    struct Result {
+        bool ok = false;
+        QString error;
+        qint64 bytes = 0;
+        int blocks = 0;
+        int threads = 0;
+        int steals = 0;                  // 从其他线程队列窃取的块数
+        double elapsedMs = 0;
+        Partial total;
+        QVector<double> spectrum;        // 平均功率谱，size = fftSize/2+1
+        double binWidth = 0;             // Hz
+        double fundamental = 0;          // Hz，0 表示谱中没有明显峰值
+        double thdPercent = 0;           // 2~kMaxHarmonic 次谐波
+    };
+
+    struct BenchmarkPoint {
+        int threads = 0;
+        double elapsedMs = 0;
+        double speedup = 0;
+        double mbPerSecond = 0;
+        bool identical = false;          // 结果与单线程逐位相同
+    };
+
+    // 进度与取消，可在其他线程读写：doneBytes 随块完成累加（性能测试为各轮之和），totalBytes 由 *File 接口填写；
+    // cancel 置位后尚未开始的块直接跳过，本次分析以“已取消”失败返回
+    struct Monitor {
+        std::atomic<qint64> doneBytes{0};
+        std::atomic<qint64> totalBytes{0};
+        std::atomic<bool> cancel{false};
+    };
+
+    // 分析的数据来源：取出覆盖 [from, to) 的只读数据，用完即释放；各工作线程会同时调用
+    class Source
+    {
+    public:
+        virtual ~Source() {}
+        // 失败返回 nullptr
+        virtual const char *acquire(qint64 from, qint64 to) = 0;
+        virtual void release(const char *data) = 0;
+    };
+
+    static const int kMaxHarmonic = 5;
+    // 超过这么长的片段不可能是有效码值，按一个无效片段计；块的映射余量也由此确定
+    static const int kMaxTokenBytes = 64;
+
+    static Result analyseFile(const QString &fileName, const Config &config, Monitor *monitor = nullptr);
+    static Result analyse(const char *data, qint64 size, const Config &config, Monitor *monitor = nullptr);
+    static Result analyse(Source &source, qint64 size, const Config &config, Monitor *monitor = nullptr);
+    // 依次以 1、2、4… 直至 maxThreads 个线程分析同一数据，speedup 以单线程耗时为基准
+    static QVector<BenchmarkPoint> benchmark(const char *data, qint64 size, const Config &config, int maxThreads,
+                                             QString *error = nullptr, Monitor *monitor = nullptr);
+    static QVector<BenchmarkPoint> benchmark(Source &source, qint64 size, const Config &config, int maxThreads,
+                                             QString *error = nullptr, Monitor *monitor = nullptr);
+    static QVector<BenchmarkPoint> benchmarkFile(const QString &fileName, const Config &config, int maxThreads,
+                                                 QString *error = nullptr, Monitor *monitor = nullptr);
+    // 工作窃取线程池：任务按序号均分到各线程的双端队列，线程从自己队列头部取，
+    // 空了再从其他线程队列尾部窃取；返回窃取次数
+    static int runParallel(int tasks, int threads, const std::function<void(int)> &task);
+    // 两次分析的统计、谱与事件是否逐位相同（不比较耗时与线程数）
+    static bool sameResult(const Result &a, const Result &b);
+};
+
+#endif // SCOPEOFFLINE_H
@@ -0,0 +1,220 @@
+#include "scopepersistence.h"
+#include "scopesimd.h"
+
+#include <QTimer>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const int kRenderIntervalMs = 40;
+
+// 余辉色表：浅蓝 -> 主题蓝 -> 紫 -> 红 -> 黄，越热越亮
+struct PhosphorPalette {
+    QRgb colors[256];
+    PhosphorPalette()
+    {
+        const int stops[][4] = {
+            {0, 0xcf, 0xe3, 0xff},
+            {80, 0x00, 0x7a, 0xff},
+            {150, 0xaf, 0x52, 0xde},
+            {210, 0xff, 0x3b, 0x30},
+            {255, 0xff, 0xcc, 0x00},
+        };
+        for (int s = 0; s < 4; ++s) {
+            const int i0 = stops[s][0];
+            const int i1 = stops[s + 1][0];
+            for (int i = i0; i <= i1; ++i) {
+                const double t = static_cast<double>(i - i0) / (i1 - i0);
+                colors[i] = qRgb(static_cast<int>(stops[s][1] + t * (stops[s + 1][1] - stops[s][1])),
+                                 static_cast<int>(stops[s][2] + t * (stops[s + 1][2] - stops[s][2])),
+                                 static_cast<int>(stops[s][3] + t * (stops[s + 1][3] - stops[s][3])));
+            }
+        }
+    }
+};
+
+const PhosphorPalette &palette()
+{
+    static const PhosphorPalette p;
+    return p;
+}
+
+int toRow(float v, float vLow, float vHigh, int height)
+{
+    const float t = (vHigh - v) / (vHigh - vLow);
+    const int y = static_cast<int>(t * (height - 1) + 0.5f);
+    return std::min(height - 1, std::max(0, y));
+}
+}
+
+void PersistenceBuffer::resize(int width, int height)
+{
+    m_width = std::max(0, width);
+    m_height = std::max(0, height);
+    m_hits.fill(0, m_width * m_height);
+}
+
+void PersistenceBuffer::clear()
+{
+    std::fill(m_hits.begin(), m_hits.end(), 0u);
+}
+
+void PersistenceBuffer::fillColumn(int x, int yLow, int yHigh)
+{
+    quint32 *col = m_hits.data() + x * m_height;
+    int y = yLow;
+#ifdef SCOPE_HAVE_SSE2
+    const __m128i ones = _mm_set1_epi32(1);
+    for (; y + 4 <= yHigh + 1; y += 4) {
+        __m128i *p = reinterpret_cast<__m128i *>(col + y);
+        _mm_storeu_si128(p, _mm_add_epi32(_mm_loadu_si128(p), ones));
+    }
+#endif
+    for (; y <= yHigh; ++y) {
+        ++col[y];
+    }
+}
+
+void PersistenceBuffer::accumulate(const float *frame, int length, float vLow, float vHigh)
+{
+    if (m_width <= 0 || m_height <= 0 || length < 2 || vHigh <= vLow) return;
+    // 每列覆盖 [pos0, pos1] 区间：端点线性插值，中间样本取极值，相邻列共享端点保证连续
+    const double step = static_cast<double>(length - 1) / m_width;
+    for (int x = 0; x < m_width; ++x) {
+        const double pos0 = x * step;
+        const double pos1 = (x + 1) * step;
+        const int i0 = static_cast<int>(pos0);
+        const int i1 = std::min(length - 1, static_cast<int>(pos1));
+        const float f0 = static_cast<float>(pos0 - i0);
+        const float f1 = static_cast<float>(pos1 - i1);
+        const float v0 = frame[i0] + f0 * (frame[std::min(length - 1, i0 + 1)] - frame[i0]);
+        const float v1 = frame[i1] + f1 * (frame[std::min(length - 1, i1 + 1)] - frame[i1]);
+        float lo = std::min(v0, v1);
+        float hi = std::max(v0, v1);
+        for (int i = i0 + 1; i <= i1; ++i) {
+            lo = std::min(lo, frame[i]);
+            hi = std::max(hi, frame[i]);
+        }
+        // 纵轴向下增长：高电压对应较小的行号
+        fillColumn(x, toRow(hi, vLow, vHigh, m_height), toRow(lo, vLow, vHigh, m_height));
+    }
+}
+
+void PersistenceBuffer::decay(float factor)
+{
+    if (factor >= 1.0f) return;
+    quint32 *p = m_hits.data();
+    const int n = m_hits.size();
+    int i = 0;
+#ifdef SCOPE_HAVE_SSE2
+    // 计数远小于 2^24，经单精度缩放后截断不会损失有效位
+    const __m128 k = _mm_set1_ps(factor);
+    for (; i + 4 <= n; i += 4) {
+        __m128i *q = reinterpret_cast<__m128i *>(p + i);
+        const __m128 f = _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128(q)), k);
+        _mm_storeu_si128(q, _mm_cvttps_epi32(f));
+    }
+#endif
+    for (; i < n; ++i) {
+        p[i] = static_cast<quint32>(p[i] * factor);
+    }
+}
+
+QImage PersistenceBuffer::render() const
+{
+    QImage image(std::max(1, m_width), std::max(1, m_height), QImage::Format_ARGB32);
+    image.fill(Qt::transparent);
+    if (m_hits.isEmpty()) return image;
+    const quint32 maxHits = *std::max_element(m_hits.begin(), m_hits.end());
+    if (maxHits == 0) return image;
+
+    // 对数映射使偶发毛刺与高频轨迹同时可见
+    const double scale = 255.0 / std::log1p(static_cast<double>(maxHits));
+    QVector<quint8> lut(std::min<quint32>(maxHits, 65535) + 1);
+    for (int h = 0; h < lut.size(); ++h) {
+        lut[h] = static_cast<quint8>(std::min(255.0, std::log1p(static_cast<double>(h)) * scale));
+    }
+    const PhosphorPalette &pal = palette();
+    const quint32 *hits = m_hits.constData();
+    for (int y = 0; y < m_height; ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < m_width; ++x) {
+            const quint32 h = hits[x * m_height + y];
+            if (h == 0) continue;
+            const int idx = h < static_cast<quint32>(lut.size())
+                    ? lut[h] : static_cast<int>(std::min(255.0, std::log1p(static_cast<double>(h)) * scale));
+            line[x] = pal.colors[idx];
+        }
+    }
+    return image;
+}
+
+PersistenceWorker::PersistenceWorker(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void PersistenceWorker::start()
+{
+    // 定时器在工作线程内创建，渲染与衰减都不占用界面线程
+    if (m_timer) return;
+    m_timer = new QTimer(this);
+    m_timer->setInterval(kRenderIntervalMs);
+    connect(m_timer, &QTimer::timeout, this, &PersistenceWorker::renderFrame);
+    m_timer->start();
+    m_clock.start();
+}
+
+void PersistenceWorker::setGeometry(int width, int height)
+{
+    if (width == m_buffer.width() && height == m_buffer.height()) return;
+    m_buffer.resize(width, height);
+    m_frameCount = 0;
+    m_dirty = true;
+}
+
+void PersistenceWorker::setRange(double vLow, double vHigh)
+{
+    if (vLow == m_vLow && vHigh == m_vHigh) return;
+    m_vLow = vLow;
+    m_vHigh = vHigh;
+    clear();
+}
+
+void PersistenceWorker::setDecayPerSecond(double percent)
+{
+    m_decayPerSecond = std::min(100.0, std::max(0.0, percent));
+}
+
+void PersistenceWorker::addFrames(const QVector<float> &frames, int frameLength)
+{
+    if (frameLength < 2) return;
+    const int count = frames.size() / frameLength;
+    for (int f = 0; f < count; ++f) {
+        m_buffer.accumulate(frames.constData() + f * frameLength, frameLength,
+                            static_cast<float>(m_vLow), static_cast<float>(m_vHigh));
+    }
+    m_frameCount += count;
+    m_dirty = m_dirty || count > 0;
+}
+
+void PersistenceWorker::clear()
+{
+    m_buffer.clear();
+    m_frameCount = 0;
+    m_dirty = true;
+}
+
+void PersistenceWorker::renderFrame()
+{
+    // 衰减按实际经过的时间计算，与渲染帧率无关
+    const double elapsedSec = m_clock.restart() / 1000.0;
+    if (m_decayPerSecond > 0 && elapsedSec > 0) {
+        const double keep = std::pow(1.0 - m_decayPerSecond / 100.0, elapsedSec);
+        m_buffer.decay(static_cast<float>(keep));
+        m_dirty = true;
+    }
+    if (!m_dirty) return;
+    m_dirty = false;
+    emit imageReady(m_buffer.render(), m_frameCount);
+}
@@ -0,0 +1,66 @@
+#ifndef SCOPEPERSISTENCE_H
+#define SCOPEPERSISTENCE_H
+
+#include <QObject>
+#include <QImage>
+#include <QVector>
+#include <QElapsedTimer>
+
+class QTimer;
+
+// 数字余辉命中计数缓冲：按列存储 (x * height + y)，使每列的竖直填充在内存中连续
+class PersistenceBuffer
+{
+public:
+    void resize(int width, int height);
+    void clear();
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    // 将一帧波形叠加到命中计数中，纵轴范围 [vLow, vHigh]
+    void accumulate(const float *frame, int length, float vLow, float vHigh);
+    // 所有计数乘以 factor (0~1)，实现余辉衰减
+    void decay(float factor);
+    // 经对数映射与色表渲染为 ARGB32 图像
+    QImage render() const;
+
+private:
+    void fillColumn(int x, int yLow, int yHigh);
+
+    QVector<quint32> m_hits;
+    int m_width = 0;
+    int m_height = 0;
+};
+
+// 余辉累积工作对象：运行在独立线程中，定时输出渲染好的图像
+class PersistenceWorker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit PersistenceWorker(QObject *parent = nullptr);
+
+public slots:
+    void start();
+    void setGeometry(int width, int height);
+    void setRange(double vLow, double vHigh);
+    // 每秒衰减百分比，0 表示无限余辉
+    void setDecayPerSecond(double percent);
+    void addFrames(const QVector<float> &frames, int frameLength);
+    void clear();
+
+signals:
+    void imageReady(const QImage &image, qint64 frameCount);
+
+private:
+    void renderFrame();
+
+    PersistenceBuffer m_buffer;
+    QTimer *m_timer = nullptr;
+    QElapsedTimer m_clock;
+    double m_vLow = 0;
+    double m_vHigh = 3.3;
+    double m_decayPerSecond = 0;
+    qint64 m_frameCount = 0;
+    bool m_dirty = false;
+};
+
+#endif // SCOPEPERSISTENCE_H
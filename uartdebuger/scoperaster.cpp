@@ -0,0 +1,270 @@
+#include "scoperaster.h"
+#include "scopesimd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+void TraceRaster::resize(int width, int height)
+{
+    m_width = std::max(0, width);
+    m_height = std::max(0, height);
+    m_main.fill(0, m_width * m_height);
+    m_overlay.fill(0, m_width * m_height);
+}
+
+void TraceRaster::clear()
+{
+    std::fill(m_main.begin(), m_main.end(), quint8(0));
+    std::fill(m_overlay.begin(), m_overlay.end(), quint8(0));
+}
+
+quint8 *TraceRaster::plane(Plane p)
+{
+    return p == MainPlane ? m_main.data() : m_overlay.data();
+}
+
+void TraceRaster::valueRange(const double *values, int count, double *minVal, double *maxVal)
+{
+    if (count <= 0) {
+        *minVal = 0;
+        *maxVal = 0;
+        return;
+    }
+    double lo = values[0];
+    double hi = values[0];
+    int i = 0;
+#ifdef SCOPE_HAVE_SSE2
+    if (count >= 4) {
+        __m128d vlo = _mm_loadu_pd(values);
+        __m128d vhi = vlo;
+        for (i = 2; i + 2 <= count; i += 2) {
+            const __m128d x = _mm_loadu_pd(values + i);
+            vlo = _mm_min_pd(vlo, x);
+            vhi = _mm_max_pd(vhi, x);
+        }
+        double l[2], h[2];
+        _mm_storeu_pd(l, vlo);
+        _mm_storeu_pd(h, vhi);
+        lo = std::min(l[0], l[1]);
+        hi = std::max(h[0], h[1]);
+    }
+#endif
+    for (; i < count; ++i) {
+        lo = std::min(lo, values[i]);
+        hi = std::max(hi, values[i]);
+    }
+    *minVal = lo;
+    *maxVal = hi;
+}
+
+void TraceRaster::valueRange(const SampleRing::Span &values, double *minVal, double *maxVal)
+{
+    valueRange(values.head, values.headCount, minVal, maxVal);
+    if (values.tailCount > 0) {
+        double lo, hi;
+        valueRange(values.tail, values.tailCount, &lo, &hi);
+        if (values.headCount > 0) {
+            lo = std::min(lo, *minVal);
+            hi = std::max(hi, *maxVal);
+        }
+        *minVal = lo;
+        *maxVal = hi;
+    }
+}
+
+void TraceRaster::fillColumn(quint8 *plane, int x, int yTop, int yBottom)
+{
+    yTop = std::max(0, yTop);
+    yBottom = std::min(m_height - 1, yBottom);
+    if (x < 0 || x >= m_width || yTop > yBottom) return;
+    quint8 *col = plane + x * m_height;
+    int y = yTop;
+#ifdef SCOPE_HAVE_SSE2
+    const __m128i full = _mm_set1_epi8(static_cast<char>(0xff));
+    for (; y + 16 <= yBottom + 1; y += 16) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(col + y), full);
+    }
+#endif
+    for (; y <= yBottom; ++y) {
+        col[y] = 0xff;
+    }
+}
+
+void TraceRaster::plot(quint8 *plane, int x, int y, double coverage)
+{
+    if (x < 0 || x >= m_width || y < 0 || y >= m_height || coverage <= 0) return;
+    quint8 &c = plane[x * m_height + y];
+    const int v = static_cast<int>(std::min(1.0, coverage) * 255.0 + 0.5);
+    // 同一像素被多段线覆盖时取最大值，避免接缝处变暗或过曝
+    if (v > c) c = static_cast<quint8>(v);
+}
+
+void TraceRaster::drawEnvelope(quint8 *plane, const SampleRing::Span &values, double minVal, double span,
+                               double lineWidth, double x0, double x1)
+{
+    // 与余辉缓冲相同：每列覆盖 [pos0, pos1]，端点插值、中间取极值，相邻列共享端点保证连续
+    // 波形占据列坐标 [x0, x1]，铺满时为 [0, m_width]
+    const int count = values.size();
+    const double step = (count - 1) / std::max(1e-9, x1 - x0);
+    const double scale = (m_height - 1) / span;
+    const double pad = std::max(0.0, (lineWidth - 1.0) / 2.0);
+    const int xFirst = std::max(0, static_cast<int>(std::floor(x0)));
+    const int xEnd = std::min(m_width, static_cast<int>(std::ceil(x1)));
+    for (int x = xFirst; x < xEnd; ++x) {
+        const double pos0 = std::max(0.0, (x - x0) * step);
+        const double pos1 = std::min(static_cast<double>(count - 1), (x + 1 - x0) * step);
+        const int i0 = static_cast<int>(pos0);
+        const int i1 = std::min(count - 1, static_cast<int>(pos1));
+        const double v0 = values[i0] + (pos0 - i0) * (values[std::min(count - 1, i0 + 1)] - values[i0]);
+        const double v1 = values[i1] + (pos1 - i1) * (values[std::min(count - 1, i1 + 1)] - values[i1]);
+        double lo = std::min(v0, v1);
+        double hi = std::max(v0, v1);
+        if (i1 - i0 > 1) {
+            double innerLo, innerHi;
+            valueRange(values.mid(i0 + 1, i1 - i0), &innerLo, &innerHi);
+            lo = std::min(lo, innerLo);
+            hi = std::max(hi, innerHi);
+        }
+        const int yTop = static_cast<int>(std::floor((minVal + span - hi) * scale + 0.5 - pad));
+        const int yBottom = static_cast<int>(std::floor((minVal + span - lo) * scale + 0.5 + pad));
+        fillColumn(plane, x, yTop, yBottom);
+    }
+}
+
+void TraceRaster::drawWuLine(quint8 *plane, double x0, double y0, double x1, double y1, double lineWidth)
+{
+    // 以主方向逐像素推进，次方向按线宽区间与像素的重叠长度给出覆盖度
+    const bool steep = std::fabs(y1 - y0) > std::fabs(x1 - x0);
+    if (steep) {
+        std::swap(x0, y0);
+        std::swap(x1, y1);
+    }
+    if (x0 > x1) {
+        std::swap(x0, x1);
+        std::swap(y0, y1);
+    }
+    const double dx = x1 - x0;
+    const double gradient = dx > 1e-9 ? (y1 - y0) / dx : 0.0;
+    const double half = lineWidth * std::sqrt(1.0 + gradient * gradient) / 2.0;
+    const int xStart = static_cast<int>(std::floor(x0 + 0.5));
+    const int xEnd = static_cast<int>(std::floor(x1 + 0.5));
+    for (int x = xStart; x <= xEnd; ++x) {
+        const double c = y0 + gradient * (x - x0);
+        const double lo = c - half + 0.5;
+        const double hi = c + half + 0.5;
+        for (int y = static_cast<int>(std::floor(lo)); y < hi; ++y) {
+            const double coverage = std::min(hi, y + 1.0) - std::max(lo, static_cast<double>(y));
+            if (steep) {
+                plot(plane, y, x, coverage);
+            } else {
+                plot(plane, x, y, coverage);
+            }
+        }
+    }
+}
+
+void TraceRaster::drawTrace(Plane p, const SampleRing::Span &values, double minVal, double span, double lineWidth,
+                            double from, double to)
+{
+    const int count = values.size();
+    if (m_width <= 0 || m_height <= 0 || count < 2 || span <= 0 || to <= from) return;
+    quint8 *target = plane(p);
+    if (count > (to - from) * m_width) {
+        drawEnvelope(target, values, minVal, span, lineWidth, from * m_width, to * m_width);
+        return;
+    }
+    // 折线以像素中心为坐标，铺满时从第 0 列画到第 m_width - 1 列
+    const double xOrigin = from * (m_width - 1);
+    const double xScale = (to - from) * (m_width - 1) / (count - 1);
+    const double yScale = (m_height - 1) / span;
+    for (int i = 0; i + 1 < count; ++i) {
+        drawWuLine(target, xOrigin + i * xScale, (minVal + span - values[i]) * yScale,
+                   xOrigin + (i + 1) * xScale, (minVal + span - values[i + 1]) * yScale, lineWidth);
+    }
+}
+
+void TraceRaster::compose(QImage &target, QRgb mainColor, QRgb overlayColor) const
+{
+    if (target.width() != m_width || target.height() != m_height
+            || target.format() != QImage::Format_ARGB32_Premultiplied) {
+        target = QImage(std::max(1, m_width), std::max(1, m_height), QImage::Format_ARGB32_Premultiplied);
+    }
+    // 覆盖度按列存储，这里转置为按行的图像，同时做 alpha 合成
+    auto premultiply = [](QRgb color, int alpha) -> QRgb {
+        return qRgba(qRed(color) * alpha / 255, qGreen(color) * alpha / 255, qBlue(color) * alpha / 255, alpha);
+    };
+    for (int y = 0; y < m_height; ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(target.scanLine(y));
+        for (int x = 0; x < m_width; ++x) {
+            const int a = m_main[x * m_height + y];
+            const int b = m_overlay[x * m_height + y];
+            if (a == 255) {
+                line[x] = premultiply(mainColor, 255);
+            } else if (b == 0) {
+                line[x] = premultiply(mainColor, a);
+            } else {
+                // 主波形 (a) 覆盖在叠加波形 (b) 上的预乘 over 合成
+                const QRgb top = premultiply(mainColor, a);
+                const QRgb bottom = premultiply(overlayColor, b);
+                const int inv = 255 - a;
+                line[x] = qRgba(qRed(top) + qRed(bottom) * inv / 255, qGreen(top) + qGreen(bottom) * inv / 255,
+                                qBlue(top) + qBlue(bottom) * inv / 255, a + b * inv / 255);
+            }
+        }
+    }
+}
+
+TraceRenderWorker::TraceRenderWorker(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void TraceRenderWorker::render(const TraceRenderRequest &request)
+{
+    // 排队期间又有新请求时直接跳过，只渲染最新的一帧
+    if (request.serial != m_latestSerial.loadAcquire()) return;
+    if (!request.values || request.count <= 0) return;
+    const SampleRing::Span values = request.values->span(request.first, request.count);
+    const ScopeMeasure::Result stats = ScopeMeasure::measure(values, request.sampleRate);
+    if (!request.draw || request.width <= 0 || request.height <= 0) {
+        if (!request.values->intact(request.first)) return;
+        emit frameReady(QImage(), stats.min, stats.max, stats, request.serial);
+        return;
+    }
+    if (request.width != m_raster.width() || request.height != m_raster.height()) {
+        m_raster.resize(request.width, request.height);
+    } else {
+        m_raster.clear();
+    }
+
+    // 纵轴范围与 QPainter 绘制路径一致：主波形极值，再并入叠加波形
+    double minVal = stats.min;
+    double maxVal = stats.max;
+    const bool haveOverlay = request.overlay && request.overlayCount > 1;
+    SampleRing::Span overlay;
+    if (haveOverlay) {
+        overlay = request.overlay->span(request.overlayFirst, request.overlayCount);
+        double oMin, oMax;
+        TraceRaster::valueRange(overlay, &oMin, &oMax);
+        minVal = std::min(minVal, oMin);
+        maxVal = std::max(maxVal, oMax);
+    }
+    const double span = std::max(1e-9, maxVal - minVal);
+    if (haveOverlay && request.count > 1) {
+        // 叠加波形按样本位置对齐主波形，不足一屏时只占对应的一段宽度
+        const double last = request.count - 1;
+        m_raster.drawTrace(TraceRaster::OverlayPlane, overlay, minVal, span, 1.0,
+                           request.overlayOffset / last, (request.overlayOffset + request.overlayCount - 1) / last);
+    }
+    m_raster.drawTrace(TraceRaster::MainPlane, values, minVal, span, 2.0);
+    if (!request.values->intact(request.first)
+            || (haveOverlay && !request.overlay->intact(request.overlayFirst))) {
+        return;
+    }
+
+    QImage &back = m_buffers[m_back];
+    m_raster.compose(back, qRgb(0x00, 0x7a, 0xff), qRgb(0xc7, 0xc7, 0xcc));
+    emit frameReady(back, minVal, maxVal, stats, request.serial);
+    m_back ^= 1;
+}
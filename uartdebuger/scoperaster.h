@@ -0,0 +1,95 @@
+#ifndef SCOPERASTER_H
+#define SCOPERASTER_H
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QImage>
+#include <QVector>
+
+#include "scopemeasure.h"
+#include "scopering.h"
+
+// 波形软件光栅化：两层覆盖度平面（主波形/叠加波形）按列存储，竖直填充在内存中连续
+// 样本比像素列多时每列画极值包络，少时画抗锯齿 Wu 线，最后合成为 ARGB32 预乘图像
+class TraceRaster
+{
+public:
+    enum Plane {
+        MainPlane = 0,
+        OverlayPlane = 1
+    };
+
+    void resize(int width, int height);
+    void clear();
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    // 把 values 铺在宽度的 [from, to] 比例区间内（默认铺满），纵轴 minVal 对应底边，minVal + span 对应顶边
+    void drawTrace(Plane plane, const SampleRing::Span &values, double minVal, double span, double lineWidth,
+                   double from = 0.0, double to = 1.0);
+    // 主波形盖在叠加波形之上，未覆盖处透明；target 尺寸不符时重新分配
+    void compose(QImage &target, QRgb mainColor, QRgb overlayColor) const;
+
+    // 单遍求最小/最大值（SSE2 每次处理 2 个 double）
+    static void valueRange(const double *values, int count, double *minVal, double *maxVal);
+    static void valueRange(const SampleRing::Span &values, double *minVal, double *maxVal);
+
+private:
+    quint8 *plane(Plane p);
+    void fillColumn(quint8 *plane, int x, int yTop, int yBottom);
+    void drawEnvelope(quint8 *plane, const SampleRing::Span &values, double minVal, double span, double lineWidth,
+                      double x0, double x1);
+    void drawWuLine(quint8 *plane, double x0, double y0, double x1, double y1, double lineWidth);
+    void plot(quint8 *plane, int x, int y, double coverage);
+
+    QVector<quint8> m_main;
+    QVector<quint8> m_overlay;
+    int m_width = 0;
+    int m_height = 0;
+};
+
+// 一次渲染请求：主波形与叠加波形以环形缓冲加绝对样本序号区间给出，工作线程直接读取，不复制历史
+struct TraceRenderRequest {
+    QSharedPointer<const SampleRing> values;
+    qint64 first = 0;
+    int count = 0;
+    QSharedPointer<const SampleRing> overlay;   // 可为空
+    qint64 overlayFirst = 0;
+    int overlayCount = 0;
+    int overlayOffset = 0;      // 叠加波形首样本在主波形区间中的位置
+    double sampleRate = 1000.0;
+    bool draw = true;           // false 时只测量（余辉模式不画波形）
+    int width = 0;
+    int height = 0;
+    int serial = 0;
+};
+
+Q_DECLARE_METATYPE(TraceRenderRequest)
+
+// 波形渲染工作对象：运行在独立线程中，渲染到后台缓冲后交给界面贴图
+class TraceRenderWorker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TraceRenderWorker(QObject *parent = nullptr);
+
+    // 界面线程调用：登记最新请求号，排队中的旧请求将被跳过
+    void setLatestSerial(int serial) { m_latestSerial.storeRelease(serial); }
+
+public slots:
+    // 读取期间区间被界面线程的追加覆盖时放弃本帧，追加之后界面会再发新的请求
+    void render(const TraceRenderRequest &request);
+
+signals:
+    // minVal/maxVal 为本帧使用的纵轴范围，界面据此绘制刻度；stats 为主波形区间的测量结果；
+    // 只测量时 image 为空
+    void frameReady(const QImage &image, double minVal, double maxVal, const ScopeMeasure::Result &stats, int serial);
+
+private:
+    TraceRaster m_raster;
+    // 双缓冲：界面持有前一帧时写另一块，避免 QImage 写时复制
+    QImage m_buffers[2];
+    int m_back = 0;
+    QAtomicInt m_latestSerial;
+};
+
+#endif // SCOPERASTER_H
@@ -0,0 +1,274 @@
+#include "scopereference.h"
+#include "scopefft.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+// 局部重同步时缓存的样本数，用于区分丢样/重复/单点错误
+const int kResyncLength = 8;
+// 局部重同步允许向前跳过/向后回退的最大样本数
+const int kMaxForwardSkip = 32;
+const int kMaxBackwardSkip = 4;
+// FFT 相关峰附近再用整数误差精确比较的范围
+const int kRefineRadius = 8;
+const int kMaxEvents = 1000;
+const int kMaxAcquireLength = 4096;
+}
+
+ReferenceChecker::ReferenceChecker()
+{
+}
+
+QVector<int> ReferenceChecker::matlabSineTable(int n)
+{
+    // 与 sine_wave.m 一致：round((sin(2*pi*t/n) + 1) * 2047.5)
+    QVector<int> table(n);
+    for (int i = 0; i < n; ++i) {
+        table[i] = static_cast<int>(std::round((std::sin(2.0 * 3.14159265358979323846 * i / n) + 1.0) * 2047.5));
+    }
+    return table;
+}
+
+bool ReferenceChecker::loadTable(const QString &text, QString *error)
+{
+    // 与示波器数据流相同的分隔符：空白、逗号、分号
+    const QByteArray bytes = text.toLatin1();
+    QVector<int> table;
+    qint64 value = 0;
+    int digits = 0;
+    bool negative = false;
+    for (int i = 0; i <= bytes.size(); ++i) {
+        const char c = i < bytes.size() ? bytes.at(i) : ' ';
+        if (c >= '0' && c <= '9') {
+            value = value * 10 + (c - '0');
+            if (++digits > 9) {
+                if (error) *error = QStringLiteral("数值过大（第 %1 个数据）").arg(table.size() + 1);
+                return false;
+            }
+        } else if (c == '-' && digits == 0 && !negative) {
+            negative = true;
+        } else if (c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == ',' || c == ';') {
+            if (digits > 0) {
+                table.append(static_cast<int>(negative ? -value : value));
+            } else if (negative) {
+                if (error) *error = QStringLiteral("孤立的负号（第 %1 个数据）").arg(table.size() + 1);
+                return false;
+            }
+            value = 0;
+            digits = 0;
+            negative = false;
+        } else {
+            if (error) *error = QStringLiteral("无法识别的字符 '%1'（第 %2 个数据）").arg(QChar(c)).arg(table.size() + 1);
+            return false;
+        }
+    }
+    if (table.size() < 2) {
+        if (error) *error = QStringLiteral("参考表至少需要 2 个数据");
+        return false;
+    }
+    setTable(table);
+    return true;
+}
+
+void ReferenceChecker::setTable(const QVector<int> &table)
+{
+    m_table = table;
+    reset();
+}
+
+void ReferenceChecker::reset()
+{
+    m_stats = Stats();
+    m_events.clear();
+    m_totalEvents = 0;
+    m_pending.clear();
+    m_position = 0;
+    m_everLocked = false;
+    m_state = m_table.isEmpty() ? Idle : Acquiring;
+}
+
+void ReferenceChecker::restartAlignment()
+{
+    m_pending.clear();
+    if (m_state == Locked) m_state = Acquiring;
+}
+
+int ReferenceChecker::wrap(int index) const
+{
+    const int n = m_table.size();
+    index %= n;
+    return index < 0 ? index + n : index;
+}
+
+bool ReferenceChecker::matches(int code, int lutIndex) const
+{
+    return std::abs(code - m_table[wrap(lutIndex)]) <= m_tolerance;
+}
+
+void ReferenceChecker::addEvent(EventKind kind, qint64 streamIndex, int lutIndex, int count)
+{
+    if (m_events.size() >= kMaxEvents) {
+        m_events.remove(0, kMaxEvents / 8);
+    }
+    Event e;
+    e.streamIndex = streamIndex;
+    e.lutIndex = lutIndex;
+    e.kind = kind;
+    e.count = count;
+    m_events.append(e);
+    ++m_totalEvents;
+}
+
+void ReferenceChecker::process(const int *codes, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        const int code = codes[i];
+        switch (m_state) {
+        case Idle:
+            break;
+        case Acquiring:
+            if (m_pending.isEmpty()) m_pendingStart = m_streamIndex;
+            m_pending.append(code);
+            if (m_pending.size() >= std::min(kMaxAcquireLength, std::max(64, m_table.size()))) acquire();
+            break;
+        case Locked:
+            if (m_pending.isEmpty()) {
+                // 常规路径：与期望值一致则前进一格
+                const int expected = m_table[m_position];
+                if (std::abs(code - expected) <= m_tolerance) {
+                    ++m_stats.compared;
+                    m_stats.maxError = std::max(m_stats.maxError, std::abs(code - expected));
+                    if (++m_position == m_table.size()) m_position = 0;
+                    break;
+                }
+                m_pendingStart = m_streamIndex;
+            }
+            m_pending.append(code);
+            if (m_pending.size() >= kResyncLength) resync();
+            break;
+        }
+        ++m_streamIndex;
+    }
+}
+
+void ReferenceChecker::acquire()
+{
+    const int n = m_table.size();
+    const int m = m_pending.size();
+    // 线性互相关 c[k] = sum x[i] * lut[(i + k) % n]，查找表周期延拓到 m + n - 1 点后用 FFT 计算
+    const int extended = m + n - 1;
+    const int fftSize = ScopeFft::nextPowerOfTwo(m + extended);
+    double meanX = 0;
+    for (int v : m_pending) meanX += v;
+    meanX /= m;
+    double meanT = 0;
+    for (int v : m_table) meanT += v;
+    meanT /= n;
+
+    QVector<float> xr(fftSize, 0.0f), xi(fftSize, 0.0f);
+    QVector<float> yr(fftSize, 0.0f), yi(fftSize, 0.0f);
+    for (int i = 0; i < m; ++i) xr[i] = static_cast<float>(m_pending[i] - meanX);
+    for (int j = 0; j < extended; ++j) yr[j] = static_cast<float>(m_table[j % n] - meanT);
+    ScopeFft fft(fftSize);
+    fft.forward(xr.data(), xi.data());
+    fft.forward(yr.data(), yi.data());
+    for (int k = 0; k < fftSize; ++k) {
+        // conj(X) * Y
+        const float re = xr[k] * yr[k] + xi[k] * yi[k];
+        const float im = xr[k] * yi[k] - xi[k] * yr[k];
+        xr[k] = re;
+        xi[k] = im;
+    }
+    fft.inverse(xr.data(), xi.data());
+    int peak = 0;
+    for (int k = 1; k < n; ++k) {
+        if (xr[k] > xr[peak]) peak = k;
+    }
+
+    // 正弦等平滑波形的相关峰很平，在峰附近用整数绝对误差精确选出相位
+    int bestLag = peak;
+    qint64 bestSad = -1;
+    for (int d = -kRefineRadius; d <= kRefineRadius; ++d) {
+        const int lag = wrap(peak + d);
+        qint64 sad = 0;
+        for (int i = 0; i < m; ++i) sad += std::abs(m_pending[i] - m_table[(i + lag) % n]);
+        if (bestSad < 0 || sad < bestSad) {
+            bestSad = sad;
+            bestLag = lag;
+        }
+    }
+    int mismatched = 0;
+    int maxError = 0;
+    for (int i = 0; i < m; ++i) {
+        const int err = std::abs(m_pending[i] - m_table[(i + bestLag) % n]);
+        if (err > m_tolerance) ++mismatched;
+        maxError = std::max(maxError, err);
+    }
+    if (mismatched > m / 8) {
+        // 对齐失败（数据不是该参考表），丢弃前一半继续收集
+        m_pending.remove(0, m / 2);
+        m_pendingStart += m / 2;
+        return;
+    }
+
+    if (!m_everLocked) {
+        m_stats.phaseOffset = wrap(bestLag - static_cast<int>(m_pendingStart % n));
+        m_everLocked = true;
+    }
+    m_stats.compared += m;
+    m_stats.mismatched += mismatched;
+    m_stats.maxError = std::max(m_stats.maxError, maxError);
+    m_position = wrap(bestLag + m);
+    m_pending.clear();
+    m_state = Locked;
+}
+
+void ReferenceChecker::resync()
+{
+    const int k = m_pending.size();
+    const int pos = m_position;
+    auto runMatches = [this, k](int start, int from) {
+        for (int i = from; i < k; ++i) {
+            if (!matches(m_pending[i], start + i)) return false;
+        }
+        return true;
+    };
+
+    // 仅首个样本错误、其后连续：单点错误
+    if (runMatches(pos, 1)) {
+        const int err = m_pending[0] - m_table[pos];
+        ++m_stats.corrupted;
+        ++m_stats.mismatched;
+        m_stats.maxError = std::max(m_stats.maxError, std::abs(err));
+        m_stats.compared += k;
+        addEvent(Corrupted, m_pendingStart, pos, err);
+        m_position = wrap(pos + k);
+        m_pending.clear();
+        return;
+    }
+    // 由近到远尝试跳过 (丢样) 或回退 (重复) 若干样本后整段连续
+    for (int skip = 1; skip <= kMaxForwardSkip; ++skip) {
+        if (runMatches(pos + skip, 0)) {
+            m_stats.dropped += skip;
+            m_stats.compared += k;
+            addEvent(Dropped, m_pendingStart, pos, skip);
+            m_position = wrap(pos + skip + k);
+            m_pending.clear();
+            return;
+        }
+        if (skip <= kMaxBackwardSkip && runMatches(pos - skip, 0)) {
+            m_stats.duplicated += skip;
+            m_stats.compared += k;
+            addEvent(Duplicated, m_pendingStart, pos, skip);
+            m_position = wrap(pos - skip + k);
+            m_pending.clear();
+            return;
+        }
+    }
+    // 局部无法恢复：以缓存样本为起点重新做相关对齐
+    ++m_stats.relocks;
+    addEvent(Relock, m_pendingStart, pos, 0);
+    m_state = Acquiring;
+}
@@ -0,0 +1,89 @@
+#ifndef SCOPEREFERENCE_H
+#define SCOPEREFERENCE_H
+
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+// 参考波形比对：用 FFT 互相关求出接收流在查找表中的相位，锁定后逐样本比较原始码值
+// 锁定状态下每个样本只做一次整数比较，可长期开启
+class ReferenceChecker
+{
+public:
+    enum State {
+        Idle,        // 未加载参考表
+        Acquiring,   // 收集样本用于相位对齐
+        Locked       // 逐样本比较中
+    };
+
+    enum EventKind {
+        Dropped,     // 流中跳过了若干样本
+        Duplicated,  // 流中重复/回退了若干样本
+        Corrupted,   // 单个样本值错误，前后连续
+        Relock       // 无法局部恢复，重新做相关对齐
+    };
+
+    struct Event {
+        qint64 streamIndex = 0;   // 出现不连续的接收样本序号
+        int lutIndex = 0;         // 此时期望的查找表下标
+        EventKind kind = Dropped;
+        int count = 0;            // 丢失/重复的样本数，或错误码值偏差
+    };
+
+    struct Stats {
+        qint64 compared = 0;
+        qint64 mismatched = 0;
+        qint64 dropped = 0;
+        qint64 duplicated = 0;
+        qint64 corrupted = 0;
+        qint64 relocks = 0;
+        int maxError = 0;         // 码值最大偏差
+        int phaseOffset = 0;      // 首次锁定时流起点对应的查找表下标
+    };
+
+    ReferenceChecker();
+
+    // 解析 MATLAB 打印的逗号/空白分隔整数表，失败返回 false
+    bool loadTable(const QString &text, QString *error);
+    void setTable(const QVector<int> &table);
+    const QVector<int> &table() const { return m_table; }
+    // sine_wave.m 生成的 1024 点 0~4095 正弦表
+    static QVector<int> matlabSineTable(int n = 1024);
+
+    // 允许的码值误差，0 表示必须完全一致
+    void setTolerance(int codes) { m_tolerance = qMax(0, codes); }
+    int tolerance() const { return m_tolerance; }
+    // 清空统计并重新对齐
+    void reset();
+    // 数据流中断（断线重连）后调用：保留统计与事件，丢弃待比较的样本并重新做相位对齐
+    void restartAlignment();
+    void process(const int *codes, int count);
+
+    State state() const { return m_state; }
+    const Stats &stats() const { return m_stats; }
+    const QVector<Event> &events() const { return m_events; }
+    // 累计产生的事件数（列表只保留最近的部分）
+    qint64 totalEvents() const { return m_totalEvents; }
+    qint64 streamIndex() const { return m_streamIndex; }
+
+private:
+    void acquire();
+    void resync();
+    void addEvent(EventKind kind, qint64 streamIndex, int lutIndex, int count);
+    bool matches(int code, int lutIndex) const;
+    int wrap(int index) const;
+
+    QVector<int> m_table;
+    int m_tolerance = 0;
+    State m_state = Idle;
+    Stats m_stats;
+    QVector<Event> m_events;
+    qint64 m_totalEvents = 0;
+    qint64 m_streamIndex = 0;
+    int m_position = 0;           // 下一个样本期望的查找表下标
+    QVector<int> m_pending;       // 对齐或局部重同步期间缓存的样本
+    qint64 m_pendingStart = 0;    // m_pending[0] 的接收序号
+    bool m_everLocked = false;
+};
+
+#endif // SCOPEREFERENCE_H
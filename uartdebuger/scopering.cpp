@@ -0,0 +1,126 @@
+#include "scopering.h"
+
+#include <algorithm>
+
+namespace {
+// 存储在深度之外多留的样本数：深度的 1/8，至少 65536 点
+int slackFor(int depth)
+{
+    return std::max(1 << 16, depth / 8);
+}
+}
+
+SampleRing::Span SampleRing::Span::mid(int from, int count) const
+{
+    Span s;
+    if (from < headCount) {
+        s.head = head + from;
+        s.headCount = std::min(count, headCount - from);
+        if (count > s.headCount) {
+            s.tail = tail;
+            s.tailCount = count - s.headCount;
+        }
+    } else {
+        s.head = tail + (from - headCount);
+        s.headCount = count;
+    }
+    return s;
+}
+
+SampleRing::SampleRing(int depth, qint64 firstIndex)
+    : m_depth(std::max(1, depth))
+    , m_start(firstIndex)
+    , m_end(firstIndex)
+    , m_reserved(firstIndex)
+{
+    m_data.resize(m_depth + slackFor(m_depth));
+}
+
+SampleRing::SampleRing()
+    : m_end(0)
+    , m_reserved(0)
+{
+}
+
+QSharedPointer<SampleRing> SampleRing::fromVector(const QVector<double> &values)
+{
+    QSharedPointer<SampleRing> ring(new SampleRing);
+    ring->m_data = values;
+    ring->m_depth = std::max(1, values.size());
+    ring->m_end.store(values.size());
+    ring->m_reserved.store(values.size());
+    return ring;
+}
+
+qint64 SampleRing::begin() const
+{
+    return std::max(m_start, end() - m_depth);
+}
+
+SampleRing::Span SampleRing::span(qint64 first, int count) const
+{
+    Span s;
+    if (count <= 0) return s;
+    const int capacity = m_data.size();
+    const int slot = static_cast<int>(first % capacity);
+    s.head = m_data.constData() + slot;
+    s.headCount = std::min(count, capacity - slot);
+    if (count > s.headCount) {
+        s.tail = m_data.constData();
+        s.tailCount = count - s.headCount;
+    }
+    return s;
+}
+
+QVector<double> SampleRing::toVector(qint64 first, int count) const
+{
+    QVector<double> out(std::max(0, count));
+    const Span s = span(first, count);
+    std::copy(s.head, s.head + s.headCount, out.begin());
+    std::copy(s.tail, s.tail + s.tailCount, out.begin() + s.headCount);
+    return out;
+}
+
+bool SampleRing::intact(qint64 first) const
+{
+    // 先完成之前的数据读取，再看写者预占到了哪里
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return m_reserved.load(std::memory_order_relaxed) - m_data.size() <= first;
+}
+
+void SampleRing::append(const double *values, int count)
+{
+    if (count <= 0) return;
+    const int capacity = m_data.size();
+    const qint64 end = m_end.load(std::memory_order_relaxed);
+    // 先发布预占位置再写数据，读者据此判断读取期间是否被覆盖
+    m_reserved.store(end + count, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    // 一次超过容量时只有最后 capacity 个样本留得下来
+    const int skip = std::max(0, count - capacity);
+    int slot = static_cast<int>((end + skip) % capacity);
+    double *data = m_data.data();
+    for (int i = skip; i < count;) {
+        const int n = std::min(count - i, capacity - slot);
+        std::copy(values + i, values + i + n, data + slot);
+        i += n;
+        slot = 0;
+    }
+    m_end.store(end + count, std::memory_order_release);
+}
+
+void SampleRing::clear()
+{
+    m_start = end();
+}
+
+QSharedPointer<SampleRing> SampleRing::withDepth(int depth) const
+{
+    const int keep = std::min(size(), std::max(1, depth));
+    const qint64 first = end() - keep;
+    QSharedPointer<SampleRing> ring(new SampleRing(depth, first));
+    const Span s = span(first, keep);
+    ring->append(s.head, s.headCount);
+    ring->append(s.tail, s.tailCount);
+    return ring;
+}
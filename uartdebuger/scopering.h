@@ -0,0 +1,67 @@
+#ifndef SCOPERING_H
+#define SCOPERING_H
+
+#include <QSharedPointer>
+#include <QVector>
+#include <atomic>
+
+// 示波器历史的预分配环形缓冲：样本按绝对序号寻址，界面线程在末尾追加，超出深度的最旧样本自然淘汰，
+// 追加只写新样本，不移动也不复制已有数据。后台线程（光栅化与测量）按序号区间直接读取，
+// 读完用 intact() 确认期间未被追加覆盖；存储比深度多留余量，正在绘制的最旧一屏不会马上被覆盖
+class SampleRing
+{
+public:
+    // 一段样本的只读视图：环形存储中至多分为前后两段连续内存
+    struct Span {
+        const double *head = nullptr;
+        int headCount = 0;
+        const double *tail = nullptr;
+        int tailCount = 0;
+
+        Span() {}
+        Span(const double *values, int count) : head(values), headCount(count) {}
+        int size() const { return headCount + tailCount; }
+        bool isEmpty() const { return size() == 0; }
+        double operator[](int i) const { return i < headCount ? head[i] : tail[i - headCount]; }
+        // [from, from + count) 的子视图
+        Span mid(int from, int count) const;
+    };
+
+    // depth 为保留的历史样本数，firstIndex 为第一个追加样本的绝对序号
+    explicit SampleRing(int depth, qint64 firstIndex = 0);
+    // 固定的一段数据（如平均帧）：隐式共享 values 不复制，此后不再追加
+    static QSharedPointer<SampleRing> fromVector(const QVector<double> &values);
+
+    int depth() const { return m_depth; }
+    // 最早保留样本与下一个追加样本的序号，历史为 [begin, end)
+    qint64 begin() const;
+    qint64 end() const { return m_end.load(std::memory_order_acquire); }
+    int size() const { return static_cast<int>(end() - begin()); }
+    bool isEmpty() const { return size() == 0; }
+    // index 须在 [begin, end) 内
+    double at(qint64 index) const { return m_data[static_cast<int>(index % m_data.size())]; }
+    // [first, first + count) 须在 [begin, end) 内
+    Span span(qint64 first, int count) const;
+    // 复制 [first, first + count)，供整段分析等一次性操作使用
+    QVector<double> toVector(qint64 first, int count) const;
+    // 读者在读完 first 起的数据后调用：读取期间写者没有绕回覆盖这些样本时返回 true
+    bool intact(qint64 first) const;
+
+    // 以下只由写者线程调用
+    void append(const double *values, int count);
+    // 丢弃全部历史，序号继续递增
+    void clear();
+    // 按新深度复制出一个缓冲，保留最新的样本
+    QSharedPointer<SampleRing> withDepth(int depth) const;
+
+private:
+    SampleRing();
+
+    QVector<double> m_data;
+    int m_depth = 0;
+    qint64 m_start = 0;                  // clear() 之后的起点
+    std::atomic<qint64> m_end;
+    std::atomic<qint64> m_reserved;      // 写者即将写到的位置，先于数据发布
+};
+
+#endif // SCOPERING_H
@@ -0,0 +1,14 @@
+#ifndef SCOPESIMD_H
+#define SCOPESIMD_H
+
+// SIMD 能力检测：x86 上使用 SSE/SSE2 内建函数，其他平台退回标量循环
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SCOPE_HAVE_SSE 1
+#define SCOPE_HAVE_SSE2 1
+#include <emmintrin.h>
+#elif defined(__SSE__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define SCOPE_HAVE_SSE 1
+#include <xmmintrin.h>
+#endif
+
+#endif // SCOPESIMD_H
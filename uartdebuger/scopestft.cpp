@@ -0,0 +1,110 @@
+#include "scopestft.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// 单次 push 最多计算的帧数，其余留在输入缓冲中由下次 push 接着计算
+const int kMaxRowsPerPush = 256;
+// 积压帧数上限，超过时跳过最旧的帧并计数，以免显示越来越滞后
+const int kMaxBacklogRows = 4 * kMaxRowsPerPush;
+const float kFloorDb = -200.0f;
+}
+
+StftEngine::StftEngine()
+{
+    configure(Config());
+}
+
+void StftEngine::configure(const Config &config)
+{
+    m_config = config;
+    m_config.fftSize = ScopeFft::nextPowerOfTwo(std::min(65536, std::max(16, m_config.fftSize)));
+    m_config.hop = std::min(m_config.fftSize, std::max(1, m_config.hop));
+    m_config.sampleRate = std::max(1e-3, m_config.sampleRate);
+    m_config.historyRows = std::max(1, m_config.historyRows);
+    m_fft.setSize(m_config.fftSize);
+    double coherentGain = 1.0;
+    m_window = ScopeFft::hannWindow(m_config.fftSize, &coherentGain);
+    m_power.resize(bins());
+    // 功率谱换算为单边幅度 (dBV)：amp = 2|X| / (N * 窗相干增益)
+    m_dbOffset = 20.0 * std::log10(2.0 / (m_config.fftSize * coherentGain));
+    m_history.fill(kFloorDb, m_config.historyRows * bins());
+    m_rowSamples.fill(0, m_config.historyRows);
+    reset();
+}
+
+void StftEngine::reset()
+{
+    m_input.clear();
+    m_next = 0;
+    m_inputStart = 0;
+    m_head = 0;
+    m_rows = 0;
+    m_totalRows = 0;
+    m_droppedRows = 0;
+}
+
+int StftEngine::physicalRow(int index) const
+{
+    const int cap = m_config.historyRows;
+    return (m_head - m_rows + index + cap) % cap;
+}
+
+const float *StftEngine::row(int index) const
+{
+    return m_history.constData() + physicalRow(index) * bins();
+}
+
+qint64 StftEngine::rowSampleIndex(int index) const
+{
+    return m_rowSamples[physicalRow(index)];
+}
+
+void StftEngine::computeRow(const float *frame)
+{
+    m_fft.powerSpectrum(frame, m_window.constData(), m_power.data());
+    float *out = m_history.data() + m_head * bins();
+    for (int k = 0; k < bins(); ++k) {
+        const float p = m_power[k];
+        out[k] = p > 0 ? std::max(kFloorDb, static_cast<float>(10.0 * std::log10(p) + m_dbOffset)) : kFloorDb;
+    }
+    m_rowSamples[m_head] = m_inputStart + m_next;
+    m_head = (m_head + 1) % m_config.historyRows;
+    m_rows = std::min(m_rows + 1, m_config.historyRows);
+    ++m_totalRows;
+}
+
+int StftEngine::push(const double *samples, int count)
+{
+    if (count <= 0) return 0;
+    const int oldSize = m_input.size();
+    m_input.resize(oldSize + count);
+    for (int i = 0; i < count; ++i) {
+        m_input[oldSize + i] = static_cast<float>(samples[i]);
+    }
+
+    const int n = m_config.fftSize;
+    const int hop = m_config.hop;
+    const int ready = m_input.size() - m_next >= n ? (m_input.size() - m_next - n) / hop + 1 : 0;
+    if (ready > kMaxBacklogRows) {
+        const int skip = ready - kMaxBacklogRows;
+        m_next += skip * hop;
+        m_droppedRows += skip;
+    }
+    int produced = 0;
+    while (produced < kMaxRowsPerPush && m_input.size() - m_next >= n) {
+        computeRow(m_input.constData() + m_next);
+        m_next += hop;
+        ++produced;
+    }
+
+    // 移除已不再被任何后续帧引用的样本
+    if (m_next > 0) {
+        const int drop = std::min(m_next, m_input.size());
+        m_input.remove(0, drop);
+        m_inputStart += drop;
+        m_next -= drop;
+    }
+    return produced;
+}
@@ -0,0 +1,62 @@
+#ifndef SCOPESTFT_H
+#define SCOPESTFT_H
+
+#include <QVector>
+#include <QtGlobal>
+
+#include "scopefft.h"
+
+// 滑动短时傅里叶变换：按跳步增量计算频谱行，并保存有限长度的历史供缩放/导出
+class StftEngine
+{
+public:
+    struct Config {
+        int fftSize = 1024;        // 频率分辨率 = 采样率 / fftSize
+        int hop = 256;             // 时间分辨率 = hop / 采样率
+        double sampleRate = 1000.0;
+        int historyRows = 4096;    // 历史保存的行数上限
+    };
+
+    StftEngine();
+
+    void configure(const Config &config);
+    const Config &config() const { return m_config; }
+    // 清空输入缓冲与历史
+    void reset();
+    // 送入新样本，返回新产生的频谱行数；单次计算不完的帧留到下次 push
+    int push(const double *samples, int count);
+
+    int bins() const { return m_config.fftSize / 2 + 1; }
+    double binWidth() const { return m_config.sampleRate / m_config.fftSize; }
+    double rowInterval() const { return m_config.hop / m_config.sampleRate; }
+    // 历史中的行数；下标 0 为最早的一行，rowCount()-1 为最新
+    int rowCount() const { return m_rows; }
+    // 指定行的幅度谱 (dBV)
+    const float *row(int index) const;
+    // 指定行对应帧的起始样本序号
+    qint64 rowSampleIndex(int index) const;
+    qint64 totalRows() const { return m_totalRows; }
+    // 积压超过上限而跳过的帧数
+    qint64 droppedRows() const { return m_droppedRows; }
+
+private:
+    void computeRow(const float *frame);
+    int physicalRow(int index) const;
+
+    Config m_config;
+    ScopeFft m_fft;
+    QVector<float> m_window;
+    QVector<float> m_power;
+    double m_dbOffset = 0;
+    QVector<float> m_input;       // 尚未完全消费的输入样本
+    int m_next = 0;               // 下一帧在 m_input 中的起点
+    qint64 m_inputStart = 0;      // m_input[0] 对应的全局样本序号
+    QVector<float> m_history;     // historyRows * bins 的环形存储
+    QVector<qint64> m_rowSamples;
+    int m_head = 0;               // 下一行写入位置
+    int m_rows = 0;
+    qint64 m_totalRows = 0;
+    qint64 m_droppedRows = 0;
+};
+
+#endif // SCOPESTFT_H
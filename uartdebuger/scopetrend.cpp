@@ -0,0 +1,288 @@
+#include "scopetrend.h"
+
+#include <QDir>
+#include <QStandardPaths>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+const char kMagic[4] = {'T', 'R', 'N', 'D'};
+const quint32 kVersion = 1;
+
+// 文件头：magic、版本、区间秒数、容量、head、count，各 4 字节
+struct RingHeader {
+    char magic[4];
+    quint32 version;
+    quint32 interval;
+    quint32 capacity;
+    quint32 head;
+    quint32 count;
+};
+const qint64 kHeaderSize = sizeof(RingHeader);
+const qint64 kRecordSize = sizeof(TrendRecorder::Record);
+
+const int kIntervals[TrendRecorder::LevelCount] = {1, 60, 3600};
+// 1 s 保留 2 天，1 min 保留 90 天，1 h 保留 5 年，合计约 7 MB
+const int kCapacities[TrendRecorder::LevelCount] = {2 * 86400, 90 * 1440, 5 * 8760};
+const char *const kFileNames[TrendRecorder::LevelCount] = {"trend_1s.bin", "trend_1min.bin", "trend_1h.bin"};
+}
+
+TrendRecorder::TrendRecorder()
+{
+}
+
+TrendRecorder::~TrendRecorder()
+{
+    close();
+}
+
+int TrendRecorder::intervalSeconds(Level level)
+{
+    return kIntervals[level];
+}
+
+int TrendRecorder::capacity(Level level)
+{
+    return kCapacities[level];
+}
+
+QString TrendRecorder::levelName(Level level)
+{
+    switch (level) {
+    case Seconds: return QStringLiteral("1 秒");
+    case Minutes: return QStringLiteral("1 分钟");
+    case Hours: return QStringLiteral("1 小时");
+    default: return QString();
+    }
+}
+
+QString TrendRecorder::defaultDirectory()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).filePath("trend");
+}
+
+bool TrendRecorder::open(const QString &directory)
+{
+    close();
+    if (!QDir().mkpath(directory)) {
+        m_error = QStringLiteral("无法创建目录 %1").arg(directory);
+        return false;
+    }
+    const QDir dir(directory);
+    for (int level = 0; level < LevelCount; ++level) {
+        if (!openRing(level, dir.filePath(kFileNames[level]))) {
+            for (int k = 0; k < level; ++k) m_rings[k].file.close();
+            return false;
+        }
+    }
+    m_open = true;
+    m_error.clear();
+    return true;
+}
+
+bool TrendRecorder::openRing(int level, const QString &fileName)
+{
+    Ring &ring = m_rings[level];
+    ring.file.setFileName(fileName);
+    if (!ring.file.open(QIODevice::ReadWrite)) {
+        m_error = QStringLiteral("无法打开 %1").arg(fileName);
+        return false;
+    }
+    const quint32 cap = static_cast<quint32>(kCapacities[level]);
+    const qint64 fileSize = kHeaderSize + kRecordSize * cap;
+    RingHeader h;
+    const bool valid = ring.file.size() == fileSize
+            && ring.file.read(reinterpret_cast<char *>(&h), kHeaderSize) == kHeaderSize
+            && std::memcmp(h.magic, kMagic, sizeof(kMagic)) == 0 && h.version == kVersion
+            && h.interval == static_cast<quint32>(kIntervals[level]) && h.capacity == cap
+            && h.head < cap && h.count <= cap;
+    if (valid) {
+        ring.head = h.head;
+        ring.count = h.count;
+        Record last;
+        ring.lastTime = ring.count > 0 && readAt(level, ring.count - 1, &last) ? static_cast<qint64>(last.time) : -1;
+        return true;
+    }
+    // 格式不符或新文件：预分配全部空间，之后只做定点覆盖写
+    ring.head = 0;
+    ring.count = 0;
+    ring.lastTime = -1;
+    if (!ring.file.resize(fileSize)) {
+        m_error = QStringLiteral("无法分配 %1").arg(fileName);
+        ring.file.close();
+        return false;
+    }
+    writeHeader(level);
+    return true;
+}
+
+void TrendRecorder::writeHeader(int level)
+{
+    Ring &ring = m_rings[level];
+    RingHeader h;
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kVersion;
+    h.interval = static_cast<quint32>(kIntervals[level]);
+    h.capacity = static_cast<quint32>(kCapacities[level]);
+    h.head = ring.head;
+    h.count = ring.count;
+    ring.file.seek(0);
+    ring.file.write(reinterpret_cast<const char *>(&h), kHeaderSize);
+}
+
+void TrendRecorder::close()
+{
+    if (!m_open) return;
+    // 程序退出时把进行中的区间按已有样本写出，下次启动继续追加
+    for (int level = 0; level < LevelCount; ++level) finish(level);
+    for (int level = 0; level < LevelCount; ++level) {
+        m_rings[level].file.flush();
+        m_rings[level].file.close();
+    }
+    m_open = false;
+}
+
+void TrendRecorder::clear()
+{
+    for (int level = 0; level < LevelCount; ++level) {
+        m_acc[level] = Accumulator();
+        m_rings[level].head = 0;
+        m_rings[level].count = 0;
+        m_rings[level].lastTime = -1;
+        if (m_open) writeHeader(level);
+    }
+}
+
+void TrendRecorder::add(const double *values, int count, qint64 wallClockMs)
+{
+    if (!m_open || !m_enabled || count <= 0) return;
+    double sum = 0;
+    double sumSquares = 0;
+    double lo = values[0];
+    double hi = values[0];
+    for (int i = 0; i < count; ++i) {
+        const double v = values[i];
+        sum += v;
+        sumSquares += v * v;
+        lo = std::min(lo, v);
+        hi = std::max(hi, v);
+    }
+    feed(Seconds, wallClockMs / 1000, sum, sumSquares, lo, hi, count);
+}
+
+void TrendRecorder::feed(int level, qint64 timeSec, double sum, double sumSquares, double min, double max, qint64 count)
+{
+    Accumulator &acc = m_acc[level];
+    const qint64 interval = timeSec / kIntervals[level];
+    if (acc.count > 0 && interval != acc.interval) finish(level);
+    if (acc.count == 0) {
+        acc.interval = interval;
+        acc.min = min;
+        acc.max = max;
+    } else {
+        acc.min = std::min(acc.min, min);
+        acc.max = std::max(acc.max, max);
+    }
+    acc.sum += sum;
+    acc.sumSquares += sumSquares;
+    acc.count += count;
+}
+
+void TrendRecorder::finish(int level)
+{
+    Accumulator acc = m_acc[level];
+    if (acc.count <= 0) return;
+    m_acc[level] = Accumulator();
+    Record r;
+    r.time = static_cast<quint32>(acc.interval * kIntervals[level]);
+    r.min = static_cast<float>(acc.min);
+    r.max = static_cast<float>(acc.max);
+    r.mean = static_cast<float>(acc.sum / acc.count);
+    r.rms = static_cast<float>(std::sqrt(std::max(0.0, acc.sumSquares / acc.count)));
+    append(level, r);
+    // 下一级直接累加本级的和/平方和，与从原始样本计算的结果一致
+    if (level + 1 < LevelCount) {
+        feed(level + 1, r.time, acc.sum, acc.sumSquares, acc.min, acc.max, acc.count);
+    }
+}
+
+void TrendRecorder::append(int level, const Record &record)
+{
+    Ring &ring = m_rings[level];
+    Record r = record;
+    // 墙钟回拨时沿用上一条的时间，保证文件内时间单调，可二分查找
+    if (ring.lastTime >= 0 && r.time < ring.lastTime) r.time = static_cast<quint32>(ring.lastTime);
+    const quint32 cap = static_cast<quint32>(kCapacities[level]);
+    ring.file.seek(kHeaderSize + kRecordSize * ring.head);
+    ring.file.write(reinterpret_cast<const char *>(&r), kRecordSize);
+    ring.head = (ring.head + 1) % cap;
+    ring.count = std::min(cap, ring.count + 1);
+    ring.lastTime = r.time;
+    writeHeader(level);
+}
+
+bool TrendRecorder::readAt(int level, quint32 logical, Record *record) const
+{
+    Ring &ring = m_rings[level];
+    if (logical >= ring.count) return false;
+    const quint32 cap = static_cast<quint32>(kCapacities[level]);
+    const quint32 slot = (ring.head + cap - ring.count + logical) % cap;
+    ring.file.seek(kHeaderSize + kRecordSize * slot);
+    return ring.file.read(reinterpret_cast<char *>(record), kRecordSize) == kRecordSize;
+}
+
+qint64 TrendRecorder::firstTime(Level level) const
+{
+    Record r;
+    return readAt(level, 0, &r) ? static_cast<qint64>(r.time) : -1;
+}
+
+qint64 TrendRecorder::lastTime(Level level) const
+{
+    return m_rings[level].lastTime;
+}
+
+int TrendRecorder::lowerBound(int level, qint64 timeSec) const
+{
+    // 记录按时间单调，二分只读 O(log n) 条
+    int lo = 0;
+    int hi = static_cast<int>(m_rings[level].count);
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        Record r;
+        if (!readAt(level, static_cast<quint32>(mid), &r)) break;
+        if (static_cast<qint64>(r.time) < timeSec) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+QVector<TrendRecorder::Record> TrendRecorder::read(Level level, qint64 fromSec, qint64 toSec) const
+{
+    QVector<Record> out;
+    if (!m_open || toSec <= fromSec) return out;
+    const int first = lowerBound(level, fromSec);
+    const int last = lowerBound(level, toSec);
+    if (last <= first) return out;
+    out.resize(last - first);
+    // 逻辑区间在环形文件中最多分成两段连续读取
+    Ring &ring = m_rings[level];
+    const quint32 cap = static_cast<quint32>(kCapacities[level]);
+    int done = 0;
+    while (done < out.size()) {
+        const quint32 slot = (ring.head + cap - ring.count + static_cast<quint32>(first + done)) % cap;
+        const int run = std::min(out.size() - done, static_cast<int>(cap - slot));
+        ring.file.seek(kHeaderSize + kRecordSize * slot);
+        const qint64 bytes = kRecordSize * run;
+        if (ring.file.read(reinterpret_cast<char *>(out.data() + done), bytes) != bytes) {
+            out.resize(done);
+            break;
+        }
+        done += run;
+    }
+    return out;
+}
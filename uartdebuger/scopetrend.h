@@ -0,0 +1,92 @@
+#ifndef SCOPETREND_H
+#define SCOPETREND_H
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+// 长期趋势记录：实时样本按墙钟逐级箱式抽取（一阶 CIC 的积分-清零形式）成 1 s、1 min、1 h 三级记录，
+// 每级记录区间内的最小/最大/均值/RMS，写入固定大小的磁盘环形文件，可跨程序重启连续记录
+class TrendRecorder
+{
+public:
+    enum Level {
+        Seconds,
+        Minutes,
+        Hours,
+        LevelCount
+    };
+
+    // 20 字节定长记录，本机字节序直接写盘
+    struct Record {
+        quint32 time;   // 区间起点，Unix 秒
+        float min;
+        float max;
+        float mean;
+        float rms;
+    };
+
+    TrendRecorder();
+    ~TrendRecorder();
+
+    // 打开（或新建）目录下的三个环形文件；文件头不匹配时重建
+    bool open(const QString &directory);
+    // 写出各级尚未结束的区间后关闭
+    void close();
+    bool isOpen() const { return m_open; }
+    QString errorString() const { return m_error; }
+    void setEnabled(bool enabled) { m_enabled = enabled; }
+    bool isEnabled() const { return m_enabled; }
+
+    // 一个接收块内的样本视为同一时刻到达
+    void add(const double *values, int count, qint64 wallClockMs);
+    // 清空全部记录与进行中的区间
+    void clear();
+
+    static int intervalSeconds(Level level);
+    static int capacity(Level level);
+    static QString levelName(Level level);
+    static QString defaultDirectory();
+
+    int size(Level level) const { return m_rings[level].count; }
+    // 读取 [fromSec, toSec) 内的记录（升序），只访问区间内的记录
+    QVector<Record> read(Level level, qint64 fromSec, qint64 toSec) const;
+    // 已保存的最早/最新区间起点；没有记录时返回 -1
+    qint64 firstTime(Level level) const;
+    qint64 lastTime(Level level) const;
+
+private:
+    struct Accumulator {
+        qint64 interval = -1;   // 区间序号 = 起点秒 / 区间长度
+        double sum = 0;
+        double sumSquares = 0;
+        double min = 0;
+        double max = 0;
+        qint64 count = 0;
+    };
+
+    struct Ring {
+        QFile file;
+        quint32 head = 0;       // 下一条写入的槽位
+        quint32 count = 0;
+        qint64 lastTime = -1;   // 最新一条的时间，追加时不必回读文件
+    };
+
+    bool openRing(int level, const QString &fileName);
+    void feed(int level, qint64 timeSec, double sum, double sumSquares, double min, double max, qint64 count);
+    void finish(int level);
+    void append(int level, const Record &record);
+    bool readAt(int level, quint32 logical, Record *record) const;
+    int lowerBound(int level, qint64 timeSec) const;
+    void writeHeader(int level);
+
+    bool m_open = false;
+    bool m_enabled = false;
+    QString m_error;
+    Accumulator m_acc[LevelCount];
+    // 读取时需要移动文件位置，故声明为 mutable
+    mutable Ring m_rings[LevelCount];
+};
+
+#endif // SCOPETREND_H
@@ -0,0 +1,109 @@
+#include "scopetrigger.h"
+
+#include <algorithm>
+#include <cmath>
+
+ScopeTrigger::ScopeTrigger()
+{
+}
+
+void ScopeTrigger::configure(const Config &config)
+{
+    m_config = config;
+    m_config.frameLength = std::max(2, m_config.frameLength);
+    m_config.preTrigger = std::min(m_config.frameLength - 1, std::max(0, m_config.preTrigger));
+    reset();
+}
+
+void ScopeTrigger::reset()
+{
+    m_buffer.clear();
+    m_searchPos = 1;
+    m_armed = false;
+    m_haveEnvelope = false;
+    m_level = m_config.level;
+}
+
+void ScopeTrigger::updateAutoLevel(const double *samples, int count)
+{
+    // 包络按本块样本数相对帧长的比例向块内极值收敛，电平取包络中点
+    double blockMin = samples[0];
+    double blockMax = samples[0];
+    for (int i = 1; i < count; ++i) {
+        blockMin = std::min(blockMin, samples[i]);
+        blockMax = std::max(blockMax, samples[i]);
+    }
+    if (!m_haveEnvelope) {
+        m_envMin = blockMin;
+        m_envMax = blockMax;
+        m_haveEnvelope = true;
+    } else {
+        const double a = std::min(1.0, static_cast<double>(count) / m_config.frameLength);
+        m_envMin = std::min(blockMin, m_envMin + a * (blockMin - m_envMin));
+        m_envMax = std::max(blockMax, m_envMax + a * (blockMax - m_envMax));
+    }
+    m_level = m_config.autoLevel ? (m_envMin + m_envMax) / 2.0 : m_config.level;
+}
+
+int ScopeTrigger::process(const double *samples, int count, QVector<float> &frames)
+{
+    if (count <= 0) return 0;
+    updateAutoLevel(samples, count);
+    const int oldSize = m_buffer.size();
+    m_buffer.resize(oldSize + count);
+    for (int i = 0; i < count; ++i) {
+        m_buffer[oldSize + i] = static_cast<float>(samples[i]);
+    }
+
+    const int length = m_config.frameLength;
+    const int pre = m_config.preTrigger;
+    const float level = static_cast<float>(m_level);
+    // 迟滞取包络幅度的 2%，避免噪声在电平附近反复触发
+    const float hyst = static_cast<float>(std::max(1e-9, 0.02 * (m_envMax - m_envMin)));
+    const float *buf = m_buffer.constData();
+    const int size = m_buffer.size();
+    int produced = 0;
+
+    int i = std::max(1, m_searchPos);
+    for (; i < size; ++i) {
+        const float prev = buf[i - 1];
+        const float v = buf[i];
+        bool fire = false;
+        if (m_config.rising) {
+            if (v < level - hyst) m_armed = true;
+            fire = m_armed && prev < level && v >= level;
+        } else {
+            if (v > level + hyst) m_armed = true;
+            fire = m_armed && prev > level && v <= level;
+        }
+        if (!fire) continue;
+
+        const int start = i - pre;
+        if (start < 0) {
+            // 触发前的样本不足，放弃这次触发
+            m_armed = false;
+            continue;
+        }
+        if (start + length > size) {
+            // 帧尾数据尚未到达，保持布防，等下一块数据再从这里重试
+            break;
+        }
+        const int offset = frames.size();
+        frames.resize(offset + length);
+        std::copy(buf + start, buf + start + length, frames.data() + offset);
+        ++produced;
+        ++m_triggerCount;
+        m_armed = false;
+        // 一帧采集完成后才重新搜索（与实际示波器的重新布防一致）
+        i = start + length - 1;
+    }
+    m_searchPos = i;
+
+    // 丢弃不再需要的旧样本，只保留下一次触发所需的预触发区
+    const int drop = std::max(0, std::min(m_searchPos - pre - 1, size - pre - 1));
+    if (drop > 0) {
+        m_buffer.remove(0, drop);
+        m_searchPos -= drop;
+    }
+    return produced;
+}
@@ -0,0 +1,45 @@
+#ifndef SCOPETRIGGER_H
+#define SCOPETRIGGER_H
+
+#include <QVector>
+#include <QtGlobal>
+
+// 边沿触发：从连续样本流中切出以触发点对齐的定长帧，供余辉/平均/模板测试使用
+class ScopeTrigger
+{
+public:
+    struct Config {
+        bool autoLevel = true;   // 自动电平取近期波形的中点
+        double level = 1.65;     // 手动触发电平 (V)
+        bool rising = true;      // 上升沿 / 下降沿
+        int frameLength = 500;   // 每帧样本数
+        int preTrigger = 50;     // 触发点之前保留的样本数
+    };
+
+    ScopeTrigger();
+
+    void configure(const Config &config);
+    const Config &config() const { return m_config; }
+    // 清空历史并重新布防
+    void reset();
+    // 送入新样本，完成的帧依次追加到 frames（每帧 frameLength 个样本），返回新帧数量
+    int process(const double *samples, int count, QVector<float> &frames);
+    // 当前生效的触发电平
+    double currentLevel() const { return m_level; }
+    qint64 triggerCount() const { return m_triggerCount; }
+
+private:
+    void updateAutoLevel(const double *samples, int count);
+
+    Config m_config;
+    QVector<float> m_buffer; // 尚未消费的近期样本
+    int m_searchPos = 1;     // 下次搜索边沿的起始下标
+    bool m_armed = false;    // 迟滞布防状态
+    bool m_haveEnvelope = false;
+    double m_envMin = 0;
+    double m_envMax = 0;
+    double m_level = 0;
+    qint64 m_triggerCount = 0;
+};
+
+#endif // SCOPETRIGGER_H
@@ -0,0 +1,189 @@
+#include "sendscheduler.h"
+
+#include "nativeport.h"
+
+#include <QMutexLocker>
+#include <algorithm>
+#include <cmath>
+
+#ifdef Q_OS_WIN
+#include <qt_windows.h>
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#else
+#include <errno.h>
+#include <time.h>
+#endif
+
+namespace {
+// 单次休眠上限，保证长周期下也能及时响应停止请求
+const qint64 kMaxSleepNs = 50 * 1000 * 1000;
+
+#ifdef Q_OS_WIN
+// Windows 没有单调时钟上的绝对定时，每次按“截止时刻 - 当前时刻”重新设定相对到期时间，
+// 误差不会跨节拍累积；Windows 10 1803 之前不支持高精度标志，退回普通定时器（约 1~16 ms 粒度）
+class DeadlineSleeper
+{
+public:
+    DeadlineSleeper()
+    {
+        m_timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        if (!m_timer) m_timer = CreateWaitableTimerW(nullptr, TRUE, nullptr);
+    }
+    ~DeadlineSleeper()
+    {
+        if (m_timer) CloseHandle(m_timer);
+    }
+    void sleepUntil(qint64 deadline)
+    {
+        const qint64 remaining = deadline - NativePort::nowNanos();
+        if (remaining <= 0 || !m_timer) return;
+        LARGE_INTEGER due;
+        due.QuadPart = -std::max<qint64>(1, remaining / 100);
+        if (SetWaitableTimer(m_timer, &due, 0, nullptr, nullptr, FALSE)) {
+            WaitForSingleObject(m_timer, INFINITE);
+        }
+    }
+
+private:
+    HANDLE m_timer = nullptr;
+};
+#else
+class DeadlineSleeper
+{
+public:
+    void sleepUntil(qint64 deadline)
+    {
+        timespec ts;
+        ts.tv_sec = static_cast<time_t>(deadline / 1000000000LL);
+        ts.tv_nsec = static_cast<long>(deadline % 1000000000LL);
+        // NativePort::nowNanos() 同为 CLOCK_MONOTONIC；被信号打断后用同一截止时刻重试即可
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+        }
+    }
+};
+#endif
+}
+
+SendScheduler::SendScheduler()
+{
+}
+
+SendScheduler::~SendScheduler()
+{
+    stop();
+}
+
+double SendScheduler::periodMicros(const Config &config, int payloadSize)
+{
+    if (config.rate <= 0 || payloadSize <= 0) return 0;
+    const double perTick = config.unit == BytesPerSecond ? static_cast<double>(config.burst) * payloadSize
+                                                         : static_cast<double>(config.burst);
+    return perTick / config.rate * 1e6;
+}
+
+bool SendScheduler::start(QSerialPort::Handle handle, const QByteArray &payload, const Config &config, QString *error)
+{
+    stop();
+    if (payload.isEmpty()) {
+        *error = QStringLiteral("发送内容为空");
+        return false;
+    }
+    if (config.rate <= 0 || config.burst < 1) {
+        *error = QStringLiteral("速率与突发数须大于 0");
+        return false;
+    }
+    m_handle = handle;
+    m_payload = payload;
+    m_config = config;
+    m_config.spinMicros = std::max(0, config.spinMicros);
+    m_stop = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stats = Stats();
+        m_stats.running = true;
+        m_stats.periodMicros = periodMicros(m_config, payload.size());
+    }
+    QThread::start(QThread::TimeCriticalPriority);
+    return true;
+}
+
+void SendScheduler::stop()
+{
+    m_stop = true;
+    wait();
+    QMutexLocker locker(&m_mutex);
+    m_stats.running = false;
+}
+
+SendScheduler::Stats SendScheduler::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stats;
+}
+
+void SendScheduler::run()
+{
+    DeadlineSleeper sleeper;
+    NativePort writer(m_handle);
+    const qint64 period = std::max<qint64>(1, std::llround(periodMicros(m_config, m_payload.size()) * 1000.0));
+    const qint64 spin = static_cast<qint64>(m_config.spinMicros) * 1000;
+    const qint64 start = NativePort::nowNanos();
+    qint64 deadline = start;
+    qint64 sent = 0;
+
+    while (!m_stop) {
+        // 先粗略休眠到截止时刻前 spin 处，再忙等到截止时刻
+        qint64 now = NativePort::nowNanos();
+        while (!m_stop && deadline - spin - now > 0) {
+            sleeper.sleepUntil(std::min(deadline - spin, now + kMaxSleepNs));
+            now = NativePort::nowNanos();
+        }
+        if (m_stop) break;
+        while (now < deadline) now = NativePort::nowNanos();
+
+        const qint64 target = deadline;
+        const qint64 woke = now;
+        int n = m_config.burst;
+        if (m_config.count > 0) n = static_cast<int>(std::min<qint64>(n, m_config.count - sent));
+        bool ok = true;
+        int done = 0;
+        for (; done < n && ok; ++done) {
+            if (m_config.compose) m_config.compose(sent + done, &m_payload);
+            ok = writer.writeAll(m_payload.constData(), m_payload.size());
+        }
+        if (!ok) --done;
+        sent += done;
+        const qint64 finished = NativePort::nowNanos();
+
+        // 截止时刻按周期累加；一个节拍做完已错过下一截止时刻则记一次超限，
+        // 并跳过已错过的节拍重新对齐，避免之后连续补发造成突发
+        deadline += period;
+        qint64 missed = 0;
+        if (finished > deadline) {
+            missed = (finished - deadline) / period + 1;
+            deadline += missed * period;
+        }
+
+        QMutexLocker locker(&m_mutex);
+        m_stats.messages = sent;
+        m_stats.bytes = sent * m_payload.size();
+        ++m_stats.ticks;
+        if (missed > 0) {
+            ++m_stats.overruns;
+            m_stats.skippedTicks += missed;
+        }
+        m_stats.elapsedSeconds = (finished - start) / 1e9;
+        m_stats.lateness.add((woke - target) / 1000.0);
+        m_stats.writeMicros.add((finished - woke) / 1000.0);
+        if (!ok) {
+            m_stats.error = writer.errorString();
+            break;
+        }
+        if (m_config.count > 0 && sent >= m_config.count) break;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_stats.running = false;
+}
@@ -0,0 +1,73 @@
+#ifndef SENDSCHEDULER_H
+#define SENDSCHEDULER_H
+
+#include "streamstats.h"
+
+#include <QByteArray>
+#include <QMutex>
+#include <QSerialPort>
+#include <QString>
+#include <QThread>
+#include <atomic>
+#include <functional>
+
+// 精确定时发送：独立高优先级线程按绝对截止时刻节拍，直接写串口的系统句柄，不经过 GUI 事件循环。
+// 休眠到截止时刻前 spinMicros 处（Unix 用 clock_nanosleep(TIMER_ABSTIME)，Windows 用高精度可等待定时器），
+// 剩余部分忙等；截止时刻按周期累加，不随单次唤醒误差漂移
+class SendScheduler : public QThread
+{
+public:
+    enum RateUnit {
+        MessagesPerSecond,
+        BytesPerSecond
+    };
+
+    struct Config {
+        double rate = 100.0;             // 目标速率，单位见 unit
+        RateUnit unit = MessagesPerSecond;
+        int burst = 1;                   // 每个节拍连续写出的报文数
+        qint64 count = 0;                // 报文总数，0 表示不限
+        int spinMicros = 200;            // 截止时刻前改为忙等的时长，0 表示纯休眠
+        // 可选：每条报文写出前在调度线程中改写内容（如填入序号与发送时刻），长度须保持不变
+        std::function<void(qint64 index, QByteArray *payload)> compose;
+    };
+
+    struct Stats {
+        bool running = false;
+        QString error;                   // 非空表示因写失败而停止
+        qint64 messages = 0;
+        qint64 bytes = 0;
+        qint64 ticks = 0;
+        qint64 overruns = 0;             // 一个节拍结束时已错过下一截止时刻的次数
+        qint64 skippedTicks = 0;         // 超限后重新对齐而放弃的节拍
+        double periodMicros = 0;
+        double elapsedSeconds = 0;
+        StreamStats lateness;            // 唤醒时刻相对截止时刻的滞后 (µs)
+        StreamStats writeMicros;         // 单个节拍的写入耗时 (µs)
+    };
+
+    SendScheduler();
+    ~SendScheduler();
+
+    // handle 为已打开串口的系统句柄（QSerialPort::handle()），运行期间调用方须保持串口打开
+    bool start(QSerialPort::Handle handle, const QByteArray &payload, const Config &config, QString *error);
+    // 请求停止并等待线程退出
+    void stop();
+    Stats stats() const;
+
+    // 节拍周期：消息速率按 burst/rate，字节速率按 burst*payload/rate
+    static double periodMicros(const Config &config, int payloadSize);
+
+protected:
+    void run() override;
+
+private:
+    QSerialPort::Handle m_handle = 0;
+    QByteArray m_payload;
+    Config m_config;
+    std::atomic<bool> m_stop{false};
+    mutable QMutex m_mutex;
+    Stats m_stats;
+};
+
+#endif // SENDSCHEDULER_H
@@ -0,0 +1,459 @@
+#include "sequenceengine.h"
+
+#include "nativeport.h"
+#include "payloadcache.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <algorithm>
+
+namespace {
+// 等待接收数据的单次超时，兼顾停止响应与 CPU 占用
+const int kPollMs = 50;
+// 正则匹配累积文本的上限，超过后丢弃前半部分
+const int kMaxRegexWindow = 64 * 1024;
+const int kLabelChars = 24;
+
+QVector<int> buildFailure(const QByteArray &pattern)
+{
+    QVector<int> failure(pattern.size(), 0);
+    for (int i = 1, k = 0; i < pattern.size(); ++i) {
+        while (k > 0 && pattern[i] != pattern[k]) k = failure[k - 1];
+        if (pattern[i] == pattern[k]) ++k;
+        failure[i] = k;
+    }
+    return failure;
+}
+
+// 从 *state 续扫 data：返回匹配末字节之后的下标，未匹配返回 -1；未完成的前缀长度留在 *state 中跨块延续
+int scanLiteral(const QByteArray &pattern, const QVector<int> &failure, int *state, const char *data, int size)
+{
+    const char *p = pattern.constData();
+    const int m = pattern.size();
+    int k = *state;
+    for (int i = 0; i < size; ++i) {
+        while (k > 0 && data[i] != p[k]) k = failure[k - 1];
+        if (data[i] == p[k]) ++k;
+        if (k == m) {
+            *state = 0;
+            return i + 1;
+        }
+    }
+    *state = k;
+    return -1;
+}
+
+QString shortText(const QString &text)
+{
+    QString s = text;
+    s.replace("\r", "\\r");
+    s.replace("\n", "\\n");
+    return s.size() > kLabelChars ? s.left(kLabelChars) + QStringLiteral("…") : s;
+}
+
+bool parseSteps(const QJsonArray &array, int depth, const QByteArray &codecName,
+                QVector<SequenceEngine::Step> *steps, QString *error)
+{
+    typedef SequenceEngine::Step Step;
+    for (const QJsonValue &value : array) {
+        const int index = steps->size() + 1;
+        if (!value.isObject()) {
+            *error = QStringLiteral("第 %1 步不是对象").arg(index);
+            return false;
+        }
+        const QJsonObject obj = value.toObject();
+        Step step;
+        step.depth = depth;
+        step.timeoutMs = obj.value("timeout").toInt(1000);
+        if (obj.contains("send")) {
+            const QString text = obj.value("send").toString();
+            step.type = Step::Send;
+            step.payload = PayloadCache::encodeText(text, codecName);
+            step.label = QStringLiteral("发送 %1").arg(shortText(text));
+        } else if (obj.contains("sendHex")) {
+            const QString text = obj.value("sendHex").toString();
+            QString hexError;
+            if (!PayloadCache::decodeHex(text, &step.payload, &hexError)) {
+                *error = QStringLiteral("第 %1 步：%2").arg(index).arg(hexError);
+                return false;
+            }
+            step.type = Step::Send;
+            step.label = QStringLiteral("发送 HEX %1").arg(shortText(text));
+        } else if (obj.contains("expect")) {
+            const QString pattern = obj.value("expect").toString();
+            if (pattern.isEmpty() || step.timeoutMs <= 0) {
+                *error = QStringLiteral("第 %1 步：等待内容为空或超时无效").arg(index);
+                return false;
+            }
+            step.type = Step::Expect;
+            step.isRegex = obj.value("regex").toBool(false);
+            if (step.isRegex) {
+                step.regex = QRegularExpression(pattern);
+                if (!step.regex.isValid()) {
+                    *error = QStringLiteral("第 %1 步：正则无效（%2）").arg(index).arg(step.regex.errorString());
+                    return false;
+                }
+                step.regex.optimize();
+            } else {
+                // 接收数据按原始字节比较；期望内容按当前编码转成字节
+                step.literal = PayloadCache::encodeText(pattern, codecName);
+                step.failure = buildFailure(step.literal);
+            }
+            step.failLiteral = PayloadCache::encodeText(obj.value("fail").toString(), codecName);
+            step.failFailure = buildFailure(step.failLiteral);
+            step.saveAs = obj.value("save").toString();
+            step.label = QStringLiteral("等待 %1").arg(shortText(pattern));
+        } else if (obj.contains("expectFrame")) {
+            const QString text = obj.value("expectFrame").toString();
+            QString hexError;
+            if (!PayloadCache::decodeHex(text, &step.framePrefix, &hexError)) {
+                *error = QStringLiteral("第 %1 步：%2").arg(index).arg(hexError);
+                return false;
+            }
+            if (step.timeoutMs <= 0) {
+                *error = QStringLiteral("第 %1 步：超时无效").arg(index);
+                return false;
+            }
+            step.type = Step::ExpectFrame;
+            step.saveAs = obj.value("save").toString();
+            step.label = text.trimmed().isEmpty() ? QStringLiteral("等待帧")
+                                                  : QStringLiteral("等待帧 %1").arg(shortText(text));
+        } else if (obj.contains("delay")) {
+            step.type = Step::Delay;
+            step.delayMs = std::max(0, obj.value("delay").toInt());
+            step.label = QStringLiteral("延时 %1 ms").arg(step.delayMs);
+        } else if (obj.contains("repeat")) {
+            const QJsonArray body = obj.value("steps").toArray();
+            if (body.isEmpty()) {
+                *error = QStringLiteral("第 %1 步：循环体为空").arg(index);
+                return false;
+            }
+            step.type = Step::Repeat;
+            step.repeat = std::max(0, obj.value("repeat").toInt());
+            step.label = step.repeat > 0 ? QStringLiteral("循环 ×%1").arg(step.repeat) : QStringLiteral("循环（不限次数）");
+        } else {
+            *error = QStringLiteral("第 %1 步：无法识别的步骤").arg(index);
+            return false;
+        }
+        if (obj.contains("name")) step.label = obj.value("name").toString();
+        step.hasVariables = step.payload.contains("${");
+        steps->append(step);
+
+        if (step.type == Step::Repeat) {
+            const int head = steps->size() - 1;
+            if (!parseSteps(obj.value("steps").toArray(), depth + 1, codecName, steps, error)) return false;
+            Step end;
+            end.type = Step::EndRepeat;
+            end.depth = depth;
+            end.jump = head;
+            end.label = QStringLiteral("循环结束");
+            steps->append(end);
+            (*steps)[head].jump = steps->size() - 1;
+        }
+    }
+    return true;
+}
+}
+
+SequenceEngine::SequenceEngine()
+{
+}
+
+SequenceEngine::~SequenceEngine()
+{
+    stop();
+}
+
+bool SequenceEngine::parse(const QByteArray &json, const QByteArray &codecName, QVector<Step> *steps, QString *error)
+{
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(json, &parseError);
+    if (doc.isNull()) {
+        *error = QStringLiteral("JSON 格式错误（位置 %1）：%2").arg(parseError.offset).arg(parseError.errorString());
+        return false;
+    }
+    const QJsonArray array = doc.isArray() ? doc.array() : doc.object().value("steps").toArray();
+    steps->clear();
+    if (!parseSteps(array, 0, codecName, steps, error)) return false;
+    if (steps->isEmpty()) {
+        *error = QStringLiteral("没有步骤");
+        return false;
+    }
+    return true;
+}
+
+bool SequenceEngine::start(QSerialPort::Handle handle, const QVector<Step> &steps, QString *error)
+{
+    stop();
+    if (steps.isEmpty()) {
+        *error = QStringLiteral("没有步骤");
+        return false;
+    }
+    m_handle = handle;
+    m_steps = steps;
+    m_variables.clear();
+    m_received = 0;
+    m_framesReceived = 0;
+    m_stop = false;
+    m_ring.clear();
+    m_frameRing.clear();
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stats = Stats();
+        m_stats.running = true;
+        m_stats.steps.resize(steps.size());
+    }
+    m_accepting = true;
+    m_acceptingFrames = std::any_of(steps.constBegin(), steps.constEnd(),
+                                    [](const Step &step) { return step.type == Step::ExpectFrame; });
+    QThread::start(QThread::HighPriority);
+    return true;
+}
+
+void SequenceEngine::stop()
+{
+    m_stop = true;
+    m_ring.wake();
+    m_frameRing.wake();
+    wait();
+    m_accepting = false;
+    m_acceptingFrames = false;
+    QMutexLocker locker(&m_mutex);
+    m_stats.running = false;
+}
+
+SequenceEngine::Stats SequenceEngine::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stats;
+}
+
+void SequenceEngine::feed(const QByteArray &data, qint64 timestampNs)
+{
+    if (m_accepting.load()) m_ring.push(data, timestampNs);
+}
+
+void SequenceEngine::feedFrame(const char *data, int size, qint64 timestampNs)
+{
+    if (m_acceptingFrames.load()) m_frameRing.push(data, size, timestampNs);
+}
+
+QByteArray SequenceEngine::substitute(const QByteArray &payload) const
+{
+    QByteArray out = payload;
+    for (auto it = m_variables.constBegin(); it != m_variables.constEnd(); ++it) {
+        out.replace("${" + it.key().toUtf8() + "}", it.value());
+    }
+    return out;
+}
+
+bool SequenceEngine::sleepFor(int ms)
+{
+    const qint64 deadline = NativePort::nowNanos() + ms * 1000000LL;
+    while (!m_stop) {
+        const qint64 left = deadline - NativePort::nowNanos();
+        if (left <= 0) return true;
+        QThread::usleep(static_cast<unsigned long>(std::min<qint64>(kPollMs * 1000LL, (left + 999) / 1000)));
+    }
+    return false;
+}
+
+void SequenceEngine::saveCapture(const Step &step, const QRegularExpressionMatch &match)
+{
+    if (step.saveAs.isEmpty()) return;
+    const QString value = match.lastCapturedIndex() >= 1 ? match.captured(1) : match.captured(0);
+    m_variables.insert(step.saveAs, value.toLatin1());
+}
+
+bool SequenceEngine::expect(const Step &step, Pending *pending, qint64 *matchNs, QString *detail)
+{
+    const qint64 deadline = NativePort::nowNanos() + step.timeoutMs * 1000000LL;
+    int state = 0;
+    int failState = 0;
+    QString window;
+    qint64 windowEndNs = 0;   // 窗口末字节所在块的读取时刻
+    // 上一步匹配之后剩下的数据先参与匹配
+    IngestRing::Chunk chunk;
+    chunk.data = pending->data;
+    chunk.timestampNs = pending->timestampNs;
+    pending->data.clear();
+    bool have = !chunk.data.isEmpty();
+
+    while (true) {
+        if (have) {
+            const char *data = chunk.data.constData();
+            const int size = chunk.data.size();
+            const int failEnd = step.failLiteral.isEmpty()
+                    ? -1 : scanLiteral(step.failLiteral, step.failFailure, &failState, data, size);
+            int end = -1;
+            qint64 endNs = chunk.timestampNs;
+            if (step.isRegex) {
+                // Latin-1 逐字节映射，匹配位置即字节偏移；窗口尾部恰为本块
+                window += QString::fromLatin1(chunk.data);
+                const qint64 previousEndNs = windowEndNs;
+                windowEndNs = chunk.timestampNs;
+                // 匹配一直延伸到窗口末尾时可能被后续数据延长（如 VER=(\d+) 的数字被拆在两块），
+                // 按部分匹配处理，等下一块再判定；超时时再按完整匹配接受
+                const QRegularExpressionMatch match = step.regex.match(window, 0, QRegularExpression::PartialPreferFirstMatch);
+                if (match.hasMatch()) {
+                    end = std::max(0, match.capturedEnd(0) - (window.size() - size));
+                    // 上一块末尾的部分匹配在本块确认结束，匹配末字节仍属上一块
+                    if (match.capturedEnd(0) <= window.size() - size) endNs = previousEndNs;
+                    saveCapture(step, match);
+                } else if (!match.hasPartialMatch() && window.size() > kMaxRegexWindow) {
+                    window.remove(0, window.size() - kMaxRegexWindow / 2);
+                }
+            } else {
+                end = scanLiteral(step.literal, step.failure, &state, data, size);
+            }
+            if (failEnd >= 0 && (end < 0 || failEnd <= end)) {
+                *detail = QStringLiteral("收到失败标记 %1").arg(shortText(QString::fromLatin1(step.failLiteral)));
+                return false;
+            }
+            if (end >= 0) {
+                *matchNs = endNs;
+                pending->data = chunk.data.mid(end);
+                pending->timestampNs = chunk.timestampNs;
+                return true;
+            }
+        }
+        if (m_stop) {
+            *detail = QStringLiteral("已停止");
+            return false;
+        }
+        const qint64 left = deadline - NativePort::nowNanos();
+        if (left <= 0) {
+            // 超时前已完整但仍可能延长的匹配，此时不会再有后续数据，按已收到的内容接受
+            const QRegularExpressionMatch match = step.isRegex ? step.regex.match(window) : QRegularExpressionMatch();
+            if (match.hasMatch()) {
+                saveCapture(step, match);
+                *matchNs = windowEndNs;
+                pending->data = window.mid(match.capturedEnd(0)).toLatin1();
+                pending->timestampNs = windowEndNs;
+                return true;
+            }
+            *detail = QStringLiteral("%1 ms 内未收到期望内容").arg(step.timeoutMs);
+            return false;
+        }
+        have = m_ring.pop(&chunk, static_cast<int>(std::min<qint64>(kPollMs, left / 1000000 + 1)));
+        if (have) m_received += chunk.data.size();
+    }
+}
+
+bool SequenceEngine::expectFrame(const Step &step, qint64 *matchNs, QString *detail)
+{
+    const qint64 deadline = NativePort::nowNanos() + step.timeoutMs * 1000000LL;
+    IngestRing::Chunk frame;
+    while (true) {
+        if (m_stop) {
+            *detail = QStringLiteral("已停止");
+            return false;
+        }
+        const qint64 left = deadline - NativePort::nowNanos();
+        if (left <= 0) {
+            *detail = QStringLiteral("%1 ms 内未收到匹配的帧（需启用分帧解码）").arg(step.timeoutMs);
+            return false;
+        }
+        if (!m_frameRing.pop(&frame, static_cast<int>(std::min<qint64>(kPollMs, left / 1000000 + 1)))) continue;
+        ++m_framesReceived;
+        if (!frame.data.startsWith(step.framePrefix)) continue;
+        if (!step.saveAs.isEmpty()) m_variables.insert(step.saveAs, frame.data.toHex(' ').toUpper());
+        *matchNs = frame.timestampNs;
+        return true;
+    }
+}
+
+void SequenceEngine::run()
+{
+    NativePort port(m_handle);
+    const qint64 start = NativePort::nowNanos();
+    qint64 lastSendNs = start;
+    qint64 sent = 0;
+    Pending pending;
+    QVector<int> remaining(m_steps.size(), 0);
+    int pc = 0;
+
+    while (pc < m_steps.size() && !m_stop) {
+        const Step &step = m_steps[pc];
+        {
+            QMutexLocker locker(&m_mutex);
+            m_stats.currentStep = pc;
+        }
+        bool ok = true;
+        bool measured = false;
+        double latencyMicros = 0;
+        QString detail;
+        int next = pc + 1;
+
+        switch (step.type) {
+        case Step::Send: {
+            const QByteArray bytes = step.hasVariables ? substitute(step.payload) : step.payload;
+            const qint64 t0 = NativePort::nowNanos();
+            ok = port.writeAll(bytes);
+            lastSendNs = NativePort::nowNanos();
+            if (ok) {
+                sent += bytes.size();
+                measured = true;
+                latencyMicros = (lastSendNs - t0) / 1000.0;
+            } else {
+                detail = port.errorString();
+            }
+            break;
+        }
+        case Step::Expect:
+        case Step::ExpectFrame: {
+            qint64 matchNs = 0;
+            ok = step.type == Step::Expect ? expect(step, &pending, &matchNs, &detail)
+                                           : expectFrame(step, &matchNs, &detail);
+            if (ok) {
+                // 匹配的可能是发送前已到达的数据，此时延迟记为 0
+                measured = true;
+                latencyMicros = std::max<qint64>(0, matchNs - lastSendNs) / 1000.0;
+            }
+            break;
+        }
+        case Step::Delay:
+            ok = sleepFor(step.delayMs);
+            break;
+        case Step::Repeat:
+            remaining[pc] = step.repeat;
+            break;
+        case Step::EndRepeat:
+            if (m_steps[step.jump].repeat == 0 || --remaining[step.jump] > 0) next = step.jump + 1;
+            break;
+        }
+        // 被停止打断的步骤不计为失败
+        if (m_stop && !ok) break;
+
+        QMutexLocker locker(&m_mutex);
+        StepStats &s = m_stats.steps[pc];
+        ++s.runs;
+        if (measured) s.latency.add(latencyMicros);
+        if (!ok) {
+            ++s.failures;
+            s.lastDetail = detail;
+            m_stats.error = detail;
+            m_stats.failedStep = pc;
+        }
+        if (ok && !step.saveAs.isEmpty()) {
+            m_stats.variables.insert(step.saveAs, QString::fromLatin1(m_variables.value(step.saveAs)));
+        }
+        m_stats.bytesSent = sent;
+        m_stats.bytesReceived = m_received;
+        m_stats.framesReceived = m_framesReceived;
+        m_stats.dropped = m_ring.dropped() + m_frameRing.dropped();
+        m_stats.elapsedSeconds = (NativePort::nowNanos() - start) / 1e9;
+        if (!ok) break;
+        pc = next;
+    }
+
+    m_accepting = false;
+    m_acceptingFrames = false;
+    QMutexLocker locker(&m_mutex);
+    m_stats.running = false;
+    m_stats.finished = pc >= m_steps.size();
+    m_stats.currentStep = -1;
+    m_stats.elapsedSeconds = (NativePort::nowNanos() - start) / 1e9;
+}
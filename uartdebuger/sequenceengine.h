@@ -0,0 +1,132 @@
+#ifndef SEQUENCEENGINE_H
+#define SEQUENCEENGINE_H
+
+#include "ingestring.h"
+#include "streamstats.h"
+
+#include <QByteArray>
+#include <QMap>
+#include <QMutex>
+#include <QRegularExpression>
+#include <QSerialPort>
+#include <QString>
+#include <QThread>
+#include <QVector>
+#include <atomic>
+
+// 发送/等待序列：在工作线程中按 JSON 步骤表发送命令、等待应答，数据来自接收环形缓冲。
+// 字面量用预编译的 KMP 失配表流式匹配（跨块不回溯），正则在步骤开始后累积的文本上匹配，
+// 延伸到已收数据末尾、可能被后续数据延长的匹配要等下一块或超时才接受（模式以 \r\n 等结尾可立即判定）；
+// 每步延迟以接收数据在 readAll() 处的时间戳计，不受 GUI 刷新影响。
+// expectFrame 等的是分帧解码器输出的整帧（载荷按前缀比较），帧另走一个环形缓冲，只在脚本含此步骤时接收
+//
+// 步骤格式（顶层为数组，或含 "steps" 数组的对象）：
+//   {"send": "AT\r\n"}                       按当前编码发送文本，可含 ${变量}
+//   {"sendHex": "01 02 03"}                  发送 HEX
+//   {"expect": "OK", "timeout": 500, "fail": "ERROR"}
+//   {"expect": "VER=(\\d+)", "regex": true, "save": "ver"}   捕获组 1 存为变量
+//   {"expectFrame": "01 03", "save": "resp"} 等待载荷以该 HEX 开头的帧（空为任意帧），save 存载荷 HEX
+//   {"delay": 10}                            毫秒
+//   {"repeat": 100, "steps": [...]}          0 表示一直循环到停止
+// 任一步骤可带 "name" 作为报告中的名称
+class SequenceEngine : public QThread
+{
+public:
+    struct Step {
+        enum Type {
+            Send,
+            Expect,
+            ExpectFrame,
+            Delay,
+            Repeat,
+            EndRepeat
+        };
+
+        Type type = Send;
+        QString label;
+        int depth = 0;                   // 循环嵌套层数，仅用于显示
+        QByteArray payload;              // Send
+        bool hasVariables = false;
+        QByteArray literal;              // Expect（非正则）
+        QVector<int> failure;            // literal 的 KMP 失配表
+        QByteArray framePrefix;          // ExpectFrame：载荷前缀，空为任意帧
+        QByteArray failLiteral;          // 先于期望内容出现即判失败
+        QVector<int> failFailure;
+        bool isRegex = false;
+        QRegularExpression regex;
+        QString saveAs;
+        int timeoutMs = 1000;
+        int delayMs = 0;
+        int repeat = 1;                  // Repeat 的次数，0 表示不限
+        int jump = -1;                   // Repeat 指向对应的 EndRepeat，EndRepeat 指回 Repeat
+    };
+
+    struct StepStats {
+        qint64 runs = 0;
+        qint64 failures = 0;
+        StreamStats latency;             // µs：发送为写入耗时，等待为上次发送完成到匹配数据被读到
+        QString lastDetail;
+    };
+
+    struct Stats {
+        bool running = false;
+        bool finished = false;           // 全部步骤执行完毕
+        QString error;                   // 非空表示在 failedStep 处失败
+        int currentStep = -1;
+        int failedStep = -1;
+        double elapsedSeconds = 0;
+        qint64 bytesSent = 0;
+        qint64 bytesReceived = 0;
+        qint64 framesReceived = 0;
+        qint64 dropped = 0;              // 环形缓冲溢出丢弃的块（含帧）
+        QVector<StepStats> steps;
+        QMap<QString, QString> variables;
+    };
+
+    SequenceEngine();
+    ~SequenceEngine();
+
+    // 解析步骤表；文本按 codecName 编码（空为本地编码），在 GUI 线程调用
+    static bool parse(const QByteArray &json, const QByteArray &codecName, QVector<Step> *steps, QString *error);
+
+    bool start(QSerialPort::Handle handle, const QVector<Step> &steps, QString *error);
+    void stop();
+    Stats stats() const;
+    // 在 readAll() 处调用；未运行时丢弃
+    void feed(const QByteArray &data, qint64 timestampNs);
+    // 在分帧解码器的帧回调中调用（载荷与帧末字节的读取时刻）；脚本不含 expectFrame 或未运行时丢弃
+    void feedFrame(const char *data, int size, qint64 timestampNs);
+
+protected:
+    void run() override;
+
+private:
+    struct Pending {
+        QByteArray data;
+        qint64 timestampNs = 0;
+    };
+
+    // 等待期望内容；成功时 matchNs 为匹配末字节所在块的读取时刻
+    bool expect(const Step &step, Pending *pending, qint64 *matchNs, QString *detail);
+    // 等待载荷前缀匹配的帧，之前不匹配的帧丢弃；成功时 matchNs 为该帧末字节的读取时刻
+    bool expectFrame(const Step &step, qint64 *matchNs, QString *detail);
+    // 步骤带 save 时把捕获组 1（无则整个匹配）存为变量
+    void saveCapture(const Step &step, const QRegularExpressionMatch &match);
+    bool sleepFor(int ms);
+    QByteArray substitute(const QByteArray &payload) const;
+
+    QSerialPort::Handle m_handle = 0;
+    QVector<Step> m_steps;
+    IngestRing m_ring;
+    IngestRing m_frameRing;                    // 每帧一块
+    std::atomic<bool> m_accepting{false};
+    std::atomic<bool> m_acceptingFrames{false};
+    std::atomic<bool> m_stop{false};
+    QMap<QString, QByteArray> m_variables;     // 仅工作线程访问
+    qint64 m_received = 0;
+    qint64 m_framesReceived = 0;
+    mutable QMutex m_mutex;
+    Stats m_stats;
+};
+
+#endif // SEQUENCEENGINE_H
@@ -0,0 +1,198 @@
+#include "sequencewindow.h"
+
+#include <QFile>
+#include <QFileDialog>
+#include <QFontDatabase>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPlainTextEdit>
+#include <QPushButton>
+#include <QSplitter>
+#include <QVBoxLayout>
+
+namespace {
+const int kRefreshIntervalMs = 200;
+
+const char *const kExampleScript =
+        "{\n"
+        "  \"steps\": [\n"
+        "    {\"send\": \"AT+VER?\\r\\n\"},\n"
+        "    {\"expect\": \"VER=([0-9.]+)\", \"regex\": true, \"save\": \"ver\", \"timeout\": 500},\n"
+        "    {\"repeat\": 100, \"steps\": [\n"
+        "      {\"send\": \"PING\\r\\n\"},\n"
+        "      {\"expect\": \"PONG\", \"fail\": \"ERR\", \"timeout\": 200},\n"
+        "      {\"delay\": 10}\n"
+        "    ]}\n"
+        "  ]\n"
+        "}\n";
+}
+
+SequenceWindow::SequenceWindow(QWidget *parent)
+    : QWidget(parent, Qt::Window)
+{
+    setWindowTitle(QStringLiteral("发送/等待序列"));
+    resize(820, 560);
+
+    m_editor = new QPlainTextEdit(this);
+    m_editor->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    m_editor->setPlainText(QString::fromUtf8(kExampleScript));
+    m_report = new QPlainTextEdit(this);
+    m_report->setReadOnly(true);
+    m_report->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    QPushButton *loadButton = new QPushButton(QStringLiteral("打开…"), this);
+    QPushButton *saveButton = new QPushButton(QStringLiteral("保存…"), this);
+    m_startButton = new QPushButton(QStringLiteral("运行"), this);
+    m_stopButton = new QPushButton(QStringLiteral("停止"), this);
+    m_stopButton->setEnabled(false);
+
+    QSplitter *splitter = new QSplitter(Qt::Horizontal, this);
+    splitter->addWidget(m_editor);
+    splitter->addWidget(m_report);
+    QHBoxLayout *buttons = new QHBoxLayout;
+    buttons->addWidget(loadButton);
+    buttons->addWidget(saveButton);
+    buttons->addStretch(1);
+    buttons->addWidget(m_startButton);
+    buttons->addWidget(m_stopButton);
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(buttons);
+    layout->addWidget(splitter, 1);
+
+    connect(loadButton, &QPushButton::clicked, this, &SequenceWindow::load);
+    connect(saveButton, &QPushButton::clicked, this, &SequenceWindow::save);
+    connect(m_startButton, &QPushButton::clicked, this, &SequenceWindow::start);
+    connect(m_stopButton, &QPushButton::clicked, this, &SequenceWindow::stop);
+
+    // 只在运行期间刷新，与窗口是否可见无关，以便及时累计发送计数
+    m_refreshTimer.setInterval(kRefreshIntervalMs);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &SequenceWindow::refresh);
+}
+
+void SequenceWindow::setPortProvider(const PortProvider &provider)
+{
+    m_portProvider = provider;
+}
+
+void SequenceWindow::setCodecProvider(const CodecProvider &provider)
+{
+    m_codecProvider = provider;
+}
+
+void SequenceWindow::setSentHandler(const SentHandler &handler)
+{
+    m_sentHandler = handler;
+}
+
+void SequenceWindow::load()
+{
+    const QString fileName = QFileDialog::getOpenFileName(this, QStringLiteral("打开序列"), QString(),
+                                                          QStringLiteral("JSON (*.json);;所有文件 (*)"));
+    if (fileName.isEmpty()) return;
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_report->setPlainText(QStringLiteral("打开文件失败。"));
+        return;
+    }
+    m_editor->setPlainText(QString::fromUtf8(file.readAll()));
+}
+
+void SequenceWindow::save()
+{
+    const QString fileName = QFileDialog::getSaveFileName(this, QStringLiteral("保存序列"), QString(),
+                                                          QStringLiteral("JSON (*.json)"));
+    if (fileName.isEmpty()) return;
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        m_report->setPlainText(QStringLiteral("保存文件失败。"));
+        return;
+    }
+    file.write(m_editor->toPlainText().toUtf8());
+}
+
+void SequenceWindow::start()
+{
+    QSerialPort::Handle handle = 0;
+    if (!m_portProvider || !m_portProvider(&handle)) {
+        m_report->setPlainText(QStringLiteral("串口未打开。"));
+        return;
+    }
+    QString error;
+    const QByteArray codecName = m_codecProvider ? m_codecProvider() : QByteArray();
+    if (!SequenceEngine::parse(m_editor->toPlainText().toUtf8(), codecName, &m_steps, &error)
+            || !m_engine.start(handle, m_steps, &error)) {
+        m_report->setPlainText(error);
+        return;
+    }
+    m_reportedBytes = 0;
+    m_startButton->setEnabled(false);
+    m_stopButton->setEnabled(true);
+    m_refreshTimer.start();
+    refresh();
+}
+
+void SequenceWindow::stop()
+{
+    m_engine.stop();
+    if (m_refreshTimer.isActive()) {
+        m_refreshTimer.stop();
+        refresh();
+    }
+    m_startButton->setEnabled(true);
+    m_stopButton->setEnabled(false);
+}
+
+void SequenceWindow::refresh()
+{
+    const SequenceEngine::Stats s = m_engine.stats();
+    if (m_sentHandler && s.bytesSent > m_reportedBytes) m_sentHandler(s.bytesSent - m_reportedBytes);
+    m_reportedBytes = s.bytesSent;
+
+    QString text;
+    if (s.running) {
+        text += QStringLiteral("运行中");
+    } else if (s.finished) {
+        text += QStringLiteral("全部通过");
+    } else if (!s.error.isEmpty()) {
+        text += QStringLiteral("失败：第 %1 步 %2").arg(s.failedStep + 1).arg(s.error);
+    } else {
+        text += QStringLiteral("已停止");
+    }
+    text += QStringLiteral("\n用时 %1 s，发送 %2 字节，接收 %3 字节")
+            .arg(s.elapsedSeconds, 0, 'f', 3).arg(s.bytesSent).arg(s.bytesReceived);
+    if (s.framesReceived > 0) text += QStringLiteral("，%1 帧").arg(s.framesReceived);
+    if (s.dropped > 0) text += QStringLiteral("，缓冲溢出丢弃 %1 块").arg(s.dropped);
+    text += QStringLiteral("\n\n步骤                          次数   失败   延迟 µs：均值 / P50 / P99 / 最大\n");
+    for (int i = 0; i < m_steps.size() && i < s.steps.size(); ++i) {
+        const SequenceEngine::Step &step = m_steps[i];
+        if (step.type == SequenceEngine::Step::EndRepeat) continue;
+        const SequenceEngine::StepStats &st = s.steps[i];
+        QString name = QString(step.depth * 2, ' ') + step.label;
+        text += QStringLiteral("%1%2 %3 %4 %5")
+                .arg(i == s.currentStep ? QStringLiteral("▶") : QStringLiteral(" "))
+                .arg(i + 1, 3)
+                .arg(name, -28)
+                .arg(st.runs, 6)
+                .arg(st.failures, 6);
+        const RunningMoments &m = st.latency.moments();
+        if (m.count() > 0) {
+            text += QStringLiteral("   %1 / %2 / %3 / %4")
+                    .arg(m.mean(), 0, 'f', 1).arg(st.latency.quantile(0.5), 0, 'f', 1)
+                    .arg(st.latency.quantile(0.99), 0, 'f', 1).arg(m.max(), 0, 'f', 1);
+        }
+        if (!st.lastDetail.isEmpty()) text += QStringLiteral("   （%1）").arg(st.lastDetail);
+        text += '\n';
+    }
+    if (!s.variables.isEmpty()) {
+        text += QStringLiteral("\n变量：\n");
+        for (auto it = s.variables.constBegin(); it != s.variables.constEnd(); ++it) {
+            text += QStringLiteral("  %1 = %2\n").arg(it.key(), it.value());
+        }
+    }
+    m_report->setPlainText(text);
+
+    if (!s.running && m_refreshTimer.isActive()) {
+        m_refreshTimer.stop();
+        m_startButton->setEnabled(true);
+        m_stopButton->setEnabled(false);
+    }
+}
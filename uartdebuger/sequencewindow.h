@@ -0,0 +1,56 @@
+#ifndef SEQUENCEWINDOW_H
+#define SEQUENCEWINDOW_H
+
+#include "framedecoder.h"
+#include "sequenceengine.h"
+
+#include <QTimer>
+#include <QWidget>
+#include <functional>
+
+class QPlainTextEdit;
+class QPushButton;
+
+// 发送/等待序列窗口：编辑或载入 JSON 步骤表，在工作线程中运行，按步骤显示通过/失败次数与延迟分位数
+class SequenceWindow : public QWidget
+{
+public:
+    // 串口已打开时给出系统句柄并返回 true
+    using PortProvider = std::function<bool(QSerialPort::Handle *handle)>;
+    // 返回当前发送编码（空为本地编码）
+    using CodecProvider = std::function<QByteArray()>;
+    // 每次刷新时报告新写出的字节数
+    using SentHandler = std::function<void(qint64 bytes)>;
+
+    explicit SequenceWindow(QWidget *parent = nullptr);
+
+    void setPortProvider(const PortProvider &provider);
+    void setCodecProvider(const CodecProvider &provider);
+    void setSentHandler(const SentHandler &handler);
+    // 在 readAll() 处调用
+    void feed(const QByteArray &data, qint64 timestampNs) { m_engine.feed(data, timestampNs); }
+    // 在分帧解码器的帧回调中调用
+    void feedFrame(const FrameDecoder::Frame &frame) { m_engine.feedFrame(frame.data, frame.size, frame.timestampNs); }
+    // 串口关闭前必须调用
+    void stop();
+
+private:
+    void load();
+    void save();
+    void start();
+    void refresh();
+
+    SequenceEngine m_engine;
+    QVector<SequenceEngine::Step> m_steps;
+    PortProvider m_portProvider;
+    CodecProvider m_codecProvider;
+    SentHandler m_sentHandler;
+    QTimer m_refreshTimer;
+    qint64 m_reportedBytes = 0;
+    QPlainTextEdit *m_editor = nullptr;
+    QPlainTextEdit *m_report = nullptr;
+    QPushButton *m_startButton = nullptr;
+    QPushButton *m_stopButton = nullptr;
+};
+
+#endif // SEQUENCEWINDOW_H
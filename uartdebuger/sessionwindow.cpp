@@ -0,0 +1,342 @@
+#include "sessionwindow.h"
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QFileDialog>
+#include <QFontDatabase>
+#include <QGridLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QPlainTextEdit>
+#include <QPushButton>
+#include <QSerialPortInfo>
+#include <QSplitter>
+#include <QVBoxLayout>
+
+namespace {
+const int kPumpIntervalMs = 100;
+const int kListRefreshPumps = 5;
+const qint64 kHoldbackNs = 200 * 1000000LL;    // 合并保留窗口：晚到不超过 200 ms 的记录仍能排进正确位置
+const int kViewBlocks = 5000;
+
+struct FrameFormat {
+    const char *name;
+    QSerialPort::DataBits dataBits;
+    QSerialPort::Parity parity;
+    QSerialPort::StopBits stopBits;
+};
+
+const FrameFormat kFormats[] = {
+    {"8N1", QSerialPort::Data8, QSerialPort::NoParity, QSerialPort::OneStop},
+    {"8E1", QSerialPort::Data8, QSerialPort::EvenParity, QSerialPort::OneStop},
+    {"8O1", QSerialPort::Data8, QSerialPort::OddParity, QSerialPort::OneStop},
+    {"8N2", QSerialPort::Data8, QSerialPort::NoParity, QSerialPort::TwoStop},
+    {"7E1", QSerialPort::Data7, QSerialPort::EvenParity, QSerialPort::OneStop},
+    {"7O1", QSerialPort::Data7, QSerialPort::OddParity, QSerialPort::OneStop},
+};
+
+// 制表符分隔文件的字段转义：反斜杠、制表符与换行写成 \\、\t、\n、\r，保证一条记录一行
+QString tsvField(const QString &text)
+{
+    QString out;
+    out.reserve(text.size());
+    for (const QChar c : text) {
+        if (c == '\\') out += QStringLiteral("\\\\");
+        else if (c == '\t') out += QStringLiteral("\\t");
+        else if (c == '\n') out += QStringLiteral("\\n");
+        else if (c == '\r') out += QStringLiteral("\\r");
+        else out += c;
+    }
+    return out;
+}
+}
+
+SessionWindow::SessionWindow(QWidget *parent)
+    : QWidget(parent, Qt::Window)
+{
+    setWindowTitle(QStringLiteral("多串口会话"));
+    resize(760, 600);
+
+    m_portCombo = new QComboBox(this);
+    m_portCombo->setEditable(true);
+    m_refreshButton = new QPushButton(QStringLiteral("刷新"), this);
+    m_baudCombo = new QComboBox(this);
+    m_baudCombo->addItems({"9600", "19200", "38400", "57600", "115200", "230400", "460800", "921600"});
+    m_baudCombo->setEditable(true);
+    m_baudCombo->setCurrentText("115200");
+    m_formatCombo = new QComboBox(this);
+    for (int i = 0; i < int(sizeof(kFormats) / sizeof(kFormats[0])); ++i) {
+        m_formatCombo->addItem(QString::fromLatin1(kFormats[i].name), i);
+    }
+    m_modeCombo = new QComboBox(this);
+    for (int i = 0; i < PortSession::ModeCount; ++i) {
+        m_modeCombo->addItem(PortSession::modeName(static_cast<PortSession::Mode>(i)), i);
+    }
+    m_modeCombo->setToolTip(QStringLiteral("分帧模式使用“分帧解码”窗口中的当前设置"));
+    m_labelEdit = new QLineEdit(this);
+    m_labelEdit->setPlaceholderText(QStringLiteral("名称（可选）"));
+    m_addButton = new QPushButton(QStringLiteral("打开"), this);
+    m_sessionList = new QListWidget(this);
+    m_removeButton = new QPushButton(QStringLiteral("关闭所选"), this);
+    m_pauseCheck = new QCheckBox(QStringLiteral("暂停显示"), this);
+    m_clearButton = new QPushButton(QStringLiteral("清空"), this);
+    m_captureButton = new QPushButton(QStringLiteral("记录到文件…"), this);
+    m_exportButton = new QPushButton(QStringLiteral("导出样本…"), this);
+    m_exportButton->setToolTip(QStringLiteral("把各路样本缓冲（最近 %1 个）按读取时刻合并导出").arg(PortSession::kMaxSamples));
+    m_statusLabel = new QLabel(this);
+    m_statusLabel->setWordWrap(true);
+    m_view = new QPlainTextEdit(this);
+    m_view->setReadOnly(true);
+    m_view->setMaximumBlockCount(kViewBlocks);
+    m_view->setLineWrapMode(QPlainTextEdit::NoWrap);
+    m_view->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+
+    QGridLayout *params = new QGridLayout;
+    params->addWidget(new QLabel(QStringLiteral("串口"), this), 0, 0);
+    params->addWidget(m_portCombo, 0, 1);
+    params->addWidget(m_refreshButton, 0, 2);
+    params->addWidget(new QLabel(QStringLiteral("波特率"), this), 0, 3);
+    params->addWidget(m_baudCombo, 0, 4);
+    params->addWidget(new QLabel(QStringLiteral("格式"), this), 1, 0);
+    params->addWidget(m_formatCombo, 1, 1);
+    params->addWidget(new QLabel(QStringLiteral("显示"), this), 1, 3);
+    params->addWidget(m_modeCombo, 1, 4);
+    params->addWidget(m_labelEdit, 2, 0, 1, 4);
+    params->addWidget(m_addButton, 2, 4);
+    QWidget *top = new QWidget(this);
+    QVBoxLayout *topLayout = new QVBoxLayout(top);
+    topLayout->setContentsMargins(0, 0, 0, 0);
+    topLayout->addLayout(params);
+    topLayout->addWidget(m_sessionList, 1);
+    QHBoxLayout *sessionButtons = new QHBoxLayout;
+    sessionButtons->addWidget(m_statusLabel, 1);
+    sessionButtons->addWidget(m_exportButton);
+    sessionButtons->addWidget(m_removeButton);
+    topLayout->addLayout(sessionButtons);
+    QWidget *bottom = new QWidget(this);
+    QVBoxLayout *bottomLayout = new QVBoxLayout(bottom);
+    bottomLayout->setContentsMargins(0, 0, 0, 0);
+    QHBoxLayout *viewButtons = new QHBoxLayout;
+    viewButtons->addWidget(new QLabel(QStringLiteral("合并时间线（t 为相对首个会话打开时刻的秒数）"), this), 1);
+    viewButtons->addWidget(m_pauseCheck);
+    viewButtons->addWidget(m_clearButton);
+    viewButtons->addWidget(m_captureButton);
+    bottomLayout->addLayout(viewButtons);
+    bottomLayout->addWidget(m_view, 1);
+    QSplitter *splitter = new QSplitter(Qt::Vertical, this);
+    splitter->addWidget(top);
+    splitter->addWidget(bottom);
+    splitter->setStretchFactor(1, 1);
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addWidget(splitter);
+
+    connect(m_refreshButton, &QPushButton::clicked, this, &SessionWindow::refreshPorts);
+    connect(m_addButton, &QPushButton::clicked, this, &SessionWindow::addSession);
+    connect(m_removeButton, &QPushButton::clicked, this, &SessionWindow::removeSession);
+    connect(m_clearButton, &QPushButton::clicked, m_view, &QPlainTextEdit::clear);
+    connect(m_captureButton, &QPushButton::clicked, this, &SessionWindow::toggleCapture);
+    connect(m_exportButton, &QPushButton::clicked, this, &SessionWindow::exportSamples);
+    // 有会话时持续取记录，与窗口是否可见无关，避免各路积压超限丢弃
+    m_pumpTimer.setInterval(kPumpIntervalMs);
+    connect(&m_pumpTimer, &QTimer::timeout, this, &SessionWindow::pump);
+    refreshPorts();
+}
+
+void SessionWindow::setFrameConfigProvider(const FrameConfigProvider &provider)
+{
+    m_frameConfigProvider = provider;
+}
+
+void SessionWindow::refreshPorts()
+{
+    const QString current = m_portCombo->currentText();
+    m_portCombo->clear();
+    for (const QSerialPortInfo &info : QSerialPortInfo::availablePorts()) {
+        m_portCombo->addItem(info.portName());
+    }
+    if (!current.isEmpty()) m_portCombo->setCurrentText(current);
+}
+
+void SessionWindow::addSession()
+{
+    PortSession::Config cfg;
+    cfg.portName = m_portCombo->currentText().trimmed();
+    if (cfg.portName.isEmpty()) {
+        m_statusLabel->setText(QStringLiteral("未选择串口"));
+        return;
+    }
+    for (int i = 0; i < m_manager.count(); ++i) {
+        if (m_manager.session(i)->config().portName == cfg.portName) {
+            m_statusLabel->setText(QStringLiteral("%1 已在会话中").arg(cfg.portName));
+            return;
+        }
+    }
+    bool ok = false;
+    cfg.baudRate = m_baudCombo->currentText().toInt(&ok);
+    if (!ok || cfg.baudRate <= 0) {
+        m_statusLabel->setText(QStringLiteral("波特率无效"));
+        return;
+    }
+    const FrameFormat &format = kFormats[m_formatCombo->currentData().toInt()];
+    cfg.dataBits = format.dataBits;
+    cfg.parity = format.parity;
+    cfg.stopBits = format.stopBits;
+    cfg.label = m_labelEdit->text().trimmed();
+    cfg.mode = static_cast<PortSession::Mode>(m_modeCombo->currentData().toInt());
+    if (cfg.mode == PortSession::Frames && m_frameConfigProvider) cfg.frames = m_frameConfigProvider();
+    m_manager.add(cfg);
+    m_labelEdit->clear();
+    m_statusLabel->clear();
+    if (!m_pumpTimer.isActive()) m_pumpTimer.start();
+    updateSessionList();
+}
+
+void SessionWindow::removeSession()
+{
+    const int row = m_sessionList->currentRow();
+    if (row < 0 || row >= m_manager.count()) return;
+    m_manager.remove(row);
+    updateSessionList();
+}
+
+void SessionWindow::closeAll()
+{
+    m_pumpTimer.stop();
+    m_manager.clear();
+    if (m_captureFile.isOpen()) toggleCapture();
+    updateSessionList();
+}
+
+void SessionWindow::toggleCapture()
+{
+    if (m_captureFile.isOpen()) {
+        m_captureFile.close();
+        m_captureButton->setText(QStringLiteral("记录到文件…"));
+        m_statusLabel->setText(QStringLiteral("已记录 %1 条").arg(m_capturedRecords));
+        return;
+    }
+    const QString fileName = QFileDialog::getSaveFileName(this, QStringLiteral("记录合并时间线"), QString(),
+                                                          QStringLiteral("制表符分隔 (*.tsv *.txt);;所有文件 (*)"));
+    if (fileName.isEmpty()) return;
+    m_captureFile.setFileName(fileName);
+    if (!m_captureFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        m_statusLabel->setText(QStringLiteral("无法打开 %1").arg(fileName));
+        return;
+    }
+    m_captureFile.write("t_s\tport\ttext\n");
+    m_capturedRecords = 0;
+    m_captureButton->setText(QStringLiteral("停止记录"));
+}
+
+void SessionWindow::exportSamples()
+{
+    if (m_manager.count() == 0) {
+        m_statusLabel->setText(QStringLiteral("没有会话"));
+        return;
+    }
+    QVector<PortSession::Samples> snapshots;
+    qint64 total = 0;
+    for (int i = 0; i < m_manager.count(); ++i) {
+        snapshots.append(m_manager.session(i)->samples());
+        total += snapshots.last().codes.size();
+    }
+    if (total == 0) {
+        m_statusLabel->setText(QStringLiteral("各路都还没有样本（HEX 模式不产生样本）"));
+        return;
+    }
+    const QString fileName = QFileDialog::getSaveFileName(this, QStringLiteral("导出样本"), QString(),
+                                                          QStringLiteral("制表符分隔 (*.tsv *.txt);;所有文件 (*)"));
+    if (fileName.isEmpty()) return;
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        m_statusLabel->setText(QStringLiteral("无法打开 %1").arg(fileName));
+        return;
+    }
+    file.write("t_s\tport\tindex\tcode\n");
+    // 各路样本按时间有序，逐个取最早的一路归并；同一时刻按会话顺序
+    const qint64 epoch = m_manager.epochNs();
+    QVector<int> next(snapshots.size(), 0);
+    QVector<QByteArray> labels;
+    for (int i = 0; i < m_manager.count(); ++i) labels.append(tsvField(m_manager.session(i)->label()).toUtf8());
+    QByteArray chunk;
+    for (qint64 written = 0; written < total; ++written) {
+        int pick = -1;
+        for (int i = 0; i < snapshots.size(); ++i) {
+            if (next[i] >= snapshots[i].codes.size()) continue;
+            if (pick < 0 || snapshots[i].timestampsNs[next[i]] < snapshots[pick].timestampsNs[next[pick]]) pick = i;
+        }
+        const PortSession::Samples &s = snapshots[pick];
+        const int k = next[pick]++;
+        chunk += QByteArray::number((s.timestampsNs[k] - epoch) / 1e9, 'f', 6);
+        chunk += '\t';
+        chunk += labels[pick];
+        chunk += '\t';
+        chunk += QByteArray::number(s.firstIndex + k);
+        chunk += '\t';
+        chunk += QByteArray::number(s.codes[k]);
+        chunk += '\n';
+        if (chunk.size() >= (1 << 16)) {
+            file.write(chunk);
+            chunk.clear();
+        }
+    }
+    file.write(chunk);
+    file.close();
+    m_statusLabel->setText(QStringLiteral("已导出 %1 个样本到 %2").arg(total).arg(fileName));
+}
+
+void SessionWindow::pump()
+{
+    QVector<PortSession::Record> records;
+    m_manager.collect(kHoldbackNs, &records);
+    if (!records.isEmpty()) {
+        const qint64 epoch = m_manager.epochNs();
+        QStringList lines;
+        for (const PortSession::Record &r : records) {
+            const double t = (r.timestampNs - epoch) / 1e9;
+            const QString label = m_manager.session(r.session)->label();
+            if (m_captureFile.isOpen()) {
+                m_captureFile.write(QStringLiteral("%1\t%2\t%3\n").arg(t, 0, 'f', 6).arg(tsvField(label), tsvField(r.text))
+                                    .toUtf8());
+                ++m_capturedRecords;
+            }
+            if (!m_pauseCheck->isChecked()) {
+                lines.append(QStringLiteral("%1  %2  %3").arg(t, 12, 'f', 6).arg(label, -10).arg(r.text));
+            }
+        }
+        // 一次追加整批，超出 kViewBlocks 的旧行由控件自动丢弃
+        if (!lines.isEmpty()) m_view->appendPlainText(lines.join('\n'));
+    }
+    if (++m_pumpCount >= kListRefreshPumps) {
+        m_pumpCount = 0;
+        updateSessionList();
+    }
+    if (m_manager.count() == 0 && records.isEmpty()) m_pumpTimer.stop();
+}
+
+void SessionWindow::updateSessionList()
+{
+    // 逐项更新文字，保持当前选中行
+    while (m_sessionList->count() > m_manager.count()) delete m_sessionList->takeItem(m_sessionList->count() - 1);
+    while (m_sessionList->count() < m_manager.count()) m_sessionList->addItem(QString());
+    for (int i = 0; i < m_manager.count(); ++i) {
+        const PortSession *session = m_manager.session(i);
+        const PortSession::Stats s = session->stats();
+        const PortSession::Config &cfg = session->config();
+        QString text = QStringLiteral("%1  %2  %3 bps  %4  ").arg(session->label(), -10).arg(cfg.portName)
+                .arg(cfg.baudRate).arg(PortSession::modeName(cfg.mode));
+        if (!s.error.isEmpty()) text += s.error;
+        else text += s.open ? QStringLiteral("已打开") : QStringLiteral("打开中");
+        text += QStringLiteral("  接收 %1 字节，%2 条，样本 %3").arg(s.bytes).arg(s.records).arg(s.samples);
+        if (cfg.mode == PortSession::Frames) {
+            text += QStringLiteral("，坏帧 %1").arg(s.frames.badChecksum + s.frames.malformed + s.frames.overlong);
+        }
+        if (s.droppedRecords > 0) text += QStringLiteral("，积压丢弃 %1").arg(s.droppedRecords);
+        m_sessionList->item(i)->setText(text);
+    }
+    if (m_captureFile.isOpen()) {
+        m_statusLabel->setText(QStringLiteral("正在记录到 %1，已写 %2 条").arg(m_captureFile.fileName()).arg(m_capturedRecords));
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef SESSIONWINDOW_H
+#define SESSIONWINDOW_H
+
+#include "portsession.h"
+
+#include <QFile>
+#include <QTimer>
+#include <QWidget>
+#include <functional>
+
+class QCheckBox;
+class QComboBox;
+class QLabel;
+class QLineEdit;
+class QListWidget;
+class QPlainTextEdit;
+class QPushButton;
+
+// 多串口会话窗口：同时打开多个串口（与主窗口的串口互相独立），各路在自己的线程中收发解析，
+// 按共享单调时钟的读取时刻合并成一条时间线显示，并可把合并结果记录到文件；
+// 各路的样本缓冲可按读取时刻对齐导出
+class SessionWindow : public QWidget
+{
+public:
+    // 分帧模式使用的配置，取自主窗口的分帧解码设置
+    using FrameConfigProvider = std::function<FrameDecoder::Config()>;
+
+    explicit SessionWindow(QWidget *parent = nullptr);
+
+    void setFrameConfigProvider(const FrameConfigProvider &provider);
+    // 关闭全部会话与记录文件
+    void closeAll();
+
+private:
+    void refreshPorts();
+    void addSession();
+    void removeSession();
+    void toggleCapture();
+    void exportSamples();
+    void pump();
+    void updateSessionList();
+
+    SessionManager m_manager;
+    FrameConfigProvider m_frameConfigProvider;
+    QTimer m_pumpTimer;
+    QFile m_captureFile;
+    qint64 m_capturedRecords = 0;
+    int m_pumpCount = 0;
+    QComboBox *m_portCombo = nullptr;
+    QComboBox *m_baudCombo = nullptr;
+    QComboBox *m_formatCombo = nullptr;
+    QComboBox *m_modeCombo = nullptr;
+    QLineEdit *m_labelEdit = nullptr;
+    QPushButton *m_refreshButton = nullptr;
+    QPushButton *m_addButton = nullptr;
+    QListWidget *m_sessionList = nullptr;
+    QPushButton *m_removeButton = nullptr;
+    QCheckBox *m_pauseCheck = nullptr;
+    QPushButton *m_clearButton = nullptr;
+    QPushButton *m_captureButton = nullptr;
+    QPushButton *m_exportButton = nullptr;
+    QLabel *m_statusLabel = nullptr;
+    QPlainTextEdit *m_view = nullptr;
+};
+
+#endif // SESSIONWINDOW_H
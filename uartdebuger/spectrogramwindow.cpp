@@ -0,0 +1,386 @@
+#include "spectrogramwindow.h"
+
+#include <QComboBox>
+#include <QDoubleSpinBox>
+#include <QFile>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QMessageBox>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPushButton>
+#include <QTextStream>
+#include <QVBoxLayout>
+#include <QWheelEvent>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const int kLeftMargin = 56;
+const int kBottomMargin = 22;
+const int kTopMargin = 8;
+const int kRightMargin = 8;
+const int kMaxRowsPerLine = 64;
+const int kMinZoomBins = 8;
+
+// 瀑布图色表：黑 -> 深紫 -> 红 -> 橙 -> 浅黄，弱信号偏暗
+struct SpectrogramPalette {
+    QRgb colors[256];
+    SpectrogramPalette()
+    {
+        const int stops[][4] = {
+            {0, 0x00, 0x00, 0x04},
+            {70, 0x42, 0x0a, 0x68},
+            {140, 0x93, 0x26, 0x67},
+            {200, 0xdd, 0x51, 0x3a},
+            {255, 0xfc, 0xff, 0xa4},
+        };
+        for (int s = 0; s < 4; ++s) {
+            const int i0 = stops[s][0];
+            const int i1 = stops[s + 1][0];
+            for (int i = i0; i <= i1; ++i) {
+                const double t = static_cast<double>(i - i0) / (i1 - i0);
+                colors[i] = qRgb(static_cast<int>(stops[s][1] + t * (stops[s + 1][1] - stops[s][1])),
+                                 static_cast<int>(stops[s][2] + t * (stops[s + 1][2] - stops[s][2])),
+                                 static_cast<int>(stops[s][3] + t * (stops[s + 1][3] - stops[s][3])));
+            }
+        }
+    }
+};
+
+const SpectrogramPalette &spectrogramPalette()
+{
+    static const SpectrogramPalette p;
+    return p;
+}
+
+QString formatFrequency(double hz)
+{
+    if (hz >= 1000.0) return QString::number(hz / 1000.0, 'f', 2) + " kHz";
+    return QString::number(hz, 'f', hz >= 100.0 ? 0 : 1) + " Hz";
+}
+}
+
+SpectrogramWidget::SpectrogramWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    setMinimumSize(480, 260);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+void SpectrogramWidget::setEngine(const StftEngine *engine)
+{
+    m_engine = engine;
+    resetZoom();
+}
+
+void SpectrogramWidget::setDbRange(double minDb, double maxDb)
+{
+    m_minDb = minDb;
+    m_maxDb = std::max(minDb + 1.0, maxDb);
+    rebuild();
+}
+
+void SpectrogramWidget::resetZoom()
+{
+    m_binLo = 0;
+    m_binHi = m_engine ? m_engine->bins() - 1 : 0;
+    m_rowsPerLine = 1;
+    rebuild();
+}
+
+QRect SpectrogramWidget::plotRect() const
+{
+    return rect().adjusted(kLeftMargin, kTopMargin, -kRightMargin, -kBottomMargin);
+}
+
+void SpectrogramWidget::updateColumnBins()
+{
+    const int w = m_ring.width();
+    const int span = m_binHi - m_binLo + 1;
+    m_columnBins.resize(w + 1);
+    for (int x = 0; x <= w; ++x) {
+        m_columnBins[x] = m_binLo + static_cast<int>(static_cast<qint64>(x) * span / std::max(1, w));
+    }
+}
+
+void SpectrogramWidget::writeLine(int lastRow)
+{
+    // 新行写在当前头部之前，使最新数据在环形图中总是从 m_ringHead 开始向后排列
+    m_ringHead = (m_ringHead - 1 + m_ring.height()) % m_ring.height();
+    QRgb *line = reinterpret_cast<QRgb *>(m_ring.scanLine(m_ringHead));
+    const int firstRow = std::max(0, lastRow - m_rowsPerLine + 1);
+    const double scale = 255.0 / (m_maxDb - m_minDb);
+    const SpectrogramPalette &pal = spectrogramPalette();
+    for (int x = 0; x < m_ring.width(); ++x) {
+        const int b0 = m_columnBins[x];
+        const int b1 = std::max(b0 + 1, m_columnBins[x + 1]);
+        // 一个像素覆盖多个频点/多帧时取峰值，避免窄带分量在缩小时消失
+        float peak = -1e30f;
+        for (int r = firstRow; r <= lastRow; ++r) {
+            const float *row = m_engine->row(r);
+            for (int b = b0; b < b1; ++b) peak = std::max(peak, row[b]);
+        }
+        const int idx = static_cast<int>((peak - m_minDb) * scale);
+        line[x] = pal.colors[std::min(255, std::max(0, idx))];
+    }
+}
+
+void SpectrogramWidget::appendRows(int count)
+{
+    if (!m_engine || m_ring.isNull()) return;
+    m_pendingRows = std::min(m_pendingRows + count, m_engine->rowCount());
+    if (m_pendingRows / m_rowsPerLine >= m_ring.height()) {
+        rebuild();
+        return;
+    }
+    while (m_pendingRows >= m_rowsPerLine) {
+        writeLine(m_engine->rowCount() - m_pendingRows + m_rowsPerLine - 1);
+        m_pendingRows -= m_rowsPerLine;
+    }
+    update();
+}
+
+void SpectrogramWidget::rebuild()
+{
+    const QRect plot = plotRect();
+    if (plot.width() <= 0 || plot.height() <= 0) return;
+    if (m_ring.size() != plot.size()) {
+        m_ring = QImage(plot.size(), QImage::Format_RGB32);
+    }
+    m_ring.fill(spectrogramPalette().colors[0]);
+    m_ringHead = 0;
+    m_pendingRows = 0;
+    if (m_engine) {
+        m_binHi = std::min(m_binHi, m_engine->bins() - 1);
+        updateColumnBins();
+        const int rows = m_engine->rowCount();
+        const int lines = std::min(m_ring.height(), (rows + m_rowsPerLine - 1) / m_rowsPerLine);
+        for (int i = lines - 1; i >= 0; --i) {
+            writeLine(rows - 1 - i * m_rowsPerLine);
+        }
+    }
+    update();
+}
+
+void SpectrogramWidget::paintEvent(QPaintEvent *)
+{
+    QPainter p(this);
+    p.fillRect(rect(), QColor("#ffffff"));
+    const QRect plot = plotRect();
+    if (m_ring.isNull() || !m_engine) return;
+
+    // 环形图分两段贴图：[head, H) 在上，[0, head) 接在下面
+    const int h = m_ring.height();
+    const int top = h - m_ringHead;
+    p.drawImage(QRect(plot.left(), plot.top(), plot.width(), top), m_ring,
+                QRect(0, m_ringHead, m_ring.width(), top));
+    if (m_ringHead > 0) {
+        p.drawImage(QRect(plot.left(), plot.top() + top, plot.width(), m_ringHead), m_ring,
+                    QRect(0, 0, m_ring.width(), m_ringHead));
+    }
+
+    p.setPen(QPen(QColor("#8e8e93"), 1));
+    const int divs = 5;
+    const double lineSeconds = m_engine->rowInterval() * m_rowsPerLine;
+    for (int i = 0; i <= divs; ++i) {
+        const int y = plot.top() + plot.height() * i / divs;
+        const double t = -lineSeconds * h * i / divs;
+        p.drawLine(plot.left() - 4, y, plot.left(), y);
+        p.drawText(QRect(0, y - 8, kLeftMargin - 6, 16), Qt::AlignRight | Qt::AlignVCenter,
+                   QString::number(t, 'f', std::fabs(t) >= 10.0 ? 0 : 2) + " s");
+
+        const int x = plot.left() + plot.width() * i / divs;
+        const double f = (m_binLo + (m_binHi - m_binLo + 1) * static_cast<double>(i) / divs) * m_engine->binWidth();
+        p.drawLine(x, plot.bottom(), x, plot.bottom() + 4);
+        const Qt::Alignment align = i == 0 ? Qt::AlignLeft : (i == divs ? Qt::AlignRight : Qt::AlignHCenter);
+        const int labelX = i == 0 ? x : (i == divs ? x - 80 : x - 40);
+        p.drawText(QRect(labelX, plot.bottom() + 4, 80, kBottomMargin - 4), align | Qt::AlignTop, formatFrequency(f));
+    }
+
+    if (m_engine->rowCount() == 0) {
+        p.setPen(QPen(QColor("#c7c7cc"), 1));
+        p.drawText(plot, Qt::AlignCenter, QStringLiteral("等待波形数据..."));
+    }
+}
+
+void SpectrogramWidget::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    rebuild();
+}
+
+void SpectrogramWidget::wheelEvent(QWheelEvent *event)
+{
+    if (!m_engine) return;
+    const bool zoomIn = event->angleDelta().y() > 0;
+    if (event->modifiers() & Qt::ControlModifier) {
+        // Ctrl+滚轮：时间轴压缩/展开
+        m_rowsPerLine = zoomIn ? std::max(1, m_rowsPerLine / 2) : std::min(kMaxRowsPerLine, m_rowsPerLine * 2);
+    } else {
+        // 滚轮：以光标所在频率为中心缩放频率轴
+        const QRect plot = plotRect();
+        const double frac = std::min(1.0, std::max(0.0, (event->position().x() - plot.left()) / std::max(1, plot.width())));
+        const int span = m_binHi - m_binLo + 1;
+        const double center = m_binLo + frac * span;
+        const int maxSpan = m_engine->bins();
+        const int newSpan = std::min(maxSpan, std::max(kMinZoomBins, static_cast<int>(span * (zoomIn ? 0.8 : 1.25))));
+        int lo = static_cast<int>(center - frac * newSpan);
+        lo = std::min(std::max(0, lo), maxSpan - newSpan);
+        m_binLo = lo;
+        m_binHi = lo + newSpan - 1;
+    }
+    rebuild();
+    event->accept();
+}
+
+void SpectrogramWidget::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    Q_UNUSED(event);
+    resetZoom();
+}
+
+SpectrogramWindow::SpectrogramWindow(StftEngine *engine, QWidget *parent)
+    : QWidget(parent, Qt::Window)
+    , m_engine(engine)
+{
+    setWindowTitle(QStringLiteral("频谱瀑布图"));
+    resize(820, 520);
+
+    m_fftSizeCombo = new QComboBox(this);
+    for (int n = 256; n <= 8192; n *= 2) {
+        m_fftSizeCombo->addItem(QString::number(n), n);
+    }
+    m_fftSizeCombo->setCurrentIndex(std::max(0, m_fftSizeCombo->findData(m_engine->config().fftSize)));
+    m_overlapCombo = new QComboBox(this);
+    m_overlapCombo->addItem(QStringLiteral("0%"), 1);
+    m_overlapCombo->addItem(QStringLiteral("50%"), 2);
+    m_overlapCombo->addItem(QStringLiteral("75%"), 4);
+    m_overlapCombo->addItem(QStringLiteral("87.5%"), 8);
+    m_overlapCombo->setCurrentIndex(
+            std::max(0, m_overlapCombo->findData(m_engine->config().fftSize / m_engine->config().hop)));
+    m_minDbSpin = new QDoubleSpinBox(this);
+    m_minDbSpin->setRange(-200.0, 40.0);
+    m_minDbSpin->setValue(-80.0);
+    m_minDbSpin->setSuffix(" dB");
+    m_maxDbSpin = new QDoubleSpinBox(this);
+    m_maxDbSpin->setRange(-160.0, 80.0);
+    m_maxDbSpin->setValue(0.0);
+    m_maxDbSpin->setSuffix(" dB");
+    QPushButton *clearButton = new QPushButton(QStringLiteral("清空"), this);
+    QPushButton *exportButton = new QPushButton(QStringLiteral("导出 CSV"), this);
+
+    QHBoxLayout *controls = new QHBoxLayout;
+    controls->addWidget(new QLabel(QStringLiteral("FFT 点数"), this));
+    controls->addWidget(m_fftSizeCombo);
+    controls->addWidget(new QLabel(QStringLiteral("重叠"), this));
+    controls->addWidget(m_overlapCombo);
+    controls->addWidget(new QLabel(QStringLiteral("色标"), this));
+    controls->addWidget(m_minDbSpin);
+    controls->addWidget(m_maxDbSpin);
+    controls->addStretch();
+    controls->addWidget(clearButton);
+    controls->addWidget(exportButton);
+
+    m_view = new SpectrogramWidget(this);
+    m_infoLabel = new QLabel(this);
+    m_infoLabel->setStyleSheet("color: #6e6e73;");
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(controls);
+    layout->addWidget(m_view, 1);
+    layout->addWidget(m_infoLabel);
+
+    connect(m_fftSizeCombo, static_cast<void(QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, [this](int) { applyConfig(); });
+    connect(m_overlapCombo, static_cast<void(QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, [this](int) { applyConfig(); });
+    connect(m_minDbSpin, static_cast<void(QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged), this, [this](double) {
+        m_view->setDbRange(m_minDbSpin->value(), m_maxDbSpin->value());
+    });
+    connect(m_maxDbSpin, static_cast<void(QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged), this, [this](double) {
+        m_view->setDbRange(m_minDbSpin->value(), m_maxDbSpin->value());
+    });
+    connect(clearButton, &QPushButton::clicked, this, &SpectrogramWindow::clearHistory);
+    connect(exportButton, &QPushButton::clicked, this, &SpectrogramWindow::exportHistory);
+
+    m_view->setDbRange(m_minDbSpin->value(), m_maxDbSpin->value());
+    m_view->setEngine(m_engine);
+    updateInfo();
+}
+
+void SpectrogramWindow::applyConfig()
+{
+    // 参数变化后旧历史的频点/时间刻度不再一致，直接重新开始
+    StftEngine::Config config = m_engine->config();
+    config.fftSize = m_fftSizeCombo->currentData().toInt();
+    config.hop = std::max(1, config.fftSize / m_overlapCombo->currentData().toInt());
+    m_engine->configure(config);
+    engineReset();
+}
+
+void SpectrogramWindow::rowsAdded(int rows)
+{
+    if (!isVisible()) return;
+    m_view->appendRows(rows);
+    updateInfo();
+}
+
+void SpectrogramWindow::engineReset()
+{
+    m_view->setEngine(m_engine);
+    updateInfo();
+}
+
+void SpectrogramWindow::clearHistory()
+{
+    m_engine->reset();
+    m_view->rebuild();
+    updateInfo();
+}
+
+void SpectrogramWindow::showEvent(QShowEvent *event)
+{
+    // 隐藏期间累积的行一次补画
+    QWidget::showEvent(event);
+    m_view->rebuild();
+    updateInfo();
+}
+
+void SpectrogramWindow::updateInfo()
+{
+    m_infoLabel->setText(QStringLiteral("频率分辨率 %1 Hz，时间分辨率 %2 ms，历史 %3 行，跳过 %4 帧 | 滚轮缩放频率，Ctrl+滚轮压缩时间，双击复位")
+                         .arg(m_engine->binWidth(), 0, 'g', 4)
+                         .arg(m_engine->rowInterval() * 1000.0, 0, 'g', 4)
+                         .arg(m_engine->rowCount())
+                         .arg(m_engine->droppedRows()));
+}
+
+void SpectrogramWindow::exportHistory()
+{
+    if (m_engine->rowCount() == 0) {
+        QMessageBox::information(this, QStringLiteral("导出"), QStringLiteral("暂无频谱数据"));
+        return;
+    }
+    const QString fileName = QFileDialog::getSaveFileName(this, QStringLiteral("导出频谱历史"), QString(), "CSV (*.csv)");
+    if (fileName.isEmpty()) return;
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QMessageBox::warning(this, QStringLiteral("导出"), QStringLiteral("无法写入文件"));
+        return;
+    }
+    QTextStream out(&file);
+    out << "sample_index,time_s";
+    for (int b = 0; b < m_engine->bins(); ++b) {
+        out << ',' << b * m_engine->binWidth();
+    }
+    out << '\n';
+    for (int r = 0; r < m_engine->rowCount(); ++r) {
+        const qint64 sample = m_engine->rowSampleIndex(r);
+        out << sample << ',' << sample / m_engine->config().sampleRate;
+        const float *row = m_engine->row(r);
+        for (int b = 0; b < m_engine->bins(); ++b) {
+            out << ',' << row[b];
+        }
+        out << '\n';
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef SPECTROGRAMWINDOW_H
+#define SPECTROGRAMWINDOW_H
+
+#include <QWidget>
+#include <QImage>
+#include <QVector>
+
+#include "scopestft.h"
+
+class QComboBox;
+class QDoubleSpinBox;
+class QLabel;
+
+// 瀑布图绘制组件：环形 QImage 每次只写入新行，绘制时分两段贴图
+class SpectrogramWidget : public QWidget
+{
+public:
+    explicit SpectrogramWidget(QWidget *parent = nullptr);
+
+    void setEngine(const StftEngine *engine);
+    void setDbRange(double minDb, double maxDb);
+    // 引擎新产生 count 行后调用，只绘制新增部分
+    void appendRows(int count);
+    // 缩放/尺寸/色标变化后按历史整体重绘
+    void rebuild();
+    // 恢复全频带、每行一帧
+    void resetZoom();
+
+protected:
+    void paintEvent(QPaintEvent *) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+
+private:
+    QRect plotRect() const;
+    void updateColumnBins();
+    void writeLine(int lastRow);
+
+    const StftEngine *m_engine = nullptr;
+    QImage m_ring;
+    int m_ringHead = 0;            // 最新一行在环形图中的位置
+    int m_pendingRows = 0;         // 尚未凑满一行像素的频谱行
+    int m_rowsPerLine = 1;         // 时间压缩：每个像素行合并的频谱行数
+    int m_binLo = 0;
+    int m_binHi = 0;
+    QVector<int> m_columnBins;     // 像素列 -> 起始频点
+    double m_minDb = -80.0;
+    double m_maxDb = 0.0;
+};
+
+// 频谱瀑布图窗口：FFT 点数/重叠率可调，支持导出历史。
+// 引擎由主窗口持有并持续送入样本，窗口隐藏时历史照常累积，显示时整体重绘
+class SpectrogramWindow : public QWidget
+{
+public:
+    explicit SpectrogramWindow(StftEngine *engine, QWidget *parent = nullptr);
+
+    // 引擎新产生 rows 行后调用；隐藏时不绘制
+    void rowsAdded(int rows);
+    // 引擎被外部重新配置或清空后调用
+    void engineReset();
+    void clearHistory();
+
+protected:
+    void showEvent(QShowEvent *event) override;
+
+private:
+    void applyConfig();
+    void exportHistory();
+    void updateInfo();
+
+    StftEngine *m_engine;
+    SpectrogramWidget *m_view = nullptr;
+    QComboBox *m_fftSizeCombo = nullptr;
+    QComboBox *m_overlapCombo = nullptr;
+    QDoubleSpinBox *m_minDbSpin = nullptr;
+    QDoubleSpinBox *m_maxDbSpin = nullptr;
+    QLabel *m_infoLabel = nullptr;
+};
+
+#endif // SPECTROGRAMWINDOW_H
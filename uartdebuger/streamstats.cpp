@@ -0,0 +1,195 @@
+#include "streamstats.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const double kPi = 3.14159265358979323846;
+// 缓冲区攒满后统一排序合并，摊薄排序开销
+const int kBufferSize = 1024;
+}
+
+void RunningMoments::add(double value)
+{
+    if (m_count == 0) {
+        m_min = value;
+        m_max = value;
+    } else {
+        m_min = std::min(m_min, value);
+        m_max = std::max(m_max, value);
+    }
+    ++m_count;
+    const double delta = value - m_mean;
+    m_mean += delta / m_count;
+    m_m2 += delta * (value - m_mean);
+}
+
+void RunningMoments::reset()
+{
+    *this = RunningMoments();
+}
+
+void RunningMoments::merge(const RunningMoments &other)
+{
+    if (other.m_count == 0) return;
+    if (m_count == 0) {
+        *this = other;
+        return;
+    }
+    // 两组的均值差修正合并后的二阶矩 (Chan et al.)
+    const qint64 n = m_count + other.m_count;
+    const double delta = other.m_mean - m_mean;
+    m_m2 += other.m_m2 + delta * delta * static_cast<double>(m_count) * other.m_count / n;
+    m_mean += delta * other.m_count / n;
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+    m_count = n;
+}
+
+double RunningMoments::stddev() const
+{
+    return std::sqrt(variance());
+}
+
+TDigest::TDigest(double compression)
+    : m_compression(std::max(20.0, compression))
+{
+}
+
+void TDigest::add(double value, double weight)
+{
+    if (std::isnan(value) || weight <= 0) return;
+    if (m_count == 0) {
+        m_min = value;
+        m_max = value;
+    } else {
+        m_min = std::min(m_min, value);
+        m_max = std::max(m_max, value);
+    }
+    m_count += static_cast<qint64>(weight);
+    Centroid c = {value, weight};
+    m_buffer.append(c);
+    if (m_buffer.size() >= kBufferSize) compress();
+}
+
+void TDigest::reset()
+{
+    m_centroids.clear();
+    m_buffer.clear();
+    m_count = 0;
+    m_min = 0;
+    m_max = 0;
+}
+
+void TDigest::compress() const
+{
+    if (m_buffer.isEmpty()) return;
+    QVector<Centroid> items = m_centroids;
+    items += m_buffer;
+    m_buffer.clear();
+    std::sort(items.begin(), items.end(), [](const Centroid &a, const Centroid &b) { return a.mean < b.mean; });
+    double total = 0;
+    for (const Centroid &c : items) total += c.weight;
+
+    // k1 尺度：k(q) = δ/(2π)·asin(2q-1)，相邻质心的 k 值相差不超过 1
+    const double delta = m_compression;
+    auto kOf = [delta](double q) { return delta / (2.0 * kPi) * std::asin(2.0 * q - 1.0); };
+    auto qOf = [delta](double k) { return (std::sin(k * 2.0 * kPi / delta) + 1.0) / 2.0; };
+
+    QVector<Centroid> merged;
+    merged.reserve(static_cast<int>(delta * 2));
+    Centroid cur = items[0];
+    double weightSoFar = 0;
+    double qLimit = qOf(kOf(0.0) + 1.0);
+    for (int i = 1; i < items.size(); ++i) {
+        const Centroid &next = items[i];
+        const double q = (weightSoFar + cur.weight + next.weight) / total;
+        if (q <= qLimit) {
+            cur.weight += next.weight;
+            cur.mean += (next.mean - cur.mean) * next.weight / cur.weight;
+        } else {
+            weightSoFar += cur.weight;
+            merged.append(cur);
+            qLimit = qOf(kOf(weightSoFar / total) + 1.0);
+            cur = next;
+        }
+    }
+    merged.append(cur);
+    m_centroids = merged;
+}
+
+int TDigest::centroidCount() const
+{
+    compress();
+    return m_centroids.size();
+}
+
+void TDigest::merge(const TDigest &other)
+{
+    if (other.m_count == 0) return;
+    other.compress();
+    if (m_count == 0) {
+        m_min = other.m_min;
+        m_max = other.m_max;
+    } else {
+        m_min = std::min(m_min, other.m_min);
+        m_max = std::max(m_max, other.m_max);
+    }
+    m_count += other.m_count;
+    m_buffer += other.m_centroids;
+    compress();
+}
+
+double TDigest::quantile(double q) const
+{
+    if (m_count == 0) return 0.0;
+    compress();
+    q = std::min(1.0, std::max(0.0, q));
+    const int n = m_centroids.size();
+    if (n == 1) return m_centroids[0].mean;
+    double total = 0;
+    for (const Centroid &c : m_centroids) total += c.weight;
+    const double target = q * total;
+
+    // 每个质心的权重视为以其均值为中心对称分布
+    const Centroid &first = m_centroids[0];
+    if (target < first.weight / 2) {
+        return m_min + (first.mean - m_min) * target / (first.weight / 2);
+    }
+    double cumulative = first.weight / 2;
+    for (int i = 0; i + 1 < n; ++i) {
+        const Centroid &a = m_centroids[i];
+        const Centroid &b = m_centroids[i + 1];
+        const double step = (a.weight + b.weight) / 2;
+        if (target < cumulative + step) {
+            return a.mean + (b.mean - a.mean) * (target - cumulative) / step;
+        }
+        cumulative += step;
+    }
+    const Centroid &last = m_centroids[n - 1];
+    const double tail = last.weight / 2;
+    return last.mean + (m_max - last.mean) * std::min(1.0, (target - cumulative) / tail);
+}
+
+void StreamStats::add(double value)
+{
+    m_moments.add(value);
+    m_digest.add(value);
+}
+
+void StreamStats::reset()
+{
+    m_moments.reset();
+    m_digest.reset();
+}
+
+void StreamStats::merge(const StreamStats &other)
+{
+    m_moments.merge(other.m_moments);
+    m_digest.merge(other.m_digest);
+}
+
+double StreamStats::quantile(double q) const
+{
+    return m_digest.quantile(q);
+}
@@ -0,0 +1,79 @@
+#ifndef STREAMSTATS_H
+#define STREAMSTATS_H
+
+#include <QVector>
+#include <QtGlobal>
+
+// Welford 递推：单遍计算均值/方差，数值稳定，内存 O(1)
+class RunningMoments
+{
+public:
+    void add(double value);
+    void reset();
+    void merge(const RunningMoments &other);
+    qint64 count() const { return m_count; }
+    double mean() const { return m_mean; }
+    double variance() const { return m_count > 1 ? m_m2 / (m_count - 1) : 0.0; }
+    double stddev() const;
+    double min() const { return m_min; }
+    double max() const { return m_max; }
+
+private:
+    qint64 m_count = 0;
+    double m_mean = 0;
+    double m_m2 = 0;
+    double m_min = 0;
+    double m_max = 0;
+};
+
+// 合并式 t-digest：按 k1 尺度函数把样本聚成有限个质心，两端分位数更细，中间更粗
+// 质心数不超过 compression，另有固定大小的输入缓冲区，内存与样本数无关
+class TDigest
+{
+public:
+    explicit TDigest(double compression = 200.0);
+
+    void add(double value, double weight = 1.0);
+    void reset();
+    qint64 count() const { return m_count; }
+    // q 取 0~1，质心之间线性插值，两端插值到精确的最小/最大值
+    double quantile(double q) const;
+    // 合并另一个摘要（用于多线程分段统计后汇总）
+    void merge(const TDigest &other);
+    int centroidCount() const;
+
+private:
+    struct Centroid {
+        double mean;
+        double weight;
+    };
+
+    void compress() const;
+
+    double m_compression;
+    // 查询时需要先合并缓冲区，故声明为 mutable
+    mutable QVector<Centroid> m_centroids;
+    mutable QVector<Centroid> m_buffer;
+    qint64 m_count = 0;
+    double m_min = 0;
+    double m_max = 0;
+};
+
+// 单个测量量的长期统计：矩 + 分位数
+class StreamStats
+{
+public:
+    void add(double value);
+    void reset();
+    void merge(const StreamStats &other);
+    const RunningMoments &moments() const { return m_moments; }
+    const TDigest &digest() const { return m_digest; }
+    qint64 count() const { return m_moments.count(); }
+    double quantile(double q) const;
+
+private:
+    RunningMoments m_moments;
+    TDigest m_digest;
+};
+
+#endif // STREAMSTATS_H
@@ -0,0 +1,336 @@
+#include "trendwindow.h"
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDateTime>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QMessageBox>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPushButton>
+#include <QSignalBlocker>
+#include <QVBoxLayout>
+#include <QWheelEvent>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// 趋势以秒为粒度，刷新不必比 1 s 更快
+const int kRefreshIntervalMs = 1000;
+const int kLeftMargin = 64;
+const int kBottomMargin = 22;
+const int kTopMargin = 22;
+const int kRightMargin = 10;
+const qint64 kMinSpan = 60;
+const qint64 kMaxSpan = 5LL * 365 * 86400;
+// 每个像素最多对应的记录数，超过则换用更粗的级别
+const int kMaxRecordsPerPixel = 2;
+
+QString formatTime(qint64 sec, qint64 span)
+{
+    const QDateTime t = QDateTime::fromSecsSinceEpoch(sec);
+    if (span <= 2 * 86400) return t.toString("HH:mm:ss");
+    if (span <= 60 * 86400) return t.toString("MM-dd HH:mm");
+    return t.toString("yyyy-MM-dd");
+}
+
+QString formatSpan(qint64 sec)
+{
+    if (sec >= 86400) return QStringLiteral("%1 天").arg(sec / 86400.0, 0, 'g', 3);
+    if (sec >= 3600) return QStringLiteral("%1 小时").arg(sec / 3600.0, 0, 'g', 3);
+    return QStringLiteral("%1 分钟").arg(sec / 60.0, 0, 'g', 3);
+}
+}
+
+TrendChart::TrendChart(const TrendRecorder *recorder, QWidget *parent)
+    : QWidget(parent)
+    , m_recorder(recorder)
+{
+    setMinimumSize(480, 240);
+}
+
+QRect TrendChart::plotRect() const
+{
+    return QRect(kLeftMargin, kTopMargin, std::max(1, width() - kLeftMargin - kRightMargin),
+                 std::max(1, height() - kTopMargin - kBottomMargin));
+}
+
+qint64 TrendChart::viewEnd() const
+{
+    return m_follow ? QDateTime::currentSecsSinceEpoch() : m_end;
+}
+
+void TrendChart::setSpan(qint64 seconds)
+{
+    const qint64 end = viewEnd();
+    m_span = std::min(kMaxSpan, std::max(kMinSpan, seconds));
+    m_end = end;
+    reload();
+}
+
+void TrendChart::setFollow(bool follow)
+{
+    if (!follow) m_end = viewEnd();
+    m_follow = follow;
+    reload();
+}
+
+void TrendChart::reload()
+{
+    m_records.clear();
+    if (!m_recorder || !m_recorder->isOpen()) {
+        update();
+        return;
+    }
+    const qint64 end = viewEnd();
+    const qint64 start = end - m_span;
+    // 记录数不超过像素宽度 kMaxRecordsPerPixel 倍的最细级别
+    const qint64 maxRecords = static_cast<qint64>(plotRect().width()) * kMaxRecordsPerPixel;
+    int finest = TrendRecorder::LevelCount - 1;
+    for (int l = 0; l < TrendRecorder::LevelCount; ++l) {
+        if (m_span / TrendRecorder::intervalSeconds(static_cast<TrendRecorder::Level>(l)) <= maxRecords) {
+            finest = l;
+            break;
+        }
+    }
+    // 细级别的环形文件保留时间短，可见区间起点已被覆盖时改用能覆盖起点的粗级别
+    int level = finest;
+    for (int l = finest; l < TrendRecorder::LevelCount; ++l) {
+        const qint64 first = m_recorder->firstTime(static_cast<TrendRecorder::Level>(l));
+        if (first >= 0 && first <= start) {
+            level = l;
+            break;
+        }
+    }
+    m_level = static_cast<TrendRecorder::Level>(level);
+    const int interval = TrendRecorder::intervalSeconds(m_level);
+    m_records = m_recorder->read(m_level, start - interval, end + 1);
+    update();
+}
+
+void TrendChart::paintEvent(QPaintEvent *)
+{
+    QPainter p(this);
+    p.fillRect(rect(), QColor("#ffffff"));
+    const QRect plot = plotRect();
+    p.setPen(QPen(QColor("#d1d1d6"), 1));
+    p.drawRect(plot);
+
+    const qint64 end = viewEnd();
+    const qint64 start = end - m_span;
+    const int interval = TrendRecorder::intervalSeconds(m_level);
+    // 时间轴刻度
+    p.setPen(QPen(QColor("#8e8e93"), 1));
+    const int divs = 5;
+    for (int i = 0; i <= divs; ++i) {
+        const int x = plot.left() + plot.width() * i / divs;
+        p.drawLine(x, plot.bottom(), x, plot.bottom() + 4);
+        const qint64 t = start + m_span * i / divs;
+        const Qt::Alignment align = i == 0 ? Qt::AlignLeft : (i == divs ? Qt::AlignRight : Qt::AlignHCenter);
+        const int labelX = i == 0 ? x : (i == divs ? x - 120 : x - 60);
+        p.drawText(QRect(labelX, plot.bottom() + 4, 120, kBottomMargin - 4), align | Qt::AlignTop, formatTime(t, m_span));
+    }
+    p.drawText(QRect(plot.left(), 2, plot.width(), kTopMargin - 4), Qt::AlignLeft | Qt::AlignVCenter,
+               QStringLiteral("跨度 %1 · 级别 %2 · %3 点    蓝：均值  橙：RMS  浅蓝：最小~最大")
+               .arg(formatSpan(m_span)).arg(TrendRecorder::levelName(m_level)).arg(m_records.size()));
+
+    if (m_records.isEmpty()) {
+        p.setPen(QPen(QColor("#c7c7cc"), 1));
+        p.drawText(plot, Qt::AlignCenter, m_recorder && m_recorder->isOpen() ? QStringLiteral("该时间段没有趋势记录")
+                                                                             : QStringLiteral("未开启趋势记录"));
+        return;
+    }
+
+    float lo = m_records[0].min;
+    float hi = m_records[0].max;
+    for (const TrendRecorder::Record &r : m_records) {
+        lo = std::min(lo, r.min);
+        hi = std::max(hi, r.max);
+    }
+    double vMin = lo;
+    double vMax = hi;
+    if (vMax - vMin < 1e-6) {
+        vMin -= 0.5;
+        vMax += 0.5;
+    }
+    const double margin = (vMax - vMin) * 0.05;
+    vMin -= margin;
+    vMax += margin;
+    for (int i = 0; i <= divs; ++i) {
+        const int y = plot.top() + plot.height() * i / divs;
+        const double v = vMax - (vMax - vMin) * i / divs;
+        p.drawLine(plot.left() - 4, y, plot.left(), y);
+        p.drawText(QRect(0, y - 8, kLeftMargin - 6, 16), Qt::AlignRight | Qt::AlignVCenter,
+                   QString::number(v, 'g', 4) + " V");
+    }
+
+    const double xScale = static_cast<double>(plot.width()) / m_span;
+    const double yScale = plot.height() / (vMax - vMin);
+    auto xOf = [&](quint32 t) { return plot.left() + (static_cast<double>(t) + interval * 0.5 - start) * xScale; };
+    auto yOf = [&](double v) { return plot.bottom() - (v - vMin) * yScale; };
+
+    p.save();
+    p.setClipRect(plot);
+    // 最小~最大包络：每条记录一根竖线，线宽取一条记录对应的像素宽度
+    const double recordWidth = std::max(1.0, interval * xScale);
+    p.setPen(QPen(QColor("#b3d4fc"), recordWidth));
+    for (const TrendRecorder::Record &r : m_records) {
+        const double x = xOf(r.time);
+        p.drawLine(QPointF(x, yOf(r.min)), QPointF(x, yOf(r.max)));
+    }
+    // 均值/RMS 折线，相邻记录间隔超过 1.5 个区间视为记录中断，断开连线
+    p.setRenderHint(QPainter::Antialiasing, true);
+    auto drawSeries = [&](const QColor &color, float TrendRecorder::Record::*field) {
+        p.setPen(QPen(color, 1.5));
+        QPolygonF line;
+        for (int i = 0; i < m_records.size(); ++i) {
+            const TrendRecorder::Record &r = m_records[i];
+            if (i > 0 && static_cast<qint64>(r.time) - m_records[i - 1].time > interval * 3 / 2 + 1) {
+                p.drawPolyline(line);
+                line.clear();
+            }
+            line.append(QPointF(xOf(r.time), yOf(r.*field)));
+        }
+        p.drawPolyline(line);
+    };
+    drawSeries(QColor("#0a84ff"), &TrendRecorder::Record::mean);
+    drawSeries(QColor("#ff9f0a"), &TrendRecorder::Record::rms);
+    p.restore();
+}
+
+void TrendChart::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    reload();
+}
+
+void TrendChart::wheelEvent(QWheelEvent *event)
+{
+    const bool zoomIn = event->angleDelta().y() > 0;
+    const qint64 newSpan = std::min(kMaxSpan, std::max(kMinSpan, static_cast<qint64>(m_span * (zoomIn ? 0.8 : 1.25))));
+    if (!m_follow) {
+        // 以光标所在时刻为中心缩放
+        const QRect plot = plotRect();
+        const double frac = std::min(1.0, std::max(0.0, (event->position().x() - plot.left()) / plot.width()));
+        const double anchor = m_end - m_span + frac * m_span;
+        m_end = static_cast<qint64>(anchor + (1.0 - frac) * newSpan);
+    }
+    m_span = newSpan;
+    reload();
+    event->accept();
+}
+
+void TrendChart::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() != Qt::LeftButton) return;
+    m_dragX = event->x();
+    m_dragEnd = viewEnd();
+}
+
+void TrendChart::mouseMoveEvent(QMouseEvent *event)
+{
+    if (!(event->buttons() & Qt::LeftButton) || m_dragX < 0) return;
+    // 拖动平移后停止跟随最新
+    m_follow = false;
+    const double secondsPerPixel = static_cast<double>(m_span) / plotRect().width();
+    m_end = m_dragEnd - static_cast<qint64>((event->x() - m_dragX) * secondsPerPixel);
+    reload();
+}
+
+void TrendChart::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    Q_UNUSED(event);
+    setFollow(true);
+}
+
+TrendWindow::TrendWindow(TrendRecorder *recorder, QWidget *parent)
+    : QWidget(parent, Qt::Window)
+    , m_recorder(recorder)
+{
+    setWindowTitle(QStringLiteral("长期趋势"));
+    resize(900, 460);
+
+    m_recordCheck = new QCheckBox(QStringLiteral("记录趋势"), this);
+    m_recordCheck->setChecked(m_recorder->isEnabled() && m_recorder->isOpen());
+    m_followCheck = new QCheckBox(QStringLiteral("跟随最新"), this);
+    m_followCheck->setChecked(true);
+    m_spanCombo = new QComboBox(this);
+    const qint64 spans[] = {600, 3600, 6 * 3600, 86400, 7 * 86400, 30 * 86400, 365 * 86400};
+    for (qint64 s : spans) m_spanCombo->addItem(formatSpan(s), s);
+    m_spanCombo->setCurrentIndex(1);
+    QPushButton *clearButton = new QPushButton(QStringLiteral("清空记录"), this);
+    m_infoLabel = new QLabel(this);
+    m_chart = new TrendChart(m_recorder, this);
+
+    QHBoxLayout *controls = new QHBoxLayout;
+    controls->addWidget(m_recordCheck);
+    controls->addWidget(m_followCheck);
+    controls->addWidget(new QLabel(QStringLiteral("跨度"), this));
+    controls->addWidget(m_spanCombo);
+    controls->addWidget(m_infoLabel, 1);
+    controls->addWidget(clearButton);
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(controls);
+    layout->addWidget(m_chart, 1);
+
+    connect(m_recordCheck, &QCheckBox::toggled, this, &TrendWindow::setRecording);
+    connect(m_followCheck, &QCheckBox::toggled, this, [this](bool checked) { m_chart->setFollow(checked); });
+    connect(m_spanCombo, static_cast<void(QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, [this]() {
+        m_chart->setSpan(m_spanCombo->currentData().toLongLong());
+    });
+    connect(clearButton, &QPushButton::clicked, this, [this]() {
+        if (QMessageBox::question(this, QStringLiteral("清空记录"), QStringLiteral("确定删除全部趋势记录？"))
+                != QMessageBox::Yes) {
+            return;
+        }
+        m_recorder->clear();
+        refresh();
+    });
+    m_refreshTimer.setInterval(kRefreshIntervalMs);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &TrendWindow::refresh);
+}
+
+void TrendWindow::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    refresh();
+    m_refreshTimer.start();
+}
+
+void TrendWindow::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    m_refreshTimer.stop();
+}
+
+void TrendWindow::setRecording(bool enabled)
+{
+    if (enabled && !m_recorder->isOpen() && !m_recorder->open(TrendRecorder::defaultDirectory())) {
+        QMessageBox::warning(this, QStringLiteral("长期趋势"), m_recorder->errorString());
+        const QSignalBlocker blocker(m_recordCheck);
+        m_recordCheck->setChecked(false);
+        return;
+    }
+    m_recorder->setEnabled(enabled);
+    refresh();
+}
+
+void TrendWindow::refresh()
+{
+    // 拖动图表会退出跟随，同步到复选框
+    {
+        const QSignalBlocker blocker(m_followCheck);
+        m_followCheck->setChecked(m_chart->follow());
+    }
+    QString info = m_recorder->isEnabled() && m_recorder->isOpen() ? QStringLiteral("记录中") : QStringLiteral("已停止");
+    if (m_recorder->isOpen()) {
+        for (int l = 0; l < TrendRecorder::LevelCount; ++l) {
+            const auto level = static_cast<TrendRecorder::Level>(l);
+            info += QStringLiteral("  %1：%2/%3").arg(TrendRecorder::levelName(level))
+                    .arg(m_recorder->size(level)).arg(TrendRecorder::capacity(level));
+        }
+    }
+    m_infoLabel->setText(info);
+    m_chart->reload();
+}
@@ -0,0 +1,71 @@
+#ifndef TRENDWINDOW_H
+#define TRENDWINDOW_H
+
+#include <QWidget>
+#include <QTimer>
+
+#include "scopetrend.h"
+
+class QCheckBox;
+class QComboBox;
+class QLabel;
+
+// 趋势条带图：按可见时间跨度选择合适的级别，只读取可见区间内的记录，绘制代价与可见点数成正比
+class TrendChart : public QWidget
+{
+public:
+    explicit TrendChart(const TrendRecorder *recorder, QWidget *parent = nullptr);
+
+    void setSpan(qint64 seconds);
+    qint64 span() const { return m_span; }
+    void setFollow(bool follow);
+    bool follow() const { return m_follow; }
+    // 从磁盘重新读取可见区间（定时刷新或视图变化后调用）
+    void reload();
+
+protected:
+    void paintEvent(QPaintEvent *) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+
+private:
+    QRect plotRect() const;
+    qint64 viewEnd() const;
+
+    const TrendRecorder *m_recorder = nullptr;
+    qint64 m_span = 3600;           // 可见时间跨度 (s)
+    qint64 m_end = 0;               // 不跟随时的右边界 (Unix 秒)
+    bool m_follow = true;
+    int m_dragX = -1;
+    qint64 m_dragEnd = 0;
+    TrendRecorder::Level m_level = TrendRecorder::Seconds;
+    QVector<TrendRecorder::Record> m_records;
+};
+
+// 长期趋势窗口：开关记录、选择时间跨度，滚轮缩放、拖动平移，双击恢复跟随最新
+class TrendWindow : public QWidget
+{
+public:
+    explicit TrendWindow(TrendRecorder *recorder, QWidget *parent = nullptr);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    void setRecording(bool enabled);
+    void refresh();
+
+    TrendRecorder *m_recorder = nullptr;
+    QTimer m_refreshTimer;
+    TrendChart *m_chart = nullptr;
+    QCheckBox *m_recordCheck = nullptr;
+    QCheckBox *m_followCheck = nullptr;
+    QComboBox *m_spanCombo = nullptr;
+    QLabel *m_infoLabel = nullptr;
+};
+
+#endif // TRENDWINDOW_H
@@ -16,11 +16,112 @@ DEFINES += QT_DEPRECATED_WARNINGS
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    alerthighlighter.cpp \
+    alertmatcher.cpp \
+    alertmonitor.cpp \
+    alertwindow.cpp \
+    bauddetector.cpp \
+    framechecksum.cpp \
+    framedecoder.cpp \
+    framewindow.cpp \
+    freqtrackerwindow.cpp \
+    glitchwindow.cpp \
+    ingestring.cpp \
+    linkprobe.cpp \
+    linkprobewindow.cpp \
+    longtermwindow.cpp \
     main.cpp \
-    mainwindow.cpp
+    mainwindow.cpp \
+    maskwindow.cpp \
+    nativeport.cpp \
+    offlinewindow.cpp \
+    oscilloscopewidget.cpp \
+    payloadcache.cpp \
+    portsession.cpp \
+    portwatcher.cpp \
+    precisesendwindow.cpp \
+    ptyecho.cpp \
+    referencewindow.cpp \
+    scopeaverager.cpp \
+    scopeautoset.cpp \
+    scopefft.cpp \
+    scopefilter.cpp \
+    scopefreqtracker.cpp \
+    scopeglitch.cpp \
+    scopeindex.cpp \
+    scopeinterp.cpp \
+    scopelongterm.cpp \
+    scopemask.cpp \
+    scopemeasure.cpp \
+    scopeoffline.cpp \
+    scopepersistence.cpp \
+    scoperaster.cpp \
+    scopereference.cpp \
+    scopering.cpp \
+    scopestft.cpp \
+    scopetrend.cpp \
+    scopetrigger.cpp \
+    sendscheduler.cpp \
+    sequenceengine.cpp \
+    sequencewindow.cpp \
+    sessionwindow.cpp \
+    spectrogramwindow.cpp \
+    streamstats.cpp \
+    trendwindow.cpp
 
 HEADERS += \
-    mainwindow.h
+    alerthighlighter.h \
+    alertmatcher.h \
+    alertmonitor.h \
+    alertwindow.h \
+    bauddetector.h \
+    framechecksum.h \
+    framedecoder.h \
+    framewindow.h \
+    freqtrackerwindow.h \
+    glitchwindow.h \
+    ingestring.h \
+    linkprobe.h \
+    linkprobewindow.h \
+    longtermwindow.h \
+    mainwindow.h \
+    maskwindow.h \
+    nativeport.h \
+    offlinewindow.h \
+    oscilloscopewidget.h \
+    payloadcache.h \
+    portsession.h \
+    portwatcher.h \
+    precisesendwindow.h \
+    ptyecho.h \
+    referencewindow.h \
+    scopeaverager.h \
+    scopeautoset.h \
+    scopefft.h \
+    scopefilter.h \
+    scopefreqtracker.h \
+    scopeglitch.h \
+    scopeindex.h \
+    scopeinterp.h \
+    scopelongterm.h \
+    scopemask.h \
+    scopemeasure.h \
+    scopeoffline.h \
+    scopepersistence.h \
+    scoperaster.h \
+    scopereference.h \
+    scopering.h \
+    scopesimd.h \
+    scopestft.h \
+    scopetrend.h \
+    scopetrigger.h \
+    sendscheduler.h \
+    sequenceengine.h \
+    sequencewindow.h \
+    sessionwindow.h \
+    spectrogramwindow.h \
+    streamstats.h \
+    trendwindow.h
 
 FORMS += \
     mainwindow.ui